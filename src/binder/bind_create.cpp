@@ -20,6 +20,7 @@
 // THE SOFTWARE.
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
 #include <iterator>
 #include <memory>
 #include <string>
@@ -68,6 +69,15 @@ auto Binder::BindColumnDefinition(duckdb_libpgquery::PGColumnDef *cdef) -> Colum
     return {colname, TypeId::INTEGER};
   }
 
+  if (name == "int8") {
+    return {colname, TypeId::BIGINT};
+  }
+
+  // DECIMAL and DOUBLE PRECISION both map to the double that DECIMAL holds.
+  if (name == "numeric" || name == "float8") {
+    return {colname, TypeId::DECIMAL};
+  }
+
   if (name == "varchar") {
     auto exprs = BindExpressionList(cdef->typeName->typmods);
     if (exprs.size() != 1) {
@@ -81,6 +91,32 @@ auto Binder::BindColumnDefinition(duckdb_libpgquery::PGColumnDef *cdef) -> Colum
   throw NotImplementedException(fmt::format("unsupported type: {}", name));
 }
 
+auto Binder::BindDefElem(duckdb_libpgquery::PGDefElem *def) -> std::pair<std::string, std::string> {
+  auto name = StringUtil::Lower(def->defname);
+  if (def->arg == nullptr) {
+    throw bustub::Exception(fmt::format("option {} needs a value", name));
+  }
+  std::string value;
+  switch (def->arg->type) {
+    case duckdb_libpgquery::T_PGTypeName: {
+      // Bare identifiers such as `pax` are parsed as type names.
+      auto type_name = reinterpret_cast<duckdb_libpgquery::PGTypeName *>(def->arg);
+      value = reinterpret_cast<duckdb_libpgquery::PGValue *>(type_name->names->tail->data.ptr_value)->val.str;
+      break;
+    }
+    case duckdb_libpgquery::T_PGString:
+    case duckdb_libpgquery::T_PGFloat:
+      value = reinterpret_cast<duckdb_libpgquery::PGValue *>(def->arg)->val.str;
+      break;
+    case duckdb_libpgquery::T_PGInteger:
+      value = std::to_string(reinterpret_cast<duckdb_libpgquery::PGValue *>(def->arg)->val.ival);
+      break;
+    default:
+      throw NotImplementedException(fmt::format("unsupported value for option {}", name));
+  }
+  return {name, StringUtil::Lower(value)};
+}
+
 auto Binder::BindCreate(duckdb_libpgquery::PGCreateStmt *pg_stmt) -> std::unique_ptr<CreateStatement> {
   auto table = std::string(pg_stmt->relation->relname);
   auto columns = std::vector<Column>{};
@@ -112,7 +148,50 @@ auto Binder::BindCreate(duckdb_libpgquery::PGCreateStmt *pg_stmt) -> std::unique
     throw bustub::Exception("should have at least 1 column");
   }
 
-  return std::make_unique<CreateStatement>(std::move(table), std::move(columns));
+  auto storage_format = TableStorageFormat::ROW;
+  if (pg_stmt->options != nullptr) {
+    for (auto c = pg_stmt->options->head; c != nullptr; c = lnext(c)) {
+      auto [name, value] = BindDefElem(reinterpret_cast<duckdb_libpgquery::PGDefElem *>(c->data.ptr_value));
+      if (name == "dictionary") {
+        // `dictionary = 'a, b'` stores the VARCHAR columns a and b as codes of a per-column string dictionary.
+        for (const auto &col_name : StringUtil::Split(value, ',')) {
+          auto trimmed = StringUtil::Strip(col_name, ' ');
+          auto it = std::find_if(columns.begin(), columns.end(),
+                                 [&](const Column &column) { return column.GetName() == trimmed; });
+          if (it == columns.end()) {
+            throw bustub::Exception(fmt::format("dictionary column {} not found", trimmed));
+          }
+          if (it->GetType() != TypeId::VARCHAR) {
+            throw bustub::Exception(fmt::format("dictionary column {} is not a varchar column", trimmed));
+          }
+          if (!it->IsDictionaryEncoded()) {
+            *it = Column(it->GetName(), TypeId::VARCHAR, it->GetLength(), std::make_shared<StringDictionary>());
+          }
+        }
+        continue;
+      }
+      if (name != "storage") {
+        throw NotImplementedException(fmt::format("unsupported table option: {}", name));
+      }
+      if (value == "row") {
+        storage_format = TableStorageFormat::ROW;
+      } else if (value == "pax") {
+        storage_format = TableStorageFormat::PAX;
+      } else {
+        throw bustub::Exception(fmt::format("unknown storage format: {}", value));
+      }
+    }
+  }
+
+  if (storage_format == TableStorageFormat::PAX) {
+    for (const auto &column : columns) {
+      if (!column.IsInlined()) {
+        throw NotImplementedException("pax storage only supports fixed-length columns");
+      }
+    }
+  }
+
+  return std::make_unique<CreateStatement>(std::move(table), std::move(columns), storage_format);
 }
 
 auto Binder::BindIndex(duckdb_libpgquery::PGIndexStmt *stmt) -> std::unique_ptr<IndexStatement> {
@@ -129,7 +208,35 @@ auto Binder::BindIndex(duckdb_libpgquery::PGIndexStmt *stmt) -> std::unique_ptr<
     }
   }
 
-  return std::make_unique<IndexStatement>(stmt->idxname, std::move(table), std::move(cols));
+  std::vector<std::unique_ptr<BoundColumnRef>> include_cols;
+  if (stmt->options != nullptr) {
+    for (auto c = stmt->options->head; c != nullptr; c = lnext(c)) {
+      auto [name, value] = BindDefElem(reinterpret_cast<duckdb_libpgquery::PGDefElem *>(c->data.ptr_value));
+      if (name != "include") {
+        throw NotImplementedException(fmt::format("unsupported index option: {}", name));
+      }
+      // `include = 'b, c'` stores the columns b and c in the index entries as well, like the INCLUDE clause of
+      // Postgres, which the parser does not know.
+      auto col_names = StringUtil::Split(value, ',');
+      for (auto &col_name : col_names) {
+        col_name = StringUtil::Strip(col_name, ' ');
+      }
+      // Split drops a trailing empty name, so the names are counted against the commas as well.
+      if (col_names.size() != static_cast<size_t>(std::count(value.begin(), value.end(), ',')) + 1 ||
+          std::any_of(col_names.begin(), col_names.end(), [](const auto &col_name) { return col_name.empty(); })) {
+        throw bustub::Exception(fmt::format("index option include needs a list of column names, got '{}'", value));
+      }
+      for (const auto &name : col_names) {
+        auto column_ref = ResolveColumnInternal(*table, std::vector{name});
+        if (column_ref == nullptr) {
+          throw bustub::Exception(fmt::format("include column {} not found in table {}", name, table->table_));
+        }
+        include_cols.emplace_back(std::make_unique<BoundColumnRef>(dynamic_cast<const BoundColumnRef &>(*column_ref)));
+      }
+    }
+  }
+
+  return std::make_unique<IndexStatement>(stmt->idxname, std::move(table), std::move(cols), std::move(include_cols));
 }
 
 }  // namespace bustub
@@ -7,13 +7,19 @@
 namespace bustub {
 
 IndexStatement::IndexStatement(std::string index_name, std::unique_ptr<BoundBaseTableRef> table,
-                               std::vector<std::unique_ptr<BoundColumnRef>> cols)
+                               std::vector<std::unique_ptr<BoundColumnRef>> cols,
+                               std::vector<std::unique_ptr<BoundColumnRef>> include_cols)
     : BoundStatement(StatementType::INDEX_STATEMENT),
       index_name_(std::move(index_name)),
       table_(std::move(table)),
-      cols_(std::move(cols)) {}
+      cols_(std::move(cols)),
+      include_cols_(std::move(include_cols)) {}
 
 auto IndexStatement::ToString() const -> std::string {
+  if (!include_cols_.empty()) {
+    return fmt::format("BoundIndex {{ index_name={}, table={}, cols={}, include_cols={} }}", index_name_, *table_,
+                       cols_, include_cols_);
+  }
   return fmt::format("BoundIndex {{ index_name={}, table={}, cols={} }}", index_name_, *table_, cols_);
 }
 
@@ -91,8 +91,6 @@ auto BufferPoolManagerInstance::NewPgImp(page_id_t *page_id) -> Page * {
   }
 
   Page& page_in_frame = pages_[frame_allocated];
-  pages_[frame_allocated].RLatch(); 
-  // use locks
   if(page_in_frame.IsDirty()){
     // std::cout << "Evicting dirty page " << page_in_frame.GetPageId() << " Data: " << page_in_frame.GetData() << std::endl;
     disk_manager_->WritePage(page_in_frame.GetPageId(), page_in_frame.GetData());
@@ -113,7 +111,6 @@ auto BufferPoolManagerInstance::NewPgImp(page_id_t *page_id) -> Page * {
   *page_id = page_in_frame.page_id_;
   page_in_frame.is_dirty_ = false; 
   page_in_frame.pin_count_ = 1;
-  pages_[frame_allocated].RUnlatch();
   
   page_table_->Insert(*page_id, frame_allocated);
   
@@ -150,9 +147,8 @@ auto BufferPoolManagerInstance::FetchPgImp(page_id_t page_id) -> Page * {
   // std::cout << " hey came for fetching " << page_id << std::endl;
   if(page_table_->Find(page_id, frame_id_mapped)){
     // std::cout << "Data is " << pages_[frame_id_mapped].GetData() << std::endl;
-    pages_[frame_id_mapped].RLatch();
     pages_[frame_id_mapped].pin_count_++;
-    pages_[frame_id_mapped].RUnlatch();
+    replacer_->SetEvictable(frame_id_mapped, false);
     return &pages_[frame_id_mapped];
   }
    
@@ -179,8 +175,6 @@ auto BufferPoolManagerInstance::FetchPgImp(page_id_t page_id) -> Page * {
   }
 
   Page& page_in_frame = pages_[frame_allocated];
-  page_in_frame.RLatch();
-  // use locks
   if(page_in_frame.IsDirty()){
     disk_manager_->WritePage(page_in_frame.GetPageId(), page_in_frame.GetData());
   }
@@ -200,7 +194,6 @@ auto BufferPoolManagerInstance::FetchPgImp(page_id_t page_id) -> Page * {
   replacer_->RecordAccess(frame_allocated);
   replacer_->SetEvictable(frame_allocated, false);
   
-  page_in_frame.RUnlatch(); 
   // std::cout << "Data is " << page_in_frame.GetData() << std::endl;
   return &page_in_frame; 
 
@@ -230,16 +223,14 @@ auto BufferPoolManagerInstance::UnpinPgImp(page_id_t page_id, bool is_dirty) ->
   if(pages_[frame_alloted].GetPinCount() <= 0){
     return false;
   }
-  pages_[frame_alloted].RLatch();
   
   pages_[frame_alloted].pin_count_--;
-  pages_[frame_alloted].is_dirty_ = is_dirty;
+  pages_[frame_alloted].is_dirty_ = pages_[frame_alloted].is_dirty_ || is_dirty;
 
   if(pages_[frame_alloted].GetPinCount() == 0){
     replacer_->SetEvictable(frame_alloted, true);
   }
   // std::cout << "isdirty ? " << pages_[frame_alloted].IsDirty() << std::endl;
-  pages_[frame_alloted].RUnlatch();
   return true;
 }
 
@@ -259,13 +250,11 @@ auto BufferPoolManagerInstance::FlushPgImp(page_id_t page_id) -> bool {
   std::scoped_lock<std::mutex> lock(latch_);
   frame_id_t frame_alloted;
   if(page_table_->Find(page_id, frame_alloted)){
-    pages_[frame_alloted].RLatch();
     page_id_t page = pages_[frame_alloted].GetPageId();
     
     disk_manager_->WritePage(page, pages_[frame_alloted].GetData());
     pages_[frame_alloted].is_dirty_ = false;
     // std::cout << "Flushing dirty page " << pages_[frame_alloted].GetPageId() << " Data: " << pages_[frame_alloted].GetData() << std::endl;
-    pages_[frame_alloted].RUnlatch();
     return true;
   }
 
@@ -316,7 +305,7 @@ auto BufferPoolManagerInstance::DeletePgImp(page_id_t page_id) -> bool {
 
   page.ResetMemory();
 
-  page.is_dirty_ = true;
+  page.is_dirty_ = false;
 
   page.page_id_ = INVALID_PAGE_ID;
 
@@ -76,19 +76,8 @@ void LRUKReplacer::RecordAccess(frame_id_t frame_id) {
     if(access_history_.count(frame_id) == 0){
         is_evicted_[frame_id] = false;
     }
-    // auto t = std::time(nullptr);
-    auto current_time = std::chrono::system_clock::now();
-
-    // Convert the current time point to milliseconds
-    auto timestamp = std::chrono::time_point_cast<std::chrono::milliseconds>(current_time);
-    
-    // for(int i= 0;i < 10000000;i++){
-
-    // }
-    // Extract the number of milliseconds
-    auto milliseconds = timestamp.time_since_epoch().count();
-    std::this_thread::sleep_for(std::chrono::milliseconds(100));
-    access_history_[frame_id].push_back(milliseconds);
+    // Stamp accesses with a logical clock, which orders them without waiting for the wall clock to tick.
+    access_history_[frame_id].push_back(current_timestamp_++);
     
     if(access_history_[frame_id].size() > k_){
         auto it = access_history_[frame_id].begin();
@@ -19,7 +19,9 @@
 namespace bustub {
 
 Schema::Schema(const std::vector<Column> &columns) {
-  uint32_t curr_offset = 0;
+  // Tuples start with the null bitmap, which is followed by the columns.
+  null_bitmap_size_ = (columns.size() + 7) / 8;
+  uint32_t curr_offset = null_bitmap_size_;
   for (uint32_t index = 0; index < columns.size(); index++) {
     Column column = columns[index];
     // handle uninlined column
@@ -32,6 +34,9 @@ Schema::Schema(const std::vector<Column> &columns) {
     curr_offset += column.GetFixedLength();
 
     // add column
+    accessors_.push_back({column.GetOffset(), column.GetType(), column.IsInlined(), column.IsDictionaryEncoded(),
+                          index / 8, static_cast<uint8_t>(1U << (index % 8))});
+    column_indices_.emplace(column.GetName(), index);
     this->columns_.push_back(column);
   }
   // set tuple length
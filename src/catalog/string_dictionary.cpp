@@ -0,0 +1,52 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// string_dictionary.cpp
+//
+// Identification: src/catalog/string_dictionary.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include "catalog/string_dictionary.h"
+
+#include "common/macros.h"
+
+namespace bustub {
+
+auto StringDictionary::GetOrAddCode(const std::string &str) -> uint32_t {
+  // Most strings of a low-cardinality column are already in the dictionary.
+  if (auto code = Lookup(str); code.has_value()) {
+    return *code;
+  }
+  latch_.WLock();
+  auto [it, inserted] = codes_.emplace(str, static_cast<uint32_t>(strings_.size()));
+  if (inserted) {
+    BUSTUB_ENSURE(it->second != NULL_CODE, "dictionary is full");
+    strings_.push_back(str);
+    size_.store(strings_.size());
+  }
+  auto code = it->second;
+  latch_.WUnlock();
+  return code;
+}
+
+auto StringDictionary::Lookup(const std::string &str) -> std::optional<uint32_t> {
+  latch_.RLock();
+  std::optional<uint32_t> code = std::nullopt;
+  if (auto it = codes_.find(str); it != codes_.end()) {
+    code = it->second;
+  }
+  latch_.RUnlock();
+  return code;
+}
+
+auto StringDictionary::GetString(uint32_t code) -> const std::string & {
+  latch_.RLock();
+  BUSTUB_ASSERT(code < strings_.size(), "code was not handed out by this dictionary");
+  const auto &str = strings_[code];
+  latch_.RUnlock();
+  return str;
+}
+
+}  // namespace bustub
@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <optional>
 #include <shared_mutex>
 #include <string>
@@ -33,6 +34,7 @@
 #include "recovery/log_manager.h"
 #include "storage/disk/disk_manager.h"
 #include "storage/disk/disk_manager_memory.h"
+#include "storage/table/vacuum_manager.h"
 #include "type/value_factory.h"
 
 namespace bustub {
@@ -58,6 +60,13 @@ BustubInstance::BustubInstance(const std::string &db_file_name) {
     std::cerr << "BufferPoolManager is not implemented, only mock tables are supported." << std::endl;
     buffer_pool_manager_ = nullptr;
   }
+  if (buffer_pool_manager_ != nullptr) {
+    // B+ tree indexes record their root pages in the header page, which has to be the first page.
+    page_id_t header_page_id;
+    buffer_pool_manager_->NewPage(&header_page_id);
+    BUSTUB_ENSURE(header_page_id == HEADER_PAGE_ID, "the header page must be the first page");
+    buffer_pool_manager_->UnpinPage(header_page_id, true);
+  }
 
   // Transaction (txn) related.
   lock_manager_ = new LockManager();
@@ -69,6 +78,12 @@ BustubInstance::BustubInstance(const std::string &db_file_name) {
   // Catalog.
   catalog_ = new Catalog(buffer_pool_manager_, lock_manager_, log_manager_);
 
+  // Vacuum related.
+  vacuum_manager_ = new VacuumManager(catalog_, txn_manager_);
+  if (buffer_pool_manager_ != nullptr) {
+    vacuum_manager_->StartVacuum();
+  }
+
   // Execution engine.
   execution_engine_ = new ExecutionEngine(buffer_pool_manager_, txn_manager_, catalog_);
 }
@@ -90,6 +105,13 @@ BustubInstance::BustubInstance() {
     std::cerr << "BufferPoolManager is not implemented, only mock tables are supported." << std::endl;
     buffer_pool_manager_ = nullptr;
   }
+  if (buffer_pool_manager_ != nullptr) {
+    // B+ tree indexes record their root pages in the header page, which has to be the first page.
+    page_id_t header_page_id;
+    buffer_pool_manager_->NewPage(&header_page_id);
+    BUSTUB_ENSURE(header_page_id == HEADER_PAGE_ID, "the header page must be the first page");
+    buffer_pool_manager_->UnpinPage(header_page_id, true);
+  }
 
   // Transaction (txn) related.
   lock_manager_ = new LockManager();
@@ -101,6 +123,12 @@ BustubInstance::BustubInstance() {
   // Catalog.
   catalog_ = new Catalog(buffer_pool_manager_, lock_manager_, log_manager_);
 
+  // Vacuum related.
+  vacuum_manager_ = new VacuumManager(catalog_, txn_manager_);
+  if (buffer_pool_manager_ != nullptr) {
+    vacuum_manager_->StartVacuum();
+  }
+
   // Execution engine.
   execution_engine_ = new ExecutionEngine(buffer_pool_manager_, txn_manager_, catalog_);
 }
@@ -174,7 +202,15 @@ see the execution plan of your query.
 
 auto BustubInstance::ExecuteSql(const std::string &sql, ResultWriter &writer) -> bool {
   auto txn = txn_manager_->Begin();
-  auto result = ExecuteSqlTxn(sql, writer, txn);
+  bool result;
+  try {
+    result = ExecuteSqlTxn(sql, writer, txn);
+  } catch (...) {
+    // A statement that fails, like a CREATE INDEX on columns too wide for a key, must not leak its transaction.
+    txn_manager_->Abort(txn);
+    delete txn;
+    throw;
+  }
   txn_manager_->Commit(txn);
   delete txn;
   return result;
@@ -212,7 +248,8 @@ auto BustubInstance::ExecuteSqlTxn(const std::string &sql, ResultWriter &writer,
         const auto &create_stmt = dynamic_cast<const CreateStatement &>(*statement);
 
         std::unique_lock<std::shared_mutex> l(catalog_lock_);
-        auto info = catalog_->CreateTable(txn, create_stmt.table_, Schema(create_stmt.columns_));
+        auto info = catalog_->CreateTable(txn, create_stmt.table_, Schema(create_stmt.columns_), true,
+                                          create_stmt.storage_format_);
         l.unlock();
 
         if (info == nullptr) {
@@ -228,19 +265,27 @@ auto BustubInstance::ExecuteSqlTxn(const std::string &sql, ResultWriter &writer,
         for (const auto &col : index_stmt.cols_) {
           auto idx = index_stmt.table_->schema_.GetColIdx(col->col_name_.back());
           col_ids.push_back(idx);
-          if (index_stmt.table_->schema_.GetColumn(idx).GetType() != TypeId::INTEGER) {
-            throw NotImplementedException("only support creating index on integer column");
-          }
         }
-        if (col_ids.size() != 1) {
-          throw NotImplementedException("only support creating index with exactly one column");
+        // Included columns follow the key columns in the key, so they are in every index entry, while the separators
+        // in the inner pages are cut short before them wherever the key columns tell the entries apart.
+        for (const auto &col : index_stmt.include_cols_) {
+          auto idx = index_stmt.table_->schema_.GetColIdx(col->col_name_.back());
+          if (std::find(col_ids.begin(), col_ids.end(), idx) == col_ids.end()) {
+            col_ids.push_back(idx);
+          }
         }
         auto key_schema = Schema::CopySchema(&index_stmt.table_->schema_, col_ids);
+        // Keys are stored in their memcomparable encoding, which GenericComparator orders with a single memcmp
+        // whatever the types of the key columns are, so the key only has to be wide enough for the encoding.
+        auto encoded_size = MaxEncodedKeySize(&key_schema);
 
         std::unique_lock<std::shared_mutex> l(catalog_lock_);
-        auto info = catalog_->CreateIndex<IntegerKeyType, IntegerValueType, IntegerComparatorType>(
-            txn, index_stmt.index_name_, index_stmt.table_->table_, index_stmt.table_->schema_, key_schema, col_ids,
-            INTEGER_SIZE, IntegerHashFunctionType{});
+        auto info = DispatchGenericKeySize(encoded_size, [&](auto key_size) {
+          constexpr size_t KEY_SIZE = decltype(key_size)::value;
+          return catalog_->CreateIndex<GenericKey<KEY_SIZE>, RID, GenericComparator<KEY_SIZE>>(
+              txn, index_stmt.index_name_, index_stmt.table_->table_, index_stmt.table_->schema_, key_schema, col_ids,
+              KEY_SIZE, HashFunction<GenericKey<KEY_SIZE>>{});
+        });
         l.unlock();
 
         if (info == nullptr) {
@@ -391,6 +436,7 @@ BustubInstance::~BustubInstance() {
   if (enable_logging) {
     log_manager_->StopFlushThread();
   }
+  delete vacuum_manager_;
   delete execution_engine_;
   delete catalog_;
   delete checkpoint_manager_;
@@ -20,4 +20,8 @@ std::chrono::duration<int64_t> log_timeout = std::chrono::seconds(1);
 
 std::chrono::milliseconds cycle_detection_interval = std::chrono::milliseconds(50);
 
+std::chrono::milliseconds vacuum_interval = std::chrono::milliseconds(5000);
+
+uint32_t parallel_scan_threads = 1;
+
 }  // namespace bustub
@@ -1,29 +1,99 @@
-//===----------------------------------------------------------------------===//
-//
-//                         BusTub
-//
-// aggregation_executor.cpp
-//
-// Identification: src/execution/aggregation_executor.cpp
-//
-// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
-//
-//===----------------------------------------------------------------------===//
-#include <memory>
-#include <vector>
-
-#include "execution/executors/aggregation_executor.h"
-
-namespace bustub {
-
-AggregationExecutor::AggregationExecutor(ExecutorContext *exec_ctx, const AggregationPlanNode *plan,
-                                         std::unique_ptr<AbstractExecutor> &&child)
-    : AbstractExecutor(exec_ctx) {}
-
-void AggregationExecutor::Init() {}
-
-auto AggregationExecutor::Next(Tuple *tuple, RID *rid) -> bool { return false; }
-
-auto AggregationExecutor::GetChildExecutor() const -> const AbstractExecutor * { return child_.get(); }
-
-}  // namespace bustub
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// aggregation_executor.cpp
+//
+// Identification: src/execution/aggregation_executor.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+#include <memory>
+#include <vector>
+
+#include "execution/executors/aggregation_executor.h"
+
+namespace bustub {
+
+AggregationExecutor::AggregationExecutor(ExecutorContext *exec_ctx, const AggregationPlanNode *plan,
+                                         std::unique_ptr<AbstractExecutor> &&child)
+    : AbstractExecutor(exec_ctx),
+      plan_(plan),
+      child_(std::move(child)),
+      aht_(plan_->GetAggregates(), plan_->GetAggregateTypes(), exec_ctx->GetArena()),
+      aht_iterator_(aht_.Begin()),
+      builder_(&plan_->OutputSchema()) {
+  for (const auto &group_by : plan_->GetGroupBys()) {
+    const auto *column_expr = dynamic_cast<const ColumnValueExpression *>(group_by.get());
+    StringDictionary *dict = nullptr;
+    if (column_expr != nullptr) {
+      const auto &col = plan_->GetChildPlan()->OutputSchema().GetColumn(column_expr->GetColIdx());
+      dict = col.IsDictionaryEncoded() ? col.GetDictionary().get() : nullptr;
+    }
+    group_by_dicts_.push_back(dict);
+  }
+}
+
+void AggregationExecutor::Init() {
+  child_->Init();
+  aht_.Clear();
+  Tuple tuple;
+  RID rid;
+  std::vector<Tuple> batch;
+  batch.reserve(AGGREGATION_BATCH_SIZE);
+  while (child_->Next(&tuple, &rid)) {
+    batch.push_back(tuple);
+    if (batch.size() == AGGREGATION_BATCH_SIZE) {
+      CombineBatch(batch);
+      batch.clear();
+    }
+  }
+  if (!batch.empty()) {
+    CombineBatch(batch);
+  }
+  // Without GROUP BY, an empty input still aggregates to one row.
+  if (aht_.Begin() == aht_.End() && plan_->GetGroupBys().empty()) {
+    aht_.InsertInitial(AggregateKey{});
+  }
+  aht_iterator_ = aht_.Begin();
+}
+
+void AggregationExecutor::CombineBatch(const std::vector<Tuple> &batch) {
+  if (plan_->GetGroupBys().empty()) {
+    // All tuples fall into one group, so each aggregate can be reduced over the whole batch.
+    aht_.InsertCombineBatch(AggregateKey{}, batch, child_->GetOutputSchema());
+    return;
+  }
+  auto keys = MakeAggregateKeys(batch);
+  for (size_t i = 0; i < batch.size(); i++) {
+    aht_.InsertCombine(keys[i], MakeAggregateValue(&batch[i]));
+  }
+}
+
+auto AggregationExecutor::Next(Tuple *tuple, RID *rid) -> bool {
+  if (aht_iterator_ == aht_.End()) {
+    return false;
+  }
+  builder_.Reset();
+  const auto &group_bys = aht_iterator_.Key().group_bys_;
+  for (size_t i = 0; i < group_bys.size(); i++) {
+    if (group_by_dicts_[i] == nullptr) {
+      builder_.Append(group_bys[i]);
+    } else if (group_bys[i].IsNull()) {
+      builder_.Append(ValueFactory::GetNullValueByType(TypeId::VARCHAR));
+    } else {
+      builder_.Append(ValueFactory::GetVarcharValue(group_by_dicts_[i]->GetString(group_bys[i].GetAs<int64_t>())));
+    }
+  }
+  for (const auto &aggregate : aht_iterator_.Val().aggregates_) {
+    builder_.Append(aggregate);
+  }
+  builder_.Build(tuple);
+  ++aht_iterator_;
+  return true;
+}
+
+auto AggregationExecutor::GetChildExecutor() const -> const AbstractExecutor * { return child_.get(); }
+
+}  // namespace bustub
@@ -11,12 +11,108 @@
 //===----------------------------------------------------------------------===//
 #include "execution/executors/index_scan_executor.h"
 
+#include <memory>
+#include <optional>
+#include <utility>
+
+#include "storage/index/key_encoding.h"
+#include "type/value_factory.h"
+
 namespace bustub {
 IndexScanExecutor::IndexScanExecutor(ExecutorContext *exec_ctx, const IndexScanPlanNode *plan)
-    : AbstractExecutor(exec_ctx) {}
+    : AbstractExecutor(exec_ctx), plan_(plan) {}
+
+void IndexScanExecutor::Init() {
+  auto *catalog = exec_ctx_->GetCatalog();
+  index_info_ = catalog->GetIndex(plan_->GetIndexOid());
+  table_info_ = catalog->GetTable(index_info_->table_name_);
+  auto *index = index_info_->index_.get();
+  key_positions_.assign(table_info_->schema_.GetColumnCount(), -1);
+  const auto &key_attrs = index->GetKeyAttrs();
+  for (size_t i = 0; i < key_attrs.size(); i++) {
+    key_positions_[key_attrs[i]] = static_cast<int>(i);
+  }
+  DispatchGenericKeySize(index_info_->key_size_, [this, index](auto key_size) {
+    constexpr size_t KEY_SIZE = decltype(key_size)::value;
+    auto *tree = dynamic_cast<BPlusTreeIndex<GenericKey<KEY_SIZE>, RID, GenericComparator<KEY_SIZE>> *>(index);
+    BUSTUB_ASSERT(tree != nullptr, "index scans only support B+ tree indexes");
+    StartScan(tree);
+  });
+  rids_.clear();
+  tuples_.clear();
+  cursor_ = 0;
+}
 
-void IndexScanExecutor::Init() { throw NotImplementedException("IndexScanExecutor is not implemented"); }
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void IndexScanExecutor::StartScan(BPlusTreeIndex<KeyType, ValueType, KeyComparator> *tree) {
+  // Keys that start with the values of a bound count as equal to it, so the rest of the key is padded to the smallest
+  // such key for an inclusive lower or exclusive upper bound, and to the greatest one otherwise.
+  auto make_bound = [](const std::optional<IndexScanBound> &bound, bool is_upper) {
+    std::optional<IndexBound<KeyType>> index_bound;
+    if (bound.has_value()) {
+      index_bound.emplace();
+      index_bound->key_.SetFromPrefix(bound->values_, is_upper == bound->inclusive_ ? '\xff' : '\x00');
+      index_bound->inclusive_ = bound->inclusive_;
+    }
+    return index_bound;
+  };
+  auto lower = make_bound(plan_->lower_, false);
+  auto upper = make_bound(plan_->upper_, true);
+  auto iterator = std::make_shared<IndexIterator<KeyType, ValueType, KeyComparator>>(
+      plan_->descending_ ? tree->GetReverseRangeIterator(lower, upper) : tree->GetRangeIterator(lower, upper));
+  if (!plan_->index_only_) {
+    next_batch_ = [this, iterator] { return iterator->NextBatch(&rids_); };
+    return;
+  }
+  next_batch_ = [this, iterator] {
+    std::vector<std::pair<KeyType, ValueType>> entries;
+    if (!iterator->NextBatch(&entries)) {
+      return false;
+    }
+    // The tuples take the layout of the table, like those fetched from it.
+    const auto &schema = table_info_->schema_;
+    for (const auto &[key, rid] : entries) {
+      auto key_values = DecodeKey(key.data_, sizeof(key.data_), &index_info_->key_schema_);
+      std::vector<Value> values;
+      values.reserve(schema.GetColumnCount());
+      for (uint32_t i = 0; i < schema.GetColumnCount(); i++) {
+        int position = key_positions_[i];
+        values.push_back(position >= 0 ? key_values[position]
+                                       : ValueFactory::GetNullValueByType(schema.GetColumn(i).GetType()));
+      }
+      tuples_.emplace_back(std::move(values), &schema);
+      rids_.push_back(rid);
+    }
+    return true;
+  };
+}
 
-auto IndexScanExecutor::Next(Tuple *tuple, RID *rid) -> bool { return false; }
+auto IndexScanExecutor::Next(Tuple *tuple, RID *rid) -> bool {
+  const auto &predicate = plan_->filter_predicate_;
+  while (true) {
+    if (cursor_ == rids_.size()) {
+      rids_.clear();
+      tuples_.clear();
+      cursor_ = 0;
+      if (!next_batch_()) {
+        return false;
+      }
+    }
+    size_t position = cursor_++;
+    *rid = rids_[position];
+    if (plan_->index_only_) {
+      *tuple = tuples_[position];
+    } else if (!table_info_->table_->GetTuple(*rid, tuple, exec_ctx_->GetTransaction())) {
+      continue;
+    }
+    if (predicate == nullptr) {
+      return true;
+    }
+    auto value = predicate->Evaluate(tuple, table_info_->schema_);
+    if (!value.IsNull() && value.GetAs<bool>()) {
+      return true;
+    }
+  }
+}
 
 }  // namespace bustub
@@ -5,7 +5,10 @@ namespace bustub {
 
 ProjectionExecutor::ProjectionExecutor(ExecutorContext *exec_ctx, const ProjectionPlanNode *plan,
                                        std::unique_ptr<AbstractExecutor> &&child_executor)
-    : AbstractExecutor(exec_ctx), plan_(plan), child_executor_(std::move(child_executor)) {}
+    : AbstractExecutor(exec_ctx),
+      plan_(plan),
+      child_executor_(std::move(child_executor)),
+      builder_(&plan_->OutputSchema()) {}
 
 void ProjectionExecutor::Init() {
   // Initialize the child executor
@@ -22,14 +25,12 @@ auto ProjectionExecutor::Next(Tuple *tuple, RID *rid) -> bool {
     return false;
   }
 
-  // Compute expressions
-  std::vector<Value> values{};
-  values.reserve(GetOutputSchema().GetColumnCount());
+  // Compute expressions, serializing each result straight into the output row
+  builder_.Reset();
   for (const auto &expr : plan_->GetExpressions()) {
-    values.push_back(expr->Evaluate(&child_tuple, child_executor_->GetOutputSchema()));
+    builder_.Append(expr->Evaluate(&child_tuple, child_executor_->GetOutputSchema()));
   }
-
-  *tuple = Tuple{values, &GetOutputSchema()};
+  builder_.Build(tuple);
 
   return true;
 }
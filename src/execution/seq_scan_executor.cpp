@@ -1,23 +1,293 @@
-//===----------------------------------------------------------------------===//
-//
-//                         BusTub
-//
-// seq_scan_executor.cpp
-//
-// Identification: src/execution/seq_scan_executor.cpp
-//
-// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
-//
-//===----------------------------------------------------------------------===//
-
-#include "execution/executors/seq_scan_executor.h"
-
-namespace bustub {
-
-SeqScanExecutor::SeqScanExecutor(ExecutorContext *exec_ctx, const SeqScanPlanNode *plan) : AbstractExecutor(exec_ctx) {}
-
-void SeqScanExecutor::Init() { throw NotImplementedException("SeqScanExecutor is not implemented"); }
-
-auto SeqScanExecutor::Next(Tuple *tuple, RID *rid) -> bool { return false; }
-
-}  // namespace bustub
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// seq_scan_executor.cpp
+//
+// Identification: src/execution/seq_scan_executor.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/executors/seq_scan_executor.h"
+
+#include <algorithm>
+#include <iterator>
+#include <numeric>
+#include <utility>
+
+#include "execution/expressions/column_value_expression.h"
+#include "execution/expressions/comparison_expression.h"
+#include "execution/expressions/constant_value_expression.h"
+#include "execution/expressions/logic_expression.h"
+
+namespace bustub {
+
+SeqScanExecutor::SeqScanExecutor(ExecutorContext *exec_ctx, const SeqScanPlanNode *plan)
+    : AbstractExecutor(exec_ctx), plan_(plan), shares_morsels_(false) {}
+
+SeqScanExecutor::SeqScanExecutor(ExecutorContext *exec_ctx, const SeqScanPlanNode *plan,
+                                 std::shared_ptr<MorselQueue> morsels)
+    : AbstractExecutor(exec_ctx), plan_(plan), shares_morsels_(true), morsels_(std::move(morsels)) {}
+
+SeqScanExecutor::~SeqScanExecutor() { StopWorkers(); }
+
+void SeqScanExecutor::Init() {
+  StopWorkers();
+  table_info_ = exec_ctx_->GetCatalog()->GetTable(plan_->GetTableOid());
+  chunk_filter_ = nullptr;
+  if (plan_->filter_predicate_ != nullptr && table_info_->table_->GetStorageFormat() == TableStorageFormat::PAX) {
+    chunk_filter_ = FindChunkFilter(*plan_->filter_predicate_);
+  }
+  morsel_.clear();
+  morsel_cursor_ = 0;
+  page_tuples_.clear();
+  selection_.clear();
+  cursor_ = 0;
+  if (shares_morsels_) {
+    return;
+  }
+
+  morsels_ = std::make_shared<MorselQueue>(table_info_->table_->GetPageIds(), SCAN_MORSEL_SIZE);
+  auto num_workers = std::min<size_t>(parallel_scan_threads, morsels_->GetMorselCount());
+  if (num_workers > 1) {
+    StartWorkers(num_workers);
+  }
+}
+
+auto SeqScanExecutor::Next(Tuple *tuple, RID *rid) -> bool {
+  if (!workers_.empty()) {
+    std::unique_lock lock(buffer_latch_);
+    buffer_not_empty_.wait(lock, [&] { return !buffer_.empty() || running_workers_ == 0 || worker_error_; });
+    if (worker_error_) {
+      auto error = std::exchange(worker_error_, nullptr);
+      lock.unlock();
+      StopWorkers();
+      std::rethrow_exception(error);
+    }
+    if (buffer_.empty()) {
+      return false;
+    }
+    *tuple = std::move(buffer_.front());
+    buffer_.pop_front();
+    *rid = tuple->GetRid();
+    buffer_not_full_.notify_one();
+    return true;
+  }
+
+  while (true) {
+    if (cursor_ < selection_.size()) {
+      auto &candidate = page_tuples_[selection_[cursor_++]];
+      *rid = candidate.GetRid();
+      *tuple = candidate;
+      return true;
+    }
+    if (!FetchNextPage()) {
+      return false;
+    }
+  }
+}
+
+auto SeqScanExecutor::FetchNextPage() -> bool {
+  const auto &filter_expr = plan_->filter_predicate_;
+  auto *zone_map = table_info_->table_->GetZoneMap();
+  while (true) {
+    if (morsel_cursor_ == morsel_.size()) {
+      if (!morsels_->Next(&morsel_)) {
+        return false;
+      }
+      morsel_cursor_ = 0;
+    }
+    auto page_id = morsel_[morsel_cursor_++];
+
+    // Skip pages whose summaries rule out the predicate, without fetching them.
+    if (filter_expr != nullptr && zone_map != nullptr && zone_map->Contains(page_id) &&
+        !PageMayMatch(page_id, *filter_expr)) {
+      continue;
+    }
+
+    page_tuples_.clear();
+    cursor_ = 0;
+    if (chunk_filter_ != nullptr) {
+      ReadPageThroughChunk(page_id);
+    } else {
+      table_info_->table_->GetPageTuples(page_id, &page_tuples_, exec_ctx_->GetTransaction());
+    }
+    // Filter the whole page at once, which lets the predicate run batch kernels. The tuples read through a chunk
+    // already passed the chunk filter, so only the rest of the predicate is left to check.
+    if (filter_expr != nullptr && filter_expr.get() != chunk_filter_) {
+      filter_expr->SelectBatch(page_tuples_, GetOutputSchema(), &selection_);
+    } else {
+      selection_.resize(page_tuples_.size());
+      std::iota(selection_.begin(), selection_.end(), 0);
+    }
+    return true;
+  }
+}
+
+auto SeqScanExecutor::FindChunkFilter(const AbstractExpression &expr) -> const ComparisonExpression * {
+  if (const auto *logic_expr = dynamic_cast<const LogicExpression *>(&expr);
+      logic_expr != nullptr && logic_expr->logic_type_ == LogicType::And) {
+    const auto *filter = FindChunkFilter(*logic_expr->GetChildAt(0));
+    return filter != nullptr ? filter : FindChunkFilter(*logic_expr->GetChildAt(1));
+  }
+  const auto *cmp_expr = dynamic_cast<const ComparisonExpression *>(&expr);
+  if (cmp_expr == nullptr) {
+    return nullptr;
+  }
+  const auto *column_expr = cmp_expr->GetComparedColumn();
+  return column_expr != nullptr && column_expr->GetTupleIdx() == 0 ? cmp_expr : nullptr;
+}
+
+void SeqScanExecutor::ReadPageThroughChunk(page_id_t page_id) {
+  const auto *column_expr = chunk_filter_->GetComparedColumn();
+  std::vector<char> values;
+  std::vector<RID> rids;
+  table_info_->table_->ReadColumnChunk(page_id, column_expr->GetColIdx(), &values, &rids);
+  ColumnVector column{table_info_->schema_.GetColumn(column_expr->GetColIdx()).GetType(), std::move(values)};
+  chunk_filter_->SelectColumn(column, &selection_);
+  if (selection_.empty()) {
+    return;
+  }
+  std::vector<RID> selected_rids;
+  selected_rids.reserve(selection_.size());
+  for (auto idx : selection_) {
+    selected_rids.push_back(rids[idx]);
+  }
+  table_info_->table_->GetPageTuples(page_id, selected_rids, &page_tuples_, exec_ctx_->GetTransaction());
+}
+
+void SeqScanExecutor::StartWorkers(size_t num_workers) {
+  stopped_ = false;
+  running_workers_ = num_workers;
+  for (size_t i = 0; i < num_workers; i++) {
+    auto &worker = worker_executors_.emplace_back(std::make_unique<SeqScanExecutor>(exec_ctx_, plan_, morsels_));
+    worker->Init();
+  }
+  for (auto &worker : worker_executors_) {
+    workers_.emplace_back(&SeqScanExecutor::RunWorker, this, worker.get());
+  }
+}
+
+void SeqScanExecutor::StopWorkers() {
+  {
+    std::scoped_lock lock(buffer_latch_);
+    stopped_ = true;
+  }
+  buffer_not_full_.notify_all();
+  for (auto &worker : workers_) {
+    worker.join();
+  }
+  workers_.clear();
+  worker_executors_.clear();
+  buffer_.clear();
+  worker_error_ = nullptr;
+}
+
+void SeqScanExecutor::RunWorker(SeqScanExecutor *worker) {
+  std::vector<Tuple> batch;
+  Tuple tuple;
+  RID rid;
+  bool has_next = true;
+  try {
+    while (has_next) {
+      has_next = worker->Next(&tuple, &rid);
+      if (has_next) {
+        batch.push_back(tuple);
+      }
+      if (batch.size() == PARALLEL_SCAN_BATCH_SIZE || (!has_next && !batch.empty())) {
+        std::unique_lock lock(buffer_latch_);
+        buffer_not_full_.wait(lock, [&] { return buffer_.size() < PARALLEL_SCAN_BUFFER_SIZE || stopped_; });
+        if (stopped_) {
+          break;
+        }
+        std::move(batch.begin(), batch.end(), std::back_inserter(buffer_));
+        batch.clear();
+        buffer_not_empty_.notify_one();
+      }
+    }
+  } catch (...) {
+    // Hand the error to the consumer, which rethrows it from Next, and stop the other workers.
+    std::scoped_lock lock(buffer_latch_);
+    if (!worker_error_) {
+      worker_error_ = std::current_exception();
+    }
+    stopped_ = true;
+    buffer_not_full_.notify_all();
+  }
+
+  std::scoped_lock lock(buffer_latch_);
+  running_workers_--;
+  buffer_not_empty_.notify_all();
+}
+
+auto SeqScanExecutor::PageMayMatch(page_id_t page_id, const AbstractExpression &expr) const -> bool {
+  if (const auto *logic_expr = dynamic_cast<const LogicExpression *>(&expr); logic_expr != nullptr) {
+    if (logic_expr->logic_type_ == LogicType::And) {
+      return PageMayMatch(page_id, *logic_expr->GetChildAt(0)) && PageMayMatch(page_id, *logic_expr->GetChildAt(1));
+    }
+    return PageMayMatch(page_id, *logic_expr->GetChildAt(0)) || PageMayMatch(page_id, *logic_expr->GetChildAt(1));
+  }
+
+  const auto *cmp_expr = dynamic_cast<const ComparisonExpression *>(&expr);
+  if (cmp_expr == nullptr) {
+    return true;
+  }
+  // Only `<column> <op> <constant>` and `<constant> <op> <column>` can be checked against the summary.
+  auto comp_type = cmp_expr->comp_type_;
+  const auto *column_expr = dynamic_cast<const ColumnValueExpression *>(cmp_expr->GetChildAt(0).get());
+  const auto *constant_expr = dynamic_cast<const ConstantValueExpression *>(cmp_expr->GetChildAt(1).get());
+  if (column_expr == nullptr || constant_expr == nullptr) {
+    column_expr = dynamic_cast<const ColumnValueExpression *>(cmp_expr->GetChildAt(1).get());
+    constant_expr = dynamic_cast<const ConstantValueExpression *>(cmp_expr->GetChildAt(0).get());
+    if (column_expr == nullptr || constant_expr == nullptr) {
+      return true;
+    }
+    switch (comp_type) {
+      case ComparisonType::LessThan:
+        comp_type = ComparisonType::GreaterThan;
+        break;
+      case ComparisonType::LessThanOrEqual:
+        comp_type = ComparisonType::GreaterThanOrEqual;
+        break;
+      case ComparisonType::GreaterThan:
+        comp_type = ComparisonType::LessThan;
+        break;
+      case ComparisonType::GreaterThanOrEqual:
+        comp_type = ComparisonType::LessThanOrEqual;
+        break;
+      default:
+        break;
+    }
+  }
+  if (column_expr->GetTupleIdx() != 0 || constant_expr->val_.IsNull()) {
+    return true;
+  }
+
+  auto range = table_info_->table_->GetZoneMap()->GetRange(page_id, column_expr->GetColIdx());
+  if (!range.has_value()) {
+    // The page holds no non-NULL value of the column, so no comparison can be true.
+    return false;
+  }
+  const auto &[min, max] = *range;
+  const auto &val = constant_expr->val_;
+  switch (comp_type) {
+    case ComparisonType::Equal:
+      return min.CompareLessThanEquals(val) == CmpBool::CmpTrue &&
+             max.CompareGreaterThanEquals(val) == CmpBool::CmpTrue;
+    case ComparisonType::NotEqual:
+      return min.CompareNotEquals(val) == CmpBool::CmpTrue || max.CompareNotEquals(val) == CmpBool::CmpTrue;
+    case ComparisonType::LessThan:
+      return min.CompareLessThan(val) == CmpBool::CmpTrue;
+    case ComparisonType::LessThanOrEqual:
+      return min.CompareLessThanEquals(val) == CmpBool::CmpTrue;
+    case ComparisonType::GreaterThan:
+      return max.CompareGreaterThan(val) == CmpBool::CmpTrue;
+    case ComparisonType::GreaterThanOrEqual:
+      return max.CompareGreaterThanEquals(val) == CmpBool::CmpTrue;
+  }
+  return true;
+}
+
+}  // namespace bustub
@@ -1,13 +1,75 @@
 #include "execution/executors/sort_executor.h"
 
+#include <algorithm>
+
 namespace bustub {
 
 SortExecutor::SortExecutor(ExecutorContext *exec_ctx, const SortPlanNode *plan,
                            std::unique_ptr<AbstractExecutor> &&child_executor)
-    : AbstractExecutor(exec_ctx) {}
+    : AbstractExecutor(exec_ctx),
+      plan_(plan),
+      child_executor_(std::move(child_executor)),
+      entries_(PoolAllocator<SortEntry>(exec_ctx->GetArena())) {
+  for (const auto &[order_by_type, expr] : plan_->GetOrderBy()) {
+    comparators_.emplace_back(expr->GetReturnType(), expr->GetReturnType());
+  }
+}
+
+void SortExecutor::Init() {
+  child_executor_->Init();
+  ReleaseEntries();
+  cursor_ = 0;
+
+  const auto &child_schema = child_executor_->GetOutputSchema();
+  Tuple tuple;
+  RID rid;
+  while (child_executor_->Next(&tuple, &rid)) {
+    std::vector<Value> keys;
+    keys.reserve(plan_->GetOrderBy().size());
+    for (const auto &[order_by_type, expr] : plan_->GetOrderBy()) {
+      keys.emplace_back(expr->Evaluate(&tuple, child_schema));
+    }
+    entries_.push_back({std::move(keys), Tuple(tuple, exec_ctx_->GetArena())});
+  }
+  std::sort(entries_.begin(), entries_.end(),
+            [this](const SortEntry &lhs, const SortEntry &rhs) { return LessThan(lhs, rhs); });
+}
+
+auto SortExecutor::Next(Tuple *tuple, RID *rid) -> bool {
+  if (cursor_ == entries_.size()) {
+    return false;
+  }
+  // A shallow copy of the tuple in the arena, which stays valid until the next Init.
+  *tuple = entries_[cursor_].tuple_;
+  *rid = tuple->GetRid();
+  cursor_++;
+  return true;
+}
 
-void SortExecutor::Init() { throw NotImplementedException("SortExecutor is not implemented"); }
+void SortExecutor::ReleaseEntries() {
+  for (auto &entry : entries_) {
+    entry.tuple_.Release(exec_ctx_->GetArena());
+  }
+  entries_.clear();
+}
 
-auto SortExecutor::Next(Tuple *tuple, RID *rid) -> bool { return false; }
+auto SortExecutor::LessThan(const SortEntry &lhs, const SortEntry &rhs) const -> bool {
+  const auto &order_bys = plan_->GetOrderBy();
+  for (size_t i = 0; i < order_bys.size(); i++) {
+    const auto &lhs_key = lhs.keys_[i];
+    const auto &rhs_key = rhs.keys_[i];
+    // NULLs sort first, like the smallest value.
+    int cmp;
+    if (lhs_key.IsNull() || rhs_key.IsNull()) {
+      cmp = static_cast<int>(rhs_key.IsNull()) - static_cast<int>(lhs_key.IsNull());
+    } else {
+      cmp = comparators_[i].Compare(lhs_key, rhs_key);
+    }
+    if (cmp != 0) {
+      return order_bys[i].first == OrderByType::DESC ? cmp > 0 : cmp < 0;
+    }
+  }
+  return false;
+}
 
 }  // namespace bustub
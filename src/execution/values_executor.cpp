@@ -3,7 +3,7 @@
 namespace bustub {
 
 ValuesExecutor::ValuesExecutor(ExecutorContext *exec_ctx, const ValuesPlanNode *plan)
-    : AbstractExecutor(exec_ctx), plan_(plan), dummy_schema_(Schema({})) {}
+    : AbstractExecutor(exec_ctx), plan_(plan), dummy_schema_(Schema({})), builder_(&plan_->OutputSchema()) {}
 
 void ValuesExecutor::Init() { cursor_ = 0; }
 
@@ -12,15 +12,12 @@ auto ValuesExecutor::Next(Tuple *tuple, RID *rid) -> bool {
     return false;
   }
 
-  std::vector<Value> values{};
-  values.reserve(GetOutputSchema().GetColumnCount());
-
+  builder_.Reset();
   const auto &row_expr = plan_->GetValues()[cursor_];
   for (const auto &col : row_expr) {
-    values.push_back(col->Evaluate(nullptr, dummy_schema_));
+    builder_.Append(col->Evaluate(nullptr, dummy_schema_));
   }
-
-  *tuple = Tuple{values, &GetOutputSchema()};
+  builder_.Build(tuple);
   cursor_ += 1;
 
   return true;
@@ -122,6 +122,9 @@ class Binder {
 
   auto BindColumnDefinition(duckdb_libpgquery::PGColumnDef *cdef) -> Column;
 
+  /** Bind a `name = value` option of a WITH clause into its lower-cased name and value. */
+  auto BindDefElem(duckdb_libpgquery::PGDefElem *def) -> std::pair<std::string, std::string>;
+
   auto BindSelect(duckdb_libpgquery::PGSelectStmt *pg_stmt) -> std::unique_ptr<SelectStatement>;
 
   auto BindRangeSubselect(duckdb_libpgquery::PGRangeSubselect *root) -> std::unique_ptr<BoundTableRef>;
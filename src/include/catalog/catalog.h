@@ -121,31 +121,30 @@ class Catalog {
    * @param table_name The name of the new table, note that all tables beginning with `__` are reserved for the system.
    * @param schema The schema of the new table
    * @param create_table_heap whether to create a table heap for the new table
+   * @param storage_format the page format of the table heap
    * @return A (non-owning) pointer to the metadata for the table
    */
-  auto CreateTable(Transaction *txn, const std::string &table_name, const Schema &schema, bool create_table_heap = true)
-      -> TableInfo * {
+  auto CreateTable(Transaction *txn, const std::string &table_name, const Schema &schema, bool create_table_heap = true,
+                   TableStorageFormat storage_format = TableStorageFormat::ROW) -> TableInfo * {
     if (table_names_.count(table_name) != 0) {
       return NULL_TABLE_INFO;
     }
 
-    // Construct the table heap
-    std::unique_ptr<TableHeap> table = nullptr;
+    // Fetch the table OID for the new table
+    const auto table_oid = next_table_oid_.fetch_add(1);
+
+    // Construct the table information
+    auto meta = std::make_unique<TableInfo>(schema, table_name, nullptr, table_oid);
+    auto *tmp = meta.get();
 
+    // Construct the table heap. It keeps a pointer to the schema owned by the table information.
     // TODO(Wan,chi): This should be refactored into a private ctor for the binder tests, we shouldn't allow nullptr.
     // When create_table_heap == false, it means that we're running binder tests (where no txn will be provided) or
     // we are running shell without buffer pool. We don't need to create TableHeap in this case.
     if (create_table_heap) {
-      table = std::make_unique<TableHeap>(bpm_, lock_manager_, log_manager_, txn);
+      tmp->table_ = std::make_unique<TableHeap>(bpm_, lock_manager_, log_manager_, txn, &tmp->schema_, storage_format);
     }
 
-    // Fetch the table OID for the new table
-    const auto table_oid = next_table_oid_.fetch_add(1);
-
-    // Construct the table information
-    auto meta = std::make_unique<TableInfo>(schema, table_name, std::move(table), table_oid);
-    auto *tmp = meta.get();
-
     // Update the internal tracking mechanisms
     tables_.emplace(table_oid, std::move(meta));
     table_names_.emplace(table_name, table_oid);
@@ -228,12 +227,9 @@ class Catalog {
     // TODO(chi): support both hash index and btree index
     auto index = std::make_unique<BPlusTreeIndex<KeyType, ValueType, KeyComparator>>(std::move(meta), bpm_);
 
-    // Populate the index with all tuples in table heap
+    // Populate the index with all tuples in table heap, building the tree bottom-up from the sorted entries
     auto *table_meta = GetTable(table_name);
-    auto *heap = table_meta->table_.get();
-    for (auto tuple = heap->Begin(txn); tuple != heap->End(); ++tuple) {
-      index->InsertEntry(tuple->KeyFromTuple(schema, key_schema, key_attrs), tuple->GetRid(), txn);
-    }
+    index->BulkLoad(table_meta->table_.get(), schema, txn);
 
     // Get the next OID for the new index
     const auto index_oid = next_index_oid_.fetch_add(1);
@@ -298,7 +294,7 @@ class Catalog {
    * @param index_oid The OID of the index for which to query
    * @return A (non-owning) pointer to the metadata for the index
    */
-  auto GetIndex(index_oid_t index_oid) -> IndexInfo * {
+  auto GetIndex(index_oid_t index_oid) const -> IndexInfo * {
     auto index = indexes_.find(index_oid);
     if (index == indexes_.end()) {
       return NULL_INDEX_INFO;
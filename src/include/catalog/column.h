@@ -19,6 +19,7 @@
 
 #include "fmt/format.h"
 
+#include "catalog/string_dictionary.h"
 #include "common/exception.h"
 #include "common/macros.h"
 #include "type/type.h"
@@ -55,6 +56,24 @@ class Column {
     BUSTUB_ASSERT(type == TypeId::VARCHAR, "Wrong constructor for non-VARCHAR type.");
   }
 
+  /**
+   * Dictionary-encoded constructor for creating a VARCHAR Column. Tuples store a fixed-length code from the dictionary
+   * instead of the string, so the column is inlined.
+   * @param column_name name of the column
+   * @param type type of column, which must be VARCHAR
+   * @param length length of the varlen
+   * @param dictionary the dictionary that encodes the strings of this column
+   */
+  Column(std::string column_name, TypeId type, uint32_t length, std::shared_ptr<StringDictionary> dictionary)
+      : column_name_(std::move(column_name)),
+        column_type_(type),
+        fixed_length_(sizeof(uint32_t)),
+        variable_length_(length),
+        dictionary_(std::move(dictionary)) {
+    BUSTUB_ASSERT(type == TypeId::VARCHAR, "Only VARCHAR columns can be dictionary-encoded.");
+    BUSTUB_ASSERT(dictionary_ != nullptr, "Dictionary-encoded columns need a dictionary.");
+  }
+
   /**
    * Replicate a Column with a different name.
    * @param column_name name of the column
@@ -65,7 +84,8 @@ class Column {
         column_type_(column.column_type_),
         fixed_length_(column.fixed_length_),
         variable_length_(column.variable_length_),
-        column_offset_(column.column_offset_) {}
+        column_offset_(column.column_offset_),
+        dictionary_(column.dictionary_) {}
 
   /** @return column name */
   auto GetName() const -> std::string { return column_name_; }
@@ -91,7 +111,13 @@ class Column {
   auto GetType() const -> TypeId { return column_type_; }
 
   /** @return true if column is inlined, false otherwise */
-  auto IsInlined() const -> bool { return column_type_ != TypeId::VARCHAR; }
+  auto IsInlined() const -> bool { return column_type_ != TypeId::VARCHAR || dictionary_ != nullptr; }
+
+  /** @return true if tuples store dictionary codes for this column */
+  auto IsDictionaryEncoded() const -> bool { return dictionary_ != nullptr; }
+
+  /** @return the dictionary of a dictionary-encoded column, nullptr otherwise */
+  auto GetDictionary() const -> const std::shared_ptr<StringDictionary> & { return dictionary_; }
 
   /** @return a string representation of this column */
   auto ToString(bool simplified = true) const -> std::string;
@@ -138,6 +164,9 @@ class Column {
 
   /** Column offset in the tuple. */
   uint32_t column_offset_{0};
+
+  /** For a dictionary-encoded VARCHAR column, the dictionary. Shared by all copies of the column. */
+  std::shared_ptr<StringDictionary> dictionary_{nullptr};
 };
 
 }  // namespace bustub
@@ -15,6 +15,7 @@
 #include <memory>
 #include <optional>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "catalog/column.h"
@@ -26,6 +27,22 @@ namespace bustub {
 class Schema;
 using SchemaRef = std::shared_ptr<const Schema>;
 
+/** How to find the value of a column in a tuple, precomputed from the column when the schema is built */
+struct ColumnAccessor {
+  /** The offset of the value in the tuple, or of the offset of the value if it is not inlined */
+  uint32_t offset_;
+  /** The type of the column */
+  TypeId type_;
+  /** True if the value is stored at offset_, false if offset_ holds the offset of the value */
+  bool inlined_;
+  /** True if the value is stored as a dictionary code */
+  bool dictionary_encoded_;
+  /** The byte of the null bitmap holding the null bit of the column */
+  uint32_t null_byte_;
+  /** The null bit of the column within that byte */
+  uint8_t null_mask_;
+};
+
 class Schema {
  public:
   /**
@@ -53,6 +70,13 @@ class Schema {
    */
   auto GetColumn(const uint32_t col_idx) const -> const Column & { return columns_[col_idx]; }
 
+  /**
+   * Returns how to read a specific column of a tuple.
+   * @param col_idx index of requested column
+   * @return the accessor of the column
+   */
+  auto GetAccessor(const uint32_t col_idx) const -> const ColumnAccessor & { return accessors_[col_idx]; }
+
   /**
    * Looks up and returns the index of the first column in the schema with the specified name.
    * If multiple columns have the same name, the first such index is returned.
@@ -73,10 +97,8 @@ class Schema {
    * @return the index of a column with the given name, `std::nullopt` if it does not exist
    */
   auto TryGetColIdx(const std::string &col_name) const -> std::optional<uint32_t> {
-    for (uint32_t i = 0; i < columns_.size(); ++i) {
-      if (columns_[i].GetName() == col_name) {
-        return std::optional{i};
-      }
+    if (auto iter = column_indices_.find(col_name); iter != column_indices_.end()) {
+      return std::optional{iter->second};
     }
     return std::nullopt;
   }
@@ -90,9 +112,12 @@ class Schema {
   /** @return the number of non-inlined columns */
   auto GetUnlinedColumnCount() const -> uint32_t { return static_cast<uint32_t>(uninlined_columns_.size()); }
 
-  /** @return the number of bytes used by one tuple */
+  /** @return the number of bytes used by one tuple, including the null bitmap */
   inline auto GetLength() const -> uint32_t { return length_; }
 
+  /** @return the number of bytes of the null bitmap at the start of every tuple, one bit per column */
+  inline auto GetNullBitmapSize() const -> uint32_t { return null_bitmap_size_; }
+
   /** @return true if all columns are inlined, false otherwise */
   inline auto IsInlined() const -> bool { return tuple_is_inlined_; }
 
@@ -103,6 +128,9 @@ class Schema {
   /** Fixed-length column size, i.e. the number of bytes used by one tuple. */
   uint32_t length_;
 
+  /** The size of the null bitmap. */
+  uint32_t null_bitmap_size_;
+
   /** All the columns in the schema, inlined and uninlined. */
   std::vector<Column> columns_;
 
@@ -111,6 +139,12 @@ class Schema {
 
   /** Indices of all uninlined columns. */
   std::vector<uint32_t> uninlined_columns_;
+
+  /** How to read each column. */
+  std::vector<ColumnAccessor> accessors_;
+
+  /** The index of the first column with each name. */
+  std::unordered_map<std::string, uint32_t> column_indices_;
 };
 
 }  // namespace bustub
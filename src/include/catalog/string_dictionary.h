@@ -0,0 +1,68 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// string_dictionary.h
+//
+// Identification: src/include/catalog/string_dictionary.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <atomic>
+#include <deque>
+#include <limits>
+#include <optional>
+#include <string>
+#include <unordered_map>
+
+#include "common/rwlatch.h"
+
+namespace bustub {
+
+/**
+ * StringDictionary maps the distinct strings of a dictionary-encoded VARCHAR column to dense integer codes. Tuples
+ * store the 4-byte code instead of the string, so the column becomes fixed-length, and equality on the column can be
+ * decided on the codes alone.
+ *
+ * Codes are handed out in order of first appearance and never change or get reused, so a code read from a tuple stays
+ * valid for the lifetime of the dictionary.
+ */
+class StringDictionary {
+ public:
+  /** The code stored for a NULL value. */
+  static constexpr uint32_t NULL_CODE = std::numeric_limits<uint32_t>::max();
+
+  /**
+   * @param str the string to encode
+   * @return the code of str, which is assigned if str has not been seen before
+   */
+  auto GetOrAddCode(const std::string &str) -> uint32_t;
+
+  /**
+   * @param str the string to look up
+   * @return the code of str, or std::nullopt if no tuple holds str
+   */
+  auto Lookup(const std::string &str) -> std::optional<uint32_t>;
+
+  /**
+   * @param code a code handed out by this dictionary
+   * @return the string encoded by code; the reference stays valid for the lifetime of the dictionary
+   */
+  auto GetString(uint32_t code) -> const std::string &;
+
+  /** @return the number of distinct strings in the dictionary, read without taking the latch */
+  auto Size() -> size_t { return size_.load(); }
+
+ private:
+  std::unordered_map<std::string, uint32_t> codes_;
+  /** Indexed by code. A deque keeps references stable while it grows. */
+  std::deque<std::string> strings_;
+  /** The size of strings_, which only grows */
+  std::atomic<size_t> size_{0};
+  ReaderWriterLatch latch_;
+};
+
+}  // namespace bustub
@@ -38,6 +38,7 @@ class LockManager;
 class TransactionManager;
 class LogManager;
 class CheckpointManager;
+class VacuumManager;
 class Catalog;
 class ExecutionEngine;
 
@@ -251,6 +252,7 @@ class BustubInstance {
   LogManager *log_manager_;
   CheckpointManager *checkpoint_manager_;
   Catalog *catalog_;
+  VacuumManager *vacuum_manager_;
   ExecutionEngine *execution_engine_;
   std::shared_mutex catalog_lock_;
 
@@ -14,6 +14,7 @@
 
 #include <atomic>
 #include <chrono>  // NOLINT
+#include <cstddef>
 #include <cstdint>
 
 namespace bustub {
@@ -21,6 +22,15 @@ namespace bustub {
 /** Cycle detection is performed every CYCLE_DETECTION_INTERVAL milliseconds. */
 extern std::chrono::milliseconds cycle_detection_interval;
 
+/** The background vacuum runs every VACUUM_INTERVAL milliseconds. */
+extern std::chrono::milliseconds vacuum_interval;
+
+/**
+ * A sequential scan of a large table is spread over up to PARALLEL_SCAN_THREADS threads; 1 disables parallel scans.
+ * Parallel scans return tuples in no particular order, so they are off by default.
+ */
+extern uint32_t parallel_scan_threads;
+
 /** True if logging should be enabled, false otherwise. */
 extern std::atomic<bool> enable_logging;
 
@@ -36,6 +46,9 @@ static constexpr int BUFFER_POOL_SIZE = 10;
 static constexpr int LOG_BUFFER_SIZE = ((BUFFER_POOL_SIZE + 1) * BUSTUB_PAGE_SIZE);  // size of a log buffer in byte
 static constexpr int BUCKET_SIZE = 50;                                               // size of extendible hash bucket
 static constexpr int LRUK_REPLACER_K = 10;  // lookback window for lru-k replacer
+static constexpr int SCAN_MORSEL_SIZE = 16;  // number of pages a parallel scan thread takes at a time
+static constexpr double BPLUS_TREE_FILL_FACTOR = 0.9;  // how full a bulk-loaded B+ tree fills its pages
+static constexpr size_t INDEX_BUILD_MEMORY = 64 << 20;   // bytes an index build sorts in memory before spilling
 
 using frame_id_t = int32_t;    // frame id type
 using page_id_t = int32_t;     // page id type
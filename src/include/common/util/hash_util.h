@@ -13,11 +13,16 @@
 #pragma once
 
 #include <algorithm>
+#include <cstdint>
 #include <cstdlib>
+#include <cstring>
 #include <iostream>
 #include <string>
+#include <type_traits>
 
 #include "common/macros.h"
+#include "type/batch_kernels.h"
+#include "type/type_kernels.h"
 #include "type/value.h"
 
 namespace bustub {
@@ -27,22 +32,50 @@ using hash_t = std::size_t;
 class HashUtil {
  private:
   static const hash_t PRIME_FACTOR = 10000019;
+  /** The multiplier and shift of MurmurHash64A */
+  static constexpr uint64_t MURMUR_MULTIPLIER = 0xc6a4a7935bd1e995ULL;
+  static constexpr int MURMUR_SHIFT = 47;
+  /** 2^64 divided by the golden ratio, which spreads the bits of the hashes that CombineHashes combines */
+  static constexpr uint64_t GOLDEN_RATIO = 0x9e3779b97f4a7c15ULL;
 
  public:
+  /** @return the hash of `length` bytes, computed a word at a time with MurmurHash64A */
   static inline auto HashBytes(const char *bytes, size_t length) -> hash_t {
-    // https://github.com/greenplum-db/gpos/blob/b53c1acd6285de94044ff91fbee91589543feba1/libgpos/src/utils.cpp#L126
-    hash_t hash = length;
-    for (size_t i = 0; i < length; ++i) {
-      hash = ((hash << 5) ^ (hash >> 27)) ^ bytes[i];
+    uint64_t hash = length * MURMUR_MULTIPLIER;
+    size_t i = 0;
+    for (; i + sizeof(uint64_t) <= length; i += sizeof(uint64_t)) {
+      uint64_t word;
+      memcpy(&word, bytes + i, sizeof(word));
+      word *= MURMUR_MULTIPLIER;
+      word ^= word >> MURMUR_SHIFT;
+      word *= MURMUR_MULTIPLIER;
+      hash ^= word;
+      hash *= MURMUR_MULTIPLIER;
     }
+    if (i < length) {
+      uint64_t word = 0;
+      memcpy(&word, bytes + i, length - i);
+      hash ^= word;
+      hash *= MURMUR_MULTIPLIER;
+    }
+    hash ^= hash >> MURMUR_SHIFT;
+    hash *= MURMUR_MULTIPLIER;
+    hash ^= hash >> MURMUR_SHIFT;
     return hash;
   }
 
+  /** @return the hash of a 64-bit integer, which is the finalizer of MurmurHash3 */
+  static inline auto HashInt(uint64_t x) -> hash_t {
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdULL;
+    x ^= x >> 33;
+    x *= 0xc4ceb9fe1a85ec53ULL;
+    x ^= x >> 33;
+    return x;
+  }
+
   static inline auto CombineHashes(hash_t l, hash_t r) -> hash_t {
-    hash_t both[2] = {};
-    both[0] = l;
-    both[1] = r;
-    return HashBytes(reinterpret_cast<char *>(both), sizeof(hash_t) * 2);
+    return HashInt(l ^ (r + GOLDEN_RATIO + (l << 6) + (l >> 2)));
   }
 
   static inline auto SumHashes(hash_t l, hash_t r) -> hash_t {
@@ -51,55 +84,121 @@ class HashUtil {
 
   template <typename T>
   static inline auto Hash(const T *ptr) -> hash_t {
-    return HashBytes(reinterpret_cast<const char *>(ptr), sizeof(T));
+    if constexpr (std::is_arithmetic_v<T>) {
+      return HashNative(*ptr);
+    } else {
+      return HashBytes(reinterpret_cast<const char *>(ptr), sizeof(T));
+    }
   }
 
   template <typename T>
   static inline auto HashPtr(const T *ptr) -> hash_t {
-    return HashBytes(reinterpret_cast<const char *>(&ptr), sizeof(void *));
+    return HashInt(reinterpret_cast<uintptr_t>(ptr));
+  }
+
+  /**
+   * @return the hash of a native value of a fixed-width type. Integers hash like their 64-bit value, so that equal
+   * values of different integer types hash equally.
+   */
+  template <typename T>
+  static inline auto HashNative(T x) -> hash_t {
+    if constexpr (std::is_floating_point_v<T>) {
+      // 0.0 and -0.0 are equal, so they have to hash equally.
+      double d = x == 0 ? 0.0 : static_cast<double>(x);
+      uint64_t bits;
+      memcpy(&bits, &d, sizeof(bits));
+      return HashInt(bits);
+    } else if constexpr (std::is_signed_v<T>) {
+      return HashInt(static_cast<uint64_t>(static_cast<int64_t>(x)));
+    } else {
+      return HashInt(static_cast<uint64_t>(x));
+    }
   }
 
   /** @return the hash of the value */
   static inline auto HashValue(const Value *val) -> hash_t {
     switch (val->GetTypeId()) {
-      case TypeId::TINYINT: {
-        auto raw = static_cast<int64_t>(val->GetAs<int8_t>());
-        return Hash<int64_t>(&raw);
-      }
-      case TypeId::SMALLINT: {
-        auto raw = static_cast<int64_t>(val->GetAs<int16_t>());
-        return Hash<int64_t>(&raw);
-      }
-      case TypeId::INTEGER: {
-        auto raw = static_cast<int64_t>(val->GetAs<int32_t>());
-        return Hash<int64_t>(&raw);
-      }
-      case TypeId::BIGINT: {
-        auto raw = static_cast<int64_t>(val->GetAs<int64_t>());
-        return Hash<int64_t>(&raw);
-      }
-      case TypeId::BOOLEAN: {
-        auto raw = val->GetAs<bool>();
-        return Hash<bool>(&raw);
-      }
-      case TypeId::DECIMAL: {
-        auto raw = val->GetAs<double>();
-        return Hash<double>(&raw);
-      }
+      case TypeId::TINYINT:
+        return HashNative(val->GetAs<int8_t>());
+      case TypeId::SMALLINT:
+        return HashNative(val->GetAs<int16_t>());
+      case TypeId::INTEGER:
+        return HashNative(val->GetAs<int32_t>());
+      case TypeId::BIGINT:
+        return HashNative(val->GetAs<int64_t>());
+      case TypeId::BOOLEAN:
+        return HashNative(val->GetAs<int8_t>());
+      case TypeId::DECIMAL:
+        return HashNative(val->GetAs<double>());
       case TypeId::VARCHAR: {
         auto raw = val->GetData();
         auto len = val->GetLength();
         return HashBytes(raw, len);
       }
-      case TypeId::TIMESTAMP: {
-        auto raw = val->GetAs<uint64_t>();
-        return Hash<uint64_t>(&raw);
-      }
+      case TypeId::TIMESTAMP:
+        return HashNative(val->GetAs<uint64_t>());
       default: {
         UNIMPLEMENTED("Unsupported type.");
       }
     }
   }
+
+  /**
+   * Hash every value of a column, like HashValue does. A NULL hashes like the NULL value of its type.
+   * @param column the values to hash
+   * @param[out] hashes the hash of the i-th value is stored to hashes[i]
+   */
+  static inline void HashColumn(const ColumnVector &column, hash_t *hashes) {
+    DispatchColumn<false>(column, hashes);
+  }
+
+  /**
+   * Combine the hash of every value of a column into an array of hashes, like CombineHashes does. A NULL leaves its
+   * hash as it is, as in the hash of an AggregateKey.
+   * @param column the values to hash
+   * @param[in,out] hashes the hash of the i-th value is combined into hashes[i]
+   */
+  static inline void CombineHashColumn(const ColumnVector &column, hash_t *hashes) {
+    DispatchColumn<true>(column, hashes);
+  }
+
+ private:
+  template <bool Combine>
+  static inline void DispatchColumn(const ColumnVector &column, hash_t *hashes) {
+    switch (column.GetType()) {
+      case TypeId::BOOLEAN:
+        return HashColumnOf<TypeId::BOOLEAN, Combine>(column, hashes);
+      case TypeId::TINYINT:
+        return HashColumnOf<TypeId::TINYINT, Combine>(column, hashes);
+      case TypeId::SMALLINT:
+        return HashColumnOf<TypeId::SMALLINT, Combine>(column, hashes);
+      case TypeId::INTEGER:
+        return HashColumnOf<TypeId::INTEGER, Combine>(column, hashes);
+      case TypeId::BIGINT:
+        return HashColumnOf<TypeId::BIGINT, Combine>(column, hashes);
+      case TypeId::DECIMAL:
+        return HashColumnOf<TypeId::DECIMAL, Combine>(column, hashes);
+      case TypeId::TIMESTAMP:
+        return HashColumnOf<TypeId::TIMESTAMP, Combine>(column, hashes);
+      default:
+        UNIMPLEMENTED("Unsupported type.");
+    }
+  }
+
+  template <TypeId T, bool Combine>
+  static inline void HashColumnOf(const ColumnVector &column, hash_t *hashes) {
+    const auto *data = column.GetData<typename NativeType<T>::Type>();
+    const auto *nulls = column.GetNullMask();
+    for (size_t i = 0; i < column.GetSize(); i++) {
+      if constexpr (Combine) {
+        if (nulls[i] == 0) {
+          hashes[i] = CombineHashes(hashes[i], HashNative(data[i]));
+        }
+      } else {
+        hashes[i] = HashNative(nulls[i] == 0 ? data[i] : NativeType<T>::NULL_VALUE);
+      }
+    }
+  }
 };
 
 }  // namespace bustub
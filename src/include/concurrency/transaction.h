@@ -19,6 +19,7 @@
 #include <thread>  // NOLINT
 #include <unordered_map>
 #include <unordered_set>
+#include <vector>
 
 #include "common/config.h"
 #include "common/logger.h"
@@ -71,6 +72,8 @@ class TableWriteRecord {
   WType wtype_;
   /** The tuple is only used for the update operation. */
   Tuple tuple_;
+  /** The overflow chains an update replaced, which are kept for rollbacks until commit. */
+  std::vector<page_id_t> overflow_chains_;
   /** The table heap specifies which table this write record is for. */
   TableHeap *table_;
 };
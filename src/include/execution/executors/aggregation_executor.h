@@ -22,25 +22,49 @@
 #include "execution/executor_context.h"
 #include "execution/executors/abstract_executor.h"
 #include "execution/expressions/abstract_expression.h"
+#include "execution/expressions/column_value_expression.h"
 #include "execution/plans/aggregation_plan.h"
 #include "storage/table/tuple.h"
+#include "storage/table/tuple_builder.h"
+#include "type/arena_pool.h"
+#include "type/batch_kernels.h"
+#include "type/type_kernels.h"
 #include "type/value_factory.h"
 
 namespace bustub {
 
 /**
  * A simplified hash table that has all the necessary functionality for aggregations.
+ *
+ * The nodes of the hash table and the VARCHAR values of its keys are allocated from a pool, normally the arena of the
+ * query.
  */
 class SimpleAggregationHashTable {
  public:
+  /** The map from aggregate keys to aggregate values, with its nodes in the pool */
+  using AggregateMap = std::unordered_map<AggregateKey, AggregateValue, std::hash<AggregateKey>,
+                                          std::equal_to<AggregateKey>,
+                                          PoolAllocator<std::pair<const AggregateKey, AggregateValue>>>;
+
   /**
    * Construct a new SimpleAggregationHashTable instance.
    * @param agg_exprs the aggregation expressions
    * @param agg_types the types of aggregations
+   * @param pool the pool the hash table allocates from
    */
   SimpleAggregationHashTable(const std::vector<AbstractExpressionRef> &agg_exprs,
-                             const std::vector<AggregationType> &agg_types)
-      : agg_exprs_{agg_exprs}, agg_types_{agg_types} {}
+                             const std::vector<AggregationType> &agg_types, AbstractPool *pool)
+      : ht_(0, std::hash<AggregateKey>{}, std::equal_to<AggregateKey>{},
+            PoolAllocator<std::pair<const AggregateKey, AggregateValue>>(pool)),
+        agg_exprs_{agg_exprs},
+        agg_types_{agg_types},
+        pool_(pool) {
+    // Resolve the kernels that combine each input column into its running aggregate.
+    for (const auto &expr : agg_exprs_) {
+      comparators_.emplace_back(expr->GetReturnType(), expr->GetReturnType());
+      adders_.emplace_back(ArithmeticKernelOp::Add, expr->GetReturnType(), expr->GetReturnType());
+    }
+  }
 
   /** @return The initial aggregrate value for this aggregation executor */
   auto GenerateInitialAggregateValue() -> AggregateValue {
@@ -64,47 +88,143 @@ class SimpleAggregationHashTable {
   }
 
   /**
-   * TODO(Student)
-   *
    * Combines the input into the aggregation result.
    * @param[out] result The output aggregate value
    * @param input The input value
    */
   void CombineAggregateValues(AggregateValue *result, const AggregateValue &input) {
     for (uint32_t i = 0; i < agg_exprs_.size(); i++) {
+      CombineAggregateValue(i, &result->aggregates_[i], input.aggregates_[i]);
+    }
+  }
+
+  /**
+   * Combines one input value into the i-th aggregate.
+   * @param i The index of the aggregate
+   * @param[out] aggregate The running aggregate
+   * @param value The input value
+   */
+  void CombineAggregateValue(uint32_t i, Value *aggregate, const Value &value) {
+    if (agg_types_[i] == AggregationType::CountStarAggregate) {
+      *aggregate = ValueFactory::GetIntegerValue(aggregate->GetAs<int32_t>() + 1);
+      return;
+    }
+    // All other aggregates ignore NULL inputs, and start from the first non-NULL one.
+    if (value.IsNull()) {
+      return;
+    }
+    switch (agg_types_[i]) {
+      case AggregationType::CountAggregate:
+        *aggregate = ValueFactory::GetIntegerValue(aggregate->IsNull() ? 1 : aggregate->GetAs<int32_t>() + 1);
+        break;
+      case AggregationType::SumAggregate:
+        *aggregate = aggregate->IsNull() ? value : adders_[i].Compute(*aggregate, value);
+        break;
+      case AggregationType::MinAggregate:
+        if (aggregate->IsNull() || comparators_[i].Compare(value, *aggregate) < 0) {
+          *aggregate = value;
+        }
+        break;
+      case AggregationType::MaxAggregate:
+        if (aggregate->IsNull() || comparators_[i].Compare(value, *aggregate) > 0) {
+          *aggregate = value;
+        }
+        break;
+      case AggregationType::CountStarAggregate:
+        break;
+    }
+  }
+
+  /**
+   * Inserts a value into the hash table and then combines it with the current aggregation.
+   * @param agg_key the key to be inserted
+   * @param agg_val the value to be inserted
+   */
+  void InsertCombine(const AggregateKey &agg_key, const AggregateValue &agg_val) {
+    auto iter = ht_.find(agg_key);
+    if (iter == ht_.end()) {
+      iter = ht_.emplace(CloneKey(agg_key), GenerateInitialAggregateValue()).first;
+    }
+    CombineAggregateValues(&iter->second, agg_val);
+  }
+
+  /**
+   * Combines a batch of tuples that all belong to the same group into its aggregation. Each aggregate over a
+   * fixed-width input is reduced by a batch kernel, and the partial result is combined into the running aggregate.
+   * @param agg_key the key of the group
+   * @param tuples the input tuples
+   * @param schema the schema of the input tuples
+   */
+  void InsertCombineBatch(const AggregateKey &agg_key, const std::vector<Tuple> &tuples, const Schema &schema) {
+    auto iter = ht_.find(agg_key);
+    if (iter == ht_.end()) {
+      iter = ht_.emplace(CloneKey(agg_key), GenerateInitialAggregateValue()).first;
+    }
+    auto &result = iter->second;
+    for (uint32_t i = 0; i < agg_exprs_.size(); i++) {
+      auto &aggregate = result.aggregates_[i];
+      if (agg_types_[i] == AggregationType::CountStarAggregate) {
+        aggregate = ValueFactory::GetIntegerValue(aggregate.GetAs<int32_t>() + static_cast<int32_t>(tuples.size()));
+        continue;
+      }
+      if (!HasBatchKernels(agg_exprs_[i]->GetReturnType())) {
+        for (const auto &tuple : tuples) {
+          CombineAggregateValue(i, &aggregate, agg_exprs_[i]->Evaluate(&tuple, schema));
+        }
+        continue;
+      }
+      auto column = agg_exprs_[i]->EvaluateBatch(tuples, schema);
+      Value partial;
       switch (agg_types_[i]) {
-        case AggregationType::CountStarAggregate:
         case AggregationType::CountAggregate:
+          if (auto count = static_cast<int32_t>(CountColumn(column)); count > 0) {
+            aggregate = ValueFactory::GetIntegerValue(aggregate.IsNull() ? count : aggregate.GetAs<int32_t>() + count);
+          }
+          continue;
         case AggregationType::SumAggregate:
+          partial = SumColumn(column);
+          break;
         case AggregationType::MinAggregate:
+          partial = MinColumn(column);
+          break;
         case AggregationType::MaxAggregate:
+          partial = MaxColumn(column);
           break;
+        case AggregationType::CountStarAggregate:
+          continue;
       }
+      // A partial SUM, MIN or MAX combines like a single input value.
+      CombineAggregateValue(i, &aggregate, partial);
     }
   }
 
   /**
-   * Inserts a value into the hash table and then combines it with the current aggregation.
+   * Inserts a key with the initial aggregate value, unless the key is already present.
    * @param agg_key the key to be inserted
-   * @param agg_val the value to be inserted
    */
-  void InsertCombine(const AggregateKey &agg_key, const AggregateValue &agg_val) {
-    if (ht_.count(agg_key) == 0) {
-      ht_.insert({agg_key, GenerateInitialAggregateValue()});
+  void InsertInitial(const AggregateKey &agg_key) {
+    if (ht_.find(agg_key) == ht_.end()) {
+      ht_.emplace(CloneKey(agg_key), GenerateInitialAggregateValue());
     }
-    CombineAggregateValues(&ht_[agg_key], agg_val);
   }
 
   /**
    * Clear the hash table
    */
-  void Clear() { ht_.clear(); }
+  void Clear() {
+    for (const auto &[key, value] : ht_) {
+      for (const auto &group_by : key.group_bys_) {
+        ValueFactory::Release(group_by, pool_);
+      }
+    }
+    ht_.clear();
+  }
 
   /** An iterator over the aggregation hash table */
   class Iterator {
    public:
     /** Creates an iterator for the aggregate map. */
-    explicit Iterator(std::unordered_map<AggregateKey, AggregateValue>::const_iterator iter) : iter_{iter} {}
+    explicit Iterator(AggregateMap::const_iterator iter) : iter_{iter} {}
 
     /** @return The key of the iterator */
     auto Key() -> const AggregateKey & { return iter_->first; }
@@ -126,7 +246,7 @@ class SimpleAggregationHashTable {
 
    private:
     /** Aggregates map */
-    std::unordered_map<AggregateKey, AggregateValue>::const_iterator iter_;
+    AggregateMap::const_iterator iter_;
   };
 
   /** @return Iterator to the start of the hash table */
@@ -136,12 +256,28 @@ class SimpleAggregationHashTable {
   auto End() -> Iterator { return Iterator{ht_.cend()}; }
 
  private:
+  /** @return a copy of agg_key, with its VARCHAR values copied into the pool */
+  auto CloneKey(const AggregateKey &agg_key) -> AggregateKey {
+    AggregateKey key{{}, agg_key.hash_};
+    key.group_bys_.reserve(agg_key.group_bys_.size());
+    for (const auto &group_by : agg_key.group_bys_) {
+      key.group_bys_.emplace_back(ValueFactory::Clone(group_by, pool_));
+    }
+    return key;
+  }
+
   /** The hash table is just a map from aggregate keys to aggregate values */
-  std::unordered_map<AggregateKey, AggregateValue> ht_{};
+  AggregateMap ht_;
   /** The aggregate expressions that we have */
   const std::vector<AbstractExpressionRef> &agg_exprs_;
   /** The types of aggregations that we have */
   const std::vector<AggregationType> &agg_types_;
+  /** Compares each input column for MIN and MAX */
+  std::vector<TypedComparator> comparators_;
+  /** Adds each input column for SUM */
+  std::vector<TypedArithmetic> adders_;
+  /** The pool the hash table allocates from */
+  AbstractPool *pool_;
 };
 
 /**
@@ -177,13 +313,50 @@ class AggregationExecutor : public AbstractExecutor {
   auto GetChildExecutor() const -> const AbstractExecutor *;
 
  private:
-  /** @return The tuple as an AggregateKey */
-  auto MakeAggregateKey(const Tuple *tuple) -> AggregateKey {
-    std::vector<Value> keys;
-    for (const auto &expr : plan_->GetGroupBys()) {
-      keys.emplace_back(expr->Evaluate(tuple, child_->GetOutputSchema()));
+  /**
+   * @return The tuples of a batch as AggregateKeys, with their hashes computed a column at a time. The hash of each
+   * key is the one std::hash<AggregateKey> would compute.
+   */
+  auto MakeAggregateKeys(const std::vector<Tuple> &batch) -> std::vector<AggregateKey> {
+    const auto &schema = child_->GetOutputSchema();
+    std::vector<AggregateKey> keys(batch.size());
+    std::vector<hash_t> hashes(batch.size(), 0);
+    for (size_t j = 0; j < plan_->GetGroupBys().size(); j++) {
+      const auto &expr = plan_->GetGroupBys()[j];
+      if (group_by_dicts_[j] != nullptr) {
+        // Group on the dictionary codes; Next decodes each group's code once.
+        auto col_idx = dynamic_cast<const ColumnValueExpression &>(*expr).GetColIdx();
+        for (size_t i = 0; i < batch.size(); i++) {
+          auto code = batch[i].GetDictionaryCode(&schema, col_idx);
+          auto value = code == StringDictionary::NULL_CODE ? ValueFactory::GetNullValueByType(TypeId::BIGINT)
+                                                           : ValueFactory::GetBigIntValue(code);
+          if (!value.IsNull()) {
+            hashes[i] = HashUtil::CombineHashes(hashes[i], HashUtil::HashValue(&value));
+          }
+          keys[i].group_bys_.emplace_back(std::move(value));
+        }
+        continue;
+      }
+      if (HasBatchKernels(expr->GetReturnType())) {
+        auto column = expr->EvaluateBatch(batch, schema);
+        HashUtil::CombineHashColumn(column, hashes.data());
+        for (size_t i = 0; i < batch.size(); i++) {
+          keys[i].group_bys_.emplace_back(column.GetValue(i));
+        }
+        continue;
+      }
+      for (size_t i = 0; i < batch.size(); i++) {
+        auto value = expr->Evaluate(&batch[i], schema);
+        if (!value.IsNull()) {
+          hashes[i] = HashUtil::CombineHashes(hashes[i], HashUtil::HashValue(&value));
+        }
+        keys[i].group_bys_.emplace_back(std::move(value));
+      }
     }
-    return {keys};
+    for (size_t i = 0; i < batch.size(); i++) {
+      keys[i].hash_ = hashes[i];
+    }
+    return keys;
   }
 
   /** @return The tuple as an AggregateValue */
@@ -196,13 +369,23 @@ class AggregationExecutor : public AbstractExecutor {
   }
 
  private:
+  /** Combine a batch of input tuples into the aggregation hash table. */
+  void CombineBatch(const std::vector<Tuple> &batch);
+
+  /** The number of input tuples the aggregation combines at a time */
+  static constexpr size_t AGGREGATION_BATCH_SIZE = 1024;
+
   /** The aggregation plan node */
   const AggregationPlanNode *plan_;
   /** The child executor that produces tuples over which the aggregation is computed */
   std::unique_ptr<AbstractExecutor> child_;
+  /** For every group-by, the dictionary of the column it reads if the groups are keyed on its codes, else nullptr */
+  std::vector<StringDictionary *> group_by_dicts_;
   /** Simple aggregation hash table */
-  // TODO(Student): Uncomment SimpleAggregationHashTable aht_;
+  SimpleAggregationHashTable aht_;
   /** Simple aggregation hash table iterator */
-  // TODO(Student): Uncomment SimpleAggregationHashTable::Iterator aht_iterator_;
+  SimpleAggregationHashTable::Iterator aht_iterator_;
+  /** Builds the output rows */
+  TupleBuilder builder_;
 };
 }  // namespace bustub
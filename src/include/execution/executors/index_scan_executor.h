@@ -12,18 +12,25 @@
 
 #pragma once
 
+#include <functional>
 #include <vector>
 
 #include "common/rid.h"
 #include "execution/executor_context.h"
 #include "execution/executors/abstract_executor.h"
 #include "execution/plans/index_scan_plan.h"
+#include "storage/index/b_plus_tree_index.h"
 #include "storage/table/tuple.h"
 
 namespace bustub {
 
 /**
- * IndexScanExecutor executes an index scan over a table.
+ * IndexScanExecutor executes an index scan over a table. It reads the RIDs of the key range of the plan from the index
+ * a leaf at a time, and fetches their tuples from the table. The index may have any of the key sizes that
+ * DispatchGenericKeySize picks.
+ *
+ * An index-only scan builds the tuples from the keys instead, which saves a random access to the table for each of
+ * them, and leaves the columns that are not in the key NULL.
  */
 
 class IndexScanExecutor : public AbstractExecutor {
@@ -42,7 +49,23 @@ class IndexScanExecutor : public AbstractExecutor {
   auto Next(Tuple *tuple, RID *rid) -> bool override;
 
  private:
+  /** Start the scan of the range of the plan on tree, the index of the plan cast to its key type. */
+  template <typename KeyType, typename ValueType, typename KeyComparator>
+  void StartScan(BPlusTreeIndex<KeyType, ValueType, KeyComparator> *tree);
+
   /** The index scan plan node to be executed. */
   const IndexScanPlanNode *plan_;
+  const IndexInfo *index_info_{nullptr};
+  const TableInfo *table_info_{nullptr};
+  /** Appends the RIDs of the next leaf in the range to rids_, and their tuples to tuples_ for an index-only scan,
+   * returning false at the end of the range */
+  std::function<bool()> next_batch_;
+  /** The RIDs of the current batch, and the position of the next one to fetch */
+  std::vector<RID> rids_;
+  size_t cursor_{0};
+  /** The tuples of the current batch, built from the keys, for an index-only scan */
+  std::vector<Tuple> tuples_;
+  /** For each column of the table, its position in the index key, or -1 if the key does not hold it */
+  std::vector<int> key_positions_;
 };
 }  // namespace bustub
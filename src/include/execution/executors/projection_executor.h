@@ -20,6 +20,7 @@
 #include "execution/plans/projection_plan.h"
 #include "execution/plans/seq_scan_plan.h"
 #include "storage/table/tuple.h"
+#include "storage/table/tuple_builder.h"
 
 namespace bustub {
 
@@ -56,5 +57,8 @@ class ProjectionExecutor : public AbstractExecutor {
 
   /** The child executor from which tuples are obtained */
   std::unique_ptr<AbstractExecutor> child_executor_;
+
+  /** Builds the output rows */
+  TupleBuilder builder_;
 };
 }  // namespace bustub
@@ -12,17 +12,34 @@
 
 #pragma once
 
+#include <condition_variable>  // NOLINT
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <thread>  // NOLINT
 #include <vector>
 
 #include "execution/executor_context.h"
 #include "execution/executors/abstract_executor.h"
+#include "execution/expressions/comparison_expression.h"
 #include "execution/plans/seq_scan_plan.h"
+#include "storage/table/morsel_queue.h"
 #include "storage/table/tuple.h"
 
 namespace bustub {
 
 /**
  * The SeqScanExecutor executor executes a sequential table scan.
+ *
+ * The pages of the table are split into morsels (see MorselQueue). If the table spans more than one morsel, the scan
+ * starts up to `parallel_scan_threads` worker threads. Every worker drives its own SeqScanExecutor over the morsels of
+ * a shared queue and hands the matching tuples back through a bounded buffer, so the scan yields tuples in no
+ * particular order. An exception thrown by a worker stops the scan and is rethrown by Next.
+ *
+ * On a PAX table, a filter that compares a fixed-width column with a constant (on its own, or as part of a
+ * conjunction) is first run over the column chunk of each page (see TableHeap::ReadColumnChunk), and only the tuples it
+ * selects are read in full.
  */
 class SeqScanExecutor : public AbstractExecutor {
  public:
@@ -33,6 +50,18 @@ class SeqScanExecutor : public AbstractExecutor {
    */
   SeqScanExecutor(ExecutorContext *exec_ctx, const SeqScanPlanNode *plan);
 
+  /**
+   * Construct a SeqScanExecutor that only scans the morsels it takes from a shared queue. Executors sharing a queue
+   * scan the table exactly once between them, and each of them can be driven by a different thread.
+   * @param exec_ctx The executor context
+   * @param plan The sequential scan plan to be executed
+   * @param morsels The queue to take morsels from
+   */
+  SeqScanExecutor(ExecutorContext *exec_ctx, const SeqScanPlanNode *plan, std::shared_ptr<MorselQueue> morsels);
+
+  /** Stop the worker threads of a parallel scan that was not run to the end. */
+  ~SeqScanExecutor() override;
+
   /** Initialize the sequential scan */
   void Init() override;
 
@@ -41,6 +70,7 @@ class SeqScanExecutor : public AbstractExecutor {
    * @param[out] tuple The next tuple produced by the scan
    * @param[out] rid The next tuple RID produced by the scan
    * @return `true` if a tuple was produced, `false` if there are no more tuples
+   * @throws the first exception thrown by a worker of a parallel scan
    */
   auto Next(Tuple *tuple, RID *rid) -> bool override;
 
@@ -48,7 +78,84 @@ class SeqScanExecutor : public AbstractExecutor {
   auto GetOutputSchema() const -> const Schema & override { return plan_->OutputSchema(); }
 
  private:
+  /**
+   * Read the tuples of the next page that may hold a match into page_tuples_, and select the matching ones.
+   * @return `false` if there are no more pages to scan
+   */
+  auto FetchNextPage() -> bool;
+
+  /**
+   * @return a comparison that the filter predicate implies and that can be run over a column chunk, i.e. the predicate
+   * itself or one of its conjuncts, or nullptr if there is none
+   */
+  static auto FindChunkFilter(const AbstractExpression &expr) -> const ComparisonExpression *;
+
+  /**
+   * Read the tuples of a page that pass chunk_filter_ into page_tuples_, reading only the column it compares for the
+   * other tuples.
+   */
+  void ReadPageThroughChunk(page_id_t page_id);
+
+  /**
+   * Check the zone map of a page against the pushed-down filter predicate.
+   * @param page_id The page to check
+   * @param expr The (sub-)predicate to check
+   * @return `false` if no tuple on the page can satisfy expr, `true` if some might
+   */
+  auto PageMayMatch(page_id_t page_id, const AbstractExpression &expr) const -> bool;
+
+  /** Start num_workers threads, each scanning with its own executor over morsels_. */
+  void StartWorkers(size_t num_workers);
+
+  /** Stop and join the worker threads, if any are running. */
+  void StopWorkers();
+
+  /** The body of a worker thread: move the tuples produced by worker into buffer_. */
+  void RunWorker(SeqScanExecutor *worker);
+
+  /** The maximum number of tuples the workers of a parallel scan buffer ahead of the consumer */
+  static constexpr size_t PARALLEL_SCAN_BUFFER_SIZE = 4096;
+  /** The number of tuples a worker hands over at a time */
+  static constexpr size_t PARALLEL_SCAN_BATCH_SIZE = 256;
+
   /** The sequential scan plan node to be executed */
   const SeqScanPlanNode *plan_;
+  /** The table being scanned */
+  TableInfo *table_info_{nullptr};
+  /** The comparison run over column chunks before tuples are read, or nullptr if the scan reads whole pages */
+  const ComparisonExpression *chunk_filter_{nullptr};
+  /** True if this executor only scans the morsels of a queue shared with other executors */
+  const bool shares_morsels_;
+  /** The queue of morsels of the table */
+  std::shared_ptr<MorselQueue> morsels_;
+  /** The pages of the morsel being scanned */
+  std::vector<page_id_t> morsel_;
+  /** The position of the next page in morsel_ */
+  size_t morsel_cursor_{0};
+  /** The tuples of the page being scanned */
+  std::vector<Tuple> page_tuples_;
+  /** The indices of the tuples in page_tuples_ that satisfy the filter predicate */
+  std::vector<uint32_t> selection_;
+  /** The position of the next tuple in selection_ */
+  size_t cursor_{0};
+
+  /** The executors driven by the worker threads of a parallel scan */
+  std::vector<std::unique_ptr<SeqScanExecutor>> worker_executors_;
+  /** The worker threads of a parallel scan */
+  std::vector<std::thread> workers_;
+  /** Protects the fields below */
+  std::mutex buffer_latch_;
+  /** Signalled when tuples are added to buffer_ or a worker finishes */
+  std::condition_variable buffer_not_empty_;
+  /** Signalled when tuples are taken from buffer_ or the scan is stopped */
+  std::condition_variable buffer_not_full_;
+  /** The tuples produced by the workers, not yet returned by Next */
+  std::deque<Tuple> buffer_;
+  /** The number of workers that are still scanning */
+  size_t running_workers_{0};
+  /** True if the workers should stop early */
+  bool stopped_{false};
+  /** The first exception thrown by a worker, rethrown by Next */
+  std::exception_ptr worker_error_;
 };
 }  // namespace bustub
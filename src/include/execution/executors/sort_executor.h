@@ -20,11 +20,17 @@
 #include "execution/plans/seq_scan_plan.h"
 #include "execution/plans/sort_plan.h"
 #include "storage/table/tuple.h"
+#include "type/arena_pool.h"
+#include "type/type_kernels.h"
 
 namespace bustub {
 
 /**
  * The SortExecutor executor executes a sort.
+ *
+ * The sort keys of every tuple are evaluated once up front. The keys are then compared through typed kernels resolved
+ * per ORDER BY column, so the comparisons of the sort itself neither dispatch through Type nor build Values. The
+ * sort run and the tuples in it are kept in the arena of the query.
  */
 class SortExecutor : public AbstractExecutor {
  public:
@@ -40,7 +46,7 @@ class SortExecutor : public AbstractExecutor {
 
   /**
    * Yield the next tuple from the sort.
-   * @param[out] tuple The next tuple produced by the sort
+   * @param[out] tuple The next tuple produced by the sort, whose data lives in the arena until the next Init
    * @param[out] rid The next tuple RID produced by the sort
    * @return `true` if a tuple was produced, `false` if there are no more tuples
    */
@@ -50,7 +56,27 @@ class SortExecutor : public AbstractExecutor {
   auto GetOutputSchema() const -> const Schema & override { return plan_->OutputSchema(); }
 
  private:
+  /** A tuple together with its evaluated sort keys */
+  struct SortEntry {
+    std::vector<Value> keys_;
+    Tuple tuple_;
+  };
+
+  /** @return `true` if lhs sorts before rhs */
+  auto LessThan(const SortEntry &lhs, const SortEntry &rhs) const -> bool;
+
   /** The sort plan node to be executed */
   const SortPlanNode *plan_;
+  /** The child executor whose tuples are sorted */
+  std::unique_ptr<AbstractExecutor> child_executor_;
+  /** One comparator per ORDER BY column */
+  std::vector<TypedComparator> comparators_;
+  /** Return the tuples of the sort run to the arena, and clear it */
+  void ReleaseEntries();
+
+  /** The sorted tuples */
+  std::vector<SortEntry, PoolAllocator<SortEntry>> entries_;
+  /** The position of the next tuple in entries_ */
+  size_t cursor_{0};
 };
 }  // namespace bustub
@@ -19,6 +19,7 @@
 #include "execution/plans/seq_scan_plan.h"
 #include "execution/plans/values_plan.h"
 #include "storage/table/tuple.h"
+#include "storage/table/tuple_builder.h"
 
 namespace bustub {
 
@@ -55,5 +56,8 @@ class ValuesExecutor : public AbstractExecutor {
   const Schema dummy_schema_;
 
   size_t cursor_{0};
+
+  /** Builds the output rows */
+  TupleBuilder builder_;
 };
 }  // namespace bustub
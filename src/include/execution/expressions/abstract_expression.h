@@ -20,6 +20,7 @@
 #include "catalog/schema.h"
 #include "fmt/format.h"
 #include "storage/table/tuple.h"
+#include "type/batch_kernels.h"
 
 #define BUSTUB_EXPR_CLONE_WITH_CHILDREN(cname)                                                                   \
   auto CloneWithChildren(std::vector<AbstractExpressionRef> children) const->std::unique_ptr<AbstractExpression> \
@@ -65,6 +66,40 @@ class AbstractExpression {
   virtual auto EvaluateJoin(const Tuple *left_tuple, const Schema &left_schema, const Tuple *right_tuple,
                             const Schema &right_schema) const -> Value = 0;
 
+  /**
+   * Evaluate the expression for a batch of tuples at once. This evaluates the tuples one by one; expressions that have
+   * batch kernels override it.
+   * @param tuples the tuples to evaluate
+   * @param schema the schema of the tuples
+   * @return the values of the expression, which must have a fixed-width type, in the order of the tuples
+   */
+  virtual auto EvaluateBatch(const std::vector<Tuple> &tuples, const Schema &schema) const -> ColumnVector {
+    std::vector<Value> values;
+    values.reserve(tuples.size());
+    for (const auto &tuple : tuples) {
+      values.emplace_back(Evaluate(&tuple, schema));
+    }
+    return ColumnVector::FromValues(GetReturnType(), values);
+  }
+
+  /**
+   * Select the tuples of a batch for which this boolean expression is true. This evaluates the tuples one by one;
+   * expressions that have batch kernels override it.
+   * @param tuples the tuples to evaluate
+   * @param schema the schema of the tuples
+   * @param[out] selection set to the indices of the selected tuples, in ascending order
+   */
+  virtual void SelectBatch(const std::vector<Tuple> &tuples, const Schema &schema,
+                           std::vector<uint32_t> *selection) const {
+    selection->clear();
+    for (uint32_t i = 0; i < tuples.size(); i++) {
+      auto value = Evaluate(&tuples[i], schema);
+      if (!value.IsNull() && value.GetAs<bool>()) {
+        selection->push_back(i);
+      }
+    }
+  }
+
   /** @return the child_idx'th child of this expression */
   auto GetChildAt(uint32_t child_idx) const -> const AbstractExpressionRef & { return children_[child_idx]; }
 
@@ -12,7 +12,6 @@
 
 #pragma once
 
-#include <optional>
 #include <string>
 #include <utility>
 #include <vector>
@@ -23,6 +22,7 @@
 #include "execution/expressions/abstract_expression.h"
 #include "fmt/format.h"
 #include "storage/table/tuple.h"
+#include "type/batch_kernels.h"
 #include "type/type_id.h"
 #include "type/value_factory.h"
 
@@ -38,7 +38,9 @@ class ArithmeticExpression : public AbstractExpression {
  public:
   /** Creates a new comparison expression representing (left comp_type right). */
   ArithmeticExpression(AbstractExpressionRef left, AbstractExpressionRef right, ArithmeticType compute_type)
-      : AbstractExpression({std::move(left), std::move(right)}, TypeId::INTEGER), compute_type_{compute_type} {
+      : AbstractExpression({std::move(left), std::move(right)}, TypeId::INTEGER),
+        compute_type_{compute_type},
+        arithmetic_{GetKernelOp(), TypeId::INTEGER, TypeId::INTEGER} {
     if (GetChildAt(0)->GetReturnType() != TypeId::INTEGER || GetChildAt(1)->GetReturnType() != TypeId::INTEGER) {
       throw bustub::NotImplementedException("only support integer for now");
     }
@@ -47,22 +49,20 @@ class ArithmeticExpression : public AbstractExpression {
   auto Evaluate(const Tuple *tuple, const Schema &schema) const -> Value override {
     Value lhs = GetChildAt(0)->Evaluate(tuple, schema);
     Value rhs = GetChildAt(1)->Evaluate(tuple, schema);
-    auto res = PerformComputation(lhs, rhs);
-    if (res == std::nullopt) {
-      return ValueFactory::GetNullValueByType(TypeId::INTEGER);
-    }
-    return ValueFactory::GetIntegerValue(*res);
+    return PerformComputation(lhs, rhs);
   }
 
   auto EvaluateJoin(const Tuple *left_tuple, const Schema &left_schema, const Tuple *right_tuple,
                     const Schema &right_schema) const -> Value override {
     Value lhs = GetChildAt(0)->EvaluateJoin(left_tuple, left_schema, right_tuple, right_schema);
     Value rhs = GetChildAt(1)->EvaluateJoin(left_tuple, left_schema, right_tuple, right_schema);
-    auto res = PerformComputation(lhs, rhs);
-    if (res == std::nullopt) {
-      return ValueFactory::GetNullValueByType(TypeId::INTEGER);
-    }
-    return ValueFactory::GetIntegerValue(*res);
+    return PerformComputation(lhs, rhs);
+  }
+
+  auto EvaluateBatch(const std::vector<Tuple> &tuples, const Schema &schema) const -> ColumnVector override {
+    auto lhs = GetChildAt(0)->EvaluateBatch(tuples, schema);
+    auto rhs = GetChildAt(1)->EvaluateBatch(tuples, schema);
+    return Compute(GetKernelOp(), lhs, rhs);
   }
 
   /** @return the string representation of the expression node and its children */
@@ -75,19 +75,27 @@ class ArithmeticExpression : public AbstractExpression {
   ArithmeticType compute_type_;
 
  private:
-  auto PerformComputation(const Value &lhs, const Value &rhs) const -> std::optional<int32_t> {
-    if (lhs.IsNull() || rhs.IsNull()) {
-      return std::nullopt;
-    }
+  /** @return the kernel operation of this computation */
+  auto GetKernelOp() const -> ArithmeticKernelOp {
     switch (compute_type_) {
       case ArithmeticType::Plus:
-        return lhs.GetAs<int32_t>() + rhs.GetAs<int32_t>();
+        return ArithmeticKernelOp::Add;
       case ArithmeticType::Minus:
-        return lhs.GetAs<int32_t>() - rhs.GetAs<int32_t>();
-      default:
-        UNREACHABLE("Unsupported arithmetic type.");
+        return ArithmeticKernelOp::Subtract;
     }
+    UNREACHABLE("Unsupported arithmetic type.");
   }
+
+  /** Compute one row. Like the batch kernels of EvaluateBatch, this throws on integer overflow. */
+  auto PerformComputation(const Value &lhs, const Value &rhs) const -> Value {
+    if (lhs.IsNull() || rhs.IsNull()) {
+      return ValueFactory::GetNullValueByType(TypeId::INTEGER);
+    }
+    return arithmetic_.Compute(lhs, rhs);
+  }
+
+  /** Computes the values of the children, resolved for their return types */
+  TypedArithmetic arithmetic_;
 };
 }  // namespace bustub
 
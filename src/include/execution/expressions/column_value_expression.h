@@ -12,8 +12,10 @@
 
 #pragma once
 
+#include <cstring>
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "catalog/schema.h"
@@ -45,6 +47,23 @@ class ColumnValueExpression : public AbstractExpression {
                            : right_tuple->GetValue(&right_schema, col_idx_);
   }
 
+  auto EvaluateBatch(const std::vector<Tuple> &tuples, const Schema &schema) const -> ColumnVector override {
+    const auto &accessor = schema.GetAccessor(col_idx_);
+    if (!accessor.inlined_ || accessor.dictionary_encoded_) {
+      return AbstractExpression::EvaluateBatch(tuples, schema);
+    }
+    // Gather the serialized values straight out of the tuples, without materializing a Value for each of them, and
+    // take the null mask from the null bitmaps instead of comparing every value against the NULL sentinel.
+    auto length = Type::GetTypeSize(accessor.type_);
+    std::vector<char> data(tuples.size() * length);
+    std::vector<uint8_t> nulls(tuples.size());
+    for (size_t i = 0; i < tuples.size(); i++) {
+      memcpy(data.data() + i * length, tuples[i].GetData() + accessor.offset_, length);
+      nulls[i] = static_cast<uint8_t>((tuples[i].GetNullBitmap()[accessor.null_byte_] & accessor.null_mask_) != 0);
+    }
+    return {accessor.type_, std::move(data), std::move(nulls)};
+  }
+
   auto GetTupleIdx() const -> uint32_t { return tuple_idx_; }
   auto GetColIdx() const -> uint32_t { return col_idx_; }
 
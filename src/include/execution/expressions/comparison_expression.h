@@ -12,14 +12,21 @@
 
 #pragma once
 
+#include <atomic>
+#include <memory>
+#include <optional>
 #include <string>
 #include <utility>
 #include <vector>
 
 #include "catalog/schema.h"
 #include "execution/expressions/abstract_expression.h"
+#include "execution/expressions/column_value_expression.h"
+#include "execution/expressions/constant_value_expression.h"
 #include "fmt/format.h"
 #include "storage/table/tuple.h"
+#include "type/batch_kernels.h"
+#include "type/type_kernels.h"
 #include "type/value_factory.h"
 
 namespace bustub {
@@ -34,9 +41,27 @@ class ComparisonExpression : public AbstractExpression {
  public:
   /** Creates a new comparison expression representing (left comp_type right). */
   ComparisonExpression(AbstractExpressionRef left, AbstractExpressionRef right, ComparisonType comp_type)
-      : AbstractExpression({std::move(left), std::move(right)}, TypeId::BOOLEAN), comp_type_{comp_type} {}
+      : AbstractExpression({std::move(left), std::move(right)}, TypeId::BOOLEAN),
+        comp_type_{comp_type},
+        comparator_{GetChildAt(0)->GetReturnType(), GetChildAt(1)->GetReturnType()},
+        lhs_column_{dynamic_cast<const ColumnValueExpression *>(GetChildAt(0).get())},
+        rhs_column_{dynamic_cast<const ColumnValueExpression *>(GetChildAt(1).get())} {
+    // Remember the string a column may be compared with, so that it is not rebuilt on every row.
+    const auto *constant_expr =
+        dynamic_cast<const ConstantValueExpression *>(GetChildAt(lhs_column_ != nullptr ? 1 : 0).get());
+    if ((lhs_column_ == nullptr) != (rhs_column_ == nullptr) && constant_expr != nullptr &&
+        constant_expr->val_.GetTypeId() == TypeId::VARCHAR) {
+      has_string_constant_ = true;
+      if (const auto &val = constant_expr->val_; !val.IsNull()) {
+        constant_string_.emplace(val.GetData(), val.GetLength() - 1);
+      }
+    }
+  }
 
   auto Evaluate(const Tuple *tuple, const Schema &schema) const -> Value override {
+    if (auto result = CompareDictionaryCodes(tuple, schema, tuple, schema); result.has_value()) {
+      return ValueFactory::GetBooleanValue(*result);
+    }
     Value lhs = GetChildAt(0)->Evaluate(tuple, schema);
     Value rhs = GetChildAt(1)->Evaluate(tuple, schema);
     return ValueFactory::GetBooleanValue(PerformComparison(lhs, rhs));
@@ -44,22 +69,243 @@ class ComparisonExpression : public AbstractExpression {
 
   auto EvaluateJoin(const Tuple *left_tuple, const Schema &left_schema, const Tuple *right_tuple,
                     const Schema &right_schema) const -> Value override {
+    if (auto result = CompareDictionaryCodes(left_tuple, left_schema, right_tuple, right_schema); result.has_value()) {
+      return ValueFactory::GetBooleanValue(*result);
+    }
     Value lhs = GetChildAt(0)->EvaluateJoin(left_tuple, left_schema, right_tuple, right_schema);
     Value rhs = GetChildAt(1)->EvaluateJoin(left_tuple, left_schema, right_tuple, right_schema);
     return ValueFactory::GetBooleanValue(PerformComparison(lhs, rhs));
   }
 
+  /**
+   * Select a batch with a batch kernel when fixed-width columns are compared with each other or with a constant,
+   * and tuple by tuple otherwise.
+   */
+  void SelectBatch(const std::vector<Tuple> &tuples, const Schema &schema,
+                   std::vector<uint32_t> *selection) const override {
+    const auto *lhs_constant = dynamic_cast<const ConstantValueExpression *>(GetChildAt(0).get());
+    const auto *rhs_constant = dynamic_cast<const ConstantValueExpression *>(GetChildAt(1).get());
+    auto lhs_type = GetChildAt(0)->GetReturnType();
+    auto rhs_type = GetChildAt(1)->GetReturnType();
+    if (lhs_constant == nullptr && rhs_constant != nullptr && CanCompareInBatch(lhs_type, rhs_constant->val_)) {
+      SelectAgainstConstant(*GetChildAt(0), rhs_constant->val_, false, tuples, schema, selection);
+      return;
+    }
+    if (lhs_constant != nullptr && rhs_constant == nullptr && CanCompareInBatch(rhs_type, lhs_constant->val_)) {
+      SelectAgainstConstant(*GetChildAt(1), lhs_constant->val_, true, tuples, schema, selection);
+      return;
+    }
+    if (lhs_constant == nullptr && rhs_constant == nullptr && lhs_type == rhs_type && HasBatchKernels(lhs_type)) {
+      selection->clear();
+      SelectCompare(GetKernelOp(false), GetChildAt(0)->EvaluateBatch(tuples, schema),
+                    GetChildAt(1)->EvaluateBatch(tuples, schema), selection);
+      return;
+    }
+    AbstractExpression::SelectBatch(tuples, schema, selection);
+  }
+
+  /**
+   * @return the column if this compares a fixed-width column with a constant that a batch kernel can compare it with,
+   * in which case SelectColumn can run the comparison on the values of the column alone, or nullptr otherwise
+   */
+  auto GetComparedColumn() const -> const ColumnValueExpression * {
+    const auto *column = lhs_column_ != nullptr ? lhs_column_ : rhs_column_;
+    const auto *constant_expr =
+        dynamic_cast<const ConstantValueExpression *>(GetChildAt(lhs_column_ != nullptr ? 1 : 0).get());
+    if (column == nullptr || constant_expr == nullptr ||
+        !CanCompareInBatch(column->GetReturnType(), constant_expr->val_)) {
+      return nullptr;
+    }
+    return column;
+  }
+
+  /**
+   * Select the rows for which the comparison holds, given the values of the column returned by GetComparedColumn.
+   * @param values the values of the column
+   * @param[out] selection the indices of the selected rows
+   */
+  void SelectColumn(const ColumnVector &values, std::vector<uint32_t> *selection) const {
+    BUSTUB_ASSERT(GetComparedColumn() != nullptr, "The comparison does not compare a column with a constant.");
+    bool mirrored = lhs_column_ == nullptr;
+    const auto &constant = dynamic_cast<const ConstantValueExpression &>(*GetChildAt(mirrored ? 0 : 1)).val_;
+    SelectValuesAgainstConstant(values, constant, mirrored, selection);
+  }
+
   /** @return the string representation of the expression node and its children */
   auto ToString() const -> std::string override {
     return fmt::format("({}{}{})", *GetChildAt(0), comp_type_, *GetChildAt(1));
   }
 
-  BUSTUB_EXPR_CLONE_WITH_CHILDREN(ComparisonExpression);
+  auto CloneWithChildren(std::vector<AbstractExpressionRef> children) const
+      -> std::unique_ptr<AbstractExpression> override {
+    // Go through the constructor, which resolves the operands anew.
+    return std::make_unique<ComparisonExpression>(std::move(children[0]), std::move(children[1]), comp_type_);
+  }
 
   ComparisonType comp_type_;
 
  private:
+  /**
+   * Decide (in)equality on dictionary codes, without decoding the strings. This applies when a dictionary-encoded
+   * column is compared with a constant, or with a column sharing its dictionary.
+   * @return the result of the comparison, or std::nullopt if it has to be performed on the values
+   */
+  auto CompareDictionaryCodes(const Tuple *left_tuple, const Schema &left_schema, const Tuple *right_tuple,
+                              const Schema &right_schema) const -> std::optional<CmpBool> {
+    if ((comp_type_ != ComparisonType::Equal && comp_type_ != ComparisonType::NotEqual) ||
+        (lhs_column_ == nullptr && rhs_column_ == nullptr)) {
+      return std::nullopt;
+    }
+    StringDictionary *lhs_dict = nullptr;
+    StringDictionary *rhs_dict = nullptr;
+    auto lhs_code = GetDictionaryCode(lhs_column_, left_tuple, left_schema, right_tuple, right_schema, &lhs_dict);
+    auto rhs_code = GetDictionaryCode(rhs_column_, left_tuple, left_schema, right_tuple, right_schema, &rhs_dict);
+    if (!lhs_code.has_value() && !rhs_code.has_value()) {
+      return std::nullopt;
+    }
+    if (!lhs_code.has_value() || !rhs_code.has_value()) {
+      if (!has_string_constant_) {
+        return std::nullopt;
+      }
+      auto column_code = lhs_code.has_value() ? *lhs_code : *rhs_code;
+      if (!constant_string_.has_value() || column_code == StringDictionary::NULL_CODE) {
+        return CmpBool::CmpNull;
+      }
+      // A string missing from the dictionary is held by no tuple.
+      auto constant_code = GetConstantCode(lhs_code.has_value() ? lhs_dict : rhs_dict);
+      bool equal = constant_code.has_value() && *constant_code == column_code;
+      return (comp_type_ == ComparisonType::Equal) == equal ? CmpBool::CmpTrue : CmpBool::CmpFalse;
+    }
+    if (lhs_dict != rhs_dict) {
+      return std::nullopt;
+    }
+    if (*lhs_code == StringDictionary::NULL_CODE || *rhs_code == StringDictionary::NULL_CODE) {
+      return CmpBool::CmpNull;
+    }
+    bool equal = *lhs_code == *rhs_code;
+    return (comp_type_ == ComparisonType::Equal) == equal ? CmpBool::CmpTrue : CmpBool::CmpFalse;
+  }
+
+  /** @return the dictionary code of column if it reads a dictionary-encoded column, which also sets dict */
+  static auto GetDictionaryCode(const ColumnValueExpression *column, const Tuple *left_tuple,
+                                const Schema &left_schema, const Tuple *right_tuple, const Schema &right_schema,
+                                StringDictionary **dict) -> std::optional<uint32_t> {
+    if (column == nullptr) {
+      return std::nullopt;
+    }
+    const auto *tuple = column->GetTupleIdx() == 0 ? left_tuple : right_tuple;
+    const auto &schema = column->GetTupleIdx() == 0 ? left_schema : right_schema;
+    const auto &col = schema.GetColumn(column->GetColIdx());
+    if (!col.IsDictionaryEncoded()) {
+      return std::nullopt;
+    }
+    *dict = col.GetDictionary().get();
+    return tuple->GetDictionaryCode(&schema, column->GetColIdx());
+  }
+
+  /**
+   * Look the string constant up in the dictionary of the column it is compared with. A code that was found stays
+   * valid, and a string that was missing can only appear once the dictionary grows, so the dictionary is only
+   * searched again after it did.
+   * @return the code of the constant, or std::nullopt if no tuple holds it
+   */
+  auto GetConstantCode(StringDictionary *dict) const -> std::optional<uint32_t> {
+    if (auto code = constant_code_.load(); code != StringDictionary::NULL_CODE) {
+      return code;
+    }
+    auto size = dict->Size();
+    if (size == constant_missing_at_size_.load()) {
+      return std::nullopt;
+    }
+    auto code = dict->Lookup(*constant_string_);
+    if (code.has_value()) {
+      constant_code_.store(*code);
+    } else {
+      constant_missing_at_size_.store(size);
+    }
+    return code;
+  }
+
+  /**
+   * @return true if a batch of column_type values can be compared with a batch kernel against `constant`, which takes
+   * converting the constant to column_type without loss
+   */
+  static auto CanCompareInBatch(TypeId column_type, const Value &constant) -> bool {
+    if (!HasBatchKernels(column_type)) {
+      return false;
+    }
+    auto constant_type = constant.GetTypeId();
+    if (constant_type == column_type || constant.IsNull()) {
+      return true;
+    }
+    bool small_integer =
+        constant_type == TypeId::TINYINT || constant_type == TypeId::SMALLINT || constant_type == TypeId::INTEGER;
+    return small_integer && (column_type == TypeId::BIGINT || column_type == TypeId::DECIMAL);
+  }
+
+  /** Select the tuples for which `column op constant` holds, or `constant op column` if mirrored is set. */
+  void SelectAgainstConstant(const AbstractExpression &column, const Value &constant, bool mirrored,
+                             const std::vector<Tuple> &tuples, const Schema &schema,
+                             std::vector<uint32_t> *selection) const {
+    selection->clear();
+    // Nothing compares true with NULL.
+    if (constant.IsNull()) {
+      return;
+    }
+    SelectValuesAgainstConstant(column.EvaluateBatch(tuples, schema), constant, mirrored, selection);
+  }
+
+  /** Select the rows for which `values[i] op constant` holds, or `constant op values[i]` if mirrored is set. */
+  void SelectValuesAgainstConstant(const ColumnVector &values, const Value &constant, bool mirrored,
+                                   std::vector<uint32_t> *selection) const {
+    selection->clear();
+    if (constant.IsNull()) {
+      return;
+    }
+    SelectCompare(GetKernelOp(mirrored), values, constant.CastAs(values.GetType()), selection);
+  }
+
+  /** @return the batch kernel operation of this comparison, with its operands swapped if mirrored is set */
+  auto GetKernelOp(bool mirrored) const -> CompareKernelOp {
+    switch (comp_type_) {
+      case ComparisonType::Equal:
+        return CompareKernelOp::Equal;
+      case ComparisonType::NotEqual:
+        return CompareKernelOp::NotEqual;
+      case ComparisonType::LessThan:
+        return mirrored ? CompareKernelOp::GreaterThan : CompareKernelOp::LessThan;
+      case ComparisonType::LessThanOrEqual:
+        return mirrored ? CompareKernelOp::GreaterThanOrEqual : CompareKernelOp::LessThanOrEqual;
+      case ComparisonType::GreaterThan:
+        return mirrored ? CompareKernelOp::LessThan : CompareKernelOp::GreaterThan;
+      case ComparisonType::GreaterThanOrEqual:
+        return mirrored ? CompareKernelOp::LessThanOrEqual : CompareKernelOp::GreaterThanOrEqual;
+    }
+    UNREACHABLE("Unsupported comparison type.");
+  }
+
   auto PerformComparison(const Value &lhs, const Value &rhs) const -> CmpBool {
+    // Fixed-width values are compared by a typed kernel, without going through the Type hierarchy.
+    if (auto kernel = comparator_.GetKernel(lhs, rhs); kernel != nullptr) {
+      if (lhs.IsNull() || rhs.IsNull()) {
+        return CmpBool::CmpNull;
+      }
+      int cmp = kernel(lhs, rhs);
+      switch (comp_type_) {
+        case ComparisonType::Equal:
+          return GetCmpBool(cmp == 0);
+        case ComparisonType::NotEqual:
+          return GetCmpBool(cmp != 0);
+        case ComparisonType::LessThan:
+          return GetCmpBool(cmp < 0);
+        case ComparisonType::LessThanOrEqual:
+          return GetCmpBool(cmp <= 0);
+        case ComparisonType::GreaterThan:
+          return GetCmpBool(cmp > 0);
+        case ComparisonType::GreaterThanOrEqual:
+          return GetCmpBool(cmp >= 0);
+      }
+    }
     switch (comp_type_) {
       case ComparisonType::Equal:
         return lhs.CompareEquals(rhs);
@@ -77,6 +323,19 @@ class ComparisonExpression : public AbstractExpression {
         BUSTUB_ASSERT(false, "Unsupported comparison type.");
     }
   }
+
+  /** Compares the values of the children, resolved for their return types */
+  TypedComparator comparator_;
+  /** The children, if they read a column */
+  const ColumnValueExpression *lhs_column_;
+  const ColumnValueExpression *rhs_column_;
+  /** True if a column is compared with a VARCHAR constant, which is then held by constant_string_ unless it is NULL */
+  bool has_string_constant_{false};
+  std::optional<std::string> constant_string_;
+  /** The dictionary code of constant_string_ once it was found, NULL_CODE before */
+  mutable std::atomic<uint32_t> constant_code_{StringDictionary::NULL_CODE};
+  /** The size of the dictionary when constant_string_ was last missing from it */
+  mutable std::atomic<size_t> constant_missing_at_size_{0};
 };
 }  // namespace bustub
 
@@ -12,6 +12,8 @@
 
 #pragma once
 
+#include <algorithm>
+#include <iterator>
 #include <string>
 #include <utility>
 #include <vector>
@@ -57,6 +59,24 @@ class LogicExpression : public AbstractExpression {
     return ValueFactory::GetBooleanValue(PerformComputation(lhs, rhs));
   }
 
+  /** Select a batch by combining the selections of the children. */
+  void SelectBatch(const std::vector<Tuple> &tuples, const Schema &schema,
+                   std::vector<uint32_t> *selection) const override {
+    std::vector<uint32_t> lhs;
+    GetChildAt(0)->SelectBatch(tuples, schema, &lhs);
+    selection->clear();
+    if (logic_type_ == LogicType::And && lhs.empty()) {
+      return;
+    }
+    std::vector<uint32_t> rhs;
+    GetChildAt(1)->SelectBatch(tuples, schema, &rhs);
+    if (logic_type_ == LogicType::And) {
+      std::set_intersection(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), std::back_inserter(*selection));
+    } else {
+      std::set_union(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), std::back_inserter(*selection));
+    }
+  }
+
   /** @return the string representation of the expression node and its children */
   auto ToString() const -> std::string override {
     return fmt::format("({}{}{})", *GetChildAt(0), logic_type_, *GetChildAt(1));
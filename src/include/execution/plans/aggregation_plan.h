@@ -13,6 +13,7 @@
 #pragma once
 
 #include <memory>
+#include <optional>
 #include <string>
 #include <utility>
 #include <vector>
@@ -22,6 +23,7 @@
 #include "execution/plans/abstract_plan.h"
 #include "fmt/format.h"
 #include "storage/table/tuple.h"
+#include "type/type_kernels.h"
 
 namespace bustub {
 
@@ -96,6 +98,8 @@ class AggregationPlanNode : public AbstractPlanNode {
 struct AggregateKey {
   /** The group-by values */
   std::vector<Value> group_bys_;
+  /** The hash of the group-by values, if it was computed up front for a whole batch of keys */
+  std::optional<hash_t> hash_{};
 
   /**
    * Compares two aggregate keys for equality.
@@ -104,7 +108,16 @@ struct AggregateKey {
    */
   auto operator==(const AggregateKey &other) const -> bool {
     for (uint32_t i = 0; i < other.group_bys_.size(); i++) {
-      if (group_bys_[i].CompareEquals(other.group_bys_[i]) != CmpBool::CmpTrue) {
+      const auto &lhs = group_bys_[i];
+      const auto &rhs = other.group_bys_[i];
+      if (auto kernel = GetCompareKernel(lhs.GetTypeId(), rhs.GetTypeId());
+          kernel != nullptr && !lhs.IsNull() && !rhs.IsNull()) {
+        if (kernel(lhs, rhs) != 0) {
+          return false;
+        }
+        continue;
+      }
+      if (lhs.CompareEquals(rhs) != CmpBool::CmpTrue) {
         return false;
       }
     }
@@ -126,6 +139,9 @@ namespace std {
 template <>
 struct hash<bustub::AggregateKey> {
   auto operator()(const bustub::AggregateKey &agg_key) const -> std::size_t {
+    if (agg_key.hash_.has_value()) {
+      return *agg_key.hash_;
+    }
     size_t curr_hash = 0;
     for (const auto &key : agg_key.group_bys_) {
       if (!key.IsNull()) {
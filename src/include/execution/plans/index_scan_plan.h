@@ -12,14 +12,26 @@
 
 #pragma once
 
+#include <optional>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "catalog/catalog.h"
 #include "execution/expressions/abstract_expression.h"
 #include "execution/plans/abstract_plan.h"
 
 namespace bustub {
+
+/**
+ * One end of the range of an index scan: values for the leading key columns, which the range holds if inclusive_ is
+ * set. Keys that start with the values count as equal to the bound, whatever their other columns are.
+ */
+struct IndexScanBound {
+  std::vector<Value> values_;
+  bool inclusive_;
+};
+
 /**
  * IndexScanPlanNode identifies a table that should be scanned with an optional predicate.
  */
@@ -33,6 +45,25 @@ class IndexScanPlanNode : public AbstractPlanNode {
   IndexScanPlanNode(SchemaRef output, index_oid_t index_oid)
       : AbstractPlanNode(std::move(output), {}), index_oid_(index_oid) {}
 
+  /**
+   * Creates a new index scan plan node that only reads the index entries between lower and upper.
+   * @param output the output format of this scan plan node
+   * @param index_oid the identifier of the index to scan
+   * @param lower the lower bound of the range, or none to start at the first entry
+   * @param upper the upper bound of the range, or none to run to the last entry
+   * @param filter_predicate the predicate that the tuples in the range must satisfy, or null
+   * @param descending whether to produce the tuples in descending rather than ascending key order
+   */
+  IndexScanPlanNode(SchemaRef output, index_oid_t index_oid, std::optional<IndexScanBound> lower,
+                    std::optional<IndexScanBound> upper, AbstractExpressionRef filter_predicate,
+                    bool descending = false)
+      : AbstractPlanNode(std::move(output), {}),
+        index_oid_(index_oid),
+        lower_(std::move(lower)),
+        upper_(std::move(upper)),
+        filter_predicate_(std::move(filter_predicate)),
+        descending_(descending) {}
+
   auto GetType() const -> PlanType override { return PlanType::IndexScan; }
 
   /** @return the identifier of the table that should be scanned */
@@ -43,11 +74,55 @@ class IndexScanPlanNode : public AbstractPlanNode {
   /** The table whose tuples should be scanned. */
   index_oid_t index_oid_;
 
-  // Add anything you want here for index lookup
+  /** The bounds of the key range to scan, where a missing one leaves the range open on that side */
+  std::optional<IndexScanBound> lower_;
+  std::optional<IndexScanBound> upper_;
+
+  /** The predicate to check the tuples in the range against, the one the range was derived from */
+  AbstractExpressionRef filter_predicate_;
+
+  /** Whether the scan produces the tuples in descending key order */
+  bool descending_{false};
+
+  /**
+   * Whether the scan builds its tuples from the index keys alone, without fetching them from the table. Only the key
+   * columns are set, and the others are NULL, so the plans above must not read those.
+   */
+  bool index_only_{false};
 
  protected:
   auto PlanNodeToString() const -> std::string override {
-    return fmt::format("IndexScan {{ index_oid={} }}", index_oid_);
+    std::string options;
+    if (descending_) {
+      options += ", descending";
+    }
+    if (index_only_) {
+      options += ", index_only";
+    }
+    if (!lower_.has_value() && !upper_.has_value() && filter_predicate_ == nullptr) {
+      return fmt::format("IndexScan {{ index_oid={}{} }}", index_oid_, options);
+    }
+    auto bound_to_string = [](const std::optional<IndexScanBound> &bound, const char *infinity) -> std::string {
+      if (!bound.has_value()) {
+        return infinity;
+      }
+      if (bound->values_.size() == 1) {
+        return bound->values_[0].ToString();
+      }
+      std::vector<std::string> values;
+      for (const auto &value : bound->values_) {
+        values.push_back(value.ToString());
+      }
+      return fmt::format("({})", fmt::join(values, ", "));
+    };
+    std::string range = fmt::format("{}{}, {}{}", lower_.has_value() && lower_->inclusive_ ? "[" : "(",
+                                    bound_to_string(lower_, "-inf"), bound_to_string(upper_, "+inf"),
+                                    upper_.has_value() && upper_->inclusive_ ? "]" : ")");
+    range += options;
+    if (filter_predicate_ != nullptr) {
+      return fmt::format("IndexScan {{ index_oid={}, range={}, filter={} }}", index_oid_, range, filter_predicate_);
+    }
+    return fmt::format("IndexScan {{ index_oid={}, range={} }}", index_oid_, range);
   }
 };
 
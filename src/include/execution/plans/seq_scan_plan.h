@@ -57,8 +57,8 @@ class SeqScanPlanNode : public AbstractPlanNode {
   /** The table name */
   std::string table_name_;
 
-  /** The predicate to filter in seqscan. It will ALWAYS be nullptr until you enable the MergeFilterScan rule.
-      You don't need to handle it to get a perfect score as of in Fall 2022.
+  /** The predicate to filter in seqscan, folded in by the MergeFilterScan rule. The scan also uses it to skip pages
+      whose zone maps rule it out.
   */
   AbstractExpressionRef filter_predicate_;
 
@@ -85,6 +85,19 @@ class Optimizer {
    */
   auto OptimizeOrderByAsIndexScan(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef;
 
+  /**
+   * @brief optimize a filtered seq scan as an index scan over the key range that the filter allows, if there's an
+   * index on a column that the filter compares with constants, and the range fixes a key column by equality or is
+   * bounded on both ends
+   */
+  auto OptimizeSeqScanAsIndexScan(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef;
+
+  /**
+   * @brief make an index scan build its tuples from the index keys rather than fetch them from the table, if the
+   * columns that it and the plans above it read are all in the key
+   */
+  auto OptimizeIndexScanAsIndexOnlyScan(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef;
+
   /** @brief check if the index can be matched */
   auto MatchIndex(const std::string &table_name, uint32_t index_key_idx)
       -> std::optional<std::tuple<index_oid_t, std::string>>;
@@ -10,49 +10,102 @@
 //===----------------------------------------------------------------------===//
 #pragma once
 
+#include <deque>
+#include <functional>
+#include <mutex>  // NOLINT
+#include <optional>
 #include <queue>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "common/config.h"
+#include "common/rwlatch.h"
 #include "concurrency/transaction.h"
 #include "storage/index/index_iterator.h"
 #include "storage/page/b_plus_tree_internal_page.h"
 #include "storage/page/b_plus_tree_leaf_page.h"
+#include "storage/page/b_plus_tree_posting_page.h"
 
 namespace bustub {
 
 #define BPLUSTREE_TYPE BPlusTree<KeyType, ValueType, KeyComparator>
 
+/** How a BPlusTree synchronizes concurrent operations. */
+enum class BPlusTreeMode {
+  /** Latch crabbing with optimistic writers. */
+  LATCH_CRABBING,
+  /** Lehman-Yao B-link tree, whose readers never hold more than one latch and whose pages never merge. */
+  B_LINK
+};
+
 /**
  * Main class providing the API for the Interactive B+ Tree.
  *
  * Implementation of simple b+ tree data structure where internal pages direct
  * the search and leaf pages contain actual data.
- * (1) We only support unique key
+ * (1) Keys are unique, or, if the tree is created for duplicate keys, map to a set of values each
  * (2) support insert & remove
  * (3) The structure should shrink and grow dynamically
  * (4) Implement index iterator for range scan
+ *
+ * A key with several values is stored once, with a posting list of its values in its leaf entry, or in a chain of
+ * posting pages once the values are too many for the leaf (see BPlusTreeLeafPage). Since a key never spans two leaves,
+ * pages split and merge on keys whether or not they repeat.
+ *
+ * Keys are compressed within pages as BPlusTreePage describes, so pages split and merge by the bytes their entries
+ * take as well as by how many there are.
+ *
+ * Concurrency follows latch crabbing. root_latch_ guards root_page_id_, and is held until the root page is latched.
+ * Lookups descend with read latches, releasing each page once its child is latched. Insert and Remove first try an
+ * optimistic descent that read latches the internal pages and write latches only the leaf; if the leaf would split or
+ * underflow, they start over with a pessimistic descent that write latches the path, releasing the pages above any
+ * page that cannot split or underflow. Latches are taken top-down, and between siblings from left to right.
+ *
+ * In B_LINK mode, every page links to its right neighbour and carries a high key that bounds its keys from above.
+ * Operations descend holding one latch at a time: a page that was split after its parent was read no longer covers
+ * the key, so the operation moves right along the links until it reaches the page that does. A writer that splits a
+ * page keeps it latched while it latches the parent to insert the new separator, so latches are only ever taken
+ * upwards or to the right while holding another. Removing a key never merges pages, so pages never go away under
+ * an operation that is about to latch them.
  */
 INDEX_TEMPLATE_ARGUMENTS
 class BPlusTree {
   using InternalPage = BPlusTreeInternalPage<KeyType, page_id_t, KeyComparator>;
   using LeafPage = BPlusTreeLeafPage<KeyType, ValueType, KeyComparator>;
+  using PostingPage = BPlusTreePostingPage<ValueType>;
+
+  friend class IndexIterator<KeyType, ValueType, KeyComparator>;
 
  public:
   explicit BPlusTree(std::string name, BufferPoolManager *buffer_pool_manager, const KeyComparator &comparator,
-                     int leaf_max_size = LEAF_PAGE_SIZE, int internal_max_size = INTERNAL_PAGE_SIZE);
+                     int leaf_max_size = LEAF_PAGE_SIZE, int internal_max_size = INTERNAL_PAGE_SIZE,
+                     BPlusTreeMode mode = BPlusTreeMode::LATCH_CRABBING, bool unique = true);
+
+  ~BPlusTree();
 
   // Returns true if this B+ tree has no keys and values.
   auto IsEmpty() const -> bool;
 
   // Insert a key-value pair into this B+ tree.
+  // @return false if key is present in a unique tree, or the key-value pair is present in a tree with duplicate keys
   auto Insert(const KeyType &key, const ValueType &value, Transaction *transaction = nullptr) -> bool;
 
-  // Remove a key and its value from this B+ tree.
+  // Remove a key and all of its values from this B+ tree.
   void Remove(const KeyType &key, Transaction *transaction = nullptr);
 
-  // return the value associated with a given key
+  // Remove a key-value pair from this B+ tree, which removes the key along with its last value.
+  void Remove(const KeyType &key, const ValueType &value, Transaction *transaction = nullptr);
+
+  /**
+   * Build this empty tree bottom-up from the entries that next produces in key order, filling its pages to fill_factor
+   * of what they hold at most. Of several entries with the same key, a unique tree only keeps the first one, like
+   * Insert would, while a tree with duplicate keys keeps them all. Must not run concurrently with other operations on
+   * the tree.
+   */
+  void BulkLoad(const std::function<bool(MappingType *)> &next, double fill_factor = BPLUS_TREE_FILL_FACTOR);
+
+  // return the values associated with a given key, in ascending order
   auto GetValue(const KeyType &key, std::vector<ValueType> *result, Transaction *transaction = nullptr) -> bool;
 
   // return the page id of the root node
@@ -63,6 +116,17 @@ class BPlusTree {
   auto Begin(const KeyType &key) -> INDEXITERATOR_TYPE;
   auto End() -> INDEXITERATOR_TYPE;
 
+  /**
+   * Iterate over the entries with keys between lower and upper, where a missing bound leaves the range open on that
+   * side. The iterator reaches End by itself once it passes upper, without reading the leaves beyond.
+   */
+  auto Begin(const std::optional<IndexBound<KeyType>> &lower, const std::optional<IndexBound<KeyType>> &upper)
+      -> INDEXITERATOR_TYPE;
+
+  /** Like Begin(lower, upper), but iterate in descending key order, from upper down to lower. */
+  auto BeginReverse(const std::optional<IndexBound<KeyType>> &lower, const std::optional<IndexBound<KeyType>> &upper)
+      -> INDEXITERATOR_TYPE;
+
   // print the B+ tree
   void Print(BufferPoolManager *bpm);
 
@@ -75,14 +139,237 @@ class BPlusTree {
   // read data from file and remove one by one
   void RemoveFromFile(const std::string &file_name, Transaction *transaction = nullptr);
 
-  //custom added
-  auto FindChildPageId(const KeyType &key, Page* node_page) -> page_id_t;
-  auto InsertInLeaf(const KeyType &key, const ValueType &value, BPlusTreeLeafPage<KeyType, ValueType, KeyComparator>* leaf_node) -> bool; 
-  auto InsertInParent(BPlusTreePage* node, const KeyType &key, BPlusTreePage* node_extra) -> bool;
-  auto FindLeaf(const KeyType &key)-> Page*;
-  
-  
  private:
+  enum class Operation { INSERT, REMOVE };
+
+  /** The pages a pessimistic operation holds write latches on, from the highest one down to the current one */
+  struct LatchedPath {
+    /** Whether the operation holds root_latch_ */
+    bool root_latched_{false};
+    /** Whether pages_[0] is the root */
+    bool top_is_root_{true};
+    std::vector<Page *> pages_;
+    /** The pages to delete once all latches are released */
+    std::vector<page_id_t> deleted_pages_;
+  };
+
+  /**
+   * Delete a page that left the tree. If an iterator still holds it pinned, the page is kept in deferred_deletes_ until
+   * the pin goes away.
+   */
+  void DeleteNode(page_id_t page_id);
+
+  /** Retry the deletes that were deferred because their pages were pinned. */
+  void DeleteDeferredNodes();
+
+  /** Unpin the page an iterator held pinned, which may have left the tree meanwhile. */
+  void UnpinIteratorPage(page_id_t page_id);
+
+  /** @return the pinned page, throwing if the buffer pool has no frame for it */
+  auto FetchNode(page_id_t page_id) -> Page *;
+
+  /** @return a new pinned page, throwing if the buffer pool has no frame for it */
+  auto NewNode(page_id_t *page_id) -> Page *;
+
+  /**
+   * Descend to the leaf that holds key, or to the leftmost leaf if key is null, with read latch crabbing.
+   * @return the pinned leaf, write latched if write_leaf is set and read latched otherwise, or nullptr if the tree is
+   * empty
+   */
+  auto FindLeaf(const KeyType *key, bool write_leaf) -> Page *;
+
+  /**
+   * Descend to the leaf that holds key with write latch crabbing. root_latch_ must be write locked and the tree must
+   * not be empty. Afterwards path holds the pages that op may have to modify, down to the leaf.
+   */
+  void FindLeafPessimistic(const KeyType &key, Operation op, LatchedPath *path);
+
+  /** @return whether op on a descendant of node can not make node split or underflow */
+  auto IsSafe(const BPlusTreePage *node, Operation op, bool is_root) const -> bool;
+
+  /** @return whether node is at least half full by entries or by bytes once removed of its entries are removed */
+  auto IsHalfFull(const BPlusTreePage *node, int removed) const -> bool;
+
+  /** Release the latches on all pages of path but the last one, and root_latch_. */
+  void ReleaseAncestors(LatchedPath *path);
+
+  /** Release all latches of path, and delete the pages it collected. */
+  void ReleasePath(LatchedPath *path);
+
+  auto InsertPessimistic(const KeyType &key, const ValueType &value) -> bool;
+
+  /** Remove value from key, or key with its only value if value is null. */
+  void RemoveValue(const KeyType &key, const ValueType *value);
+  void RemovePessimistic(const KeyType &key, const ValueType *value);
+
+  /** Insert (key, value) into the write latched leaf, which must have room for another entry. @return like Insert */
+  auto InsertIntoLeaf(LeafPage *leaf, const KeyType &key, const ValueType &value) -> bool;
+
+  /** Remove value from key, or key with its only value if value is null, from the write latched leaf. @return whether
+   * the leaf held them */
+  auto RemoveFromLeaf(LeafPage *leaf, const KeyType &key, const ValueType *value) -> bool;
+
+  /*
+   * Posting pages, which are only accessed while the leaf holding their key is latched
+   */
+
+  /** Append the values of the key at index of the latched leaf to values, in ascending order. */
+  void ReadValues(const LeafPage *leaf, int index, std::vector<ValueType> *values);
+
+  /** Move the values of posting, which are in ascending order, into a new chain of posting pages. */
+  void WritePostingPages(LeafPosting<ValueType> *posting);
+
+  /** Insert value into the posting pages of posting, which may change its last page. @return false if they hold it */
+  auto InsertIntoPostingPages(LeafPosting<ValueType> *posting, const ValueType &value) -> bool;
+
+  /**
+   * Remove value from the posting pages of posting, merging a page into its neighbour once their values fit onto one,
+   * so that posting has no first page once the last value is gone. @return false if they do not hold value
+   */
+  auto RemoveFromPostingPages(LeafPosting<ValueType> *posting, const ValueType &value) -> bool;
+
+  /** Make a leaf holding (key, value) the root of this empty tree. */
+  void StartNewTree(const KeyType &key, const ValueType &value);
+
+  /** Insert new_page_id, which was split from the page at path->pages_[level], into the parent of that page. */
+  void InsertIntoParent(LatchedPath *path, size_t level, const KeyType &key, page_id_t new_page_id);
+
+  /** Merge or redistribute the page at path->pages_[level] with a sibling if it holds too few entries. */
+  void HandleUnderflow(LatchedPath *path, size_t level);
+
+  /**
+   * Copy the entries of the leaf holding key that are not less than key, or greater than key if inclusive is not set,
+   * and not beyond the upper bound of itr, into itr, moving on to the next leaves while there are none. All entries
+   * of the leftmost leaf are copied if key is null. If later leaves may hold entries within the bound, the next leaf
+   * is left pinned in itr.
+   */
+  void CopyLeaf(const KeyType *key, bool inclusive, INDEXITERATOR_TYPE *itr);
+
+  /**
+   * CopyLeaf for the entries greater than last_key, starting at the leaf that itr holds pinned if that still follows
+   * the one last_key came from.
+   */
+  void CopyNextLeaf(const KeyType &last_key, INDEXITERATOR_TYPE *itr);
+
+  /** CopyLeaf starting at page, a read latched and pinned leaf, which is unlatched and unpinned afterwards. */
+  void CopyFromLeaf(Page *page, const KeyType *key, bool inclusive, INDEXITERATOR_TYPE *itr);
+
+  /** Copy the key at index of the latched leaf into itr once for each of its values, in descending order if reverse. */
+  void CopyEntry(const LeafPage *leaf, int index, bool reverse, INDEXITERATOR_TYPE *itr);
+
+  /**
+   * Copy the entries of the leaf holding key that are not greater than key, or less than key if inclusive is not set,
+   * and not beyond the lower bound of itr, into itr in descending order, moving on to the previous leaves while there
+   * are none. All entries of the rightmost leaf are copied if key is null.
+   */
+  void CopyLeafReverse(const KeyType *key, bool inclusive, INDEXITERATOR_TYPE *itr);
+
+  /** @return whether there is a key less than key, which then goes to preceding as the greatest such key */
+  static auto PrecedingKey(const KeyType &key, KeyType *preceding) -> bool;
+
+  /*
+   * Bulk loading
+   */
+
+  using InternalEntry = std::pair<KeyType, page_id_t>;
+
+  /** A level of the tree that BulkLoad builds from left to right */
+  template <typename EntryType>
+  struct BulkLevel {
+    BulkLevel(int max_size, int capacity, int fill_size, double fill_factor)
+        : max_size_(max_size), capacity_(capacity), fill_size_(fill_size), fill_factor_(fill_factor) {}
+
+    /**
+     * The max size of the pages, the most entries they hold at rest, how many entries BulkLoad gives them, and how
+     * full it fills them by bytes
+     */
+    int max_size_;
+    int capacity_;
+    int fill_size_;
+    double fill_factor_;
+    /** The entries that were not written to a page yet */
+    std::vector<EntryType> pending_;
+    /** The low key of the next page, which is all zeros for the first one */
+    KeyType low_key_{};
+    /** The last page written, which stays pinned until the next page of the level is linked to it */
+    Page *last_page_{nullptr};
+    int num_pages_{0};
+  };
+
+  /** The internal levels that BulkLoad builds, from the lowest one up */
+  struct BulkParents {
+    int fill_size_;
+    double fill_factor_;
+    std::deque<BulkLevel<InternalEntry>> levels_;
+  };
+
+  /** @return the key that separates a page of PageType ending with left from the next page, starting with right */
+  template <typename PageType>
+  static auto BulkSeparator(const KeyType &left, const KeyType &right) -> KeyType;
+
+  /** @return the number of bytes that entry takes in a page of PageType whose keys share prefix_size bytes */
+  template <typename PageType, typename EntryType>
+  static auto BulkEntrySize(const EntryType &entry, int prefix_size) -> int;
+
+  /** Add entry to the leaf level, moving its values into posting pages first if there are too many to keep inline. */
+  void BulkAppendLeafEntry(BulkLevel<LeafEntryType> *leaves, LeafEntryType *entry, BulkParents *parents);
+
+  /**
+   * @return how many of the pending entries of level from begin on go into a page bounded below by low_key, taking at
+   * most max_count entries and fill_factor of the bytes the page holds, but at least one entry
+   */
+  template <typename PageType, typename EntryType>
+  static auto BulkPageSize(const BulkLevel<EntryType> &level, size_t begin, const KeyType &low_key, int max_count,
+                           double fill_factor) -> int;
+
+  /** Add entry to level, writing a page once enough entries are pending. */
+  template <typename PageType, typename EntryType>
+  void BulkAppend(BulkLevel<EntryType> *level, const EntryType &entry, size_t height, BulkParents *parents);
+
+  /**
+   * Write the first size pending entries of level to a new page, linking it to the previous page of the level, and
+   * add it to the level above, whose index in parents is height, unless parents is null. @return the new page
+   */
+  template <typename PageType, typename EntryType>
+  auto BulkWritePage(BulkLevel<EntryType> *level, int size, size_t height, BulkParents *parents) -> page_id_t;
+
+  /**
+   * Write the pending entries of level, splitting them over two pages if they do not fit into one or if the level has
+   * pages already, so that no page holds fewer than the min size, and over more pages if their bytes take more than
+   * two. @return the page, if the level is the root level, or INVALID_PAGE_ID
+   */
+  template <typename PageType, typename EntryType>
+  auto BulkFinishLevel(BulkLevel<EntryType> *level, size_t height, BulkParents *parents) -> page_id_t;
+
+  /*
+   * B-link mode
+   */
+
+  /**
+   * Descend to the leaf that holds key, or to the leftmost leaf if key is null, holding one latch at a time.
+   * If path is not null, it receives the internal pages the descent went down from, top-down.
+   * @return the pinned leaf, latched like FindLeaf does, or nullptr if the tree is empty
+   */
+  auto FindLeafBLink(const KeyType *key, bool write_leaf, std::vector<page_id_t> *path) -> Page *;
+
+  /** @return the page that covers key, starting at the latched page and following the links to the right */
+  auto MoveRight(Page *page, const KeyType &key, bool exclusive) -> Page *;
+
+  /** @return whether key is not less than the high key of node, so that it belongs to a page further right */
+  auto IsBeyondHighKey(const BPlusTreePage *node, const KeyType &key) const -> bool;
+
+  auto InsertBLink(const KeyType &key, const ValueType &value) -> bool;
+  void RemoveBLink(const KeyType &key, const ValueType *value);
+
+  /**
+   * Insert new_page_id, which was split from the write latched page, into the parent of page, splitting ancestors as
+   * needed. path holds the ancestors the descent to page went through. Releases page.
+   */
+  void InsertIntoParentBLink(Page *page, const KeyType &key, page_id_t new_page_id, std::vector<page_id_t> *path);
+
+  /** @return the write latched parent of the page child_page_id, which covers key, searching down from root_page_id */
+  auto FindParentBLink(page_id_t root_page_id, page_id_t child_page_id, const KeyType &key) -> Page *;
+
   void UpdateRootPageId(int insert_record = 0);
 
   /* Debug Routines for FREE!! */
@@ -90,14 +377,21 @@ class BPlusTree {
 
   void ToString(BPlusTreePage *page, BufferPoolManager *bpm) const;
 
-  
   // member variable
   std::string index_name_;
   page_id_t root_page_id_;
+  /** Guards root_page_id_ */
+  mutable ReaderWriterLatch root_latch_;
   BufferPoolManager *buffer_pool_manager_;
   KeyComparator comparator_;
   int leaf_max_size_;
   int internal_max_size_;
+  BPlusTreeMode mode_;
+  /** Whether a key maps to a single value, rather than to a set of them */
+  bool unique_;
+  /** Pages that left the tree while they were pinned, to delete once they are not */
+  std::vector<page_id_t> deferred_deletes_;
+  std::mutex deferred_deletes_latch_;
 };
 
 }  // namespace bustub
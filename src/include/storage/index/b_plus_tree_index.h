@@ -13,12 +13,17 @@
 
 #include <map>
 #include <memory>
+#include <optional>
 #include <string>
+#include <type_traits>
 #include <vector>
 
+#include "common/exception.h"
 #include "container/hash/hash_function.h"
+#include "fmt/format.h"
 #include "storage/index/b_plus_tree.h"
 #include "storage/index/index.h"
+#include "storage/table/table_heap.h"
 
 namespace bustub {
 
@@ -35,20 +40,61 @@ class BPlusTreeIndex : public Index {
 
   void ScanKey(const Tuple &key, std::vector<RID> *result, Transaction *transaction) override;
 
+  /**
+   * Index all rows of table_heap, a table of table_schema, in this empty index. Rather than inserting the rows one by
+   * one, the entries are sorted, spilling to disk if they do not fit into memory, and the tree is built bottom-up
+   * with its pages filled to fill_factor.
+   */
+  void BulkLoad(TableHeap *table_heap, const Schema &table_schema, Transaction *transaction,
+                double fill_factor = BPLUS_TREE_FILL_FACTOR);
+
   auto GetBeginIterator() -> INDEXITERATOR_TYPE;
 
   auto GetBeginIterator(const KeyType &key) -> INDEXITERATOR_TYPE;
 
   auto GetEndIterator() -> INDEXITERATOR_TYPE;
 
+  /** @return an iterator over the entries with keys between lower and upper, which ends by itself past upper */
+  auto GetRangeIterator(const std::optional<IndexBound<KeyType>> &lower,
+                        const std::optional<IndexBound<KeyType>> &upper) -> INDEXITERATOR_TYPE;
+
+  /** @return an iterator over the same entries as GetRangeIterator, in descending key order */
+  auto GetReverseRangeIterator(const std::optional<IndexBound<KeyType>> &lower,
+                               const std::optional<IndexBound<KeyType>> &upper) -> INDEXITERATOR_TYPE;
+
  protected:
+  BufferPoolManager *buffer_pool_manager_;
   // comparator for key
   KeyComparator comparator_;
   // container
   BPlusTree<KeyType, ValueType, KeyComparator> container_;
 };
 
-/** We only support index table with one integer key for now in BusTub. Hardcode everything here. */
+/**
+ * B+ tree indexes are instantiated for keys of 4, 8, 16, 32 and 64 bytes. Call f with the std::integral_constant of
+ * the smallest of those sizes that holds key_size bytes, throwing if none does.
+ */
+template <typename F>
+auto DispatchGenericKeySize(size_t key_size, F &&f) {
+  if (key_size <= 4) {
+    return f(std::integral_constant<size_t, 4>{});
+  }
+  if (key_size <= 8) {
+    return f(std::integral_constant<size_t, 8>{});
+  }
+  if (key_size <= 16) {
+    return f(std::integral_constant<size_t, 16>{});
+  }
+  if (key_size <= 32) {
+    return f(std::integral_constant<size_t, 32>{});
+  }
+  if (key_size <= 64) {
+    return f(std::integral_constant<size_t, 64>{});
+  }
+  throw NotImplementedException(fmt::format("index keys of up to {} bytes are wider than 64 bytes", key_size));
+}
+
+/** The types of an index on one integer column, the key type of the indexes the starter code used. */
 
 constexpr static const auto INTEGER_SIZE = 4;
 using IntegerKeyType = GenericKey<INTEGER_SIZE>;
@@ -12,10 +12,14 @@
 
 #pragma once
 
+#include <cstdint>
 #include <cstring>
+#include <vector>
 
+#include "storage/index/key_encoding.h"
 #include "storage/table/tuple.h"
 #include "type/value.h"
+#include "type/value_factory.h"
 
 namespace bustub {
 
@@ -25,39 +29,49 @@ namespace bustub {
  * This key type uses an fixed length array to hold data for indexing
  * purposes, the actual size of which is specified and instantiated
  * with a template argument.
+ *
+ * The key is stored in the memcomparable encoding of key_encoding.h, padded with zeros, so keys order like their bytes.
  */
 template <size_t KeySize>
 class GenericKey {
  public:
-  inline void SetFromKey(const Tuple &tuple) {
+  inline void SetFromKey(const Tuple &tuple, const Schema *key_schema) {
     // intialize to 0
     memset(data_, 0, KeySize);
-    memcpy(data_, tuple.GetData(), tuple.GetLength());
+    EncodeKey(tuple, key_schema, data_, KeySize);
+  }
+
+  /**
+   * Encode values as the leading columns of a key and fill the rest with pad. Padding with 0x00 makes the smallest key
+   * that starts with values, and padding with 0xFF the greatest one.
+   */
+  inline void SetFromPrefix(const std::vector<Value> &values, char pad) {
+    size_t size = 0;
+    for (const auto &value : values) {
+      size += EncodeKeyValue(value, data_ + size, KeySize - size);
+    }
+    memset(data_ + size, pad, KeySize - size);
   }
 
   // NOTE: for test purpose only
   inline void SetFromInteger(int64_t key) {
     memset(data_, 0, KeySize);
-    memcpy(data_, &key, sizeof(int64_t));
+    EncodeKeyValue(ValueFactory::GetBigIntValue(key), data_, KeySize);
   }
 
   inline auto ToValue(Schema *schema, uint32_t column_idx) const -> Value {
-    const char *data_ptr;
-    const auto &col = schema->GetColumn(column_idx);
-    const TypeId column_type = col.GetType();
-    const bool is_inlined = col.IsInlined();
-    if (is_inlined) {
-      data_ptr = (data_ + col.GetOffset());
-    } else {
-      int32_t offset = *reinterpret_cast<int32_t *>(const_cast<char *>(data_ + col.GetOffset()));
-      data_ptr = (data_ + offset);
-    }
-    return Value::DeserializeFrom(data_ptr, column_type);
+    return DecodeKeyColumn(data_, KeySize, schema, column_idx);
   }
 
   // NOTE: for test purpose only
-  // interpret the first 8 bytes as int64_t from data vector
-  inline auto ToString() const -> int64_t { return *reinterpret_cast<int64_t *>(const_cast<char *>(data_)); }
+  // interpret the first 8 bytes as an encoded int64_t from data vector
+  inline auto ToString() const -> int64_t {
+    uint64_t bits = 0;
+    for (size_t i = 0; i < sizeof(int64_t); i++) {
+      bits = (bits << 8) | static_cast<uint8_t>(data_[i]);
+    }
+    return static_cast<int64_t>(bits ^ (uint64_t{1} << 63));
+  }
 
   // NOTE: for test purpose only
   // interpret the first 8 bytes as int64_t from data vector
@@ -72,33 +86,25 @@ class GenericKey {
 
 /**
  * Function object returns true if lhs < rhs, used for trees
+ *
+ * Keys are memcomparable, so comparing them is a single memcmp over the key bytes.
  */
 template <size_t KeySize>
 class GenericComparator {
  public:
   inline auto operator()(const GenericKey<KeySize> &lhs, const GenericKey<KeySize> &rhs) const -> int {
-    uint32_t column_count = key_schema_->GetColumnCount();
-
-    for (uint32_t i = 0; i < column_count; i++) {
-      Value lhs_value = (lhs.ToValue(key_schema_, i));
-      Value rhs_value = (rhs.ToValue(key_schema_, i));
-
-      if (lhs_value.CompareLessThan(rhs_value) == CmpBool::CmpTrue) {
-        return -1;
-      }
-      if (lhs_value.CompareGreaterThan(rhs_value) == CmpBool::CmpTrue) {
-        return 1;
-      }
-    }
-    // equals
-    return 0;
+    int cmp = memcmp(lhs.data_, rhs.data_, KeySize);
+    return static_cast<int>(cmp > 0) - static_cast<int>(cmp < 0);
   }
 
-  GenericComparator(const GenericComparator &other) : key_schema_{other.key_schema_} {}
+  GenericComparator(const GenericComparator &other) = default;
 
   // constructor
   explicit GenericComparator(Schema *key_schema) : key_schema_(key_schema) {}
 
+  /** @return the schema of the keys */
+  inline auto GetKeySchema() const -> Schema * { return key_schema_; }
+
  private:
   Schema *key_schema_;
 };
@@ -0,0 +1,125 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// index_build_sorter.h
+//
+// Identification: src/include/storage/index/index_build_sorter.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <functional>
+#include <utility>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "common/config.h"
+#include "common/macros.h"
+#include "storage/page/b_plus_tree_leaf_page.h"
+#include "storage/page/overflow_page.h"
+
+namespace bustub {
+
+#define INDEX_BUILD_SORTER_TYPE IndexBuildSorter<KeyType, ValueType, KeyComparator>
+
+/**
+ * IndexBuildSorter sorts the entries of an index that is being built, so that the tree can be loaded bottom-up.
+ *
+ * Entries are collected in memory up to a budget. Each time the budget fills up, the entries are sorted and spilled as
+ * a run into a chain of overflow pages, which the buffer pool writes out to disk when it needs their frames. Finish()
+ * merges the runs in passes until few enough are left to merge them all at once, and Next() then returns the entries
+ * of that last merge. If everything fits into memory, nothing is spilled. Entries with equal keys come out in the
+ * order they were added.
+ *
+ *   IndexBuildSorter<KeyType, ValueType, KeyComparator> sorter(bpm, comparator);
+ *   for (...) {
+ *     sorter.Add(key, value);
+ *   }
+ *   sorter.Finish();
+ *   while (sorter.Next(&entry)) { ... }
+ */
+INDEX_TEMPLATE_ARGUMENTS
+class IndexBuildSorter {
+ public:
+  /**
+   * @param buffer_pool_manager the buffer pool the runs are spilled to
+   * @param comparator the comparator of the keys
+   * @param memory_limit the number of bytes of entries to sort in memory at a time
+   */
+  IndexBuildSorter(BufferPoolManager *buffer_pool_manager, const KeyComparator &comparator,
+                   size_t memory_limit = INDEX_BUILD_MEMORY);
+
+  /** Free the pages of the runs that were not read to the end. */
+  ~IndexBuildSorter();
+
+  DISALLOW_COPY_AND_MOVE(IndexBuildSorter);
+
+  /** Add an entry. Must not be called after Finish(). */
+  void Add(const KeyType &key, const ValueType &value);
+
+  /** Sort the entries added so far, which Next() then returns. */
+  void Finish();
+
+  /** Store the next entry in key order in entry. @return false if there are no more entries */
+  auto Next(MappingType *entry) -> bool;
+
+  /** @return the number of runs that were spilled, including the ones written by intermediate merges */
+  auto GetNumSpilledRuns() const -> size_t { return num_spilled_runs_; }
+
+ private:
+  /** The position of a merge in a run, which keeps the page it reads pinned */
+  struct RunReader {
+    page_id_t page_id_{INVALID_PAGE_ID};
+    OverflowPage *page_{nullptr};
+    uint32_t offset_{0};
+  };
+
+  /** The next entry of a run being merged, and the index of the run */
+  using HeapEntry = std::pair<MappingType, size_t>;
+
+  /** The size of an entry in a run */
+  static constexpr uint32_t ENTRY_SIZE = sizeof(KeyType) + sizeof(ValueType);
+
+  /** Sort the entries in memory and spill them as a new run. */
+  void SpillBuffer();
+
+  /** Write the entries that next produces into a new run. @return the first page of the run */
+  auto WriteRun(const std::function<bool(MappingType *)> &next) -> page_id_t;
+
+  /** Start merging the runs runs_[begin, end). */
+  void OpenMerge(size_t begin, size_t end);
+
+  /** Store the next entry of the open merge in entry. @return false if the merged runs are exhausted */
+  auto NextMerged(MappingType *entry) -> bool;
+
+  /** @return whether a comes out of the merge after b; of two equal keys, the one of the earlier run comes first */
+  auto IsMergedAfter(const HeapEntry &a, const HeapEntry &b) const -> bool;
+
+  /** Read the next entry of the run of reader into entry, freeing each page once it was read. */
+  auto ReadRun(RunReader *reader, MappingType *entry) -> bool;
+
+  /** Unpin the page of reader, and free it and the rest of its run. */
+  void CloseRun(RunReader *reader);
+
+  BufferPoolManager *buffer_pool_manager_;
+  KeyComparator comparator_;
+  /** The number of entries sorted in memory at a time */
+  size_t buffer_capacity_;
+  /** The number of runs merged at once, which is the number of run pages a merge keeps pinned */
+  size_t max_fan_in_;
+  std::vector<MappingType> buffer_;
+  /** The first pages of the spilled runs, in the order their entries were added */
+  std::vector<page_id_t> runs_;
+  size_t num_spilled_runs_{0};
+  bool finished_{false};
+  /** The position of Next() in buffer_, if nothing was spilled */
+  size_t buffer_index_{0};
+
+  /** The runs being merged, and the next entry of each of them ordered by key and then by run */
+  std::vector<RunReader> readers_;
+  std::vector<HeapEntry> heap_;
+};
+
+}  // namespace bustub
@@ -13,17 +13,49 @@
  * For range scan of b+ tree
  */
 #pragma once
+#include <optional>
+#include <vector>
+
 #include "storage/page/b_plus_tree_leaf_page.h"
 
 namespace bustub {
 
 #define INDEXITERATOR_TYPE IndexIterator<KeyType, ValueType, KeyComparator>
 
+INDEX_TEMPLATE_ARGUMENTS
+class BPlusTree;
+
+/** One end of a key range, which holds the key itself if inclusive_ is set */
+template <typename KeyType>
+struct IndexBound {
+  KeyType key_;
+  bool inclusive_{true};
+};
+
+/**
+ * IndexIterator walks the entries of a B+ tree in key order, up to an optional upper bound. It works on a copy of the
+ * entries of the current leaf, so it holds no latch between calls, and concurrent writers may restructure the tree
+ * under it. While the copy is consumed, the next leaf stays pinned, so that the iterator can go on from there without
+ * descending from the root. If that leaf no longer follows the copied one, because entries moved out of it or it was
+ * merged away, the next entries are found by descending to the last key seen again. Either way an iterator sees every
+ * key that stays in the tree while it runs, each key once.
+ *
+ * A reverse iterator walks the entries in descending key order, down to an optional lower bound. Leaves only link to
+ * the right, so it finds each previous leaf by descending to the greatest key below the low key of the copied one.
+ */
 INDEX_TEMPLATE_ARGUMENTS
 class IndexIterator {
+  friend class BPlusTree<KeyType, ValueType, KeyComparator>;
+
  public:
-  // you may define your own constructor based on your member variables
+  /** Construct the end iterator. */
   IndexIterator();
+  IndexIterator(BPlusTree<KeyType, ValueType, KeyComparator> *tree, std::optional<IndexBound<KeyType>> lower,
+                std::optional<IndexBound<KeyType>> upper);
+  IndexIterator(const IndexIterator &) = delete;
+  IndexIterator(IndexIterator &&other) noexcept;
+  auto operator=(const IndexIterator &) -> IndexIterator & = delete;
+  auto operator=(IndexIterator &&other) noexcept -> IndexIterator &;
   ~IndexIterator();  // NOLINT
 
   auto IsEnd() -> bool;
@@ -32,12 +64,33 @@ class IndexIterator {
 
   auto operator++() -> IndexIterator &;
 
-  auto operator==(const IndexIterator &itr) const -> bool { throw std::runtime_error("unimplemented"); }
+  /**
+   * Append the values from the current entry to the end of the copied leaf to values, and move on to the next leaf.
+   * @return false if the iterator was at its end already
+   */
+  auto NextBatch(std::vector<ValueType> *values) -> bool;
+
+  /** Like NextBatch on values, but append the entries, keys included. */
+  auto NextBatch(std::vector<MappingType> *entries) -> bool;
+
+  auto operator==(const IndexIterator &itr) const -> bool;
 
-  auto operator!=(const IndexIterator &itr) const -> bool { throw std::runtime_error("unimplemented"); }
+  auto operator!=(const IndexIterator &itr) const -> bool { return !(*this == itr); }
 
  private:
-  // add your own private member variables here
+  BPlusTree<KeyType, ValueType, KeyComparator> *tree_{nullptr};
+  /** The entries copied from the current leaf, starting at the first one the iterator visits */
+  std::vector<MappingType> entries_;
+  size_t index_{0};
+  /** The bounds past which the iterator ends, where a missing one lets it run to the end of the tree */
+  std::optional<IndexBound<KeyType>> lower_;
+  std::optional<IndexBound<KeyType>> upper_;
+  /** The leaf after the copied one, pinned, or null if no later leaf holds entries within upper_ */
+  Page *next_page_{nullptr};
+  /** The high key of the copied leaf, which the low key of the next leaf must still equal for the scan to go on there */
+  KeyType next_low_key_{};
+  /** Whether this is a reverse iterator and leaves to the left of the copied one may hold entries within lower_ */
+  bool has_prev_leaf_{false};
 };
 
 }  // namespace bustub
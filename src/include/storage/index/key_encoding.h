@@ -0,0 +1,73 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// key_encoding.h
+//
+// Identification: src/include/storage/index/key_encoding.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "catalog/schema.h"
+#include "storage/table/tuple.h"
+#include "type/value.h"
+
+namespace bustub {
+
+/*
+ * Memcomparable key encoding.
+ *
+ * Index keys are stored in an order-preserving binary form, so two keys compare the same way as their bytes do under
+ * memcmp, and a key comparison never has to deserialize a Value. The columns are encoded one after another:
+ *
+ *  - Integers are stored big-endian with the sign bit flipped, so negative numbers sort before positive ones.
+ *  - DECIMAL flips the sign bit of positive numbers and all the bits of negative ones, then stores them big-endian.
+ *  - TIMESTAMP is stored big-endian.
+ *  - VARCHAR stores its bytes with every 0x00 escaped as 0x00 0xFF, followed by the terminator 0x00 0x01, which keeps
+ *    a string from comparing against the column after a shorter one. Dictionary-encoded columns store the string, not
+ *    the code, as codes are not ordered like their strings.
+ *
+ * A NULL fixed-width value keeps its sentinel, which encodes as the smallest value of the type except for TIMESTAMP,
+ * and a NULL VARCHAR is stored as 0x00 0x00. So unlike Value comparisons, NULL compares equal to NULL only, which is
+ * what a total order over the keys of an index needs.
+ */
+
+/**
+ * Encode the columns of `key` into `out`.
+ * @param key a tuple of `key_schema`
+ * @param size the size of `out`; the encoding throws if it does not fit
+ * @return the number of bytes written
+ */
+auto EncodeKey(const Tuple &key, const Schema *key_schema, char *out, size_t size) -> size_t;
+
+/**
+ * @return the most bytes that EncodeKey writes for a key of `key_schema`. A VARCHAR column counts its declared length
+ * and the terminator, as strings from SQL hold no 0x00 bytes to escape; a longer string fails to encode.
+ */
+auto MaxEncodedKeySize(const Schema *key_schema) -> size_t;
+
+/**
+ * Encode a single value into `out`.
+ * @return the number of bytes written
+ */
+auto EncodeKeyValue(const Value &value, char *out, size_t size) -> size_t;
+
+/**
+ * Decode one column of a key encoded by EncodeKey. Dictionary-encoded columns decode to their string.
+ * @param size the size of `data`
+ */
+auto DecodeKeyColumn(const char *data, size_t size, const Schema *key_schema, uint32_t column_idx) -> Value;
+
+/**
+ * Decode all the columns of a key encoded by EncodeKey, in a single pass over it.
+ * @param size the size of `data`
+ */
+auto DecodeKey(const char *data, size_t size, const Schema *key_schema) -> std::vector<Value>;
+
+}  // namespace bustub
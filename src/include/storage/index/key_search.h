@@ -0,0 +1,68 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// key_search.h
+//
+// Identification: src/include/storage/index/key_search.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+namespace bustub {
+
+/**
+ * The number of keys that KeySearch leaves to CountKeysBelow once its binary search has narrowed them down this far.
+ */
+static constexpr int KEY_SEARCH_WINDOW = 16;
+
+/**
+ * The keys of a B+ tree page are stored as entries that start with the size of the stored part of the key, one byte,
+ * followed by that part. Stored parts compare bytewise, the shorter one padded with zeros.
+ *
+ * @return the stored part of the entry at offset, and its size
+ */
+inline auto EntryKey(const char *page, uint16_t offset, int *size) -> const char * {
+  *size = static_cast<uint8_t>(page[offset]);
+  return page + offset + 1;
+}
+
+/** @return a negative number, zero, or a positive number if the stored key a is less than, equal to or greater than b */
+inline auto CompareStoredKeys(const char *a, int a_size, const char *b, int b_size) -> int {
+  int cmp = memcmp(a, b, std::min(a_size, b_size));
+  // Stored keys end with a byte that is not zero, so of two keys that agree up to the shorter one, the longer one is
+  // greater.
+  return cmp != 0 ? cmp : a_size - b_size;
+}
+
+/**
+ * Count the keys below key among the size entries at the offsets into page. The stored keys are at most 8 bytes, and
+ * compared as big-endian unsigned integers, eight bytes at a time from the start of each key. The page must have at
+ * least 8 bytes after the start of the last key. The keys are compared four at a time with AVX2 where the CPU has it.
+ *
+ * @param key the key to compare with, as a native integer
+ * @param inclusive whether to count the keys equal to key as well
+ */
+auto CountKeysBelow(const char *page, const uint16_t *offsets, int size, uint64_t key, bool inclusive) -> int;
+
+/**
+ * Binary search the size entries at the offsets into page, which are in key order.
+ *
+ * If no stored key is longer than 8 bytes, keys are compared as integers, and once a few keys are left, they are
+ * compared all at once by CountKeysBelow.
+ *
+ * @param key the stored part of the key to search for, of key_size bytes
+ * @param width the size of the longest key that can be stored in the page
+ * @param upper whether to skip the keys equal to key
+ * @return the index of the first key not less than key, or greater than key if upper is set, which is size if there
+ * is none
+ */
+auto KeySearch(const char *page, const uint16_t *offsets, int size, const char *key, int key_size, int width,
+               bool upper) -> int;
+
+}  // namespace bustub
@@ -18,8 +18,9 @@
 namespace bustub {
 
 #define B_PLUS_TREE_INTERNAL_PAGE_TYPE BPlusTreeInternalPage<KeyType, ValueType, KeyComparator>
-#define INTERNAL_PAGE_HEADER_SIZE 24
-#define INTERNAL_PAGE_SIZE ((BUSTUB_PAGE_SIZE - INTERNAL_PAGE_HEADER_SIZE) / (sizeof(MappingType)))
+#define INTERNAL_PAGE_HEADER_SIZE (32 + 2 * sizeof(KeyType))
+#define INTERNAL_PAGE_SIZE \
+  ((BUSTUB_PAGE_SIZE - sizeof(uint64_t) - INTERNAL_PAGE_HEADER_SIZE) / (sizeof(uint16_t) + 1 + sizeof(ValueType)))
 /**
  * Store n indexed keys and n+1 child pointers (page_id) within internal page.
  * Pointer PAGE_ID(i) points to a subtree in which all keys K satisfy:
@@ -28,27 +29,150 @@ namespace bustub {
  * the first key always remains invalid. That is to say, any search/lookup
  * should ignore the first key.
  *
- * Internal page format (keys are stored in increasing order):
- *  --------------------------------------------------------------------------
- * | HEADER | KEY(1)+PAGE_ID(1) | KEY(2)+PAGE_ID(2) | ... | KEY(n)+PAGE_ID(n) |
- *  --------------------------------------------------------------------------
+ * The size of an internal page is its number of children, at most max size, and at most as many as fit.
+ *
+ * Like leaves, every internal page but the last one of its level links to the next page of the level, and carries
+ * the high key that bounds the keys of its subtree from above. The low key is the key that separates the page from
+ * its previous page, and is all zeros for the first page of a level. The first key, which is not stored, reads as the
+ * low key.
+ *
+ * Keys are compressed as BPlusTreePage describes. Separators come from the leaves already truncated to the shortest
+ * key that tells two leaves apart, and they move up unchanged, since they bound the subtrees below them.
+ *
+ * Internal page format (the offsets of the entries are stored in key order, the entries wherever they were put):
+ *  -----------------------------------------------------------------------------------------------------------
+ * | HEADER | OFFSET(1) | OFFSET(2) | ... | OFFSET(n) | free space | ... | KEY SIZE + KEY + PAGE_ID | (8 bytes) |
+ *  -----------------------------------------------------------------------------------------------------------
+ *
+ * Header format (size in byte, 32 bytes plus twice the key size in total):
+ *  ---------------------------------------------------------------------------------------------------------------
+ * | Common header (20) | NextPageId (4) | PrefixSize (4) | HeapOffset (4) | LowKey (key size) | HighKey (key size) |
+ *  ---------------------------------------------------------------------------------------------------------------
  */
 INDEX_TEMPLATE_ARGUMENTS
 class BPlusTreeInternalPage : public BPlusTreePage {
  public:
+  /** The number of bytes of entries, with their offsets, that an internal page holds at most */
+  static auto GetDataCapacity(int prefix_size) -> int;
+
+  /** @return the number of bytes that an entry with key takes when the keys of the page share prefix_size bytes */
+  static auto GetEntrySize(const KeyType &key, int prefix_size) -> int;
+
+  /** @return the number of leading bytes that all keys from low_key up to high_key share, from low_key on if null */
+  static auto GetPrefixSize(const KeyType &low_key, const KeyType *high_key) -> int;
+
   // must call initialize method after "create" a new node
-  void Init(page_id_t page_id, page_id_t parent_id = INVALID_PAGE_ID, int max_size = INTERNAL_PAGE_SIZE);
+  void Init(page_id_t page_id, int max_size = INTERNAL_PAGE_SIZE);
 
   auto KeyAt(int index) const -> KeyType;
+  /** Replace the key at index, which must not be 0. The page must have room for a longer key. */
   void SetKeyAt(int index, const KeyType &key);
   auto ValueAt(int index) const -> ValueType;
-  
-  void SetValueAt(int index, const ValueType &value);
-  //Custom methods
-  auto Lookup(const KeyType& key,  KeyComparator &comparator)->page_id_t;
+
+  auto GetNextPageId() const -> page_id_t;
+  void SetNextPageId(page_id_t next_page_id);
+  auto GetLowKey() const -> const KeyType &;
+  auto GetHighKey() const -> const KeyType &;
+  /** Set the keys that bound the keys of this empty page, where a null high_key means there is no bound. */
+  void SetFences(const KeyType &low_key, const KeyType *high_key);
+  /** @return whether key is not less than the high key, which means it belongs to a page further right */
+  auto IsBeyondHighKey(const KeyType &key, const KeyComparator &comparator) const -> bool;
+
+  /** @return whether count more children fit into this page, whatever their keys */
+  auto HasRoomFor(int count) const -> bool;
+  /** @return whether any key of this page can be replaced with a longer one */
+  auto HasRoomForLongerKey() const -> bool;
+  /** @return whether this page is at least half full by children or by bytes once count of its children are removed */
+  auto IsHalfFull(int removed) const -> bool;
+
+  /** @return the index of the child pointer value, or -1 if this page does not point to it */
+  auto ValueIndex(const ValueType &value) const -> int;
+
+  /** @return the child whose subtree holds key */
+  auto Lookup(const KeyType &key, const KeyComparator &comparator) const -> ValueType;
+
+  /** Turn this empty page into a root with the two children old_value and new_value, separated by key. */
+  void PopulateNewRoot(const ValueType &old_value, const KeyType &key, const ValueType &new_value);
+
+  /** Insert (key, new_value) right after the child old_value. The page must have room for it. */
+  void InsertNodeAfter(const ValueType &old_value, const KeyType &key, const ValueType &new_value);
+
+  /**
+   * Insert (key, new_value) right after the child old_value into this full page, and move the upper half of the
+   * children to recipient, an empty page that becomes the next page of this one. The low key of recipient then
+   * separates the two pages in their parent.
+   */
+  void InsertNodeAfterAndSplit(const ValueType &old_value, const KeyType &key, const ValueType &new_value,
+                               BPlusTreeInternalPage *recipient);
+
+  /**
+   * Append size children with their keys, which must come after the children of this page and fit between its fences.
+   * The key of the first child of an empty page is not stored, since it reads as the low key.
+   */
+  void CopyNFrom(const MappingType *items, int size);
+
+  /** Remove the key and the child at index. */
+  void Remove(int index);
+
+  /**
+   * Append all children of this page to recipient, its left sibling, and unlink this page. The low key of this page,
+   * which separates the two pages in their parent, becomes the key of its first child.
+   * @return false, and move nothing, if the children do not fit into recipient
+   */
+  auto MoveAllTo(BPlusTreeInternalPage *recipient) -> bool;
+
+  /**
+   * Even out the children of this page and right, its next page.
+   * @return false, and move nothing, if the children do not fit into the two pages that way; otherwise separator
+   * receives the new key that separates the two pages
+   */
+  auto Redistribute(BPlusTreeInternalPage *right, KeyType *separator) -> bool;
+
  private:
-  // Flexible array member for page data.
-  MappingType array_[1];
-  // std::vector<MappingType> array_;
+  /** The number of bytes up to the offset of the first entry */
+  static constexpr int HEADER_SIZE = INTERNAL_PAGE_HEADER_SIZE;
+
+  /** @return the number of bytes of the key that an entry stores when the keys of the page share prefix_size bytes */
+  static auto GetStoredKeySize(const KeyType &key, int prefix_size) -> int;
+
+  /** @return the number of bytes that items take, with their offsets, when their keys share prefix_size bytes */
+  static auto GetDataSize(const MappingType *items, int size, int prefix_size) -> int;
+
+  /** @return the number of bytes that are not taken by entries and their offsets */
+  auto GetFreeSpace() const -> int;
+
+  /** @return the number of bytes that an entry with the longest key this page can hold takes */
+  auto GetMaxEntrySize() const -> int;
+
+  /** @return whether size items fit into this page, if it was bounded by low_key and high_key */
+  auto Fits(const MappingType *items, int size, const KeyType &low_key, const KeyType *high_key) const -> bool;
+
+  /** @return the index at which to split items over two pages, whose keys share at least prefix_size bytes */
+  auto SplitIndex(const std::vector<MappingType> &items, int prefix_size) const -> int;
+
+  /** @return all children of this page with their keys, the first one with the low key */
+  auto GetItems() const -> std::vector<MappingType>;
+
+  /** Replace the entries of this page with size items, bounded by low_key and high_key, which may be keys of this page */
+  void Reset(const MappingType *items, int size, const KeyType &low_key, const KeyType *high_key);
+
+  /** Store (key, value) as the entry at index, moving the later ones up. The entry at index 0 stores no key. */
+  void InsertEntry(int index, const KeyType &key, const ValueType &value);
+
+  /** Remove the entry at index, moving the later ones down. */
+  void RemoveEntry(int index);
+
+  auto Data() const -> const char * { return reinterpret_cast<const char *>(this); }
+  auto Data() -> char * { return reinterpret_cast<char *>(this); }
+
+  page_id_t next_page_id_;
+  /** The number of leading bytes that all keys of the page share, which are only stored in low_key_ */
+  int prefix_size_;
+  /** The offset of the lowest entry; entries are stored downwards from HEAP_END */
+  int heap_offset_;
+  KeyType low_key_;
+  KeyType high_key_;
+  // Flexible array member for the offsets of the entries.
+  uint16_t offsets_[1];
 };
 }  // namespace bustub
@@ -18,48 +18,227 @@
 namespace bustub {
 
 #define B_PLUS_TREE_LEAF_PAGE_TYPE BPlusTreeLeafPage<KeyType, ValueType, KeyComparator>
-#define LEAF_PAGE_HEADER_SIZE 28
-#define LEAF_PAGE_SIZE ((BUSTUB_PAGE_SIZE - LEAF_PAGE_HEADER_SIZE) / sizeof(MappingType))
+#define LEAF_PAGE_HEADER_SIZE (32 + 2 * sizeof(KeyType))
+#define LEAF_PAGE_SIZE \
+  ((BUSTUB_PAGE_SIZE - sizeof(uint64_t) - LEAF_PAGE_HEADER_SIZE) / (sizeof(uint16_t) + 2 + sizeof(ValueType)))
+#define LeafEntryType std::pair<KeyType, LeafPosting<ValueType>>
+
+/**
+ * The values of a key in a leaf, which are stored inline in ascending order, or, if they are too many, in a chain of
+ * posting pages from first_page_id_ to last_page_id_ (see BPlusTreePostingPage), in which case values_ is empty.
+ */
+template <typename ValueType>
+struct LeafPosting {
+  std::vector<ValueType> values_;
+  page_id_t first_page_id_{INVALID_PAGE_ID};
+  page_id_t last_page_id_{INVALID_PAGE_ID};
+};
 
 /**
  * Store indexed key and record id(record id = page id combined with slot id,
  * see include/common/rid.h for detailed implementation) together within leaf
- * page. Only support unique key.
+ * page. A key is stored once, with a posting list of all its values, so a key never spans two leaves.
+ *
+ * A posting list holds up to POSTING_LIST_MAX_SIZE values inline, sorted, and a key with more values keeps them in
+ * posting pages instead, where the entry only refers to the first and last one. Either way, adding or removing one
+ * value changes the size of an entry by at most the size of an entry with a single value, except that a key whose
+ * posting pages shrink to POSTING_LIST_MAX_SIZE values takes them back inline if the leaf has room for that.
+ *
+ * A leaf splits as soon as it has no room left for another entry, either because it holds max size entries or
+ * because an entry with the longest key might not fit, so a leaf at rest always has room for one more entry.
  *
- * Leaf page format (keys are stored in order):
- *  ----------------------------------------------------------------------
- * | HEADER | KEY(1) + RID(1) | KEY(2) + RID(2) | ... | KEY(n) + RID(n)
- *  ----------------------------------------------------------------------
+ * Every leaf but the last one links to the next leaf, and carries a high key: the key that separates it from the next
+ * leaf in their parent. The separator is the shortest key between the last key of this leaf and the first key of the
+ * next one when they were split apart, which bounds the keys of this leaf from above. A B-link tree reader that finds
+ * its key at or beyond the high key knows the leaf was split under it, and follows the link. The low key bounds the
+ * keys of the leaf from below in the same way, and is all zeros for the first leaf.
  *
- *  Header format (size in byte, 28 bytes in total):
+ * Keys are compressed as BPlusTreePage describes: the leading bytes that the low and high key share are only stored in
+ * the low key, and entries only store the rest of their key up to its last byte that is not zero.
+ *
+ * Leaf page format (the offsets of the entries are stored in key order, the entries wherever they were put):
+ *  ----------------------------------------------------------------------------------------------------------
+ * | HEADER | OFFSET(1) | OFFSET(2) | ... | OFFSET(n) | free space | ... | KEY SIZE + KEY + POSTING | (8 bytes) |
+ *  ----------------------------------------------------------------------------------------------------------
+ *
+ *  Posting format, where a count of zero means the values are in posting pages:
+ *  ------------------------------------------------------------------------------
+ * | Count (1) | VALUE(1) | ... | VALUE(count) |  or  | 0 (1) | FirstPageId (4) | LastPageId (4) |
+ *  ------------------------------------------------------------------------------
+ *
+ *  Header format (size in byte, 32 bytes plus twice the key size in total):
  *  ---------------------------------------------------------------------
  * | PageType (4) | LSN (4) | CurrentSize (4) | MaxSize (4) |
  *  ---------------------------------------------------------------------
- *  -----------------------------------------------
- * | ParentPageId (4) | PageId (4) | NextPageId (4)
- *  -----------------------------------------------
+ *  --------------------------------------------------------------------------------------------------
+ * | PageId (4) | NextPageId (4) | PrefixSize (4) | HeapOffset (4) | LowKey (key size) | HighKey (key size)
+ *  --------------------------------------------------------------------------------------------------
  */
 INDEX_TEMPLATE_ARGUMENTS
 class BPlusTreeLeafPage : public BPlusTreePage {
  public:
+  /** The most values that a posting list holds inline, which keeps an entry within an eighth of a page */
+  static constexpr int POSTING_LIST_MAX_SIZE = BUSTUB_PAGE_SIZE / 8 / sizeof(ValueType);
+  static_assert(POSTING_LIST_MAX_SIZE <= UINT8_MAX, "the count of a posting list takes one byte");
+  static_assert(2 * sizeof(page_id_t) <= sizeof(ValueType),
+                "a key whose values are in posting pages must not take more bytes than a key with a single value");
+
+  /** The number of bytes of entries, with their offsets, that a leaf holds at rest when its keys share prefix_size bytes */
+  static auto GetDataCapacity(int prefix_size) -> int;
+
+  /** @return the number of bytes that an entry with key and one value takes when the keys share prefix_size bytes */
+  static auto GetEntrySize(const KeyType &key, int prefix_size) -> int;
+
+  /** @return the number of bytes that entry takes when the keys of the leaf share prefix_size bytes */
+  static auto GetEntrySize(const LeafEntryType &entry, int prefix_size) -> int;
+
+  /** @return the number of leading bytes that all keys from low_key up to high_key share, from low_key on if null */
+  static auto GetPrefixSize(const KeyType &low_key, const KeyType *high_key) -> int;
+
+  /** @return the shortest key that is greater than left but not greater than right, which separates the two */
+  static auto GetSeparator(const KeyType &left, const KeyType &right) -> KeyType;
+
   // After creating a new leaf page from buffer pool, must call initialize
   // method to set default values
-  void Init(page_id_t page_id, page_id_t parent_id = INVALID_PAGE_ID, int max_size = LEAF_PAGE_SIZE);
+  void Init(page_id_t page_id, int max_size = LEAF_PAGE_SIZE);
   // helper methods
   auto GetNextPageId() const -> page_id_t;
   void SetNextPageId(page_id_t next_page_id);
+  auto GetLowKey() const -> const KeyType &;
+  auto GetHighKey() const -> const KeyType &;
+  /** Set the keys that bound the keys of this empty page, where a null high_key means there is no bound. */
+  void SetFences(const KeyType &low_key, const KeyType *high_key);
+  /** @return whether key is not less than the high key, which means it belongs to a leaf further right */
+  auto IsBeyondHighKey(const KeyType &key, const KeyComparator &comparator) const -> bool;
   auto KeyAt(int index) const -> KeyType;
+  /** @return the value at position in the inline posting list of the key at index */
+  auto ValueAt(int index, int position = 0) const -> ValueType;
+  /** @return the number of values of the key at index that are stored inline, which is zero if they are not */
+  auto GetValueCount(int index) const -> int;
+  /** @return the values of the key at index, or the posting pages that hold them */
+  auto GetPosting(int index) const -> LeafPosting<ValueType>;
+  auto GetItem(int index) const -> LeafEntryType;
+
+  /** @return the number of bytes that are not taken by entries and their offsets */
+  auto GetFreeSpace() const -> int;
+  /** @return the number of bytes that an entry with the longest key this page can hold takes */
+  auto GetMaxEntrySize() const -> int;
+  /** @return whether count more entries fit into this page, whatever their keys */
+  auto HasRoomFor(int count) const -> bool;
+  /** @return whether the key at index can hold count values inline and leave room for another entry in this page */
+  auto HasRoomForValues(int index, int count) const -> bool;
+  /** @return whether this page is at least half full by entries or by bytes once count of its entries are removed */
+  auto IsHalfFull(int removed) const -> bool;
+
+  /** @return the index of the first key that is not less than key, which is the size if there is none */
+  auto KeyIndex(const KeyType &key, const KeyComparator &comparator) const -> int;
+
+  /** @return the index of key, or -1 if key is not present */
+  auto FindKey(const KeyType &key, const KeyComparator &comparator) const -> int;
+
+  /** Look up key, storing its first value in value if it is found. @return whether key was found */
+  auto Lookup(const KeyType &key, ValueType *value, const KeyComparator &comparator) const -> bool;
+
+  /** Insert (key, value) in key order. The page must have room for it. @return false if key is already present */
+  auto Insert(const KeyType &key, const ValueType &value, const KeyComparator &comparator) -> bool;
+
+  /**
+   * Add value to the inline posting list of the key at index, which must hold fewer than POSTING_LIST_MAX_SIZE values.
+   * The page must have room for another entry. @return false if the key has value already
+   */
+  auto AddValue(int index, const ValueType &value) -> bool;
+
+  /**
+   * Remove value from the inline posting list of the key at index, and the key along with its last value.
+   * @return false if the key does not have value
+   */
+  auto RemoveValue(int index, const ValueType &value) -> bool;
+
+  /** Replace the values of the key at index with posting, which must not take more bytes than the page has free. */
+  void SetPosting(int index, const LeafPosting<ValueType> &posting);
+
+  /** Remove key with its values, leaving its posting pages, if any, to the caller. @return false if key is absent */
+  auto Remove(const KeyType &key, const KeyComparator &comparator) -> bool;
+
+  /** Append size entries, which must be in key order, come after the entries of this page and fit between its fences. */
+  void CopyNFrom(const LeafEntryType *items, int size);
+
+  /**
+   * Move the upper half of the entries to recipient, an empty page that becomes the next page of this one. The low key
+   * of recipient then separates the two pages.
+   */
+  void MoveHalfTo(BPlusTreeLeafPage *recipient);
+
+  /**
+   * Append all entries to recipient, the previous page of this one, and unlink this page.
+   * @return false, and move nothing, if the entries do not fit into recipient
+   */
+  auto MoveAllTo(BPlusTreeLeafPage *recipient) -> bool;
+
+  /**
+   * Even out the entries of this page and right, its next page.
+   * @return false, and move nothing, if the entries do not fit into the two pages that way; otherwise separator
+   * receives the new key that separates the two pages
+   */
+  auto Redistribute(BPlusTreeLeafPage *right, KeyType *separator) -> bool;
 
-  //Custom
-  void SetKeyAt(int index, const KeyType &key);
-  void SetValueAt(int index, const ValueType &value);
-  auto ValueAt(int index) const -> ValueType;
-  auto Insert(const KeyType &key, const ValueType &value, KeyComparator &comparator) -> bool;
-  auto FindKeyIndex(const KeyType &key, KeyComparator &comparator) -> int;
-  
  private:
+  /** The number of bytes up to the offset of the first entry */
+  static constexpr int HEADER_SIZE = LEAF_PAGE_HEADER_SIZE;
+
+  /** @return the number of bytes of the key that an entry stores when the keys of the leaf share prefix_size bytes */
+  static auto GetStoredKeySize(const KeyType &key, int prefix_size) -> int;
+
+  /** @return the number of bytes that posting takes in an entry */
+  static auto GetPostingSize(const LeafPosting<ValueType> &posting) -> int;
+
+  /** Store posting into buffer, which must hold GetPostingSize(posting) bytes. */
+  static void EncodePosting(const LeafPosting<ValueType> &posting, char *buffer);
+
+  /** @return the number of bytes of the stored posting */
+  static auto GetStoredPostingSize(const char *posting) -> int;
+
+  /** @return the number of bytes that items take, with their offsets, when their keys share prefix_size bytes */
+  static auto GetDataSize(const LeafEntryType *items, int size, int prefix_size) -> int;
+
+  /** @return whether size items fit into this page at rest, if it was bounded by low_key and high_key */
+  auto Fits(const LeafEntryType *items, int size, const KeyType &low_key, const KeyType *high_key) const -> bool;
+
+  /** @return the index at which to split items over two pages */
+  auto SplitIndex(const std::vector<LeafEntryType> &items, int prefix_size) const -> int;
+
+  /** @return all entries of this page */
+  auto GetItems() const -> std::vector<LeafEntryType>;
+
+  /** Replace the entries of this page with size items, bounded by low_key and high_key, which may be keys of this page */
+  void Reset(const LeafEntryType *items, int size, const KeyType &low_key, const KeyType *high_key);
+
+  /** @return the posting of the entry at index, which starts with its count */
+  auto PostingAt(int index) const -> const char *;
+
+  /** Store key with the posting of posting_size bytes as the entry at index, moving the later ones up. */
+  void InsertEntry(int index, const KeyType &key, const char *posting, int posting_size);
+
+  /** Store item as the entry at index, moving the later ones up. */
+  void InsertEntry(int index, const LeafEntryType &item);
+
+  /** Replace the posting of the entry at index with the one of posting_size bytes. */
+  void ReplacePosting(int index, const char *posting, int posting_size);
+
+  /** Remove the entry at index, moving the later ones down. */
+  void RemoveEntry(int index);
+
+  auto Data() const -> const char * { return reinterpret_cast<const char *>(this); }
+  auto Data() -> char * { return reinterpret_cast<char *>(this); }
+
   page_id_t next_page_id_;
-  // Flexible array member for page data.
-  MappingType array_[1];
+  /** The number of leading bytes that all keys of the page share, which are only stored in low_key_ */
+  int prefix_size_;
+  /** The offset of the lowest entry; entries are stored downwards from HEAP_END */
+  int heap_offset_;
+  KeyType low_key_;
+  KeyType high_key_;
+  // Flexible array member for the offsets of the entries.
+  uint16_t offsets_[1];
 };
 }  // namespace bustub
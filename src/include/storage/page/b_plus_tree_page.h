@@ -12,6 +12,7 @@
 
 #include <cassert>
 #include <climits>
+#include <cstdint>
 #include <cstdlib>
 #include <string>
 
@@ -25,7 +26,7 @@ namespace bustub {
 #define INDEX_TEMPLATE_ARGUMENTS template <typename KeyType, typename ValueType, typename KeyComparator>
 
 // define page type enum
-enum class IndexPageType { INVALID_INDEX_PAGE = 0, LEAF_PAGE, INTERNAL_PAGE };
+enum class IndexPageType { INVALID_INDEX_PAGE = 0, LEAF_PAGE, INTERNAL_PAGE, POSTING_PAGE };
 
 /**
  * Both internal and leaf page are inherited from this page.
@@ -33,17 +34,22 @@ enum class IndexPageType { INVALID_INDEX_PAGE = 0, LEAF_PAGE, INTERNAL_PAGE };
  * It actually serves as a header part for each B+ tree page and
  * contains information shared by both leaf page and internal page.
  *
- * Header format (size in byte, 24 bytes in total):
- * ----------------------------------------------------------------------------
- * | PageType (4) | LSN (4) | CurrentSize (4) | MaxSize (4) |
+ * Pages do not point to their parents: a tree operation that restructures a page keeps the latched path from the root
+ * down to it instead, so a split does not have to rewrite every child that moves to the new page.
+ *
+ * Keys are compressed within a page. A page covers the keys from its low key up to its high key, and all of those
+ * share the bytes that the two share, which the page stores once. Of the rest of each key, only the bytes up to the
+ * last one that is not zero are stored, since keys are padded with zeros. Entries thus vary in size, so pages hold
+ * entries up to a max size, but also only as many as fit into the page.
+ *
+ * Header format (size in byte, 20 bytes in total):
  * ----------------------------------------------------------------------------
- * | ParentPageId (4) | PageId(4) |
+ * | PageType (4) | LSN (4) | CurrentSize (4) | MaxSize (4) | PageId(4) |
  * ----------------------------------------------------------------------------
  */
 class BPlusTreePage {
  public:
   auto IsLeafPage() const -> bool;
-  auto IsRootPage() const -> bool;
   void SetPageType(IndexPageType page_type);
 
   auto GetSize() const -> int;
@@ -54,22 +60,35 @@ class BPlusTreePage {
   void SetMaxSize(int max_size);
   auto GetMinSize() const -> int;
 
-  auto GetParentPageId() const -> page_id_t;
-  void SetParentPageId(page_id_t parent_page_id);
-
   auto GetPageId() const -> page_id_t;
   void SetPageId(page_id_t page_id);
 
   void SetLSN(lsn_t lsn = INVALID_LSN);
 
-  
+  /** Entries are stored below this offset, which leaves a word after them, so that keys can be loaded a word at a time */
+  static constexpr int HEAP_END = BUSTUB_PAGE_SIZE - sizeof(uint64_t);
+
+  /** @return the number of leading bytes that the keys a and b, of size bytes each, share */
+  static auto CommonPrefixSize(const char *a, const char *b, int size) -> int;
+
+  /** @return the size of key without its trailing zeros */
+  static auto SignificantSize(const char *key, int size) -> int;
+
+  /** @return the number of leading bytes that all keys from low up to high share, or from low on if high is null */
+  static auto FencePrefixSize(const char *low, const char *high, int size) -> int;
+
+  /**
+   * Store the shortest key that is greater than left but not greater than right into separator, which holds the bytes
+   * of right up to the first one that differs from left, padded with zeros.
+   */
+  static void ShortestSeparator(const char *left, const char *right, char *separator, int size);
+
  private:
   // member variable, attributes that both internal and leaf page share
   IndexPageType page_type_ __attribute__((__unused__));
   lsn_t lsn_ __attribute__((__unused__));
   int size_ __attribute__((__unused__));
   int max_size_ __attribute__((__unused__));
-  page_id_t parent_page_id_ __attribute__((__unused__));
   page_id_t page_id_ __attribute__((__unused__));
 };
 
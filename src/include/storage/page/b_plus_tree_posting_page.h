@@ -0,0 +1,74 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_plus_tree_posting_page.h
+//
+// Identification: src/include/storage/page/b_plus_tree_posting_page.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "storage/page/b_plus_tree_page.h"
+
+namespace bustub {
+
+#define B_PLUS_TREE_POSTING_PAGE_TYPE BPlusTreePostingPage<ValueType>
+#define POSTING_PAGE_HEADER_SIZE 24
+#define POSTING_PAGE_SIZE ((BUSTUB_PAGE_SIZE - POSTING_PAGE_HEADER_SIZE) / sizeof(ValueType))
+
+/**
+ * Store the values of a key that has too many of them to keep in its leaf entry. The leaf entry then refers to a chain
+ * of posting pages instead, which holds the values in ascending order, within each page and from one page to the next.
+ *
+ * Posting pages belong to the leaf entry of their key, and move along with it when entries move between leaves. They
+ * are not latched themselves: they are only read while the leaf that holds their key is latched, and only written
+ * while it is write latched.
+ *
+ * Posting page format (values are sorted in ascending order):
+ *  ----------------------------------------------------
+ * | HEADER | VALUE(1) | VALUE(2) | ... | VALUE(n) |
+ *  ----------------------------------------------------
+ *
+ * Header format (size in byte, 24 bytes in total):
+ *  ------------------------------------------------------
+ * | Common header (20) | NextPageId (4) |
+ *  ------------------------------------------------------
+ */
+template <typename ValueType>
+class BPlusTreePostingPage : public BPlusTreePage {
+ public:
+  // After creating a new posting page from buffer pool, must call initialize method to set default values
+  void Init(page_id_t page_id, int max_size = POSTING_PAGE_SIZE);
+
+  auto GetNextPageId() const -> page_id_t;
+  void SetNextPageId(page_id_t next_page_id);
+
+  auto ValueAt(int index) const -> const ValueType &;
+
+  /** @return the index of the first value that is not less than value, which is the size if there is none */
+  auto ValueIndex(const ValueType &value) const -> int;
+
+  /** Insert value in order. The page must not be full. @return false if value is already present */
+  auto Insert(const ValueType &value) -> bool;
+
+  /** Remove value. @return false if value is not present */
+  auto Remove(const ValueType &value) -> bool;
+
+  /** Append size values, which must be in order, come after the values of this page and fit into it. */
+  void CopyNFrom(const ValueType *values, int size);
+
+  /** Move the upper half of the values to recipient, an empty page that becomes the next page of this one. */
+  void MoveHalfTo(BPlusTreePostingPage *recipient);
+
+  /** Append all values to recipient, the previous page of this one that has room for them, and unlink this page. */
+  void MoveAllTo(BPlusTreePostingPage *recipient);
+
+ private:
+  page_id_t next_page_id_;
+  // Flexible array member for the values.
+  ValueType array_[1];
+};
+
+}  // namespace bustub
@@ -0,0 +1,72 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// overflow_page.h
+//
+// Identification: src/include/storage/page/overflow_page.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstring>
+
+#include "buffer/buffer_pool_manager.h"
+#include "storage/page/page.h"
+
+namespace bustub {
+
+/**
+ * Overflow page format. A varlen value that is too large to be stored in its tuple is stored in a chain of overflow
+ * pages instead, and the tuple keeps a reference to the first page of the chain (see Tuple).
+ *
+ *  ------------------------------------------------------
+ *  | NextPageId (4) | DataSize (4) | ... VALUE DATA ... |
+ *  ------------------------------------------------------
+ *
+ * The chain belongs to the tuple that references it, so it is freed when the tuple is deleted. Index builds spill
+ * their sorted runs into chains of overflow pages as well (see IndexBuildSorter).
+ */
+class OverflowPage : public Page {
+ public:
+  /** @return the page ID of the next page of the chain, or INVALID_PAGE_ID for the last page */
+  auto GetNextPageId() -> page_id_t { return *reinterpret_cast<page_id_t *>(GetData()); }
+
+  /** Link this page to the next page of the chain. */
+  void SetNextPageId(page_id_t next_page_id) { memcpy(GetData(), &next_page_id, sizeof(page_id_t)); }
+
+  /** @return the number of bytes of value data on this page */
+  auto GetDataSize() -> uint32_t { return *reinterpret_cast<uint32_t *>(GetData() + OFFSET_DATA_SIZE); }
+
+  /** @return the value data on this page */
+  auto GetPayload() -> char * { return GetData() + SIZE_HEADER; }
+
+  /** Initialize the page with the next page of the chain and a part of the value data. */
+  void Init(page_id_t next_page_id, const char *data, uint32_t size) {
+    memcpy(GetData(), &next_page_id, sizeof(page_id_t));
+    memcpy(GetData() + OFFSET_DATA_SIZE, &size, sizeof(uint32_t));
+    memcpy(GetPayload(), data, size);
+  }
+
+  /**
+   * Store data in a new chain of overflow pages.
+   * @return the first page of the chain, or INVALID_PAGE_ID if the buffer pool ran out of pages
+   */
+  static auto WriteChain(BufferPoolManager *bpm, const char *data, uint32_t size) -> page_id_t;
+
+  /** Read the `size` bytes of data stored in the chain starting at first_page_id into out. */
+  static void ReadChain(BufferPoolManager *bpm, page_id_t first_page_id, char *out, uint32_t size);
+
+  /** Deallocate the chain starting at first_page_id. */
+  static void DeleteChain(BufferPoolManager *bpm, page_id_t first_page_id);
+
+  /** The number of bytes of value data that fit on one page */
+  static constexpr uint32_t CAPACITY = BUSTUB_PAGE_SIZE - 8;
+
+ private:
+  static constexpr size_t SIZE_HEADER = 8;
+  static constexpr size_t OFFSET_DATA_SIZE = 4;
+};
+
+}  // namespace bustub
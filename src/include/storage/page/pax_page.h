@@ -0,0 +1,186 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// pax_page.h
+//
+// Identification: src/include/storage/page/pax_page.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstring>
+
+#include "catalog/schema.h"
+#include "common/rid.h"
+#include "concurrency/transaction.h"
+#include "recovery/log_manager.h"
+#include "storage/page/page.h"
+#include "storage/table/tuple.h"
+
+namespace bustub {
+
+/**
+ * PAX (Partition Attributes Across) page format. The tuples of a page are split by column, and every column gets its
+ * own contiguous minipage. A scan that only touches a few columns of a wide table then only pulls those minipages
+ * through the cache, and the values of one column can be handed out as a plain array.
+ *
+ *  ------------------------------------------------------------------------------------------------
+ *  | HEADER | SLOT STATES | NULL BITMAP MINIPAGE | COLUMN 0 MINIPAGE | COLUMN 1 MINIPAGE | ... | UNUSED |
+ *  ------------------------------------------------------------------------------------------------
+ *
+ *  Header format (size in bytes):
+ *  -------------------------------------------------------------------------------------
+ *  | PageId (4)| LSN (4)| PrevPageId (4)| NextPageId (4)| TupleCount (4)| Capacity (4) |
+ *  -------------------------------------------------------------------------------------
+ *
+ * Slot states hold one byte per slot. The minipage of column i starts at
+ * HEADER + Capacity + Capacity * column_offset(i), and slot s of that column lives at minipage + s * column_length(i).
+ * The null bitmaps of the tuples come first, because they come first in the tuples as well.
+ *
+ * The first 16 bytes of the header match the TablePage header, so TableHeap links and walks PAX pages with the same
+ * accessors it uses for row pages. Only schemas whose columns are all inlined can be stored in a PAX page.
+ */
+class PaxPage : public Page {
+ public:
+  /**
+   * Initialize the PaxPage header. The slot capacity is derived from the tuple length of the schema.
+   * @param page_id the page ID of this table page
+   * @param page_size the size of this table page
+   * @param prev_page_id the previous table page ID
+   * @param schema the schema of the tuples stored in this page
+   * @param log_manager the log manager in use
+   * @param txn the transaction that this page is created in
+   */
+  void Init(page_id_t page_id, uint32_t page_size, page_id_t prev_page_id, const Schema &schema,
+            LogManager *log_manager, Transaction *txn);
+
+  /** @return the page ID of this table page */
+  auto GetTablePageId() -> page_id_t { return *reinterpret_cast<page_id_t *>(GetData()); }
+
+  /** @return the number of slots in use, some of which may be free */
+  auto GetTupleCount() -> uint32_t { return *reinterpret_cast<uint32_t *>(GetData() + OFFSET_TUPLE_COUNT); }
+
+  /** @return the maximum number of tuples this page can hold */
+  auto GetCapacity() -> uint32_t { return *reinterpret_cast<uint32_t *>(GetData() + OFFSET_CAPACITY); }
+
+  /**
+   * Insert a tuple into the page.
+   * @param tuple tuple to insert, which must have been built with `schema`
+   * @param schema the schema of the table
+   * @param[out] rid rid of the inserted tuple
+   * @return true if the insert is successful (i.e. there is a free slot)
+   */
+  auto InsertTuple(const Tuple &tuple, const Schema &schema, RID *rid) -> bool;
+
+  /**
+   * Mark a tuple as deleted. This does not actually delete the tuple.
+   * @param rid rid of the tuple to mark as deleted
+   * @return true if marking the tuple as deleted is successful (i.e the tuple exists)
+   */
+  auto MarkDelete(const RID &rid) -> bool;
+
+  /**
+   * Update a tuple in place. PAX tuples are fixed-length, so an update never runs out of space.
+   * @param new_tuple new value of the tuple
+   * @param[out] old_tuple old value of the tuple
+   * @param rid rid of the tuple
+   * @param schema the schema of the table
+   * @return true if updating the tuple succeeded
+   */
+  auto UpdateTuple(const Tuple &new_tuple, Tuple *old_tuple, const RID &rid, const Schema &schema) -> bool;
+
+  /** To be called on commit or abort. Actually perform the delete or rollback an insert. */
+  void ApplyDelete(const RID &rid);
+
+  /** To be called on abort. Rollback a delete, i.e. this reverses a MarkDelete. */
+  void RollbackDelete(const RID &rid);
+
+  /**
+   * Read a tuple from the page, gathering its columns from the minipages.
+   * @param rid rid of the tuple to read
+   * @param[out] tuple the tuple that was read
+   * @param schema the schema of the table
+   * @return true if the read is successful (i.e. the tuple exists)
+   */
+  auto GetTuple(const RID &rid, Tuple *tuple, const Schema &schema) -> bool;
+
+  /**
+   * @param[out] first_rid the RID of the first tuple in this page
+   * @return true if the first tuple exists, false otherwise
+   */
+  auto GetFirstTupleRid(RID *first_rid) -> bool;
+
+  /**
+   * @param cur_rid the RID of the current tuple
+   * @param[out] next_rid the RID of the tuple following the current tuple
+   * @return true if the next tuple exists, false otherwise
+   */
+  auto GetNextTupleRid(const RID &cur_rid, RID *next_rid) -> bool;
+
+  /** @return true if the tuple at slot_num is visible to a scan, i.e. it is neither free nor marked deleted */
+  auto IsTupleVisible(uint32_t slot_num) -> bool { return GetSlotState(slot_num) == SLOT_LIVE; }
+
+  /**
+   * @param column_idx the column whose minipage is requested
+   * @param schema the schema of the table
+   * @return the start of the minipage of the column; slot s lives at `s * column length`
+   */
+  auto GetColumnData(uint32_t column_idx, const Schema &schema) -> const char * {
+    return GetData() + GetColumnOffset(column_idx, schema);
+  }
+
+  /** @return the number of tuples of `schema` that fit into one PAX page of `page_size` bytes */
+  static auto ComputeCapacity(uint32_t page_size, const Schema &schema) -> uint32_t {
+    return (page_size - SIZE_PAX_PAGE_HEADER) / (SIZE_SLOT_STATE + schema.GetLength());
+  }
+
+ private:
+  static_assert(sizeof(page_id_t) == 4);
+
+  static constexpr size_t SIZE_PAX_PAGE_HEADER = 24;
+  static constexpr size_t SIZE_SLOT_STATE = 1;
+  static constexpr size_t OFFSET_PREV_PAGE_ID = 8;
+  static constexpr size_t OFFSET_NEXT_PAGE_ID = 12;
+  static constexpr size_t OFFSET_TUPLE_COUNT = 16;
+  static constexpr size_t OFFSET_CAPACITY = 20;
+  static constexpr size_t OFFSET_SLOT_STATE = 24;
+
+  static constexpr uint8_t SLOT_FREE = 0;
+  static constexpr uint8_t SLOT_LIVE = 1;
+  static constexpr uint8_t SLOT_DELETED = 2;
+
+  /** Set the number of slots in use. */
+  void SetTupleCount(uint32_t tuple_count) { memcpy(GetData() + OFFSET_TUPLE_COUNT, &tuple_count, sizeof(uint32_t)); }
+
+  /** Set the slot capacity of this page. */
+  void SetCapacity(uint32_t capacity) { memcpy(GetData() + OFFSET_CAPACITY, &capacity, sizeof(uint32_t)); }
+
+  /** @return the state of slot slot_num */
+  auto GetSlotState(uint32_t slot_num) -> uint8_t {
+    return *reinterpret_cast<uint8_t *>(GetData() + OFFSET_SLOT_STATE + SIZE_SLOT_STATE * slot_num);
+  }
+
+  /** Set the state of slot slot_num. */
+  void SetSlotState(uint32_t slot_num, uint8_t state) {
+    *reinterpret_cast<uint8_t *>(GetData() + OFFSET_SLOT_STATE + SIZE_SLOT_STATE * slot_num) = state;
+  }
+
+  /** @return the byte offset of the minipage of column_idx within the page */
+  auto GetColumnOffset(uint32_t column_idx, const Schema &schema) -> uint32_t {
+    uint32_t capacity = GetCapacity();
+    return OFFSET_SLOT_STATE + SIZE_SLOT_STATE * capacity + capacity * schema.GetColumn(column_idx).GetOffset();
+  }
+
+  /** @return the byte offset of the minipage holding the null bitmaps within the page */
+  auto GetNullBitmapOffset() -> uint32_t { return OFFSET_SLOT_STATE + SIZE_SLOT_STATE * GetCapacity(); }
+
+  /** Scatter the fixed-length row image in `data` into the minipages at slot_num. */
+  void WriteSlot(uint32_t slot_num, const char *data, const Schema &schema);
+
+  /** Gather the minipages at slot_num back into a fixed-length row image in `data`. */
+  void ReadSlot(uint32_t slot_num, char *data, const Schema &schema);
+};
+
+}  // namespace bustub
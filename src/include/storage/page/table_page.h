@@ -107,8 +107,11 @@ class TablePage : public Page {
   auto UpdateTuple(const Tuple &new_tuple, Tuple *old_tuple, const RID &rid, Transaction *txn,
                    LockManager *lock_manager, LogManager *log_manager) -> bool;
 
-  /** To be called on commit or abort. Actually perform the delete or rollback an insert. */
-  void ApplyDelete(const RID &rid, Transaction *txn, LogManager *log_manager);
+  /**
+   * To be called on commit or abort. Actually perform the delete or rollback an insert.
+   * @param[out] deleted_tuple if not nullptr, receives a copy of the deleted tuple
+   */
+  void ApplyDelete(const RID &rid, Transaction *txn, LogManager *log_manager, Tuple *deleted_tuple = nullptr);
 
   /** To be called on abort. Rollback a delete, i.e. this reverses a MarkDelete. */
   void RollbackDelete(const RID &rid, Transaction *txn, LogManager *log_manager);
@@ -138,6 +141,16 @@ class TablePage : public Page {
    */
   auto GetNextTupleRid(const RID &cur_rid, RID *next_rid) -> bool;
 
+  /**
+   * Give the trailing free slots back to the free space. ApplyDelete already keeps the tuple data contiguous, so the
+   * slot array is the only part of the page that fragments. Slots before the last used one keep their RIDs.
+   * @return true if any slot was given back
+   */
+  auto Compact() -> bool;
+
+  /** @return true if the page holds no slots, which Compact leaves once every tuple is deleted */
+  auto IsEmpty() -> bool { return GetTupleCount() == 0; }
+
  private:
   static_assert(sizeof(page_id_t) == 4);
 
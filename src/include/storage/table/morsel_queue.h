@@ -0,0 +1,58 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// morsel_queue.h
+//
+// Identification: src/include/storage/table/morsel_queue.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <utility>
+#include <vector>
+
+#include "common/config.h"
+
+namespace bustub {
+
+/**
+ * MorselQueue splits the pages of a table heap into morsels, i.e. runs of consecutive pages, and hands them out to
+ * concurrent scanners. Every page is handed out exactly once; a scanner that finishes its morsel early simply takes the
+ * next one, which balances the work between scanners without any coordination.
+ *
+ * The queue scans a snapshot of the page directory taken when it was created, see TableHeap::GetPageIds.
+ */
+class MorselQueue {
+ public:
+  /**
+   * Create a queue over a page snapshot.
+   * @param page_ids the pages to hand out, in page chain order
+   * @param morsel_size the number of pages per morsel
+   */
+  MorselQueue(std::vector<page_id_t> page_ids, size_t morsel_size)
+      : page_ids_(std::move(page_ids)), morsel_size_(morsel_size) {}
+
+  /**
+   * Take the next morsel. This is safe to call from any number of threads.
+   * @param[out] morsel the pages of the morsel
+   * @return false if all pages have been handed out
+   */
+  auto Next(std::vector<page_id_t> *morsel) -> bool;
+
+  /** @return the number of pages in the queue */
+  auto GetPageCount() const -> size_t { return page_ids_.size(); }
+
+  /** @return the number of morsels the pages are split into */
+  auto GetMorselCount() const -> size_t { return (page_ids_.size() + morsel_size_ - 1) / morsel_size_; }
+
+ private:
+  const std::vector<page_id_t> page_ids_;
+  const size_t morsel_size_;
+  /** The index of the first page of the next morsel */
+  std::atomic<size_t> next_{0};
+};
+
+}  // namespace bustub
@@ -12,17 +12,30 @@
 
 #pragma once
 
+#include <functional>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <unordered_set>
+#include <vector>
+
 #include "buffer/buffer_pool_manager.h"
 #include "recovery/log_manager.h"
+#include "storage/page/pax_page.h"
 #include "storage/page/table_page.h"
 #include "storage/table/table_iterator.h"
+#include "storage/table/table_storage_format.h"
+#include "storage/table/zone_map.h"
 #include "storage/table/tuple.h"
 
 namespace bustub {
 
+/** Called for every tuple Vacuum moves to another page, so that indexes can follow it to its new RID. */
+using TupleMoveCallback = std::function<void(const Tuple &tuple, const RID &old_rid, const RID &new_rid)>;
+
 /**
  * TableHeap represents a physical table on disk.
- * This is just a doubly-linked list of pages.
+ * This is just a doubly-linked list of pages. The heap additionally keeps a directory of its pages in chain order, so
+ * that the pages can be handed out to concurrent scanners without walking the chain.
  */
 class TableHeap {
   friend class TableIterator;
@@ -36,9 +49,12 @@ class TableHeap {
    * @param lock_manager the lock manager
    * @param log_manager the log manager
    * @param first_page_id the id of the first page
+   * @param schema the schema of the table, which must outlive the heap; required for the PAX format
+   * @param format the page format the table was created with
    */
   TableHeap(BufferPoolManager *buffer_pool_manager, LockManager *lock_manager, LogManager *log_manager,
-            page_id_t first_page_id);
+            page_id_t first_page_id, const Schema *schema = nullptr,
+            TableStorageFormat format = TableStorageFormat::ROW);
 
   /**
    * Create a table heap with a transaction. (create table)
@@ -46,9 +62,11 @@ class TableHeap {
    * @param lock_manager the lock manager
    * @param log_manager the log manager
    * @param txn the creating transaction
+   * @param schema the schema of the table, which must outlive the heap; required for the PAX format
+   * @param format the page format to store the table in
    */
   TableHeap(BufferPoolManager *buffer_pool_manager, LockManager *lock_manager, LogManager *log_manager,
-            Transaction *txn);
+            Transaction *txn, const Schema *schema = nullptr, TableStorageFormat format = TableStorageFormat::ROW);
 
   /**
    * Insert a tuple into the table. If the tuple is too large (>= page_size), return false.
@@ -68,7 +86,8 @@ class TableHeap {
   auto MarkDelete(const RID &rid, Transaction *txn) -> bool;  // for delete
 
   /**
-   * if the new tuple is too large to fit in the old page, return false (will delete and insert)
+   * if the new tuple is too large to fit in the old page, return false (will delete and insert). Unlike InsertTuple,
+   * this never moves values into overflow pages.
    * @param tuple new tuple
    * @param rid rid of the old tuple
    * @param txn transaction performing the update
@@ -76,6 +95,13 @@ class TableHeap {
    */
   auto UpdateTuple(const Tuple &tuple, const RID &rid, Transaction *txn) -> bool;
 
+  /**
+   * Called on Commit to deallocate the overflow chains an update replaced. They are kept until then, as an abort writes
+   * the old tuple back.
+   * @param overflow_chains first pages of the replaced chains
+   */
+  void ApplyUpdate(const std::vector<page_id_t> &overflow_chains);
+
   /**
    * Called on Commit/Abort to actually delete a tuple or rollback an insert.
    * @param rid rid of the tuple to delete
@@ -105,14 +131,135 @@ class TableHeap {
   /** @return the end iterator of this table */
   auto End() -> TableIterator;
 
+  /**
+   * Reclaim the space left behind by deletes. Only pages that had tuples deleted since the last Vacuum are looked at:
+   * tuples of sparse ones at the tail of the table are moved into free space of earlier pages, pages that end up empty
+   * are unlinked from the page chain and deallocated, trailing free slots are trimmed and the zone maps are rebuilt
+   * from the remaining tuples.
+   *
+   * Vacuum moves tuples outside of any transaction, so the caller must make sure that no transaction is running, e.g.
+   * with TransactionManager::BlockAllTransactions.
+   * @param on_move called for every moved tuple
+   * @return the number of pages that were deallocated
+   */
+  auto Vacuum(const TupleMoveCallback &on_move) -> uint32_t;
+
+  /** @return true if tuples were deleted since the last Vacuum, i.e. Vacuum may have something to reclaim */
+  auto HasPagesToVacuum() -> bool;
+
+  /**
+   * Read all visible tuples of a page in one go.
+   * @param page_id the page to read
+   * @param[out] tuples the tuples of the page are appended here
+   * @param txn the transaction performing the read
+   * @return the id of the page following page_id, or INVALID_PAGE_ID at the end of the table
+   */
+  auto GetPageTuples(page_id_t page_id, std::vector<Tuple> *tuples, Transaction *txn) -> page_id_t;
+
+  /**
+   * Read some tuples of a page in one go, e.g. the ones a filter selected from a column chunk of the page.
+   * @param page_id the page to read
+   * @param rids the RIDs of the tuples to read, which all lie on page_id
+   * @param[out] tuples the tuples that are still visible are appended here
+   * @param txn the transaction performing the read
+   */
+  void GetPageTuples(page_id_t page_id, const std::vector<RID> &rids, std::vector<Tuple> *tuples, Transaction *txn);
+
+  /**
+   * Read the values of one column of every visible tuple on a page into a contiguous buffer. On a PAX page this copies
+   * straight out of the column minipage; on a row page the values are gathered tuple by tuple. A sequential scan of a
+   * PAX table filters on such a chunk before it reads any whole tuple.
+   * @param page_id the page to read
+   * @param column_idx the column to read, which must be inlined
+   * @param[out] values the fixed-length values of the column, appended back to back
+   * @param[out] rids the RIDs of the tuples the values belong to, in the same order
+   * @return the id of the page following page_id, or INVALID_PAGE_ID at the end of the table
+   */
+  auto ReadColumnChunk(page_id_t page_id, uint32_t column_idx, std::vector<char> *values, std::vector<RID> *rids)
+      -> page_id_t;
+
+  /**
+   * Take a snapshot of the page directory. Pages appended afterwards are not part of the snapshot, and pages removed by
+   * Vacuum afterwards must not be read, which Vacuum guarantees by running without concurrent transactions.
+   * @return the ids of all pages of this table, in page chain order
+   */
+  auto GetPageIds() -> std::vector<page_id_t>;
+
   /** @return the id of the first page of this table */
   inline auto GetFirstPageId() const -> page_id_t { return first_page_id_; }
 
+  /** @return the page format of this table */
+  inline auto GetStorageFormat() const -> TableStorageFormat { return format_; }
+
+  /** @return the per-page column summaries of this table, or nullptr if the table does not keep them */
+  inline auto GetZoneMap() const -> ZoneMap * { return zone_map_.get(); }
+
  private:
+  /** Initialize a freshly allocated page in the format of this table. */
+  void InitPage(Page *page, page_id_t page_id, page_id_t prev_page_id, Transaction *txn);
+
+  /** Insert a tuple into a page in the format of this table. */
+  auto InsertIntoPage(Page *page, const Tuple &tuple, RID *rid, Transaction *txn) -> bool;
+
+  /**
+   * Delete a tuple from a page in the format of this table, or roll back its insert. The overflow chains of the tuple
+   * are left alone, as they still belong to the tuple when it is moved.
+   * @param[out] deleted_tuple if not nullptr, receives a copy of the deleted tuple
+   */
+  void ApplyDeleteOnPage(Page *page, const RID &rid, Transaction *txn, Tuple *deleted_tuple = nullptr);
+
+  /**
+   * Build a copy of a tuple too large for a page, with its largest varlen values moved into overflow chains, which
+   * keeps the values that are read most often inline.
+   * @param[out] spilled the copy, which fits into a page
+   * @return false if the tuple cannot be made to fit, or the buffer pool ran out of pages
+   */
+  auto SpillLargeValues(const Tuple &tuple, Tuple *spilled) -> bool;
+
+  /** @return true if the tuple references overflow pages */
+  auto HasOverflowedValues(const Tuple &tuple) -> bool;
+
+  /** Deallocate the overflow chains of a tuple. */
+  void FreeOverflowChains(const Tuple &tuple);
+
+  /** @return the first pages of the overflow chains of old_tuple that new_tuple does not reference */
+  auto ReplacedOverflowChains(const Tuple &old_tuple, const Tuple &new_tuple) -> std::vector<page_id_t>;
+
+  /** @return true if a tuple of tuple_size bytes fits into an empty table page */
+  static inline auto FitsIntoPage(uint32_t tuple_size) -> bool { return tuple_size + 32 <= BUSTUB_PAGE_SIZE; }
+
+  /** Trim the trailing free slots of a page. @return true if any slot was trimmed */
+  auto CompactPage(Page *page) -> bool;
+
+  /** @return true if a page holds no slots, i.e. it can be removed */
+  auto IsPageEmpty(Page *page) -> bool;
+
+  /** Unlink a page from the page chain and deallocate it. The page must not be the first page. */
+  void RemovePage(page_id_t page_id);
+
+  /** Read a tuple from a page in the format of this table. */
+  auto GetTupleFromPage(Page *page, const RID &rid, Tuple *tuple, Transaction *txn) -> bool;
+
+  /** @return true if page holds a visible tuple, which is then stored in first_rid */
+  auto GetFirstTupleRid(Page *page, RID *first_rid) -> bool;
+
+  /** @return true if page holds a visible tuple after cur_rid, which is then stored in next_rid */
+  auto GetNextTupleRid(Page *page, const RID &cur_rid, RID *next_rid) -> bool;
+
   BufferPoolManager *buffer_pool_manager_;
   LockManager *lock_manager_;
   LogManager *log_manager_;
   page_id_t first_page_id_{};
+  const Schema *schema_;
+  TableStorageFormat format_;
+  /** Only tables created with a schema keep zone maps, as an opened table has no summaries of its existing pages */
+  std::unique_ptr<ZoneMap> zone_map_{nullptr};
+  /** The ids of all pages, in page chain order */
+  std::vector<page_id_t> page_ids_;
+  /** The pages that had tuples deleted since the last Vacuum */
+  std::unordered_set<page_id_t> pages_to_vacuum_;
+  /** Protects page_ids_ and pages_to_vacuum_ */
+  std::mutex page_ids_latch_;
 };
 
 }  // namespace bustub
@@ -0,0 +1,40 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// table_storage_format.h
+//
+// Identification: src/include/storage/table/table_storage_format.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "fmt/format.h"
+
+namespace bustub {
+
+/**
+ * The page format a table heap stores its tuples in. ROW is the slotted TablePage, PAX stores every page as column
+ * minipages (see PaxPage) and is chosen with `CREATE TABLE ... WITH (storage = pax)`.
+ */
+enum class TableStorageFormat : uint8_t { ROW, PAX };
+
+}  // namespace bustub
+
+template <>
+struct fmt::formatter<bustub::TableStorageFormat> : formatter<string_view> {
+  template <typename FormatContext>
+  auto format(bustub::TableStorageFormat c, FormatContext &ctx) const {
+    string_view name;
+    switch (c) {
+      case bustub::TableStorageFormat::ROW:
+        name = "Row";
+        break;
+      case bustub::TableStorageFormat::PAX:
+        name = "Pax";
+        break;
+    }
+    return formatter<string_view>::format(name, ctx);
+  }
+};
@@ -12,25 +12,45 @@
 
 #pragma once
 
+#include <algorithm>
+#include <cstring>
 #include <string>
 #include <vector>
 
 #include "catalog/schema.h"
+#include "common/macros.h"
 #include "common/rid.h"
+#include "type/abstract_pool.h"
 #include "type/value.h"
 
 namespace bustub {
 
+class BufferPoolManager;
+
 /**
  * Tuple format:
- * ---------------------------------------------------------------------
- * | FIXED-SIZE or VARIED-SIZED OFFSET | PAYLOAD OF VARIED-SIZED FIELD |
- * ---------------------------------------------------------------------
+ * -----------------------------------------------------------------------------------
+ * | NULL BITMAP | FIXED-SIZE or VARIED-SIZED OFFSET | PAYLOAD OF VARIED-SIZED FIELD |
+ * -----------------------------------------------------------------------------------
+ *
+ * The null bitmap holds one bit per column, which is set if the column is NULL (see Schema::GetNullBitmapSize). A NULL
+ * column still stores the NULL sentinel of its type, so code that reads serialized values directly sees the NULL too.
+ * If all columns of the schema are inlined, there is no varied-sized payload and every tuple has the same size.
+ *
+ * A varied-sized value too large for a table page is stored in a chain of overflow pages (see OverflowPage) instead,
+ * and its payload is replaced by a reference to the chain, whose length field holds OVERFLOW_FLAG and its size:
+ * --------------------------------------------------------------------------------------------------
+ * | OVERFLOW_FLAG + SIZE (4) | VALUE LENGTH (4) | FIRST OVERFLOW PAGE (4) | PREFIX OF THE VALUE (32) |
+ * --------------------------------------------------------------------------------------------------
+ * Such a value is only read from the chain when the column is read, so tuples read from a table heap remember the
+ * buffer pool holding their overflow pages.
  */
 class Tuple {
   friend class TablePage;
+  friend class PaxPage;
   friend class TableHeap;
   friend class TableIterator;
+  friend class TupleBuilder;
 
  public:
   // Default constructor (to create a dummy tuple)
@@ -48,6 +68,13 @@ class Tuple {
   // assign operator, deep copy
   auto operator=(const Tuple &other) -> Tuple &;
 
+  // copy constructor, deep copy into pool. The copy does not own its data, which lives until the copy is released or
+  // the pool goes away, and further copies of it are shallow.
+  Tuple(const Tuple &other, AbstractPool *pool);
+
+  // return the data of a tuple copied into pool to the pool
+  void Release(AbstractPool *pool);
+
   ~Tuple() {
     if (allocated_) {
       delete[] data_;
@@ -74,19 +101,83 @@ class Tuple {
   // checks the schema to see how to return the Value.
   auto GetValue(const Schema *schema, uint32_t column_idx) const -> Value;
 
+  // Is the value of the column stored in an overflow chain ?
+  auto IsOverflowed(const Schema *schema, uint32_t column_idx) const -> bool;
+
+  // Get the first page of the overflow chain holding the value of the column
+  auto GetOverflowPageId(const Schema *schema, uint32_t column_idx) const -> page_id_t;
+
+  // Get the size of the reference to an overflow chain holding a value of len bytes, including its length field
+  static inline auto GetOverflowReferenceSize(uint32_t len) -> uint32_t {
+    return 3 * sizeof(uint32_t) + std::min(len, OVERFLOW_PREFIX_SIZE);
+  }
+
+  // Marks the length of a varied-sized value that is stored in an overflow chain
+  static constexpr uint32_t OVERFLOW_FLAG = 1U << 31;
+  // The number of leading bytes of an overflowed value that are kept in the tuple
+  static constexpr uint32_t OVERFLOW_PREFIX_SIZE = 32;
+
+  // Get the dictionary code of a dictionary-encoded column, without decoding the string
+  auto GetDictionaryCode(const Schema *schema, uint32_t column_idx) const -> uint32_t;
+
+  // Encode a value of a dictionary-encoded column into its code
+  static auto EncodeDictionaryValue(const Column &col, const Value &value) -> uint32_t;
+
+  // Decode a code of a dictionary-encoded column back into its value
+  static auto DecodeDictionaryValue(const Column &col, uint32_t code) -> Value;
+
   // Generates a key tuple given schemas and attributes
-  auto KeyFromTuple(const Schema &schema, const Schema &key_schema, const std::vector<uint32_t> &key_attrs) -> Tuple;
+  auto KeyFromTuple(const Schema &schema, const Schema &key_schema, const std::vector<uint32_t> &key_attrs) const
+      -> Tuple;
+
+  // Read a fixed-width column straight from the tuple data, without building a Value. T must be the native type of the
+  // column (see NativeType), and a NULL reads as the NULL sentinel of the type.
+  template <class T>
+  inline auto GetNative(const Schema *schema, uint32_t column_idx) const -> T {
+    const auto &accessor = schema->GetAccessor(column_idx);
+    BUSTUB_ASSERT(accessor.inlined_ && !accessor.dictionary_encoded_ && Type::GetTypeSize(accessor.type_) == sizeof(T),
+                  "column is not of a fixed-width type of this size");
+    T value;
+    memcpy(&value, data_ + accessor.offset_, sizeof(T));
+    return value;
+  }
+
+  // Typed getters for the fixed-width types
+  inline auto GetBoolean(const Schema *schema, uint32_t column_idx) const -> int8_t {
+    return GetNative<int8_t>(schema, column_idx);
+  }
+  inline auto GetInt32(const Schema *schema, uint32_t column_idx) const -> int32_t {
+    return GetNative<int32_t>(schema, column_idx);
+  }
+  inline auto GetInt64(const Schema *schema, uint32_t column_idx) const -> int64_t {
+    return GetNative<int64_t>(schema, column_idx);
+  }
+  inline auto GetDecimal(const Schema *schema, uint32_t column_idx) const -> double {
+    return GetNative<double>(schema, column_idx);
+  }
 
   // Is the column value null ?
   inline auto IsNull(const Schema *schema, uint32_t column_idx) const -> bool {
-    Value value = GetValue(schema, column_idx);
-    return value.IsNull();
+    const auto &accessor = schema->GetAccessor(column_idx);
+    return (GetNullBitmap()[accessor.null_byte_] & accessor.null_mask_) != 0;
   }
+
+  // Get the null bitmap, which holds bit (i % 8) of byte (i / 8) for column i
+  inline auto GetNullBitmap() const -> const uint8_t * { return reinterpret_cast<const uint8_t *>(data_); }
+
+  // Set the null bit of a column in the serialized tuple at data, whose null bit must be clear
+  static inline void SetNullBit(char *data, const ColumnAccessor &accessor, bool is_null) {
+    data[accessor.null_byte_] = static_cast<char>(data[accessor.null_byte_] | accessor.null_mask_ * is_null);
+  }
+
   inline auto IsAllocated() -> bool { return allocated_; }
 
   auto ToString(const Schema *schema) const -> std::string;
 
  private:
+  // Serialize the value of an inlined column, and its null bit, into the tuple data at data
+  static void SerializeInlined(const Schema *schema, uint32_t column_idx, const Value &value, char *data);
+
   // Get the starting storage address of specific column
   auto GetDataPtr(const Schema *schema, uint32_t column_idx) const -> const char *;
 
@@ -94,6 +185,8 @@ class Tuple {
   RID rid_{};              // if pointing to the table heap, the rid is valid
   uint32_t size_{0};
   char *data_{nullptr};
+  // the buffer pool holding the overflow pages of the tuple, if it was read from a table heap
+  BufferPoolManager *overflow_bpm_{nullptr};
 };
 
 }  // namespace bustub
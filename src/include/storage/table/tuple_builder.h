@@ -0,0 +1,111 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// tuple_builder.h
+//
+// Identification: src/include/storage/table/tuple_builder.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+#include "catalog/schema.h"
+#include "common/macros.h"
+#include "storage/table/tuple.h"
+#include "type/abstract_pool.h"
+#include "type/value.h"
+
+namespace bustub {
+
+/**
+ * TupleBuilder serializes a row one column at a time, in the format of Tuple, without first collecting the values into
+ * a vector. The row is written into a buffer that the builder keeps across rows, so once it has grown to the size of
+ * the widest row, building a row allocates nothing. The finished row is then copied to wherever it goes: into a Tuple,
+ * whose own buffer is reused when it fits, into a pool, or into any caller-provided buffer such as a page slot.
+ *
+ *   builder.Reset();
+ *   for (const auto &expr : exprs) {
+ *     builder.Append(expr->Evaluate(&input, input_schema));
+ *   }
+ *   builder.Build(output);
+ */
+class TupleBuilder {
+ public:
+  /** @param schema the schema of the rows, which must outlive the builder */
+  explicit TupleBuilder(const Schema *schema) : schema_(schema) { Reset(); }
+
+  /** Start a new row. */
+  void Reset() {
+    next_column_ = 0;
+    size_ = schema_->GetLength();
+    Reserve(size_);
+    memset(buffer_.data(), 0, schema_->GetNullBitmapSize());
+  }
+
+  /** Append the value of the next column. */
+  void Append(const Value &value);
+
+  /**
+   * Append the value of the next column, which must be a non-NULL varied-sized value, as a reference to the overflow
+   * chain at first_page_id holding the value.
+   */
+  void AppendOverflowed(const Value &value, page_id_t first_page_id);
+
+  /**
+   * Append the value of the next column, which must be of a fixed-width type whose native type is T. The NULL sentinel
+   * of the type appends a NULL.
+   */
+  template <class T>
+  void AppendNative(T value) {
+    const auto &accessor = schema_->GetAccessor(next_column_++);
+    BUSTUB_ASSERT(accessor.inlined_ && !accessor.dictionary_encoded_ && Type::GetTypeSize(accessor.type_) == sizeof(T),
+                  "column is not of a fixed-width type of this size");
+    // The NULL sentinel of each native type is its lowest value, or its largest one for the unsigned TIMESTAMP.
+    constexpr T null_value = std::is_unsigned_v<T> ? std::numeric_limits<T>::max() : std::numeric_limits<T>::lowest();
+    Tuple::SetNullBit(buffer_.data(), accessor, value == null_value);
+    memcpy(buffer_.data() + accessor.offset_, &value, sizeof(T));
+  }
+
+  /** @return the size of the row */
+  auto GetSize() const -> uint32_t { return size_; }
+
+  /** @return the serialized row */
+  auto GetData() const -> const char * { return buffer_.data(); }
+
+  /** Copy the row to dest, which must hold GetSize() bytes. */
+  void CopyTo(char *dest) const {
+    BUSTUB_ASSERT(next_column_ == schema_->GetColumnCount(), "not all columns were appended");
+    memcpy(dest, buffer_.data(), size_);
+  }
+
+  /** Store the row in tuple, reusing the buffer of the tuple if it owns one of the size of the row. */
+  void Build(Tuple *tuple) const;
+
+  /** @return the row as a tuple whose data lives in pool, as if copied by Tuple(const Tuple &, AbstractPool *) */
+  auto Build(AbstractPool *pool) const -> Tuple;
+
+ private:
+  void Reserve(size_t size) {
+    if (buffer_.size() < size) {
+      buffer_.resize(std::max(size, 2 * buffer_.size()));
+    }
+  }
+
+  /** The schema of the rows */
+  const Schema *schema_;
+  /** The row being built, followed by unused space */
+  std::vector<char> buffer_;
+  /** The size of the row, including the varlen values appended so far */
+  uint32_t size_{0};
+  /** The index of the next column to append */
+  uint32_t next_column_{0};
+};
+
+}  // namespace bustub
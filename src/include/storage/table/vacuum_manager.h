@@ -0,0 +1,64 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// vacuum_manager.h
+//
+// Identification: src/include/storage/table/vacuum_manager.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>  // NOLINT
+#include <mutex>               // NOLINT
+#include <thread>              // NOLINT
+
+#include "catalog/catalog.h"
+#include "concurrency/transaction_manager.h"
+
+namespace bustub {
+
+/**
+ * VacuumManager periodically runs TableHeap::Vacuum on the tables of the catalog that had deletes, and moves the index
+ * entries of the tuples it relocates. A round blocks all transactions while it runs, like a checkpoint does.
+ */
+class VacuumManager {
+ public:
+  /**
+   * Create a new vacuum manager. The background thread is not started yet.
+   * @param catalog the catalog whose tables are vacuumed
+   * @param txn_manager the transaction manager, used to block transactions during a round
+   */
+  VacuumManager(Catalog *catalog, TransactionManager *txn_manager) : catalog_(catalog), txn_manager_(txn_manager) {}
+
+  ~VacuumManager() { StopVacuum(); }
+
+  /** Start vacuuming in the background every vacuum_interval. */
+  void StartVacuum();
+
+  /** Stop the background thread, waiting for a running round to finish. */
+  void StopVacuum();
+
+  /**
+   * Vacuum all tables with deletes since their last vacuum once. Transactions, which DDL runs in as well, are blocked
+   * before the catalog is read.
+   * @return the number of pages that were deallocated
+   */
+  auto RunVacuumRound() -> uint32_t;
+
+ private:
+  /** The body of the background thread. */
+  void RunVacuum();
+
+  Catalog *catalog_;
+  TransactionManager *txn_manager_;
+  std::atomic<bool> enable_vacuum_{false};
+  std::thread *vacuum_thread_{nullptr};
+  /** Wakes the background thread up early on StopVacuum */
+  std::mutex latch_;
+  std::condition_variable cv_;
+};
+
+}  // namespace bustub
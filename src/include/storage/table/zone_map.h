@@ -0,0 +1,97 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// zone_map.h
+//
+// Identification: src/include/storage/table/zone_map.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <optional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "catalog/schema.h"
+#include "common/config.h"
+#include "common/rwlatch.h"
+#include "storage/table/tuple.h"
+#include "type/value.h"
+
+namespace bustub {
+
+/**
+ * ZoneMap keeps a min/max summary of every column for each page of a table heap, next to the page chain of the heap.
+ * A scan with a filter predicate can rule out a whole page from its summary, and follow the chain past the page without
+ * fetching it from the buffer pool.
+ *
+ * The summaries only ever widen: inserts and updates extend them, deletes leave them alone. A page is therefore never
+ * skipped wrongly, it is only scanned needlessly after many deletes. NULL values are not tracked, as no comparison
+ * with NULL is true.
+ */
+class ZoneMap {
+ public:
+  /**
+   * Create an empty zone map.
+   * @param schema the schema of the table, which must outlive the zone map
+   */
+  explicit ZoneMap(const Schema *schema) : schema_(schema) {}
+
+  /**
+   * Register a freshly created page at the end of the page chain.
+   * @param prev_page_id the page that now links to page_id, or INVALID_PAGE_ID for the first page
+   * @param page_id the new page
+   */
+  void AppendPage(page_id_t prev_page_id, page_id_t page_id);
+
+  /**
+   * Unlink a page that was removed from the page chain.
+   * @param prev_page_id the page that linked to page_id and now links to its successor
+   * @param page_id the removed page
+   */
+  void RemovePage(page_id_t prev_page_id, page_id_t page_id);
+
+  /** Forget the summary of a page, e.g. before it is rebuilt from the tuples left after deletes. */
+  void ResetPage(page_id_t page_id);
+
+  /**
+   * Widen the summary of a page with the values of a tuple stored on it.
+   * @param page_id the page the tuple lives on
+   * @param tuple the inserted or updated tuple
+   */
+  void Update(page_id_t page_id, const Tuple &tuple);
+
+  /**
+   * @param page_id the page to look up
+   * @param column_idx the column to look up
+   * @return the [min, max] range of the column on the page, or std::nullopt if the page holds no non-NULL value of the
+   * column or is not tracked by this zone map
+   */
+  auto GetRange(page_id_t page_id, uint32_t column_idx) -> std::optional<std::pair<Value, Value>>;
+
+  /** @return true if page_id is tracked, i.e. its summary and its successor are known */
+  auto Contains(page_id_t page_id) -> bool;
+
+  /** @return the page following page_id in the page chain */
+  auto GetNextPageId(page_id_t page_id) -> page_id_t;
+
+ private:
+  /** The summary of one page. */
+  struct PageZone {
+    /** Per column minimum; std::nullopt until the first non-NULL value arrives */
+    std::vector<std::optional<Value>> min_;
+    /** Per column maximum */
+    std::vector<std::optional<Value>> max_;
+    /** The next page in the page chain */
+    page_id_t next_page_id_{INVALID_PAGE_ID};
+  };
+
+  const Schema *schema_;
+  std::unordered_map<page_id_t, PageZone> zones_;
+  ReaderWriterLatch latch_;
+};
+
+}  // namespace bustub
@@ -0,0 +1,112 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// arena_pool.h
+//
+// Identification: src/include/type/arena_pool.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <new>
+#include <vector>
+
+#include "common/macros.h"
+#include "type/abstract_pool.h"
+
+namespace bustub {
+
+/**
+ * ArenaPool hands out memory by bumping a pointer through large chunks, and releases all of it at once when it is
+ * destroyed. Every block is rounded up to a power-of-two size class, and a freed block goes onto the free list of its
+ * class, so an executor that rebuilds its state on every Init reuses its old blocks instead of growing the pool.
+ *
+ * Blocks are aligned like `new` aligns them. The pool is safe to share between threads.
+ */
+class ArenaPool : public AbstractPool {
+ public:
+  /** @param chunk_size the size of the chunks the pool bumps through */
+  explicit ArenaPool(size_t chunk_size = DEFAULT_CHUNK_SIZE) : chunk_size_(chunk_size) {}
+
+  ~ArenaPool() override = default;
+
+  DISALLOW_COPY_AND_MOVE(ArenaPool);
+
+  auto Allocate(size_t size) -> void * override;
+
+  void Free(void *ptr) override;
+
+  /** @return the number of bytes the pool holds in chunks */
+  auto GetCapacity() const -> size_t;
+
+  /** The default chunk size */
+  static constexpr size_t DEFAULT_CHUNK_SIZE = 64 * 1024;
+
+ private:
+  /** Every block is preceded by a header holding its size class, which keeps the block aligned */
+  static constexpr size_t HEADER_SIZE = alignof(std::max_align_t);
+  /** The size class of the smallest blocks, which is 2^4 = 16 bytes */
+  static constexpr size_t MIN_SIZE_CLASS = 4;
+  static constexpr size_t NUM_SIZE_CLASSES = 64;
+
+  /** @return the size class of a block of `size` bytes */
+  static auto SizeClassOf(size_t size) -> size_t;
+
+  const size_t chunk_size_;
+  mutable std::mutex latch_;
+  /** The chunks, including the ones holding a single large block */
+  std::vector<std::unique_ptr<char[]>> chunks_;
+  size_t capacity_{0};
+  /** The next free byte of the current chunk, and the bytes left in it */
+  char *cursor_{nullptr};
+  size_t remaining_{0};
+  /** The freed blocks of each size class, linked through their first bytes */
+  std::array<void *, NUM_SIZE_CLASSES> free_lists_{};
+};
+
+/** PoolAllocator is an STL allocator that allocates from an AbstractPool, such as the arena of an ExecutorContext. */
+template <class T>
+class PoolAllocator {
+ public:
+  using value_type = T;  // NOLINT
+
+  explicit PoolAllocator(AbstractPool *pool) : pool_(pool) {}
+
+  template <class U>
+  PoolAllocator(const PoolAllocator<U> &other) : pool_(other.GetPool()) {}  // NOLINT
+
+  auto allocate(size_t n) -> T * {  // NOLINT
+    static_assert(alignof(T) <= alignof(std::max_align_t), "over-aligned types are not supported");
+    void *ptr = pool_->Allocate(n * sizeof(T));
+    if (ptr == nullptr) {
+      throw std::bad_alloc();
+    }
+    return static_cast<T *>(ptr);
+  }
+
+  void deallocate(T *ptr, size_t n) { pool_->Free(ptr); }  // NOLINT
+
+  /** @return the pool the allocator allocates from */
+  auto GetPool() const -> AbstractPool * { return pool_; }
+
+  template <class U>
+  auto operator==(const PoolAllocator<U> &other) const -> bool {
+    return pool_ == other.GetPool();
+  }
+
+  template <class U>
+  auto operator!=(const PoolAllocator<U> &other) const -> bool {
+    return pool_ != other.GetPool();
+  }
+
+ private:
+  AbstractPool *pool_;
+};
+
+}  // namespace bustub
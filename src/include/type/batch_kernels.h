@@ -0,0 +1,133 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// batch_kernels.h
+//
+// Identification: src/include/type/batch_kernels.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "type/type_id.h"
+#include "type/type_kernels.h"
+#include "type/value.h"
+
+namespace bustub {
+
+/*
+ * Batch kernels for the fixed-width types.
+ *
+ * The kernels in type_kernels.h still handle one Value at a time. The kernels below instead run over a whole column of
+ * a batch of tuples, stored as a plain array of native values, which lets them use SIMD instructions. On x86-64 CPUs
+ * with AVX2 the comparisons, arithmetic and reductions over INTEGER, BIGINT and DECIMAL columns take an AVX2 path,
+ * which is picked at runtime; everywhere else they fall back to branch-free scalar loops, which compilers vectorize
+ * with the SSE2 baseline of x86-64.
+ */
+
+/** The comparisons that have batch kernels. */
+enum class CompareKernelOp : uint8_t { Equal, NotEqual, LessThan, LessThanOrEqual, GreaterThan, GreaterThanOrEqual };
+
+/**
+ * ColumnVector holds the values of one fixed-width column for a batch of tuples. The values are stored back to back
+ * as their native C++ type (see NativeType), and a null mask holds one byte per value, which is 1 for NULL and 0
+ * otherwise. The stored value of a NULL is unspecified.
+ */
+class ColumnVector {
+ public:
+  ColumnVector() = default;
+
+  /** Create a vector of `size` values of `type`, all zero and not NULL. */
+  ColumnVector(TypeId type, size_t size);
+
+  /** Wrap values serialized back to back, e.g. by TableHeap::ReadColumnChunk. NULLs are found by their sentinel. */
+  ColumnVector(TypeId type, std::vector<char> data);
+
+  /** Wrap values serialized back to back, together with their null mask, e.g. gathered from tuple null bitmaps. */
+  ColumnVector(TypeId type, std::vector<char> data, std::vector<uint8_t> nulls);
+
+  /** @return a vector holding `values`, which must all be of type `type` or NULL */
+  static auto FromValues(TypeId type, const std::vector<Value> &values) -> ColumnVector;
+
+  /** @return the type of the values */
+  inline auto GetType() const -> TypeId { return type_; }
+
+  /** @return the number of values */
+  inline auto GetSize() const -> size_t { return size_; }
+
+  /** @return the values, as an array of their native type */
+  template <class T>
+  inline auto GetData() const -> const T * {
+    return reinterpret_cast<const T *>(data_.data());
+  }
+
+  template <class T>
+  inline auto GetMutableData() -> T * {
+    return reinterpret_cast<T *>(data_.data());
+  }
+
+  /** @return the null mask */
+  inline auto GetNullMask() const -> const uint8_t * { return nulls_.data(); }
+  inline auto GetMutableNullMask() -> uint8_t * { return nulls_.data(); }
+
+  /** @return true if the i-th value is NULL */
+  inline auto IsNull(size_t i) const -> bool { return nulls_[i] != 0; }
+
+  /** @return the i-th value */
+  auto GetValue(size_t i) const -> Value;
+
+  /** Overwrite the i-th value with `value`, which must be of the type of the vector or NULL. */
+  void SetValue(size_t i, const Value &value);
+
+ private:
+  TypeId type_{TypeId::INVALID};
+  size_t size_{0};
+  std::vector<char> data_;
+  std::vector<uint8_t> nulls_;
+};
+
+/** @return true if the batch kernels support columns of `type`, which are INTEGER, BIGINT, DECIMAL and BOOLEAN */
+auto HasBatchKernels(TypeId type) -> bool;
+
+/**
+ * Select the rows where `column[i] op constant` holds, which excludes the rows where the column is NULL.
+ * @param constant a non-NULL value of the type of the column
+ * @param[out] selection the indices of the selected rows are appended here, in ascending order
+ */
+void SelectCompare(CompareKernelOp op, const ColumnVector &column, const Value &constant,
+                   std::vector<uint32_t> *selection);
+
+/**
+ * Select the rows where `lhs[i] op rhs[i]` holds, which excludes the rows where either side is NULL. Both vectors must
+ * have the same type and size.
+ * @param[out] selection the indices of the selected rows are appended here, in ascending order
+ */
+void SelectCompare(CompareKernelOp op, const ColumnVector &lhs, const ColumnVector &rhs,
+                   std::vector<uint32_t> *selection);
+
+/**
+ * Compute `lhs[i] op rhs[i]` for every row, which is NULL where either side is NULL. Both vectors must have the same
+ * numeric type and size. Integer overflow throws, as in IntegerParentType.
+ */
+auto Compute(ArithmeticKernelOp op, const ColumnVector &lhs, const ColumnVector &rhs) -> ColumnVector;
+
+/** @return the number of non-NULL values of `column` */
+auto CountColumn(const ColumnVector &column) -> size_t;
+
+/**
+ * @return the sum of the non-NULL values of a numeric column, as a value of the type of the column, or NULL if there
+ * are none. An integer sum that does not fit into the type throws.
+ */
+auto SumColumn(const ColumnVector &column) -> Value;
+
+/** @return the smallest non-NULL value of `column`, or NULL if there are none */
+auto MinColumn(const ColumnVector &column) -> Value;
+
+/** @return the largest non-NULL value of `column`, or NULL if there are none */
+auto MaxColumn(const ColumnVector &column) -> Value;
+
+}  // namespace bustub
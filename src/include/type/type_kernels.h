@@ -0,0 +1,233 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// type_kernels.h
+//
+// Identification: src/include/type/type_kernels.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+
+#include "common/exception.h"
+#include "common/macros.h"
+#include "type/limits.h"
+#include "type/type_id.h"
+#include "type/value.h"
+
+namespace bustub {
+
+/*
+ * Typed kernels for the fixed-width types.
+ *
+ * Value::CompareLessThan, Value::Add and friends look up the Type of the left-hand side, make a virtual call, and then
+ * switch on the type of the right-hand side, for every single row. The kernels below are instead instantiated for
+ * every pair of TypeIds and work on the native C++ values. A caller resolves a kernel once, e.g. per column or per
+ * expression, and then calls straight into it. VARCHAR has no kernels and keeps going through the Type hierarchy.
+ */
+
+/** The C++ type that the values of a fixed-width TypeId are stored as, and its NULL sentinel. */
+template <TypeId T>
+struct NativeType;
+
+template <>
+struct NativeType<TypeId::BOOLEAN> {
+  using Type = int8_t;
+  static constexpr Type NULL_VALUE = BUSTUB_BOOLEAN_NULL;
+};
+
+template <>
+struct NativeType<TypeId::TINYINT> {
+  using Type = int8_t;
+  static constexpr Type NULL_VALUE = BUSTUB_INT8_NULL;
+};
+
+template <>
+struct NativeType<TypeId::SMALLINT> {
+  using Type = int16_t;
+  static constexpr Type NULL_VALUE = BUSTUB_INT16_NULL;
+};
+
+template <>
+struct NativeType<TypeId::INTEGER> {
+  using Type = int32_t;
+  static constexpr Type NULL_VALUE = BUSTUB_INT32_NULL;
+};
+
+template <>
+struct NativeType<TypeId::BIGINT> {
+  using Type = int64_t;
+  static constexpr Type NULL_VALUE = BUSTUB_INT64_NULL;
+};
+
+template <>
+struct NativeType<TypeId::DECIMAL> {
+  using Type = double;
+  static constexpr Type NULL_VALUE = BUSTUB_DECIMAL_NULL;
+};
+
+template <>
+struct NativeType<TypeId::TIMESTAMP> {
+  using Type = uint64_t;
+  static constexpr Type NULL_VALUE = BUSTUB_TIMESTAMP_NULL;
+};
+
+/** The arithmetic operations that have kernels. */
+enum class ArithmeticKernelOp : uint8_t { Add, Subtract, Multiply };
+
+/** @return the type of `L op R`: DECIMAL if either side is DECIMAL, otherwise the wider integer type */
+template <TypeId L, TypeId R>
+constexpr auto ArithmeticResultType() -> TypeId {
+  if constexpr (L == TypeId::DECIMAL || R == TypeId::DECIMAL) {
+    return TypeId::DECIMAL;
+  } else if constexpr (sizeof(typename NativeType<L>::Type) >= sizeof(typename NativeType<R>::Type)) {
+    return L;
+  } else {
+    return R;
+  }
+}
+
+/** Three-way compare two non-NULL values of type L and R. @return a negative number, zero or a positive number */
+template <TypeId L, TypeId R>
+inline auto TypedCompare(const Value &lhs, const Value &rhs) -> int {
+  auto x = lhs.GetAs<typename NativeType<L>::Type>();
+  auto y = rhs.GetAs<typename NativeType<R>::Type>();
+  return static_cast<int>(y < x) - static_cast<int>(x < y);
+}
+
+/**
+ * Three-way compare two serialized values of type T. Like Value comparisons, a NULL is neither less than nor greater
+ * than anything, so it compares equal.
+ */
+template <TypeId T>
+inline auto TypedCompareRaw(const char *lhs, const char *rhs) -> int {
+  typename NativeType<T>::Type x;
+  typename NativeType<T>::Type y;
+  memcpy(&x, lhs, sizeof(x));
+  memcpy(&y, rhs, sizeof(y));
+  if (x == NativeType<T>::NULL_VALUE || y == NativeType<T>::NULL_VALUE) {
+    return 0;
+  }
+  return static_cast<int>(y < x) - static_cast<int>(x < y);
+}
+
+/** Compute `lhs op rhs` for two non-NULL values of type L and R. Integer overflow throws, as in IntegerParentType. */
+template <ArithmeticKernelOp Op, TypeId L, TypeId R>
+inline auto TypedCompute(const Value &lhs, const Value &rhs) -> Value {
+  constexpr TypeId RESULT_TYPE = ArithmeticResultType<L, R>();
+  using T = typename NativeType<RESULT_TYPE>::Type;
+  auto x = static_cast<T>(lhs.GetAs<typename NativeType<L>::Type>());
+  auto y = static_cast<T>(rhs.GetAs<typename NativeType<R>::Type>());
+  T result;
+  if constexpr (RESULT_TYPE == TypeId::DECIMAL) {
+    if constexpr (Op == ArithmeticKernelOp::Add) {
+      result = x + y;
+    } else if constexpr (Op == ArithmeticKernelOp::Subtract) {
+      result = x - y;
+    } else {
+      result = x * y;
+    }
+  } else {
+    bool overflow;
+    if constexpr (Op == ArithmeticKernelOp::Add) {
+      overflow = __builtin_add_overflow(x, y, &result);
+    } else if constexpr (Op == ArithmeticKernelOp::Subtract) {
+      overflow = __builtin_sub_overflow(x, y, &result);
+    } else {
+      overflow = __builtin_mul_overflow(x, y, &result);
+    }
+    if (overflow) {
+      throw Exception(ExceptionType::OUT_OF_RANGE, "Numeric value out of range.");
+    }
+  }
+  return {RESULT_TYPE, result};
+}
+
+using CompareKernel = auto (*)(const Value &lhs, const Value &rhs) -> int;
+using RawCompareKernel = auto (*)(const char *lhs, const char *rhs) -> int;
+using ArithmeticKernel = auto (*)(const Value &lhs, const Value &rhs) -> Value;
+
+/** @return the kernel comparing values of type lhs with values of type rhs, or nullptr if there is none */
+auto GetCompareKernel(TypeId lhs, TypeId rhs) -> CompareKernel;
+
+/** @return the kernel comparing two serialized values of type `type`, or nullptr if there is none */
+auto GetRawCompareKernel(TypeId type) -> RawCompareKernel;
+
+/** @return the kernel computing `lhs op rhs` for values of type lhs and rhs, or nullptr if there is none */
+auto GetArithmeticKernel(ArithmeticKernelOp op, TypeId lhs, TypeId rhs) -> ArithmeticKernel;
+
+/**
+ * TypedComparator compares values through a kernel resolved up front for the types the caller expects. Values of other
+ * types still compare correctly, they just take the slow path.
+ */
+class TypedComparator {
+ public:
+  TypedComparator() = default;
+
+  /** Resolve the kernel for comparing lhs_type values with rhs_type values. */
+  TypedComparator(TypeId lhs_type, TypeId rhs_type)
+      : lhs_type_(lhs_type), rhs_type_(rhs_type), kernel_(GetCompareKernel(lhs_type, rhs_type)) {}
+
+  /** @return the kernel for the types of lhs and rhs, or nullptr if they have to be compared through Type */
+  inline auto GetKernel(const Value &lhs, const Value &rhs) const -> CompareKernel {
+    if (lhs.GetTypeId() == lhs_type_ && rhs.GetTypeId() == rhs_type_) {
+      return kernel_;
+    }
+    return GetCompareKernel(lhs.GetTypeId(), rhs.GetTypeId());
+  }
+
+  /** Three-way compare two non-NULL values. @return a negative number, zero or a positive number */
+  inline auto Compare(const Value &lhs, const Value &rhs) const -> int {
+    if (auto kernel = GetKernel(lhs, rhs); kernel != nullptr) {
+      return kernel(lhs, rhs);
+    }
+    if (lhs.CompareLessThan(rhs) == CmpBool::CmpTrue) {
+      return -1;
+    }
+    return lhs.CompareGreaterThan(rhs) == CmpBool::CmpTrue ? 1 : 0;
+  }
+
+ private:
+  TypeId lhs_type_{TypeId::INVALID};
+  TypeId rhs_type_{TypeId::INVALID};
+  CompareKernel kernel_{nullptr};
+};
+
+/** TypedArithmetic is the TypedComparator of an arithmetic operation. */
+class TypedArithmetic {
+ public:
+  /** Resolve the kernel computing `lhs_type op rhs_type`. */
+  TypedArithmetic(ArithmeticKernelOp op, TypeId lhs_type, TypeId rhs_type)
+      : op_(op), lhs_type_(lhs_type), rhs_type_(rhs_type), kernel_(GetArithmeticKernel(op, lhs_type, rhs_type)) {}
+
+  /** @return `lhs op rhs` for two non-NULL values */
+  inline auto Compute(const Value &lhs, const Value &rhs) const -> Value {
+    auto kernel = lhs.GetTypeId() == lhs_type_ && rhs.GetTypeId() == rhs_type_
+                      ? kernel_
+                      : GetArithmeticKernel(op_, lhs.GetTypeId(), rhs.GetTypeId());
+    if (kernel != nullptr) {
+      return kernel(lhs, rhs);
+    }
+    switch (op_) {
+      case ArithmeticKernelOp::Add:
+        return lhs.Add(rhs);
+      case ArithmeticKernelOp::Subtract:
+        return lhs.Subtract(rhs);
+      case ArithmeticKernelOp::Multiply:
+        return lhs.Multiply(rhs);
+    }
+    UNREACHABLE("Unsupported arithmetic type.");
+  }
+
+ private:
+  ArithmeticKernelOp op_;
+  TypeId lhs_type_;
+  TypeId rhs_type_;
+  ArithmeticKernel kernel_;
+};
+
+}  // namespace bustub
@@ -64,6 +64,7 @@ class Value {
 
   Value() : Value(TypeId::INVALID) {}
   Value(const Value &other);
+  Value(Value &&other) noexcept;
   auto operator=(Value other) -> Value &;
   ~Value();
   // NOLINTNEXTLINE
@@ -127,6 +128,13 @@ class Value {
   inline auto IsZero() const -> bool { return Type::GetInstance(type_id_)->IsZero(*this); }
   inline auto IsNull() const -> bool { return size_.len_ == BUSTUB_VALUE_NULL; }
 
+  // Whether a VARCHAR is stored inside the value rather than behind a pointer. Owned strings of up to
+  // INLINE_VARLEN_LENGTH bytes, including the trailing '\0', always are, so copying them never allocates.
+  inline auto IsVarlenInlined() const -> bool { return manage_data_ && size_.len_ <= INLINE_VARLEN_LENGTH; }
+
+  // The longest VARCHAR, including the trailing '\0', that is stored inline
+  static constexpr uint32_t INLINE_VARLEN_LENGTH = 16;
+
   // Serialize this value into the given storage space. The inlined parameter
   // indicates whether we are allowed to inline this value into the storage
   // space, or whether we must store only a reference to this value. If inlined
@@ -145,6 +153,20 @@ class Value {
   inline auto Copy() const -> Value { return Type::GetInstance(type_id_)->Copy(*this); }
 
  protected:
+  // Point the value at storage for an owned string of len bytes, inline if it fits, and return it
+  inline auto AllocateVarlen(uint32_t len) -> char * {
+    if (len <= INLINE_VARLEN_LENGTH) {
+      return value_.inline_varlen_;
+    }
+    value_.varlen_ = new char[len];
+    return value_.varlen_;
+  }
+
+  // The data of a VARCHAR
+  inline auto GetVarlenData() const -> const char * {
+    return IsVarlenInlined() ? value_.inline_varlen_ : value_.const_varlen_;
+  }
+
   // The actual value item
   union Val {
     int8_t boolean_;
@@ -156,6 +178,7 @@ class Value {
     uint64_t timestamp_;
     char *varlen_;
     const char *const_varlen_;
+    char inline_varlen_[INLINE_VARLEN_LENGTH];
   } value_;
 
   union {
@@ -13,6 +13,7 @@
 #pragma once
 
 #include <algorithm>
+#include <cstring>
 #include <stdexcept>
 #include <string>
 
@@ -34,8 +35,22 @@ namespace bustub {
 
 class ValueFactory {
  public:
-  static inline auto Clone(const Value &src, __attribute__((__unused__)) AbstractPool *dataPool = nullptr) -> Value {
-    return src.Copy();
+  /**
+   * Copy a value. With a pool, the payload of a VARCHAR too long to be inlined is copied into the pool, and the copy
+   * does not own it; it lives until it is returned with Release, or until the pool goes away.
+   */
+  static inline auto Clone(const Value &src, AbstractPool *dataPool = nullptr) -> Value {
+    if (dataPool == nullptr || src.GetTypeId() != TypeId::VARCHAR || src.IsNull()) {
+      return src.Copy();
+    }
+    return GetVarcharValue(src.GetData(), src.GetLength(), false, dataPool);
+  }
+
+  /** Return the payload of a value cloned into `pool` to the pool. */
+  static inline void Release(const Value &value, AbstractPool *pool) {
+    if (value.GetTypeId() == TypeId::VARCHAR && !value.IsNull() && !value.IsVarlenInlined()) {
+      pool->Free(const_cast<char *>(value.GetData()));
+    }
   }
 
   static inline auto GetTinyIntValue(int8_t value) -> Value { return {TypeId::TINYINT, value}; }
@@ -58,19 +73,32 @@ class ValueFactory {
 
   static inline auto GetBooleanValue(int8_t value) -> Value { return {TypeId::BOOLEAN, value}; }
 
-  static inline auto GetVarcharValue(const char *value, bool manage_data,
-                                     __attribute__((__unused__)) AbstractPool *pool = nullptr) -> Value {
+  static inline auto GetVarcharValue(const char *value, bool manage_data, AbstractPool *pool = nullptr) -> Value {
     auto len = static_cast<uint32_t>(value == nullptr ? 0U : strlen(value) + 1);
-    return GetVarcharValue(value, len, manage_data);
+    return GetVarcharValue(value, len, manage_data, pool);
   }
 
-  static inline auto GetVarcharValue(const char *value, uint32_t len, bool manage_data,
-                                     __attribute__((__unused__)) AbstractPool *pool = nullptr) -> Value {
+  /**
+   * With a pool, the string is always copied, like Clone does: a short string is inlined into the value, and a longer
+   * one is copied into the pool and not managed.
+   */
+  static inline auto GetVarcharValue(const char *value, uint32_t len, bool manage_data, AbstractPool *pool = nullptr)
+      -> Value {
+    if (pool != nullptr && value != nullptr) {
+      if (len <= Value::INLINE_VARLEN_LENGTH) {
+        return {TypeId::VARCHAR, value, len, true};
+      }
+      auto *data = static_cast<char *>(pool->Allocate(len));
+      memcpy(data, value, len);
+      return {TypeId::VARCHAR, data, len, false};
+    }
     return {TypeId::VARCHAR, value, len, manage_data};
   }
 
-  static inline auto GetVarcharValue(const std::string &value, __attribute__((__unused__)) AbstractPool *pool = nullptr)
-      -> Value {
+  static inline auto GetVarcharValue(const std::string &value, AbstractPool *pool = nullptr) -> Value {
+    if (pool != nullptr) {
+      return GetVarcharValue(value.c_str(), static_cast<uint32_t>(value.length()) + 1, false, pool);
+    }
     return {TypeId::VARCHAR, value};
   }
 
@@ -0,0 +1,105 @@
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include "execution/expressions/column_value_expression.h"
+#include "execution/plans/aggregation_plan.h"
+#include "execution/plans/filter_plan.h"
+#include "execution/plans/index_scan_plan.h"
+#include "execution/plans/projection_plan.h"
+#include "execution/plans/sort_plan.h"
+#include "execution/plans/topn_plan.h"
+#include "optimizer/optimizer.h"
+
+namespace bustub {
+
+namespace {
+
+/** Mark the columns that expr reads from the tuples of the only child of its plan. */
+void MarkReadColumns(const AbstractExpression &expr, std::vector<bool> *read) {
+  if (const auto *column_expr = dynamic_cast<const ColumnValueExpression *>(&expr); column_expr != nullptr) {
+    (*read)[column_expr->GetColIdx()] = true;
+    return;
+  }
+  for (const auto &child : expr.GetChildren()) {
+    MarkReadColumns(*child, read);
+  }
+}
+
+/**
+ * Make the index scans in plan index-only where the index key holds every column they are read for, where read marks
+ * the output columns of plan that the plans above it read.
+ */
+auto MakeIndexOnly(const Catalog &catalog, const AbstractPlanNodeRef &plan, std::vector<bool> read)
+    -> AbstractPlanNodeRef {
+  switch (plan->GetType()) {
+    case PlanType::IndexScan: {
+      const auto &index_scan = dynamic_cast<const IndexScanPlanNode &>(*plan);
+      if (index_scan.filter_predicate_ != nullptr) {
+        MarkReadColumns(*index_scan.filter_predicate_, &read);
+      }
+      const auto &key_attrs = catalog.GetIndex(index_scan.GetIndexOid())->index_->GetKeyAttrs();
+      for (uint32_t col_idx = 0; col_idx < read.size(); col_idx++) {
+        if (read[col_idx] && std::find(key_attrs.begin(), key_attrs.end(), col_idx) == key_attrs.end()) {
+          return plan;
+        }
+      }
+      auto index_only_scan = std::make_shared<IndexScanPlanNode>(index_scan);
+      index_only_scan->index_only_ = true;
+      return index_only_scan;
+    }
+    // These pass the tuples of their child on, so the columns read above them are read from the child as well.
+    case PlanType::Filter:
+      MarkReadColumns(*dynamic_cast<const FilterPlanNode &>(*plan).GetPredicate(), &read);
+      break;
+    case PlanType::Sort:
+      for (const auto &[order_type, expr] : dynamic_cast<const SortPlanNode &>(*plan).GetOrderBy()) {
+        MarkReadColumns(*expr, &read);
+      }
+      break;
+    case PlanType::TopN:
+      for (const auto &[order_type, expr] : dynamic_cast<const TopNPlanNode &>(*plan).GetOrderBy()) {
+        MarkReadColumns(*expr, &read);
+      }
+      break;
+    case PlanType::Limit:
+      break;
+    // These only read the columns of their child that their expressions do.
+    case PlanType::Projection:
+      read.assign(plan->GetChildAt(0)->OutputSchema().GetColumnCount(), false);
+      for (const auto &expr : dynamic_cast<const ProjectionPlanNode &>(*plan).GetExpressions()) {
+        MarkReadColumns(*expr, &read);
+      }
+      break;
+    case PlanType::Aggregation: {
+      const auto &aggregation = dynamic_cast<const AggregationPlanNode &>(*plan);
+      read.assign(plan->GetChildAt(0)->OutputSchema().GetColumnCount(), false);
+      for (const auto &expr : aggregation.GetGroupBys()) {
+        MarkReadColumns(*expr, &read);
+      }
+      for (const auto &expr : aggregation.GetAggregates()) {
+        MarkReadColumns(*expr, &read);
+      }
+      break;
+    }
+    default: {
+      // Other plans may read any column of their children, and joins read columns of both.
+      std::vector<AbstractPlanNodeRef> children;
+      for (const auto &child : plan->GetChildren()) {
+        children.emplace_back(
+            MakeIndexOnly(catalog, child, std::vector<bool>(child->OutputSchema().GetColumnCount(), true)));
+      }
+      return plan->CloneWithChildren(std::move(children));
+    }
+  }
+  return plan->CloneWithChildren({MakeIndexOnly(catalog, plan->GetChildAt(0), std::move(read))});
+}
+
+}  // namespace
+
+auto Optimizer::OptimizeIndexScanAsIndexOnlyScan(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef {
+  // Whoever runs the plan reads every column of its output.
+  return MakeIndexOnly(catalog_, plan, std::vector<bool>(plan->OutputSchema().GetColumnCount(), true));
+}
+
+}  // namespace bustub
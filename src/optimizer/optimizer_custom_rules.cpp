@@ -15,6 +15,13 @@ auto Optimizer::OptimizeCustom(const AbstractPlanNodeRef &plan) -> AbstractPlanN
   // p = OptimizeNLJAsHashJoin(p);  // Enable this rule after you have implemented hash join.
   p = OptimizeOrderByAsIndexScan(p);
   p = OptimizeSortLimitAsTopN(p);
+  // Fold the remaining filters into their scans last, so that the rules above still see plain SeqScans. The scan
+  // checks the predicate against the per-page zone maps of the table.
+  p = OptimizeMergeFilterScan(p);
+  // A filter that bounds an indexed column then turns its scan into a range scan of the index.
+  p = OptimizeSeqScanAsIndexScan(p);
+  // Once the index scans are all in place, those that only read columns of the key skip the table.
+  p = OptimizeIndexScanAsIndexOnlyScan(p);
   return p;
 }
 
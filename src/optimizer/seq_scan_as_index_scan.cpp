@@ -0,0 +1,196 @@
+#include <algorithm>
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include "common/exception.h"
+#include "execution/expressions/column_value_expression.h"
+#include "execution/expressions/comparison_expression.h"
+#include "execution/expressions/constant_value_expression.h"
+#include "execution/expressions/logic_expression.h"
+#include "execution/plans/index_scan_plan.h"
+#include "execution/plans/seq_scan_plan.h"
+#include "optimizer/optimizer.h"
+
+namespace bustub {
+
+namespace {
+
+/** A `<column> <op> <constant>` conjunct of a scan predicate */
+struct ColumnComparison {
+  uint32_t col_idx_;
+  ComparisonType comp_type_;
+  Value value_;
+};
+
+/** Collect the conjuncts of expr that compare a column with a constant of its own type. */
+void CollectColumnComparisons(const AbstractExpression &expr, const Schema &schema,
+                              std::vector<ColumnComparison> *comparisons) {
+  if (const auto *logic_expr = dynamic_cast<const LogicExpression *>(&expr); logic_expr != nullptr) {
+    if (logic_expr->logic_type_ == LogicType::And) {
+      CollectColumnComparisons(*logic_expr->GetChildAt(0), schema, comparisons);
+      CollectColumnComparisons(*logic_expr->GetChildAt(1), schema, comparisons);
+    }
+    return;
+  }
+  const auto *cmp_expr = dynamic_cast<const ComparisonExpression *>(&expr);
+  if (cmp_expr == nullptr || cmp_expr->comp_type_ == ComparisonType::NotEqual) {
+    return;
+  }
+  auto comp_type = cmp_expr->comp_type_;
+  const auto *column_expr = dynamic_cast<const ColumnValueExpression *>(cmp_expr->GetChildAt(0).get());
+  const auto *constant_expr = dynamic_cast<const ConstantValueExpression *>(cmp_expr->GetChildAt(1).get());
+  if (column_expr == nullptr || constant_expr == nullptr) {
+    column_expr = dynamic_cast<const ColumnValueExpression *>(cmp_expr->GetChildAt(1).get());
+    constant_expr = dynamic_cast<const ConstantValueExpression *>(cmp_expr->GetChildAt(0).get());
+    if (column_expr == nullptr || constant_expr == nullptr) {
+      return;
+    }
+    switch (comp_type) {
+      case ComparisonType::LessThan:
+        comp_type = ComparisonType::GreaterThan;
+        break;
+      case ComparisonType::LessThanOrEqual:
+        comp_type = ComparisonType::GreaterThanOrEqual;
+        break;
+      case ComparisonType::GreaterThan:
+        comp_type = ComparisonType::LessThan;
+        break;
+      case ComparisonType::GreaterThanOrEqual:
+        comp_type = ComparisonType::LessThanOrEqual;
+        break;
+      default:
+        break;
+    }
+  }
+  if (column_expr->GetTupleIdx() != 0 || constant_expr->val_.IsNull()) {
+    return;
+  }
+  // The key is encoded from the value as it is, so the value must have the type of the column. Integer literals are
+  // cast to the wider numeric types, and kept out of the range if they do not fit.
+  auto val = constant_expr->val_;
+  auto col_type = schema.GetColumn(column_expr->GetColIdx()).GetType();
+  if (val.GetTypeId() != col_type) {
+    bool is_numeric = col_type == TypeId::TINYINT || col_type == TypeId::SMALLINT || col_type == TypeId::INTEGER ||
+                      col_type == TypeId::BIGINT || col_type == TypeId::DECIMAL;
+    if (!val.CheckInteger() || !is_numeric) {
+      return;
+    }
+    try {
+      val = val.CastAs(col_type);
+    } catch (const Exception &e) {
+      return;
+    }
+  }
+  comparisons->push_back({column_expr->GetColIdx(), comp_type, val});
+}
+
+/** Narrow bound, on a single column, to value if that is tighter, where is_upper tells which end of the range it is. */
+void TightenBound(std::optional<IndexScanBound> *bound, const Value &value, bool inclusive, bool is_upper) {
+  if (bound->has_value()) {
+    const auto &old_value = (*bound)->values_[0];
+    if (old_value.CompareEquals(value) == CmpBool::CmpTrue) {
+      (*bound)->inclusive_ = (*bound)->inclusive_ && inclusive;
+      return;
+    }
+    auto tighter = is_upper ? value.CompareLessThan(old_value) : value.CompareGreaterThan(old_value);
+    if (tighter != CmpBool::CmpTrue) {
+      return;
+    }
+  }
+  *bound = IndexScanBound{{value}, inclusive};
+}
+
+/** The range of an index that a predicate allows */
+struct IndexRange {
+  std::optional<IndexScanBound> lower_;
+  std::optional<IndexScanBound> upper_;
+  /** How much of the key the range pins down: two for each leading column fixed by equality, one for a bounded one */
+  size_t score_{0};
+  /**
+   * True if the range fixes a key column or is bounded on both ends. A range like `a > 0` may cover most of the table,
+   * which the index would then fetch in key order, one random heap access per tuple, so it is left to the seq scan.
+   */
+  bool selective_{false};
+};
+
+/**
+ * Build the range of the index on key_attrs from comparisons: the values of the leading key columns that are compared
+ * for equality, followed by the bounds on the next key column.
+ */
+auto MakeIndexRange(const std::vector<uint32_t> &key_attrs, const std::vector<ColumnComparison> &comparisons)
+    -> IndexRange {
+  IndexRange range;
+  std::vector<Value> prefix;
+  for (auto key_attr : key_attrs) {
+    auto equal = std::find_if(comparisons.begin(), comparisons.end(), [key_attr](const ColumnComparison &cmp) {
+      return cmp.col_idx_ == key_attr && cmp.comp_type_ == ComparisonType::Equal;
+    });
+    if (equal != comparisons.end()) {
+      prefix.push_back(equal->value_);
+      range.score_ += 2;
+      continue;
+    }
+    for (const auto &[col_idx, comp_type, value] : comparisons) {
+      if (col_idx != key_attr) {
+        continue;
+      }
+      if (comp_type == ComparisonType::LessThan || comp_type == ComparisonType::LessThanOrEqual) {
+        TightenBound(&range.upper_, value, comp_type == ComparisonType::LessThanOrEqual, true);
+      } else {
+        TightenBound(&range.lower_, value, comp_type == ComparisonType::GreaterThanOrEqual, false);
+      }
+    }
+    range.score_ += static_cast<size_t>(range.lower_.has_value() || range.upper_.has_value());
+    break;
+  }
+  range.selective_ = !prefix.empty() || (range.lower_.has_value() && range.upper_.has_value());
+  for (auto *bound : {&range.lower_, &range.upper_}) {
+    if (bound->has_value()) {
+      (*bound)->values_.insert((*bound)->values_.begin(), prefix.begin(), prefix.end());
+    } else if (!prefix.empty()) {
+      *bound = IndexScanBound{prefix, true};
+    }
+  }
+  return range;
+}
+
+}  // namespace
+
+auto Optimizer::OptimizeSeqScanAsIndexScan(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef {
+  std::vector<AbstractPlanNodeRef> children;
+  for (const auto &child : plan->GetChildren()) {
+    children.emplace_back(OptimizeSeqScanAsIndexScan(child));
+  }
+  auto optimized_plan = plan->CloneWithChildren(std::move(children));
+
+  if (optimized_plan->GetType() != PlanType::SeqScan) {
+    return optimized_plan;
+  }
+  const auto &seq_scan = dynamic_cast<const SeqScanPlanNode &>(*optimized_plan);
+  if (seq_scan.filter_predicate_ == nullptr) {
+    return optimized_plan;
+  }
+  const auto *table_info = catalog_.GetTable(seq_scan.GetTableOid());
+  std::vector<ColumnComparison> comparisons;
+  CollectColumnComparisons(*seq_scan.filter_predicate_, table_info->schema_, &comparisons);
+
+  // Scan the index whose range constrains the most leading key columns, as long as the range is selective. The whole
+  // predicate is still checked on the tuples in the range, so that the comparisons on other columns apply as well.
+  std::optional<IndexRange> best_range;
+  index_oid_t best_index_oid = 0;
+  for (const auto *index_info : catalog_.GetTableIndexes(seq_scan.table_name_)) {
+    auto range = MakeIndexRange(index_info->index_->GetKeyAttrs(), comparisons);
+    if (range.selective_ && (!best_range.has_value() || range.score_ > best_range->score_)) {
+      best_range = std::move(range);
+      best_index_oid = index_info->index_oid_;
+    }
+  }
+  if (best_range.has_value()) {
+    return std::make_shared<IndexScanPlanNode>(seq_scan.output_schema_, best_index_oid, std::move(best_range->lower_),
+                                               std::move(best_range->upper_), seq_scan.filter_predicate_);
+  }
+  return optimized_plan;
+}
+
+}  // namespace bustub
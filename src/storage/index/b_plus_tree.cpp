@@ -1,5 +1,7 @@
-
+#include <algorithm>
+#include <cstring>
 #include <string>
+#include <type_traits>
 
 #include "common/config.h"
 #include "common/exception.h"
@@ -11,52 +13,210 @@
 #include "storage/page/b_plus_tree_page.h"
 #include "storage/page/header_page.h"
 #include "storage/page/page.h"
-#include "iostream"
+
 namespace bustub {
 INDEX_TEMPLATE_ARGUMENTS
 BPLUSTREE_TYPE::BPlusTree(std::string name, BufferPoolManager *buffer_pool_manager, const KeyComparator &comparator,
-                          int leaf_max_size, int internal_max_size)
+                          int leaf_max_size, int internal_max_size, BPlusTreeMode mode, bool unique)
     : index_name_(std::move(name)),
       root_page_id_(INVALID_PAGE_ID),
       buffer_pool_manager_(buffer_pool_manager),
       comparator_(comparator),
       leaf_max_size_(leaf_max_size),
-      internal_max_size_(internal_max_size) {}
+      internal_max_size_(internal_max_size),
+      mode_(mode),
+      unique_(unique) {}
+
+INDEX_TEMPLATE_ARGUMENTS
+BPLUSTREE_TYPE::~BPlusTree() { DeleteDeferredNodes(); }
 
 /*
  * Helper function to decide whether current b+tree is empty
  */
 INDEX_TEMPLATE_ARGUMENTS
-auto BPLUSTREE_TYPE::IsEmpty() const -> bool { 
-  //Editing
-  return root_page_id_ == INVALID_PAGE_ID; 
+auto BPLUSTREE_TYPE::IsEmpty() const -> bool {
+  root_latch_.RLock();
+  bool is_empty = root_page_id_ == INVALID_PAGE_ID;
+  root_latch_.RUnlock();
+  return is_empty;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::FetchNode(page_id_t page_id) -> Page * {
+  Page *page = buffer_pool_manager_->FetchPage(page_id);
+  if (page == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "B+ tree cannot fetch a page: all frames are pinned");
+  }
+  return page;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::NewNode(page_id_t *page_id) -> Page * {
+  Page *page = buffer_pool_manager_->NewPage(page_id);
+  if (page == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "B+ tree cannot allocate a page: all frames are pinned");
+  }
+  return page;
 }
+
 /*****************************************************************************
  * SEARCH
  *****************************************************************************/
 /*
- * Return the only value that associated with input key
+ * Return the values that associated with input key
  * This method is used for point query
  * @return : true means key exists
  */
 INDEX_TEMPLATE_ARGUMENTS
 auto BPLUSTREE_TYPE::GetValue(const KeyType &key, std::vector<ValueType> *result, Transaction *transaction) -> bool {
-  
-  auto node_page_id = root_page_id_;
-  BPlusTreeLeafPage<KeyType, ValueType, KeyComparator>* leaf_target;
-  while(true){
-    auto node_page = buffer_pool_manager_->FetchPage(node_page_id);
-    auto node = reinterpret_cast<BPlusTreePage *>(node_page->GetData());
-
-    if(node->IsLeafPage()){
-      leaf_target = reinterpret_cast<BPlusTreeLeafPage<KeyType, ValueType, KeyComparator> *>(node_page->GetData());
-      break;
+  Page *page = FindLeaf(&key, false);
+  if (page == nullptr) {
+    return false;
+  }
+  auto *leaf = reinterpret_cast<LeafPage *>(page->GetData());
+  int index = leaf->FindKey(key, comparator_);
+  if (index >= 0) {
+    ReadValues(leaf, index, result);
+  }
+  page->RUnlatch();
+  buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+  return index >= 0;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::FindLeaf(const KeyType *key, bool write_leaf) -> Page * {
+  if (mode_ == BPlusTreeMode::B_LINK) {
+    return FindLeafBLink(key, write_leaf, nullptr);
+  }
+  // Nobody changes the type of a page while its parent, or root_latch_ for the root, is latched, so the type can be
+  // read before the page is latched to pick the latch mode.
+  auto latch = [write_leaf](Page *page) {
+    if (write_leaf && reinterpret_cast<BPlusTreePage *>(page->GetData())->IsLeafPage()) {
+      page->WLatch();
+    } else {
+      page->RLatch();
     }
-    
-    node_page_id = FindChildPageId(key, node_page);
+  };
+
+  root_latch_.RLock();
+  if (root_page_id_ == INVALID_PAGE_ID) {
+    root_latch_.RUnlock();
+    return nullptr;
   }
+  Page *page = FetchNode(root_page_id_);
+  latch(page);
+  root_latch_.RUnlock();
 
-  return false;
+  auto *node = reinterpret_cast<BPlusTreePage *>(page->GetData());
+  while (!node->IsLeafPage()) {
+    auto *internal = reinterpret_cast<InternalPage *>(node);
+    Page *child = FetchNode(key == nullptr ? internal->ValueAt(0) : internal->Lookup(*key, comparator_));
+    latch(child);
+    page->RUnlatch();
+    buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+    page = child;
+    node = reinterpret_cast<BPlusTreePage *>(page->GetData());
+  }
+  return page;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::FindLeafPessimistic(const KeyType &key, Operation op, LatchedPath *path) {
+  Page *page = FetchNode(root_page_id_);
+  page->WLatch();
+  path->pages_.push_back(page);
+  while (true) {
+    auto *node = reinterpret_cast<BPlusTreePage *>(page->GetData());
+    if (IsSafe(node, op, path->top_is_root_ && path->pages_.size() == 1)) {
+      ReleaseAncestors(path);
+    }
+    if (node->IsLeafPage()) {
+      return;
+    }
+    page = FetchNode(reinterpret_cast<InternalPage *>(node)->Lookup(key, comparator_));
+    page->WLatch();
+    path->pages_.push_back(page);
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::IsSafe(const BPlusTreePage *node, Operation op, bool is_root) const -> bool {
+  if (op == Operation::INSERT) {
+    // A leaf splits when it has no room left for another entry, an internal page when it has no room for another
+    // child.
+    return node->IsLeafPage() ? reinterpret_cast<const LeafPage *>(node)->HasRoomFor(2)
+                              : reinterpret_cast<const InternalPage *>(node)->HasRoomFor(1);
+  }
+  if (is_root) {
+    // The root only changes when a root leaf becomes empty or a root internal page is left with a single child.
+    return node->GetSize() > (node->IsLeafPage() ? 1 : 2);
+  }
+  return IsHalfFull(node, 1);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::IsHalfFull(const BPlusTreePage *node, int removed) const -> bool {
+  if (node->IsLeafPage()) {
+    return reinterpret_cast<const LeafPage *>(node)->IsHalfFull(removed);
+  }
+  return reinterpret_cast<const InternalPage *>(node)->IsHalfFull(removed);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::ReleaseAncestors(LatchedPath *path) {
+  if (path->root_latched_) {
+    root_latch_.WUnlock();
+    path->root_latched_ = false;
+  }
+  if (path->pages_.size() > 1) {
+    path->top_is_root_ = false;
+  }
+  for (size_t i = 0; i + 1 < path->pages_.size(); i++) {
+    path->pages_[i]->WUnlatch();
+    buffer_pool_manager_->UnpinPage(path->pages_[i]->GetPageId(), false);
+  }
+  path->pages_.erase(path->pages_.begin(), path->pages_.end() - 1);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::ReleasePath(LatchedPath *path) {
+  if (path->root_latched_) {
+    root_latch_.WUnlock();
+    path->root_latched_ = false;
+  }
+  for (Page *page : path->pages_) {
+    page->WUnlatch();
+    buffer_pool_manager_->UnpinPage(page->GetPageId(), true);
+  }
+  path->pages_.clear();
+  for (page_id_t page_id : path->deleted_pages_) {
+    DeleteNode(page_id);
+  }
+  path->deleted_pages_.clear();
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::DeleteNode(page_id_t page_id) {
+  {
+    // Page ids are not reused, so a deferred delete never hits a page that joined the tree since.
+    std::scoped_lock lock(deferred_deletes_latch_);
+    deferred_deletes_.push_back(page_id);
+  }
+  DeleteDeferredNodes();
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::DeleteDeferredNodes() {
+  std::scoped_lock lock(deferred_deletes_latch_);
+  auto pinned = std::remove_if(deferred_deletes_.begin(), deferred_deletes_.end(),
+                               [this](page_id_t id) { return buffer_pool_manager_->DeletePage(id); });
+  deferred_deletes_.erase(pinned, deferred_deletes_.end());
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::UnpinIteratorPage(page_id_t page_id) {
+  buffer_pool_manager_->UnpinPage(page_id, false);
+  DeleteDeferredNodes();
 }
 
 /*****************************************************************************
@@ -66,239 +226,479 @@ auto BPLUSTREE_TYPE::GetValue(const KeyType &key, std::vector<ValueType> *result
  * Insert constant key & value pair into b+ tree
  * if current tree is empty, start new tree, update root page id and insert
  * entry, otherwise insert into leaf page.
- * @return: since we only support unique key, if user try to insert duplicate
- * keys return false, otherwise return true.
+ * @return: if user try to insert a duplicate key into a unique tree, or a
+ * duplicate key & value pair into any tree, return false, otherwise return true.
  */
-
 INDEX_TEMPLATE_ARGUMENTS
-auto BPLUSTREE_TYPE::FindLeaf(const KeyType &key)-> Page *{
+auto BPLUSTREE_TYPE::Insert(const KeyType &key, const ValueType &value, Transaction *transaction) -> bool {
+  if (mode_ == BPlusTreeMode::B_LINK) {
+    return InsertBLink(key, value);
+  }
+  Page *page = FindLeaf(&key, true);
+  if (page != nullptr) {
+    auto *leaf = reinterpret_cast<LeafPage *>(page->GetData());
+    bool duplicate = unique_ && leaf->FindKey(key, comparator_) >= 0;
+    bool done = duplicate || leaf->HasRoomFor(2);
+    bool inserted = done && !duplicate && InsertIntoLeaf(leaf, key, value);
+    page->WUnlatch();
+    buffer_pool_manager_->UnpinPage(page->GetPageId(), inserted);
+    if (done) {
+      return inserted;
+    }
+  }
+  // The tree is empty or the leaf has to split.
+  return InsertPessimistic(key, value);
+}
 
-  auto node_page_id = root_page_id_;
-  
-  Page* node_page;
-  while(true){
-    node_page = buffer_pool_manager_->FetchPage(node_page_id);
-    auto node = reinterpret_cast<BPlusTreePage *>(node_page->GetData());
-    
-    std::cout << "Traversing node " << " " << node_page->GetPageId() << " " << node->GetPageId() << " " << node->IsLeafPage() << std::endl;
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::InsertPessimistic(const KeyType &key, const ValueType &value) -> bool {
+  LatchedPath path;
+  root_latch_.WLock();
+  path.root_latched_ = true;
+  if (root_page_id_ == INVALID_PAGE_ID) {
+    StartNewTree(key, value);
+    ReleasePath(&path);
+    return true;
+  }
 
-    if(node->IsLeafPage()){
-      return node_page;
-    }
-    
-    buffer_pool_manager_->UnpinPage(node_page_id, false);
-    node_page_id = (reinterpret_cast<InternalPage *>(node))->Lookup(key, comparator_);
+  FindLeafPessimistic(key, Operation::INSERT, &path);
+  auto *leaf = reinterpret_cast<LeafPage *>(path.pages_.back()->GetData());
+  if (!InsertIntoLeaf(leaf, key, value)) {
+    ReleasePath(&path);
+    return false;
+  }
+  if (!leaf->HasRoomFor(1)) {
+    page_id_t new_page_id;
+    Page *new_page = NewNode(&new_page_id);
+    auto *new_leaf = reinterpret_cast<LeafPage *>(new_page->GetData());
+    new_leaf->Init(new_page_id, leaf_max_size_);
+    leaf->MoveHalfTo(new_leaf);
+    KeyType separator = new_leaf->GetLowKey();
+    // The new leaf is only reachable through the latched leaf and its parent until the path is released.
+    buffer_pool_manager_->UnpinPage(new_page_id, true);
+    InsertIntoParent(&path, path.pages_.size() - 1, separator, new_page_id);
   }
+  ReleasePath(&path);
+  return true;
 }
+
 INDEX_TEMPLATE_ARGUMENTS
-auto BPLUSTREE_TYPE::FindChildPageId(const KeyType &key, Page* node_page) -> page_id_t {
-  auto internal_node = reinterpret_cast<InternalPage *>(node_page->GetData());
-  int i;
-  for(i = 1;i <= internal_node->GetSize();i++){
-    if(comparator_(internal_node->KeyAt(i), key) != -1){
-      break;
+auto BPLUSTREE_TYPE::InsertIntoLeaf(LeafPage *leaf, const KeyType &key, const ValueType &value) -> bool {
+  int index = leaf->FindKey(key, comparator_);
+  if (index < 0) {
+    return leaf->Insert(key, value, comparator_);
+  }
+  if (unique_) {
+    return false;
+  }
+  int count = leaf->GetValueCount(index);
+  if (count > 0 && count < LeafPage::POSTING_LIST_MAX_SIZE) {
+    return leaf->AddValue(index, value);
+  }
+  LeafPosting<ValueType> posting = leaf->GetPosting(index);
+  if (count == 0) {
+    if (!InsertIntoPostingPages(&posting, value)) {
+      return false;
     }
-    
+  } else {
+    // The posting list is full, so the values move into posting pages, which only shrinks the leaf.
+    auto &values = posting.values_;
+    auto position = std::lower_bound(values.begin(), values.end(), value);
+    if (position != values.end() && *position == value) {
+      return false;
+    }
+    values.insert(position, value);
+    WritePostingPages(&posting);
   }
-  if(i == internal_node->GetSize()+1){
-    return internal_node->ValueAt(i-1);
+  leaf->SetPosting(index, posting);
+  return true;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::StartNewTree(const KeyType &key, const ValueType &value) {
+  page_id_t root_page_id;
+  Page *page = NewNode(&root_page_id);
+  auto *root = reinterpret_cast<LeafPage *>(page->GetData());
+  root->Init(root_page_id, leaf_max_size_);
+  root->Insert(key, value, comparator_);
+  buffer_pool_manager_->UnpinPage(root_page_id, true);
+  root_page_id_ = root_page_id;
+  UpdateRootPageId(1);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::InsertIntoParent(LatchedPath *path, size_t level, const KeyType &key, page_id_t new_page_id) {
+  page_id_t old_page_id = path->pages_[level]->GetPageId();
+  if (level == 0) {
+    // Only an unsafe page splits, so the ancestors of the top page were kept latched, and there are none: it is the
+    // root.
+    BUSTUB_ASSERT(path->root_latched_, "the split page must be the root");
+    page_id_t root_page_id;
+    Page *page = NewNode(&root_page_id);
+    auto *root = reinterpret_cast<InternalPage *>(page->GetData());
+    root->Init(root_page_id, internal_max_size_);
+    root->PopulateNewRoot(old_page_id, key, new_page_id);
+    buffer_pool_manager_->UnpinPage(root_page_id, true);
+    root_page_id_ = root_page_id;
+    UpdateRootPageId();
+    return;
   }
-  if(comparator_(internal_node->KeyAt(i), key) == 0){
-    return internal_node->ValueAt(i);
+
+  auto *parent = reinterpret_cast<InternalPage *>(path->pages_[level - 1]->GetData());
+  if (parent->HasRoomFor(1)) {
+    parent->InsertNodeAfter(old_page_id, key, new_page_id);
+    return;
   }
+  page_id_t sibling_page_id;
+  Page *page = NewNode(&sibling_page_id);
+  auto *sibling = reinterpret_cast<InternalPage *>(page->GetData());
+  sibling->Init(sibling_page_id, internal_max_size_);
+  parent->InsertNodeAfterAndSplit(old_page_id, key, new_page_id, sibling);
+  KeyType separator = sibling->GetLowKey();
+  buffer_pool_manager_->UnpinPage(sibling_page_id, true);
+  InsertIntoParent(path, level - 1, separator, sibling_page_id);
+}
 
-  return internal_node->ValueAt(i-1);;
+/*****************************************************************************
+ * REMOVE
+ *****************************************************************************/
+/*
+ * Delete key & value pair associated with input key
+ * If current tree is empty, return immdiately.
+ * If not, User needs to first find the right leaf page as deletion target, then
+ * delete entry from leaf page. Remember to deal with redistribute or merge if
+ * necessary.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::Remove(const KeyType &key, Transaction *transaction) {
+  if (unique_) {
+    RemoveValue(key, nullptr);
+    return;
+  }
+  // The values go one at a time, so that no removal shrinks a leaf by more than the largest entry, which is what
+  // IsHalfFull and IsSafe allow for.
+  std::vector<ValueType> values;
+  GetValue(key, &values, transaction);
+  for (const auto &value : values) {
+    RemoveValue(key, &value);
+  }
 }
 
 INDEX_TEMPLATE_ARGUMENTS
-auto BPLUSTREE_TYPE::InsertInParent(BPlusTreePage* node, const KeyType &key, BPlusTreePage* node_extra) 
--> bool {
- if(node->GetPageId() == root_page_id_){
-  Page* root = buffer_pool_manager_->NewPage(&root_page_id_);
-  auto new_root = new BPlusTreeInternalPage<KeyType, page_id_t, KeyComparator>(); 
+void BPLUSTREE_TYPE::Remove(const KeyType &key, const ValueType &value, Transaction *transaction) {
+  RemoveValue(key, &value);
+}
 
-  new_root->Init(root->GetPageId(), -1, internal_max_size_);
-  new_root->SetValueAt(0, node->GetPageId());
-  new_root->SetValueAt(0, node_extra->GetPageId());
-  
-  root_page_id_ = root->GetPageId();
-  return true;
- }
- 
-  auto parent_node = reinterpret_cast<BPlusTreeInternalPage<KeyType, page_id_t, KeyComparator> *>(buffer_pool_manager_->FetchPage(node->GetParentPageId())->GetData());
-  if(parent_node->GetSize() < parent_node->GetMaxSize()){
-    int i;
-    for(i = 0;i <= parent_node->GetSize();i++){
-      if(parent_node->ValueAt(i) == node->GetParentPageId()){
-        break;
-      }
-    }
-    int j = parent_node->GetSize();
-    while(j > i){
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::RemoveValue(const KeyType &key, const ValueType *value) {
+  if (mode_ == BPlusTreeMode::B_LINK) {
+    RemoveBLink(key, value);
+    return;
+  }
+  Page *page = FindLeaf(&key, true);
+  if (page == nullptr) {
+    return;
+  }
+  auto *leaf = reinterpret_cast<LeafPage *>(page->GetData());
+  bool found = leaf->FindKey(key, comparator_) >= 0;
+  // The leaf may have become the root meanwhile, so never let the optimistic path empty it.
+  bool done = !found || (leaf->GetSize() > 1 && leaf->IsHalfFull(1));
+  bool removed = done && found && RemoveFromLeaf(leaf, key, value);
+  page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(page->GetPageId(), removed);
+  if (!done) {
+    RemovePessimistic(key, value);
+  }
+}
 
-      parent_node->SetKeyAt(j+1, parent_node->KeyAt(j));
-      parent_node->SetValueAt(j+1, parent_node->ValueAt(j));
-      j--;
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::RemovePessimistic(const KeyType &key, const ValueType *value) {
+  LatchedPath path;
+  root_latch_.WLock();
+  path.root_latched_ = true;
+  if (root_page_id_ != INVALID_PAGE_ID) {
+    FindLeafPessimistic(key, Operation::REMOVE, &path);
+    auto *leaf = reinterpret_cast<LeafPage *>(path.pages_.back()->GetData());
+    if (RemoveFromLeaf(leaf, key, value)) {
+      HandleUnderflow(&path, path.pages_.size() - 1);
     }
-    parent_node->SetKeyAt(i+1, key);
-    parent_node->SetValueAt(i+1, node_extra->GetPageId());
+  }
+  ReleasePath(&path);
+}
 
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::RemoveFromLeaf(LeafPage *leaf, const KeyType &key, const ValueType *value) -> bool {
+  int index = leaf->FindKey(key, comparator_);
+  if (index < 0) {
+    return false;
+  }
+  if (value == nullptr) {
+    BUSTUB_ASSERT(unique_, "a key can only be removed with all of its values from a unique tree");
+    return leaf->Remove(key, comparator_);
   }
-  else{
-    parent_node->SetSize(parent_node->GetSize()+1);
-    int i;
-    for(i = 0;i <= parent_node->GetSize();i++){
-      if(parent_node->ValueAt(i) == node->GetParentPageId()){
-        break;
+  if (leaf->GetValueCount(index) > 0) {
+    return leaf->RemoveValue(index, *value);
+  }
+  LeafPosting<ValueType> posting = leaf->GetPosting(index);
+  if (!RemoveFromPostingPages(&posting, *value)) {
+    return false;
+  }
+  if (posting.first_page_id_ == INVALID_PAGE_ID) {
+    leaf->Remove(key, comparator_);
+    return true;
+  }
+  if (posting.first_page_id_ == posting.last_page_id_) {
+    // A key left with no more values than an inline posting list holds takes them back from its only posting page.
+    Page *page = FetchNode(posting.first_page_id_);
+    auto *node = reinterpret_cast<PostingPage *>(page->GetData());
+    int count = node->GetSize();
+    page_id_t page_id = posting.first_page_id_;
+    bool inline_values = count <= LeafPage::POSTING_LIST_MAX_SIZE && leaf->HasRoomForValues(index, count);
+    if (inline_values) {
+      for (int i = 0; i < count; i++) {
+        posting.values_.push_back(node->ValueAt(i));
       }
+      posting.first_page_id_ = INVALID_PAGE_ID;
+      posting.last_page_id_ = INVALID_PAGE_ID;
     }
-
-    int j = parent_node->GetSize();
-    while(j > i){
-
-      parent_node->SetKeyAt(j+1, parent_node->KeyAt(j));
-      parent_node->SetValueAt(j+1, parent_node->ValueAt(j));
-      j--;
+    buffer_pool_manager_->UnpinPage(page_id, false);
+    if (inline_values) {
+      DeleteNode(page_id);
     }
-    parent_node->SetKeyAt(i+1, key);
-    parent_node->SetValueAt(i+1, node_extra->GetPageId());
-
-    Page* root = buffer_pool_manager_->NewPage(&root_page_id_); //Upin it later
-    // Create L+1
-    auto *parent_extra = new BPlusTreeInternalPage<KeyType, page_id_t, KeyComparator>();
+  }
+  leaf->SetPosting(index, posting);
+  return true;
+}
 
-    //Initialise the new leaf value
-    parent_extra->Init(root->GetPageId(), parent_node->GetParentPageId(), leaf_max_size_+1);
-    int h = (parent_node->GetSize()+1)/2;
-    parent_node->SetSize(h-1);
-    for(int i=h+1;i <= parent_extra->GetSize();i++){
-      parent_extra->SetKeyAt(i, parent_extra->KeyAt(i));
+/*****************************************************************************
+ * POSTING PAGES
+ *****************************************************************************/
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::ReadValues(const LeafPage *leaf, int index, std::vector<ValueType> *values) {
+  int count = leaf->GetValueCount(index);
+  for (int i = 0; i < count; i++) {
+    values->push_back(leaf->ValueAt(index, i));
+  }
+  if (count > 0) {
+    return;
+  }
+  page_id_t page_id = leaf->GetPosting(index).first_page_id_;
+  while (page_id != INVALID_PAGE_ID) {
+    Page *page = FetchNode(page_id);
+    auto *node = reinterpret_cast<PostingPage *>(page->GetData());
+    for (int i = 0; i < node->GetSize(); i++) {
+      values->push_back(node->ValueAt(i));
     }
-    parent_extra->SetSize(parent_extra->GetSize()/2);
+    page_id = node->GetNextPageId();
+    buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+  }
+}
 
-    InsertInParent(parent_node, parent_node->KeyAt(h), parent_extra);
-    
-    
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::WritePostingPages(LeafPosting<ValueType> *posting) {
+  const auto &values = posting->values_;
+  Page *last_page = nullptr;
+  for (size_t begin = 0; begin < values.size();) {
+    page_id_t page_id;
+    Page *page = NewNode(&page_id);
+    auto *node = reinterpret_cast<PostingPage *>(page->GetData());
+    node->Init(page_id);
+    int size = std::min(static_cast<int>(values.size() - begin), node->GetMaxSize());
+    node->CopyNFrom(values.data() + begin, size);
+    begin += size;
+    if (last_page == nullptr) {
+      posting->first_page_id_ = page_id;
+    } else {
+      reinterpret_cast<PostingPage *>(last_page->GetData())->SetNextPageId(page_id);
+      buffer_pool_manager_->UnpinPage(last_page->GetPageId(), true);
     }
-
-  return true;
+    last_page = page;
+  }
+  posting->last_page_id_ = last_page->GetPageId();
+  buffer_pool_manager_->UnpinPage(last_page->GetPageId(), true);
+  posting->values_.clear();
 }
 
 INDEX_TEMPLATE_ARGUMENTS
-auto BPLUSTREE_TYPE::InsertInLeaf(const KeyType &key, const ValueType &value, BPlusTreeLeafPage<KeyType, ValueType, KeyComparator>* leaf_node) 
--> bool {
-
-  if(leaf_node->GetSize() == 0 || comparator_(leaf_node->KeyAt(leaf_node->GetSize()), key) == -1){
-    leaf_node->SetKeyAt(leaf_node->GetSize()+1, key);
-    leaf_node->SetValueAt(leaf_node->GetSize()+1, value);
-    return true;
-  }
-  int i;
-  for(i = 1;i <= leaf_node->GetSize();i++){
-    if(comparator_(leaf_node->KeyAt(i), key) != -1){
-      break;
+auto BPLUSTREE_TYPE::InsertIntoPostingPages(LeafPosting<ValueType> *posting, const ValueType &value) -> bool {
+  // Tables mostly grow at their end, so new values mostly go after all the others, onto the last page.
+  Page *page = FetchNode(posting->last_page_id_);
+  auto *node = reinterpret_cast<PostingPage *>(page->GetData());
+  bool append = node->ValueAt(node->GetSize() - 1) < value;
+  if (!append) {
+    buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+    // Otherwise value goes onto the first page whose values end at or above it.
+    page = FetchNode(posting->first_page_id_);
+    node = reinterpret_cast<PostingPage *>(page->GetData());
+    while (node->ValueAt(node->GetSize() - 1) < value) {
+      page_id_t next_page_id = node->GetNextPageId();
+      buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+      page = FetchNode(next_page_id);
+      node = reinterpret_cast<PostingPage *>(page->GetData());
     }
-    
   }
-  if(comparator_(leaf_node->KeyAt(i), key) == 0){
+  if (node->GetSize() < node->GetMaxSize()) {
+    bool inserted = node->Insert(value);
+    buffer_pool_manager_->UnpinPage(page->GetPageId(), inserted);
+    return inserted;
+  }
+  int index = node->ValueIndex(value);
+  if (index < node->GetSize() && node->ValueAt(index) == value) {
+    buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
     return false;
   }
-  int j = leaf_node->GetSize();
-  while(j >= i){
 
-    leaf_node->SetKeyAt(j+1, leaf_node->KeyAt(j));
-    leaf_node->SetValueAt(j+1, leaf_node->ValueAt(j));
-    j--;
+  page_id_t new_page_id;
+  Page *new_page = NewNode(&new_page_id);
+  auto *new_node = reinterpret_cast<PostingPage *>(new_page->GetData());
+  new_node->Init(new_page_id);
+  if (append) {
+    // Appended values leave full pages behind, rather than half full ones.
+    node->SetNextPageId(new_page_id);
+    new_node->Insert(value);
+  } else {
+    node->MoveHalfTo(new_node);
+    (value < new_node->ValueAt(0) ? node : new_node)->Insert(value);
   }
-
-  leaf_node->SetKeyAt(i, key);
-  leaf_node->SetValueAt(i, value);
-
-  leaf_node->IncreaseSize(1);
-  
+  if (posting->last_page_id_ == page->GetPageId()) {
+    posting->last_page_id_ = new_page_id;
+  }
+  buffer_pool_manager_->UnpinPage(new_page_id, true);
+  buffer_pool_manager_->UnpinPage(page->GetPageId(), true);
   return true;
-
 }
 
-
-
 INDEX_TEMPLATE_ARGUMENTS
-auto BPLUSTREE_TYPE::Insert(const KeyType &key, const ValueType &value, Transaction *transaction) -> bool {
-  // std::cout << "I am here for insert" << std::endl;
-  if(IsEmpty()){
-    //create a new page
-    Page* root = buffer_pool_manager_->NewPage(&root_page_id_);
-    
-    //create a new leaf page
-    //apply root id, and reset
-    auto *root_leaf = reinterpret_cast<LeafPage *>(root->GetData());
-
-    //Initialise the new leaf value
-    root_leaf->Init(root->GetPageId(), INVALID_PAGE_ID, leaf_max_size_);
-    root_leaf->Insert(key, value, comparator_);
-    buffer_pool_manager_->UnpinPage(root_page_id_, true);
-    UpdateRootPageId(1);
-    
-    return true;
+auto BPLUSTREE_TYPE::RemoveFromPostingPages(LeafPosting<ValueType> *posting, const ValueType &value) -> bool {
+  Page *prev_page = nullptr;
+  Page *page = FetchNode(posting->first_page_id_);
+  auto *node = reinterpret_cast<PostingPage *>(page->GetData());
+  while (node->ValueAt(node->GetSize() - 1) < value && node->GetNextPageId() != INVALID_PAGE_ID) {
+    if (prev_page != nullptr) {
+      buffer_pool_manager_->UnpinPage(prev_page->GetPageId(), false);
+    }
+    prev_page = page;
+    page = FetchNode(node->GetNextPageId());
+    node = reinterpret_cast<PostingPage *>(page->GetData());
   }
+  bool removed = node->Remove(value);
+  // Neighbouring pages whose values fit onto one page are merged, which also takes an emptied page out of the chain,
+  // so a chain of more than one page holds more values than any one page, and far more than an inline posting list.
+  page_id_t deleted_page_id = INVALID_PAGE_ID;
+  if (removed && prev_page != nullptr) {
+    auto *prev_node = reinterpret_cast<PostingPage *>(prev_page->GetData());
+    if (prev_node->GetSize() + node->GetSize() <= prev_node->GetMaxSize()) {
+      node->MoveAllTo(prev_node);
+      deleted_page_id = page->GetPageId();
+    }
+  }
+  if (removed && deleted_page_id == INVALID_PAGE_ID && node->GetNextPageId() != INVALID_PAGE_ID) {
+    Page *next_page = FetchNode(node->GetNextPageId());
+    auto *next_node = reinterpret_cast<PostingPage *>(next_page->GetData());
+    bool merged = node->GetSize() + next_node->GetSize() <= node->GetMaxSize();
+    if (merged) {
+      next_node->MoveAllTo(node);
+      deleted_page_id = next_page->GetPageId();
+    }
+    buffer_pool_manager_->UnpinPage(next_page->GetPageId(), merged);
+  }
+  if (removed && deleted_page_id == INVALID_PAGE_ID && node->GetSize() == 0) {
+    // The only page is empty, and so is the posting.
+    posting->first_page_id_ = INVALID_PAGE_ID;
+    posting->last_page_id_ = INVALID_PAGE_ID;
+    deleted_page_id = page->GetPageId();
+  }
+  if (deleted_page_id != INVALID_PAGE_ID && posting->last_page_id_ == deleted_page_id) {
+    posting->last_page_id_ = deleted_page_id == page->GetPageId() ? prev_page->GetPageId() : page->GetPageId();
+  }
+  if (prev_page != nullptr) {
+    buffer_pool_manager_->UnpinPage(prev_page->GetPageId(), deleted_page_id == page->GetPageId());
+  }
+  buffer_pool_manager_->UnpinPage(page->GetPageId(), removed);
+  if (deleted_page_id != INVALID_PAGE_ID) {
+    DeleteNode(deleted_page_id);
+  }
+  return removed;
+}
 
-  
- 
-  Page* leaf_page = FindLeaf(key);
-  auto leaf_target = reinterpret_cast<LeafPage *>(leaf_page->GetData());
-
-  if(!leaf_target->Insert(key, value, comparator_)){
-    buffer_pool_manager_->UnpinPage(leaf_page->GetPageId(), false);
-    return false;
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::HandleUnderflow(LatchedPath *path, size_t level) {
+  Page *page = path->pages_[level];
+  auto *node = reinterpret_cast<BPlusTreePage *>(page->GetData());
+  if (level == 0 && path->top_is_root_) {
+    // The root may hold fewer entries than the other pages, but an empty root leaf or a root internal page with a
+    // single child goes away.
+    if (node->IsLeafPage() && node->GetSize() == 0) {
+      path->deleted_pages_.push_back(node->GetPageId());
+      root_page_id_ = INVALID_PAGE_ID;
+      UpdateRootPageId();
+    } else if (!node->IsLeafPage() && node->GetSize() == 1) {
+      path->deleted_pages_.push_back(node->GetPageId());
+      root_page_id_ = reinterpret_cast<InternalPage *>(node)->ValueAt(0);
+      UpdateRootPageId();
+    }
+    return;
   }
-  if(leaf_target->GetSize() <= leaf_target->GetMaxSize()) {
-    
-    buffer_pool_manager_->UnpinPage(leaf_page->GetPageId(), true);
-    return true;
+  if (IsHalfFull(node, 0)) {
+    return;
   }
+  BUSTUB_ASSERT(level > 0, "a page that underflows must have its parent latched");
 
-  Page* root = buffer_pool_manager_->NewPage(&root_page_id_); //Upin it later
-  // Create L+1
-  auto *leaf_overflow = new BPlusTreeLeafPage<KeyType, ValueType, KeyComparator>();
+  auto *parent = reinterpret_cast<InternalPage *>(path->pages_[level - 1]->GetData());
+  int index = parent->ValueIndex(node->GetPageId());
+  bool sibling_is_right = index + 1 < parent->GetSize();
+  int right_index = sibling_is_right ? index + 1 : index;
+  Page *sibling_page = FetchNode(parent->ValueAt(sibling_is_right ? index + 1 : index - 1));
+  if (sibling_is_right) {
+    sibling_page->WLatch();
+  } else {
+    // Siblings are latched from left to right, like iterators moving through the leaves do. While the parent stays
+    // latched, only such an iterator can get to the page in between.
+    page->WUnlatch();
+    sibling_page->WLatch();
+    page->WLatch();
+  }
+  Page *left_page = sibling_is_right ? page : sibling_page;
+  Page *right_page = sibling_is_right ? sibling_page : page;
 
-  //Initialise the new leaf value
-  leaf_overflow->Init(root->GetPageId(), leaf_target->GetParentPageId(), leaf_max_size_+1);
-  
-  for(int i = 1;i <= leaf_target->GetSize();i++){
-    leaf_overflow->SetKeyAt(i, leaf_target->KeyAt(i));
-    leaf_overflow->SetValueAt(i, leaf_target->ValueAt(i));
+  // Pages merge if their entries fit into one, and even out otherwise. The new separator may be longer than the old
+  // one, so if the parent has no room for that, the page is left as it is.
+  bool merged;
+  KeyType separator;
+  bool redistributed = false;
+  if (node->IsLeafPage()) {
+    auto *left = reinterpret_cast<LeafPage *>(left_page->GetData());
+    auto *right = reinterpret_cast<LeafPage *>(right_page->GetData());
+    merged = right->MoveAllTo(left);
+    if (!merged && parent->HasRoomForLongerKey()) {
+      redistributed = left->Redistribute(right, &separator);
+    }
+  } else {
+    auto *left = reinterpret_cast<InternalPage *>(left_page->GetData());
+    auto *right = reinterpret_cast<InternalPage *>(right_page->GetData());
+    merged = right->MoveAllTo(left);
+    if (!merged && parent->HasRoomForLongerKey()) {
+      redistributed = left->Redistribute(right, &separator);
+    }
   }
-  if(!InsertInLeaf(key, value, leaf_overflow)){
-    return false;
+  if (redistributed) {
+    parent->SetKeyAt(right_index, separator);
   }
-  int h = (leaf_overflow->GetSize()+1)/2;
-  leaf_target->SetSize(h);
-  for(int i=h+1;i <= leaf_overflow->GetSize();i++){
-    leaf_overflow->SetKeyAt(i, leaf_overflow->KeyAt(i));
+  if (merged) {
+    // An iterator may hold the page pinned to go on from there, and must not take it for a leaf anymore. The page is
+    // deleted once the iterator lets go of it.
+    reinterpret_cast<BPlusTreePage *>(right_page->GetData())->SetPageType(IndexPageType::INVALID_INDEX_PAGE);
   }
-  leaf_overflow->SetSize(leaf_overflow->GetSize()/2);
-
-  
-  leaf_overflow->SetNextPageId(leaf_target->GetNextPageId());
-  leaf_target->SetNextPageId(leaf_overflow->GetPageId());
-
+  sibling_page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(sibling_page->GetPageId(), merged || redistributed);
 
-  return true;
+  if (merged) {
+    parent->Remove(right_index);
+    path->deleted_pages_.push_back(right_page->GetPageId());
+    HandleUnderflow(path, level - 1);
+  }
 }
 
-/*****************************************************************************
- * REMOVE
- *****************************************************************************/
-/*
- * Delete key & value pair associated with input key
- * If current tree is empty, return immdiately.
- * If not, User needs to first find the right leaf page as deletion target, then
- * delete entry from leaf page. Remember to deal with redistribute or merge if
- * necessary.
- */
-INDEX_TEMPLATE_ARGUMENTS
-void BPLUSTREE_TYPE::Remove(const KeyType &key, Transaction *transaction) {}
-
 /*****************************************************************************
  * INDEX ITERATOR
  *****************************************************************************/
@@ -308,7 +708,11 @@ void BPLUSTREE_TYPE::Remove(const KeyType &key, Transaction *transaction) {}
  * @return : index iterator
  */
 INDEX_TEMPLATE_ARGUMENTS
-auto BPLUSTREE_TYPE::Begin() -> INDEXITERATOR_TYPE { return INDEXITERATOR_TYPE(); }
+auto BPLUSTREE_TYPE::Begin() -> INDEXITERATOR_TYPE {
+  INDEXITERATOR_TYPE itr(this, std::nullopt, std::nullopt);
+  CopyLeaf(nullptr, true, &itr);
+  return itr;
+}
 
 /*
  * Input parameter is low key, find the leaf page that contains the input key
@@ -316,7 +720,11 @@ auto BPLUSTREE_TYPE::Begin() -> INDEXITERATOR_TYPE { return INDEXITERATOR_TYPE()
  * @return : index iterator
  */
 INDEX_TEMPLATE_ARGUMENTS
-auto BPLUSTREE_TYPE::Begin(const KeyType &key) -> INDEXITERATOR_TYPE { return INDEXITERATOR_TYPE(); }
+auto BPLUSTREE_TYPE::Begin(const KeyType &key) -> INDEXITERATOR_TYPE {
+  INDEXITERATOR_TYPE itr(this, std::nullopt, std::nullopt);
+  CopyLeaf(&key, true, &itr);
+  return itr;
+}
 
 /*
  * Input parameter is void, construct an index iterator representing the end
@@ -326,11 +734,594 @@ auto BPLUSTREE_TYPE::Begin(const KeyType &key) -> INDEXITERATOR_TYPE { return IN
 INDEX_TEMPLATE_ARGUMENTS
 auto BPLUSTREE_TYPE::End() -> INDEXITERATOR_TYPE { return INDEXITERATOR_TYPE(); }
 
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::Begin(const std::optional<IndexBound<KeyType>> &lower,
+                           const std::optional<IndexBound<KeyType>> &upper) -> INDEXITERATOR_TYPE {
+  INDEXITERATOR_TYPE itr(this, std::nullopt, upper);
+  if (lower.has_value()) {
+    CopyLeaf(&lower->key_, lower->inclusive_, &itr);
+  } else {
+    CopyLeaf(nullptr, true, &itr);
+  }
+  return itr;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::BeginReverse(const std::optional<IndexBound<KeyType>> &lower,
+                                  const std::optional<IndexBound<KeyType>> &upper) -> INDEXITERATOR_TYPE {
+  INDEXITERATOR_TYPE itr(this, lower, std::nullopt);
+  if (upper.has_value()) {
+    CopyLeafReverse(&upper->key_, upper->inclusive_, &itr);
+  } else {
+    CopyLeafReverse(nullptr, true, &itr);
+  }
+  return itr;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::CopyLeaf(const KeyType *key, bool inclusive, INDEXITERATOR_TYPE *itr) {
+  Page *page = FindLeaf(key, false);
+  if (page == nullptr) {
+    itr->entries_.clear();
+    return;
+  }
+  CopyFromLeaf(page, key, inclusive, itr);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::CopyNextLeaf(const KeyType &last_key, INDEXITERATOR_TYPE *itr) {
+  Page *page = std::exchange(itr->next_page_, nullptr);
+  page->RLatch();
+  // The pin kept the page from being deleted, but not from changing. The scan can go on there unless entries moved
+  // from it into the copied leaf, which raised its low key, or it was merged away.
+  auto *node = reinterpret_cast<BPlusTreePage *>(page->GetData());
+  if (node->IsLeafPage() &&
+      comparator_(reinterpret_cast<LeafPage *>(node)->GetLowKey(), itr->next_low_key_) == 0) {
+    CopyFromLeaf(page, &last_key, false, itr);
+    return;
+  }
+  page->RUnlatch();
+  UnpinIteratorPage(page->GetPageId());
+  CopyLeaf(&last_key, false, itr);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::CopyFromLeaf(Page *page, const KeyType *key, bool inclusive, INDEXITERATOR_TYPE *itr) {
+  const auto &upper = itr->upper_;
+  itr->entries_.clear();
+  while (true) {
+    auto *leaf = reinterpret_cast<LeafPage *>(page->GetData());
+    int index = 0;
+    if (key != nullptr) {
+      index = leaf->KeyIndex(*key, comparator_);
+      if (!inclusive && index < leaf->GetSize() && comparator_(leaf->KeyAt(index), *key) == 0) {
+        index++;
+      }
+    }
+    int end = leaf->GetSize();
+    page_id_t next_page_id = leaf->GetNextPageId();
+    if (upper.has_value()) {
+      end = leaf->KeyIndex(upper->key_, comparator_);
+      if (upper->inclusive_ && end < leaf->GetSize() && comparator_(leaf->KeyAt(end), upper->key_) == 0) {
+        end++;
+      }
+      // The keys of the later leaves are not less than the high key of this one.
+      if (end < leaf->GetSize() || !leaf->IsBeyondHighKey(upper->key_, comparator_) ||
+          (!upper->inclusive_ && comparator_(leaf->GetHighKey(), upper->key_) == 0)) {
+        next_page_id = INVALID_PAGE_ID;
+      }
+    }
+    if (index < end || next_page_id == INVALID_PAGE_ID) {
+      for (int i = index; i < end; i++) {
+        CopyEntry(leaf, i, false, itr);
+      }
+      if (next_page_id != INVALID_PAGE_ID) {
+        // Pin the next leaf while this one is latched, so that the link is current, and the page is at hand in the
+        // buffer pool by the time the iterator has consumed the entries of this one.
+        itr->next_page_ = FetchNode(next_page_id);
+        itr->next_low_key_ = leaf->GetHighKey();
+      }
+      page->RUnlatch();
+      buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+      return;
+    }
+    // The next leaf can only go away by merging into this one, which stays latched until the next one is.
+    Page *next_page = FetchNode(next_page_id);
+    next_page->RLatch();
+    page->RUnlatch();
+    buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+    page = next_page;
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::CopyEntry(const LeafPage *leaf, int index, bool reverse, INDEXITERATOR_TYPE *itr) {
+  KeyType key = leaf->KeyAt(index);
+  int count = leaf->GetValueCount(index);
+  for (int i = 0; i < count; i++) {
+    itr->entries_.emplace_back(key, leaf->ValueAt(index, reverse ? count - 1 - i : i));
+  }
+  if (count > 0) {
+    return;
+  }
+  std::vector<ValueType> values;
+  ReadValues(leaf, index, &values);
+  if (reverse) {
+    std::reverse(values.begin(), values.end());
+  }
+  for (const auto &value : values) {
+    itr->entries_.emplace_back(key, value);
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::CopyLeafReverse(const KeyType *key, bool inclusive, INDEXITERATOR_TYPE *itr) {
+  const auto &lower = itr->lower_;
+  itr->entries_.clear();
+  itr->has_prev_leaf_ = false;
+  // Keys are memcomparable, so the entries below a key are those not greater than the key preceding it.
+  KeyType search_key;
+  if (key == nullptr) {
+    memset(&search_key, 0xFF, sizeof(KeyType));
+  } else if (inclusive) {
+    search_key = *key;
+  } else if (!PrecedingKey(*key, &search_key)) {
+    return;
+  }
+  while (true) {
+    Page *page = FindLeaf(&search_key, false);
+    if (page == nullptr) {
+      return;
+    }
+    auto *leaf = reinterpret_cast<LeafPage *>(page->GetData());
+    int end = leaf->KeyIndex(search_key, comparator_);
+    if (end < leaf->GetSize() && comparator_(leaf->KeyAt(end), search_key) == 0) {
+      end++;
+    }
+    int begin = 0;
+    if (lower.has_value()) {
+      begin = leaf->KeyIndex(lower->key_, comparator_);
+      if (!lower->inclusive_ && begin < leaf->GetSize() && comparator_(leaf->KeyAt(begin), lower->key_) == 0) {
+        begin++;
+      }
+    }
+    for (int i = end - 1; i >= begin; i--) {
+      CopyEntry(leaf, i, true, itr);
+    }
+    // The keys of the previous leaves are less than the low key of this one, which is the smallest key for the
+    // leftmost leaf.
+    KeyType low_key = leaf->GetLowKey();
+    bool has_prev_leaf = (!lower.has_value() || comparator_(lower->key_, low_key) < 0) &&
+                         PrecedingKey(low_key, &search_key);
+    page->RUnlatch();
+    buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+    if (!itr->entries_.empty() || !has_prev_leaf) {
+      itr->has_prev_leaf_ = has_prev_leaf;
+      return;
+    }
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::PrecedingKey(const KeyType &key, KeyType *preceding) -> bool {
+  *preceding = key;
+  auto *bytes = reinterpret_cast<unsigned char *>(preceding);
+  for (int i = static_cast<int>(sizeof(KeyType)) - 1; i >= 0; i--) {
+    if (bytes[i] != 0) {
+      bytes[i]--;
+      return true;
+    }
+    bytes[i] = 0xFF;
+  }
+  return false;
+}
+
 /**
  * @return Page id of the root of this tree
  */
 INDEX_TEMPLATE_ARGUMENTS
-auto BPLUSTREE_TYPE::GetRootPageId() -> page_id_t { return 0; }
+auto BPLUSTREE_TYPE::GetRootPageId() -> page_id_t {
+  root_latch_.RLock();
+  page_id_t root_page_id = root_page_id_;
+  root_latch_.RUnlock();
+  return root_page_id;
+}
+
+/*****************************************************************************
+ * BULK LOADING
+ *****************************************************************************/
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::BulkLoad(const std::function<bool(MappingType *)> &next, double fill_factor) {
+  if (!IsEmpty()) {
+    throw Exception(ExceptionType::INVALID, "Only an empty B+ tree can be bulk loaded.");
+  }
+  if (fill_factor <= 0 || fill_factor > 1) {
+    throw Exception(ExceptionType::OUT_OF_RANGE, "The fill factor must be greater than 0 and at most 1.");
+  }
+  // A leaf splits when it is full, so at rest it holds one entry less than its max size, while an internal page holds
+  // up to its max size. Pages are filled at least to their min size, so that removes find them as they expect, unless
+  // their entries take too many bytes for that.
+  auto fill_size = [fill_factor](int capacity, int min_size) {
+    return std::clamp(static_cast<int>(capacity * fill_factor), std::max(min_size, 1), capacity);
+  };
+  BulkLevel<LeafEntryType> leaves(leaf_max_size_, leaf_max_size_ - 1,
+                                  fill_size(leaf_max_size_ - 1, leaf_max_size_ / 2), fill_factor);
+  BulkParents parents{fill_size(internal_max_size_, (internal_max_size_ + 1) / 2), fill_factor, {}};
+
+  // The entries of a key are gathered into a single leaf entry before it is appended.
+  MappingType entry;
+  LeafEntryType leaf_entry;
+  bool has_entry = false;
+  while (next(&entry)) {
+    if (has_entry) {
+      int cmp = comparator_(entry.first, leaf_entry.first);
+      BUSTUB_ASSERT(cmp >= 0, "bulk loaded entries must come in key order");
+      if (cmp == 0) {
+        if (!unique_) {
+          leaf_entry.second.values_.push_back(entry.second);
+        }
+        continue;
+      }
+      BulkAppendLeafEntry(&leaves, &leaf_entry, &parents);
+    }
+    has_entry = true;
+    leaf_entry.first = entry.first;
+    leaf_entry.second = {{entry.second}};
+  }
+  if (!has_entry) {
+    return;
+  }
+  BulkAppendLeafEntry(&leaves, &leaf_entry, &parents);
+
+  page_id_t root_page_id = BulkFinishLevel<LeafPage>(&leaves, 0, &parents);
+  for (size_t height = 0; root_page_id == INVALID_PAGE_ID; height++) {
+    root_page_id = BulkFinishLevel<InternalPage>(&parents.levels_[height], height + 1, &parents);
+  }
+  root_latch_.WLock();
+  root_page_id_ = root_page_id;
+  UpdateRootPageId(1);
+  root_latch_.WUnlock();
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+template <typename PageType>
+auto BPLUSTREE_TYPE::BulkSeparator(const KeyType &left, const KeyType &right) -> KeyType {
+  // Leaves can be split anywhere between two keys, while the pages above are split at a separator of the level below.
+  if constexpr (std::is_same_v<PageType, LeafPage>) {
+    return LeafPage::GetSeparator(left, right);
+  } else {
+    return right;
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+template <typename PageType, typename EntryType>
+auto BPLUSTREE_TYPE::BulkEntrySize(const EntryType &entry, int prefix_size) -> int {
+  // The size of a leaf entry also depends on its values, while an internal entry always points to a single page.
+  if constexpr (std::is_same_v<PageType, LeafPage>) {
+    return LeafPage::GetEntrySize(entry, prefix_size);
+  } else {
+    return PageType::GetEntrySize(entry.first, prefix_size);
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::BulkAppendLeafEntry(BulkLevel<LeafEntryType> *leaves, LeafEntryType *entry,
+                                         BulkParents *parents) {
+  // The values of a key come in no particular order, and may repeat.
+  auto &values = entry->second.values_;
+  std::sort(values.begin(), values.end());
+  values.erase(std::unique(values.begin(), values.end()), values.end());
+  if (static_cast<int>(values.size()) > LeafPage::POSTING_LIST_MAX_SIZE) {
+    WritePostingPages(&entry->second);
+  }
+  BulkAppend<LeafPage>(leaves, *entry, 0, parents);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+template <typename PageType, typename EntryType>
+auto BPLUSTREE_TYPE::BulkPageSize(const BulkLevel<EntryType> &level, size_t begin, const KeyType &low_key,
+                                  int max_count, double fill_factor) -> int {
+  const auto &pending = level.pending_;
+  int size = std::min(static_cast<int>(pending.size() - begin), max_count);
+  // The more entries a page holds, the wider its fences and the fewer bytes its keys share, so the data size is only
+  // recounted when the prefix gets shorter.
+  int prefix_size = sizeof(KeyType);
+  int data_size = 0;
+  for (int count = 1; count <= size; count++) {
+    size_t end = begin + count;
+    int page_prefix_size;
+    if (end < pending.size()) {
+      KeyType high_key = BulkSeparator<PageType>(pending[end - 1].first, pending[end].first);
+      page_prefix_size = PageType::GetPrefixSize(low_key, &high_key);
+    } else {
+      page_prefix_size = PageType::GetPrefixSize(low_key, nullptr);
+    }
+    if (page_prefix_size != prefix_size) {
+      prefix_size = page_prefix_size;
+      data_size = 0;
+      for (size_t i = begin; i + 1 < end; i++) {
+        data_size += BulkEntrySize<PageType>(pending[i], prefix_size);
+      }
+    }
+    data_size += BulkEntrySize<PageType>(pending[end - 1], prefix_size);
+    if (data_size > PageType::GetDataCapacity(prefix_size) * fill_factor) {
+      return std::max(count - 1, 1);
+    }
+  }
+  return size;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+template <typename PageType, typename EntryType>
+void BPLUSTREE_TYPE::BulkAppend(BulkLevel<EntryType> *level, const EntryType &entry, size_t height,
+                                BulkParents *parents) {
+  level->pending_.push_back(entry);
+  // Keep more than a page of entries pending, so that BulkFinishLevel can always split them over two pages.
+  if (static_cast<int>(level->pending_.size()) > level->fill_size_ + level->capacity_) {
+    int size = BulkPageSize<PageType>(*level, 0, level->low_key_, level->fill_size_, level->fill_factor_);
+    BulkWritePage<PageType>(level, size, height, parents);
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+template <typename PageType, typename EntryType>
+auto BPLUSTREE_TYPE::BulkWritePage(BulkLevel<EntryType> *level, int size, size_t height, BulkParents *parents)
+    -> page_id_t {
+  page_id_t page_id;
+  Page *page = NewNode(&page_id);
+  auto *node = reinterpret_cast<PageType *>(page->GetData());
+  node->Init(page_id, level->max_size_);
+  // The page is bounded by the separators from the previous page and to the next one, which its keys are compressed
+  // against.
+  KeyType low_key = level->low_key_;
+  bool is_last = size == static_cast<int>(level->pending_.size());
+  if (!is_last) {
+    level->low_key_ = BulkSeparator<PageType>(level->pending_[size - 1].first, level->pending_[size].first);
+  }
+  node->SetFences(low_key, is_last ? nullptr : &level->low_key_);
+  node->CopyNFrom(level->pending_.data(), size);
+  level->pending_.erase(level->pending_.begin(), level->pending_.begin() + size);
+
+  if (level->last_page_ != nullptr) {
+    reinterpret_cast<PageType *>(level->last_page_->GetData())->SetNextPageId(page_id);
+    buffer_pool_manager_->UnpinPage(level->last_page_->GetPageId(), true);
+  }
+  level->last_page_ = page;
+  level->num_pages_++;
+
+  if (parents != nullptr) {
+    if (height == parents->levels_.size()) {
+      parents->levels_.emplace_back(internal_max_size_, internal_max_size_, parents->fill_size_,
+                                    parents->fill_factor_);
+    }
+    BulkAppend<InternalPage>(&parents->levels_[height], InternalEntry{low_key, page_id}, height + 1, parents);
+  }
+  return page_id;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+template <typename PageType, typename EntryType>
+auto BPLUSTREE_TYPE::BulkFinishLevel(BulkLevel<EntryType> *level, size_t height, BulkParents *parents) -> page_id_t {
+  page_id_t root_page_id = INVALID_PAGE_ID;
+  while (true) {
+    auto remaining = static_cast<int>(level->pending_.size());
+    int first_size = BulkPageSize<PageType>(*level, 0, level->low_key_, level->capacity_, 1);
+    if (first_size == remaining && level->num_pages_ == 0) {
+      root_page_id = BulkWritePage<PageType>(level, remaining, height, nullptr);
+      break;
+    }
+    // Once the level has a page, more than a page of entries is pending, and each half holds at least the min size,
+    // if the halves fit.
+    int left_size = std::min(remaining / 2, first_size);
+    bool halves_fit = first_size == remaining;
+    if (!halves_fit && left_size > 0) {
+      KeyType separator = BulkSeparator<PageType>(level->pending_[left_size - 1].first, level->pending_[left_size].first);
+      halves_fit = BulkPageSize<PageType>(*level, left_size, separator, level->capacity_, 1) == remaining - left_size;
+    }
+    if (halves_fit) {
+      if (left_size > 0) {
+        BulkWritePage<PageType>(level, left_size, height, parents);
+      }
+      BulkWritePage<PageType>(level, remaining - left_size, height, parents);
+      break;
+    }
+    // Otherwise the entries take more than two pages, which only happens when bytes rather than entries fill them.
+    int size = BulkPageSize<PageType>(*level, 0, level->low_key_, level->fill_size_, level->fill_factor_);
+    BulkWritePage<PageType>(level, size, height, parents);
+  }
+  buffer_pool_manager_->UnpinPage(level->last_page_->GetPageId(), true);
+  level->last_page_ = nullptr;
+  return root_page_id;
+}
+
+/*****************************************************************************
+ * B-LINK MODE
+ *****************************************************************************/
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::IsBeyondHighKey(const BPlusTreePage *node, const KeyType &key) const -> bool {
+  if (node->IsLeafPage()) {
+    return reinterpret_cast<const LeafPage *>(node)->IsBeyondHighKey(key, comparator_);
+  }
+  return reinterpret_cast<const InternalPage *>(node)->IsBeyondHighKey(key, comparator_);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::MoveRight(Page *page, const KeyType &key, bool exclusive) -> Page * {
+  auto *node = reinterpret_cast<BPlusTreePage *>(page->GetData());
+  while (IsBeyondHighKey(node, key)) {
+    page_id_t next_page_id = node->IsLeafPage() ? reinterpret_cast<LeafPage *>(node)->GetNextPageId()
+                                                : reinterpret_cast<InternalPage *>(node)->GetNextPageId();
+    Page *next_page = FetchNode(next_page_id);
+    if (exclusive) {
+      next_page->WLatch();
+      page->WUnlatch();
+    } else {
+      next_page->RLatch();
+      page->RUnlatch();
+    }
+    buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+    page = next_page;
+    node = reinterpret_cast<BPlusTreePage *>(page->GetData());
+  }
+  return page;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::FindLeafBLink(const KeyType *key, bool write_leaf, std::vector<page_id_t> *path) -> Page * {
+  root_latch_.RLock();
+  page_id_t page_id = root_page_id_;
+  root_latch_.RUnlock();
+  if (page_id == INVALID_PAGE_ID) {
+    return nullptr;
+  }
+  while (true) {
+    Page *page = FetchNode(page_id);
+    // Pages never change their type or go away in this mode, so the type can be read before the page is latched.
+    bool exclusive = write_leaf && reinterpret_cast<BPlusTreePage *>(page->GetData())->IsLeafPage();
+    if (exclusive) {
+      page->WLatch();
+    } else {
+      page->RLatch();
+    }
+    if (key != nullptr) {
+      page = MoveRight(page, *key, exclusive);
+    }
+    auto *node = reinterpret_cast<BPlusTreePage *>(page->GetData());
+    if (node->IsLeafPage()) {
+      return page;
+    }
+    auto *internal = reinterpret_cast<InternalPage *>(node);
+    if (path != nullptr) {
+      path->push_back(page->GetPageId());
+    }
+    page_id = key == nullptr ? internal->ValueAt(0) : internal->Lookup(*key, comparator_);
+    page->RUnlatch();
+    buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::InsertBLink(const KeyType &key, const ValueType &value) -> bool {
+  std::vector<page_id_t> path;
+  Page *page = FindLeafBLink(&key, true, &path);
+  if (page == nullptr) {
+    root_latch_.WLock();
+    if (root_page_id_ == INVALID_PAGE_ID) {
+      StartNewTree(key, value);
+      root_latch_.WUnlock();
+      return true;
+    }
+    root_latch_.WUnlock();
+    page = FindLeafBLink(&key, true, &path);
+  }
+
+  auto *leaf = reinterpret_cast<LeafPage *>(page->GetData());
+  if (!InsertIntoLeaf(leaf, key, value)) {
+    page->WUnlatch();
+    buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+    return false;
+  }
+  if (leaf->HasRoomFor(1)) {
+    page->WUnlatch();
+    buffer_pool_manager_->UnpinPage(page->GetPageId(), true);
+    return true;
+  }
+  page_id_t new_page_id;
+  Page *new_page = NewNode(&new_page_id);
+  auto *new_leaf = reinterpret_cast<LeafPage *>(new_page->GetData());
+  new_leaf->Init(new_page_id, leaf_max_size_);
+  leaf->MoveHalfTo(new_leaf);
+  KeyType separator = new_leaf->GetLowKey();
+  buffer_pool_manager_->UnpinPage(new_page_id, true);
+  InsertIntoParentBLink(page, separator, new_page_id, &path);
+  return true;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::InsertIntoParentBLink(Page *page, const KeyType &key, page_id_t new_page_id,
+                                           std::vector<page_id_t> *path) {
+  KeyType separator = key;
+  while (true) {
+    page_id_t page_id = page->GetPageId();
+    Page *parent_page;
+    if (path->empty()) {
+      root_latch_.WLock();
+      if (root_page_id_ == page_id) {
+        page_id_t root_page_id;
+        Page *root_page = NewNode(&root_page_id);
+        auto *root = reinterpret_cast<InternalPage *>(root_page->GetData());
+        root->Init(root_page_id, internal_max_size_);
+        root->PopulateNewRoot(page_id, separator, new_page_id);
+        buffer_pool_manager_->UnpinPage(root_page_id, true);
+        root_page_id_ = root_page_id;
+        UpdateRootPageId();
+        root_latch_.WUnlock();
+        page->WUnlatch();
+        buffer_pool_manager_->UnpinPage(page_id, true);
+        return;
+      }
+      page_id_t root_page_id = root_page_id_;
+      root_latch_.WUnlock();
+      // The tree grew above the page after the descent passed, so its parent has to be looked up again.
+      parent_page = FindParentBLink(root_page_id, page_id, separator);
+    } else {
+      parent_page = FetchNode(path->back());
+      path->pop_back();
+      parent_page->WLatch();
+      parent_page = MoveRight(parent_page, separator, true);
+    }
+    // Readers find the new page through the link of the split one until the parent points to it.
+    page->WUnlatch();
+    buffer_pool_manager_->UnpinPage(page_id, true);
+
+    auto *parent = reinterpret_cast<InternalPage *>(parent_page->GetData());
+    if (parent->HasRoomFor(1)) {
+      parent->InsertNodeAfter(page_id, separator, new_page_id);
+      parent_page->WUnlatch();
+      buffer_pool_manager_->UnpinPage(parent_page->GetPageId(), true);
+      return;
+    }
+    page_id_t sibling_page_id;
+    Page *sibling_page = NewNode(&sibling_page_id);
+    auto *sibling = reinterpret_cast<InternalPage *>(sibling_page->GetData());
+    sibling->Init(sibling_page_id, internal_max_size_);
+    parent->InsertNodeAfterAndSplit(page_id, separator, new_page_id, sibling);
+    separator = sibling->GetLowKey();
+    buffer_pool_manager_->UnpinPage(sibling_page_id, true);
+    page = parent_page;
+    new_page_id = sibling_page_id;
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::FindParentBLink(page_id_t root_page_id, page_id_t child_page_id, const KeyType &key) -> Page * {
+  page_id_t page_id = root_page_id;
+  while (true) {
+    Page *page = FetchNode(page_id);
+    page->WLatch();
+    page = MoveRight(page, key, true);
+    auto *node = reinterpret_cast<InternalPage *>(page->GetData());
+    BUSTUB_ASSERT(!node->IsLeafPage(), "the parent must be above the leaves");
+    if (node->ValueIndex(child_page_id) >= 0) {
+      return page;
+    }
+    page_id = node->Lookup(key, comparator_);
+    page->WUnlatch();
+    buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::RemoveBLink(const KeyType &key, const ValueType *value) {
+  Page *page = FindLeafBLink(&key, true, nullptr);
+  if (page == nullptr) {
+    return;
+  }
+  bool removed = RemoveFromLeaf(reinterpret_cast<LeafPage *>(page->GetData()), key, value);
+  page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(page->GetPageId(), removed);
+}
 
 /*****************************************************************************
  * UTILITIES AND DEBUG
@@ -341,16 +1332,13 @@ auto BPLUSTREE_TYPE::GetRootPageId() -> page_id_t { return 0; }
  * Call this method everytime root page id is changed.
  * @parameter: insert_record      defualt value is false. When set to true,
  * insert a record <index_name, root_page_id> into header page instead of
- * updating it.
+ * updating it. A tree that became empty and grows again already has its record, which is updated then.
  */
 INDEX_TEMPLATE_ARGUMENTS
 void BPLUSTREE_TYPE::UpdateRootPageId(int insert_record) {
   auto *header_page = static_cast<HeaderPage *>(buffer_pool_manager_->FetchPage(HEADER_PAGE_ID));
-  if (insert_record != 0) {
-    // create a new record<index_name + root_page_id> in header_page
-    header_page->InsertRecord(index_name_, root_page_id_);
-  } else {
-    // update root_page_id in header_page
+  // create a new record<index_name + root_page_id> in header_page, or update root_page_id in the existing one
+  if (insert_record == 0 || !header_page->InsertRecord(index_name_, root_page_id_)) {
     header_page->UpdateRecord(index_name_, root_page_id_);
   }
   buffer_pool_manager_->UnpinPage(HEADER_PAGE_ID, true);
@@ -456,12 +1444,6 @@ void BPLUSTREE_TYPE::ToGraph(BPlusTreePage *page, BufferPoolManager *bpm, std::o
       out << leaf_prefix << leaf->GetPageId() << " -> " << leaf_prefix << leaf->GetNextPageId() << ";\n";
       out << "{rank=same " << leaf_prefix << leaf->GetPageId() << " " << leaf_prefix << leaf->GetNextPageId() << "};\n";
     }
-
-    // Print parent links if there is a parent
-    if (leaf->GetParentPageId() != INVALID_PAGE_ID) {
-      out << internal_prefix << leaf->GetParentPageId() << ":p" << leaf->GetPageId() << " -> " << leaf_prefix
-          << leaf->GetPageId() << ";\n";
-    }
   } else {
     auto *inner = reinterpret_cast<InternalPage *>(page);
     // Print node name
@@ -488,14 +1470,12 @@ void BPLUSTREE_TYPE::ToGraph(BPlusTreePage *page, BufferPoolManager *bpm, std::o
     out << "</TR>";
     // Print table end
     out << "</TABLE>>];\n";
-    // Print Parent link
-    if (inner->GetParentPageId() != INVALID_PAGE_ID) {
-      out << internal_prefix << inner->GetParentPageId() << ":p" << inner->GetPageId() << " -> " << internal_prefix
-          << inner->GetPageId() << ";\n";
-    }
     // Print leaves
     for (int i = 0; i < inner->GetSize(); i++) {
       auto child_page = reinterpret_cast<BPlusTreePage *>(bpm->FetchPage(inner->ValueAt(i))->GetData());
+      // Print the link from this page to the child
+      out << internal_prefix << inner->GetPageId() << ":p" << child_page->GetPageId() << " -> "
+          << (child_page->IsLeafPage() ? leaf_prefix : internal_prefix) << child_page->GetPageId() << ";\n";
       ToGraph(child_page, bpm, out);
       if (i > 0) {
         auto sibling_page = reinterpret_cast<BPlusTreePage *>(bpm->FetchPage(inner->ValueAt(i - 1))->GetData());
@@ -522,8 +1502,7 @@ INDEX_TEMPLATE_ARGUMENTS
 void BPLUSTREE_TYPE::ToString(BPlusTreePage *page, BufferPoolManager *bpm) const {
   if (page->IsLeafPage()) {
     auto *leaf = reinterpret_cast<LeafPage *>(page);
-    std::cout << "Leaf Page: " << leaf->GetPageId() << " parent: " << leaf->GetParentPageId()
-              << " next: " << leaf->GetNextPageId() << std::endl;
+    std::cout << "Leaf Page: " << leaf->GetPageId() << " next: " << leaf->GetNextPageId() << std::endl;
     for (int i = 0; i < leaf->GetSize(); i++) {
       std::cout << leaf->KeyAt(i) << ",";
     }
@@ -531,7 +1510,7 @@ void BPLUSTREE_TYPE::ToString(BPlusTreePage *page, BufferPoolManager *bpm) const
     std::cout << std::endl;
   } else {
     auto *internal = reinterpret_cast<InternalPage *>(page);
-    std::cout << "Internal Page: " << internal->GetPageId() << " parent: " << internal->GetParentPageId() << std::endl;
+    std::cout << "Internal Page: " << internal->GetPageId() << std::endl;
     for (int i = 0; i < internal->GetSize(); i++) {
       std::cout << internal->KeyAt(i) << ": " << internal->ValueAt(i) << ",";
     }
@@ -11,6 +11,8 @@
 
 #include "storage/index/b_plus_tree_index.h"
 
+#include "storage/index/index_build_sorter.h"
+
 namespace bustub {
 /*
  * Constructor
@@ -18,14 +20,17 @@ namespace bustub {
 INDEX_TEMPLATE_ARGUMENTS
 BPLUSTREE_INDEX_TYPE::BPlusTreeIndex(std::unique_ptr<IndexMetadata> &&metadata, BufferPoolManager *buffer_pool_manager)
     : Index(std::move(metadata)),
+      buffer_pool_manager_(buffer_pool_manager),
       comparator_(GetMetadata()->GetKeySchema()),
-      container_(GetMetadata()->GetName(), buffer_pool_manager, comparator_) {}
+      // Tables may hold several tuples with the same key, so the index maps each key to all of their RIDs.
+      container_(GetMetadata()->GetName(), buffer_pool_manager, comparator_, LEAF_PAGE_SIZE, INTERNAL_PAGE_SIZE,
+                 BPlusTreeMode::LATCH_CRABBING, false) {}
 
 INDEX_TEMPLATE_ARGUMENTS
 void BPLUSTREE_INDEX_TYPE::InsertEntry(const Tuple &key, RID rid, Transaction *transaction) {
   // construct insert index key
   KeyType index_key;
-  index_key.SetFromKey(key);
+  index_key.SetFromKey(key, GetKeySchema());
 
   container_.Insert(index_key, rid, transaction);
 }
@@ -34,20 +39,33 @@ INDEX_TEMPLATE_ARGUMENTS
 void BPLUSTREE_INDEX_TYPE::DeleteEntry(const Tuple &key, RID rid, Transaction *transaction) {
   // construct delete index key
   KeyType index_key;
-  index_key.SetFromKey(key);
+  index_key.SetFromKey(key, GetKeySchema());
 
-  container_.Remove(index_key, transaction);
+  container_.Remove(index_key, rid, transaction);
 }
 
 INDEX_TEMPLATE_ARGUMENTS
 void BPLUSTREE_INDEX_TYPE::ScanKey(const Tuple &key, std::vector<RID> *result, Transaction *transaction) {
   // construct scan index key
   KeyType index_key;
-  index_key.SetFromKey(key);
+  index_key.SetFromKey(key, GetKeySchema());
 
   container_.GetValue(index_key, result, transaction);
 }
 
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_INDEX_TYPE::BulkLoad(TableHeap *table_heap, const Schema &table_schema, Transaction *transaction,
+                                    double fill_factor) {
+  IndexBuildSorter<KeyType, ValueType, KeyComparator> sorter(buffer_pool_manager_, comparator_);
+  KeyType index_key;
+  for (auto tuple = table_heap->Begin(transaction); tuple != table_heap->End(); ++tuple) {
+    index_key.SetFromKey(tuple->KeyFromTuple(table_schema, *GetKeySchema(), GetKeyAttrs()), GetKeySchema());
+    sorter.Add(index_key, tuple->GetRid());
+  }
+  sorter.Finish();
+  container_.BulkLoad([&sorter](MappingType *entry) { return sorter.Next(entry); }, fill_factor);
+}
+
 INDEX_TEMPLATE_ARGUMENTS
 auto BPLUSTREE_INDEX_TYPE::GetBeginIterator() -> INDEXITERATOR_TYPE { return container_.Begin(); }
 
@@ -57,6 +75,19 @@ auto BPLUSTREE_INDEX_TYPE::GetBeginIterator(const KeyType &key) -> INDEXITERATOR
 INDEX_TEMPLATE_ARGUMENTS
 auto BPLUSTREE_INDEX_TYPE::GetEndIterator() -> INDEXITERATOR_TYPE { return container_.End(); }
 
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_INDEX_TYPE::GetRangeIterator(const std::optional<IndexBound<KeyType>> &lower,
+                                            const std::optional<IndexBound<KeyType>> &upper) -> INDEXITERATOR_TYPE {
+  return container_.Begin(lower, upper);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_INDEX_TYPE::GetReverseRangeIterator(const std::optional<IndexBound<KeyType>> &lower,
+                                                   const std::optional<IndexBound<KeyType>> &upper)
+    -> INDEXITERATOR_TYPE {
+  return container_.BeginReverse(lower, upper);
+}
+
 template class BPlusTreeIndex<GenericKey<4>, RID, GenericComparator<4>>;
 template class BPlusTreeIndex<GenericKey<8>, RID, GenericComparator<8>>;
 template class BPlusTreeIndex<GenericKey<16>, RID, GenericComparator<16>>;
@@ -0,0 +1,240 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// index_build_sorter.cpp
+//
+// Identification: src/storage/index/index_build_sorter.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/index/index_build_sorter.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "common/exception.h"
+#include "common/rid.h"
+#include "storage/index/generic_key.h"
+
+namespace bustub {
+
+INDEX_TEMPLATE_ARGUMENTS
+INDEX_BUILD_SORTER_TYPE::IndexBuildSorter(BufferPoolManager *buffer_pool_manager, const KeyComparator &comparator,
+                                          size_t memory_limit)
+    : buffer_pool_manager_(buffer_pool_manager),
+      comparator_(comparator),
+      buffer_capacity_(std::max<size_t>(1, memory_limit / sizeof(MappingType))),
+      // Leave half of the frames to the writer of the merged run, and to whoever consumes the last merge.
+      max_fan_in_(std::max<size_t>(2, buffer_pool_manager->GetPoolSize() / 2)) {}
+
+INDEX_TEMPLATE_ARGUMENTS
+INDEX_BUILD_SORTER_TYPE::~IndexBuildSorter() {
+  for (auto &reader : readers_) {
+    CloseRun(&reader);
+  }
+  for (page_id_t first_page_id : runs_) {
+    OverflowPage::DeleteChain(buffer_pool_manager_, first_page_id);
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void INDEX_BUILD_SORTER_TYPE::Add(const KeyType &key, const ValueType &value) {
+  BUSTUB_ASSERT(!finished_, "entries cannot be added once the sort finished");
+  buffer_.emplace_back(key, value);
+  if (buffer_.size() == buffer_capacity_) {
+    SpillBuffer();
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void INDEX_BUILD_SORTER_TYPE::SpillBuffer() {
+  std::stable_sort(buffer_.begin(), buffer_.end(), [this](const MappingType &a, const MappingType &b) {
+    return comparator_(a.first, b.first) < 0;
+  });
+  size_t index = 0;
+  runs_.push_back(WriteRun([this, &index](MappingType *entry) {
+    if (index == buffer_.size()) {
+      return false;
+    }
+    *entry = buffer_[index++];
+    return true;
+  }));
+  num_spilled_runs_++;
+  buffer_.clear();
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void INDEX_BUILD_SORTER_TYPE::Finish() {
+  BUSTUB_ASSERT(!finished_, "the sort already finished");
+  finished_ = true;
+  if (runs_.empty()) {
+    std::stable_sort(buffer_.begin(), buffer_.end(), [this](const MappingType &a, const MappingType &b) {
+      return comparator_(a.first, b.first) < 0;
+    });
+    return;
+  }
+  if (!buffer_.empty()) {
+    SpillBuffer();
+  }
+  buffer_.shrink_to_fit();
+
+  // Merge adjacent runs, so that equal keys stay in the order they were added.
+  while (runs_.size() > max_fan_in_) {
+    std::vector<page_id_t> merged_runs;
+    for (size_t begin = 0; begin < runs_.size(); begin += max_fan_in_) {
+      size_t end = std::min(begin + max_fan_in_, runs_.size());
+      if (end - begin == 1) {
+        merged_runs.push_back(runs_[begin]);
+        continue;
+      }
+      OpenMerge(begin, end);
+      merged_runs.push_back(WriteRun([this](MappingType *entry) { return NextMerged(entry); }));
+      num_spilled_runs_++;
+      readers_.clear();
+    }
+    runs_ = std::move(merged_runs);
+  }
+  OpenMerge(0, runs_.size());
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto INDEX_BUILD_SORTER_TYPE::Next(MappingType *entry) -> bool {
+  BUSTUB_ASSERT(finished_, "the sort has not finished yet");
+  if (readers_.empty()) {
+    if (buffer_index_ == buffer_.size()) {
+      return false;
+    }
+    *entry = buffer_[buffer_index_++];
+    return true;
+  }
+  return NextMerged(entry);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto INDEX_BUILD_SORTER_TYPE::WriteRun(const std::function<bool(MappingType *)> &next) -> page_id_t {
+  // Nobody else knows about the run, so its pages are not latched.
+  std::vector<char> data(OverflowPage::CAPACITY);
+  page_id_t first_page_id = INVALID_PAGE_ID;
+  page_id_t last_page_id = INVALID_PAGE_ID;
+  OverflowPage *last_page = nullptr;
+  MappingType entry;
+  bool has_entry = next(&entry);
+  while (has_entry) {
+    uint32_t size = 0;
+    while (has_entry && size + ENTRY_SIZE <= OverflowPage::CAPACITY) {
+      memcpy(data.data() + size, &entry.first, sizeof(KeyType));
+      memcpy(data.data() + size + sizeof(KeyType), &entry.second, sizeof(ValueType));
+      size += ENTRY_SIZE;
+      has_entry = next(&entry);
+    }
+    page_id_t page_id;
+    auto *page = reinterpret_cast<OverflowPage *>(buffer_pool_manager_->NewPage(&page_id));
+    if (page == nullptr) {
+      throw Exception(ExceptionType::OUT_OF_MEMORY, "Index build cannot spill a run: all frames are pinned");
+    }
+    page->Init(INVALID_PAGE_ID, data.data(), size);
+    if (last_page == nullptr) {
+      first_page_id = page_id;
+    } else {
+      last_page->SetNextPageId(page_id);
+      buffer_pool_manager_->UnpinPage(last_page_id, true);
+    }
+    last_page_id = page_id;
+    last_page = page;
+  }
+  if (last_page != nullptr) {
+    buffer_pool_manager_->UnpinPage(last_page_id, true);
+  }
+  return first_page_id;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void INDEX_BUILD_SORTER_TYPE::OpenMerge(size_t begin, size_t end) {
+  readers_.assign(end - begin, RunReader{});
+  heap_.clear();
+  for (size_t i = begin; i < end; i++) {
+    auto &reader = readers_[i - begin];
+    reader.page_id_ = std::exchange(runs_[i], INVALID_PAGE_ID);
+    if (reader.page_id_ != INVALID_PAGE_ID) {
+      reader.page_ = reinterpret_cast<OverflowPage *>(buffer_pool_manager_->FetchPage(reader.page_id_));
+      if (reader.page_ == nullptr) {
+        runs_[i] = reader.page_id_;
+        throw Exception(ExceptionType::OUT_OF_MEMORY, "Index build cannot merge a run: all frames are pinned");
+      }
+    }
+    MappingType entry;
+    if (ReadRun(&reader, &entry)) {
+      heap_.emplace_back(entry, i - begin);
+    }
+  }
+  std::make_heap(heap_.begin(), heap_.end(), [this](const auto &a, const auto &b) { return IsMergedAfter(a, b); });
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto INDEX_BUILD_SORTER_TYPE::IsMergedAfter(const HeapEntry &a, const HeapEntry &b) const -> bool {
+  int cmp = comparator_(a.first.first, b.first.first);
+  return cmp != 0 ? cmp > 0 : a.second > b.second;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto INDEX_BUILD_SORTER_TYPE::NextMerged(MappingType *entry) -> bool {
+  if (heap_.empty()) {
+    return false;
+  }
+  auto greater = [this](const auto &a, const auto &b) { return IsMergedAfter(a, b); };
+  std::pop_heap(heap_.begin(), heap_.end(), greater);
+  *entry = heap_.back().first;
+  size_t run = heap_.back().second;
+  heap_.pop_back();
+  MappingType next_entry;
+  if (ReadRun(&readers_[run], &next_entry)) {
+    heap_.emplace_back(next_entry, run);
+    std::push_heap(heap_.begin(), heap_.end(), greater);
+  }
+  return true;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto INDEX_BUILD_SORTER_TYPE::ReadRun(RunReader *reader, MappingType *entry) -> bool {
+  if (reader->page_ == nullptr) {
+    return false;
+  }
+  if (reader->offset_ == reader->page_->GetDataSize()) {
+    page_id_t next_page_id = reader->page_->GetNextPageId();
+    buffer_pool_manager_->UnpinPage(reader->page_id_, false);
+    buffer_pool_manager_->DeletePage(reader->page_id_);
+    reader->page_ = nullptr;
+    reader->page_id_ = next_page_id;
+    reader->offset_ = 0;
+    if (next_page_id == INVALID_PAGE_ID) {
+      return false;
+    }
+    reader->page_ = reinterpret_cast<OverflowPage *>(buffer_pool_manager_->FetchPage(next_page_id));
+    if (reader->page_ == nullptr) {
+      throw Exception(ExceptionType::OUT_OF_MEMORY, "Index build cannot merge a run: all frames are pinned");
+    }
+  }
+  const char *data = reader->page_->GetPayload() + reader->offset_;
+  memcpy(&entry->first, data, sizeof(KeyType));
+  memcpy(&entry->second, data + sizeof(KeyType), sizeof(ValueType));
+  reader->offset_ += ENTRY_SIZE;
+  return true;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void INDEX_BUILD_SORTER_TYPE::CloseRun(RunReader *reader) {
+  if (reader->page_ != nullptr) {
+    buffer_pool_manager_->UnpinPage(reader->page_id_, false);
+    reader->page_ = nullptr;
+  }
+  OverflowPage::DeleteChain(buffer_pool_manager_, std::exchange(reader->page_id_, INVALID_PAGE_ID));
+}
+
+template class IndexBuildSorter<GenericKey<4>, RID, GenericComparator<4>>;
+template class IndexBuildSorter<GenericKey<8>, RID, GenericComparator<8>>;
+template class IndexBuildSorter<GenericKey<16>, RID, GenericComparator<16>>;
+template class IndexBuildSorter<GenericKey<32>, RID, GenericComparator<32>>;
+template class IndexBuildSorter<GenericKey<64>, RID, GenericComparator<64>>;
+
+}  // namespace bustub
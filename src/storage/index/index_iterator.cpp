@@ -2,29 +2,111 @@
  * index_iterator.cpp
  */
 #include <cassert>
+#include <utility>
 
+#include "storage/index/b_plus_tree.h"
 #include "storage/index/index_iterator.h"
 
 namespace bustub {
 
-/*
- * NOTE: you can change the destructor/constructor method here
- * set your own input parameters
- */
 INDEX_TEMPLATE_ARGUMENTS
 INDEXITERATOR_TYPE::IndexIterator() = default;
 
 INDEX_TEMPLATE_ARGUMENTS
-INDEXITERATOR_TYPE::~IndexIterator() = default;  // NOLINT
+INDEXITERATOR_TYPE::IndexIterator(BPlusTree<KeyType, ValueType, KeyComparator> *tree,
+                                  std::optional<IndexBound<KeyType>> lower, std::optional<IndexBound<KeyType>> upper)
+    : tree_(tree), lower_(std::move(lower)), upper_(std::move(upper)) {}
+
+INDEX_TEMPLATE_ARGUMENTS
+INDEXITERATOR_TYPE::IndexIterator(IndexIterator &&other) noexcept
+    : tree_(other.tree_),
+      entries_(std::move(other.entries_)),
+      index_(other.index_),
+      lower_(std::move(other.lower_)),
+      upper_(std::move(other.upper_)),
+      next_page_(std::exchange(other.next_page_, nullptr)),
+      next_low_key_(other.next_low_key_),
+      has_prev_leaf_(other.has_prev_leaf_) {}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto INDEXITERATOR_TYPE::operator=(IndexIterator &&other) noexcept -> INDEXITERATOR_TYPE & {
+  if (this != &other) {
+    if (next_page_ != nullptr) {
+      tree_->UnpinIteratorPage(next_page_->GetPageId());
+    }
+    tree_ = other.tree_;
+    entries_ = std::move(other.entries_);
+    index_ = other.index_;
+    lower_ = std::move(other.lower_);
+    upper_ = std::move(other.upper_);
+    next_page_ = std::exchange(other.next_page_, nullptr);
+    next_low_key_ = other.next_low_key_;
+    has_prev_leaf_ = other.has_prev_leaf_;
+  }
+  return *this;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+INDEXITERATOR_TYPE::~IndexIterator() {  // NOLINT
+  if (next_page_ != nullptr) {
+    tree_->UnpinIteratorPage(next_page_->GetPageId());
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto INDEXITERATOR_TYPE::IsEnd() -> bool { return index_ >= entries_.size(); }
+
+INDEX_TEMPLATE_ARGUMENTS
+auto INDEXITERATOR_TYPE::operator*() -> const MappingType & { return entries_[index_]; }
+
+INDEX_TEMPLATE_ARGUMENTS
+auto INDEXITERATOR_TYPE::operator++() -> INDEXITERATOR_TYPE & {
+  index_++;
+  if (index_ == entries_.size() && (next_page_ != nullptr || has_prev_leaf_)) {
+    KeyType last_key = entries_.back().first;
+    if (has_prev_leaf_) {
+      tree_->CopyLeafReverse(&last_key, false, this);
+    } else {
+      tree_->CopyNextLeaf(last_key, this);
+    }
+    index_ = 0;
+  }
+  return *this;
+}
 
 INDEX_TEMPLATE_ARGUMENTS
-auto INDEXITERATOR_TYPE::IsEnd() -> bool { throw std::runtime_error("unimplemented"); }
+auto INDEXITERATOR_TYPE::NextBatch(std::vector<ValueType> *values) -> bool {
+  if (IsEnd()) {
+    return false;
+  }
+  for (size_t i = index_; i < entries_.size(); i++) {
+    values->push_back(entries_[i].second);
+  }
+  index_ = entries_.size() - 1;
+  ++(*this);
+  return true;
+}
 
 INDEX_TEMPLATE_ARGUMENTS
-auto INDEXITERATOR_TYPE::operator*() -> const MappingType & { throw std::runtime_error("unimplemented"); }
+auto INDEXITERATOR_TYPE::NextBatch(std::vector<MappingType> *entries) -> bool {
+  if (IsEnd()) {
+    return false;
+  }
+  entries->insert(entries->end(), entries_.begin() + index_, entries_.end());
+  index_ = entries_.size() - 1;
+  ++(*this);
+  return true;
+}
 
 INDEX_TEMPLATE_ARGUMENTS
-auto INDEXITERATOR_TYPE::operator++() -> INDEXITERATOR_TYPE & { throw std::runtime_error("unimplemented"); }
+auto INDEXITERATOR_TYPE::operator==(const IndexIterator &itr) const -> bool {
+  bool is_end = index_ >= entries_.size();
+  bool other_is_end = itr.index_ >= itr.entries_.size();
+  if (is_end || other_is_end) {
+    return is_end == other_is_end;
+  }
+  return tree_ == itr.tree_ && tree_->comparator_(entries_[index_].first, itr.entries_[itr.index_].first) == 0;
+}
 
 template class IndexIterator<GenericKey<4>, RID, GenericComparator<4>>;
 
@@ -0,0 +1,256 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// key_encoding.cpp
+//
+// Identification: src/storage/index/key_encoding.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/index/key_encoding.h"
+
+#include <cstring>
+#include <string>
+#include <type_traits>
+
+#include "common/exception.h"
+#include "type/type.h"
+#include "type/type_kernels.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+namespace {
+
+template <TypeId T>
+using TypeTag = std::integral_constant<TypeId, T>;
+
+/** Call f with the TypeTag of a fixed-width type. */
+template <class F>
+auto DispatchFixedType(TypeId type, F &&f) {
+  switch (type) {
+    case TypeId::BOOLEAN:
+      return f(TypeTag<TypeId::BOOLEAN>{});
+    case TypeId::TINYINT:
+      return f(TypeTag<TypeId::TINYINT>{});
+    case TypeId::SMALLINT:
+      return f(TypeTag<TypeId::SMALLINT>{});
+    case TypeId::INTEGER:
+      return f(TypeTag<TypeId::INTEGER>{});
+    case TypeId::BIGINT:
+      return f(TypeTag<TypeId::BIGINT>{});
+    case TypeId::DECIMAL:
+      return f(TypeTag<TypeId::DECIMAL>{});
+    case TypeId::TIMESTAMP:
+      return f(TypeTag<TypeId::TIMESTAMP>{});
+    default:
+      throw Exception(ExceptionType::MISMATCH_TYPE, "Index keys do not support this type.");
+  }
+}
+
+void CheckFits(size_t pos, size_t width, size_t size) {
+  if (pos + width > size) {
+    throw Exception(ExceptionType::OUT_OF_RANGE, "Index key does not fit into the key size.");
+  }
+}
+
+/** The unsigned integer holding the encoding of a value of type T. */
+template <TypeId T>
+struct OrderedBitsOf {
+  using Type = std::make_unsigned_t<typename NativeType<T>::Type>;
+};
+
+template <>
+struct OrderedBitsOf<TypeId::DECIMAL> {
+  using Type = uint64_t;
+};
+
+template <TypeId T>
+using OrderedBits = typename OrderedBitsOf<T>::Type;
+
+/** @return the bits of x, mapped so that they sort as unsigned integers like x does */
+template <TypeId T>
+auto ToOrdered(typename NativeType<T>::Type x) -> OrderedBits<T> {
+  using U = OrderedBits<T>;
+  if constexpr (T == TypeId::DECIMAL) {
+    // -0.0 equals 0.0, so it has to encode the same.
+    if (x == 0) {
+      x = 0;
+    }
+    U bits;
+    memcpy(&bits, &x, sizeof(bits));
+    return (bits >> 63) != 0 ? ~bits : bits | (U{1} << 63);
+  } else if constexpr (std::is_signed_v<typename NativeType<T>::Type>) {
+    return static_cast<U>(static_cast<U>(x) ^ (U{1} << (8 * sizeof(U) - 1)));
+  } else {
+    return x;
+  }
+}
+
+/** The inverse of ToOrdered. */
+template <TypeId T>
+auto FromOrdered(OrderedBits<T> bits) -> typename NativeType<T>::Type {
+  using U = OrderedBits<T>;
+  typename NativeType<T>::Type x;
+  if constexpr (T == TypeId::DECIMAL) {
+    bits = (bits >> 63) != 0 ? bits & ~(U{1} << 63) : ~bits;
+    memcpy(&x, &bits, sizeof(x));
+  } else if constexpr (std::is_signed_v<typename NativeType<T>::Type>) {
+    x = static_cast<typename NativeType<T>::Type>(bits ^ (U{1} << (8 * sizeof(U) - 1)));
+  } else {
+    x = bits;
+  }
+  return x;
+}
+
+template <class U>
+void StoreBigEndian(U bits, char *out) {
+  for (size_t i = 0; i < sizeof(U); i++) {
+    out[i] = static_cast<char>(bits >> (8 * (sizeof(U) - 1 - i)));
+  }
+}
+
+template <class U>
+auto LoadBigEndian(const char *in) -> U {
+  U bits = 0;
+  for (size_t i = 0; i < sizeof(U); i++) {
+    bits = static_cast<U>((bits << 8) | static_cast<uint8_t>(in[i]));
+  }
+  return bits;
+}
+
+/** Encode a serialized fixed-width value. @return the number of bytes written */
+auto EncodeFixed(TypeId type, const char *native, char *out, size_t size) -> size_t {
+  return DispatchFixedType(type, [&](auto tag) -> size_t {
+    constexpr TypeId TYPE = decltype(tag)::value;
+    typename NativeType<TYPE>::Type x;
+    CheckFits(0, sizeof(x), size);
+    memcpy(&x, native, sizeof(x));
+    StoreBigEndian(ToOrdered<TYPE>(x), out);
+    return sizeof(x);
+  });
+}
+
+/** Decode a fixed-width value at data + *pos and advance *pos past it. */
+auto DecodeFixed(TypeId type, const char *data, size_t size, size_t *pos) -> Value {
+  return DispatchFixedType(type, [&](auto tag) -> Value {
+    constexpr TypeId TYPE = decltype(tag)::value;
+    using U = OrderedBits<TYPE>;
+    CheckFits(*pos, sizeof(U), size);
+    auto x = FromOrdered<TYPE>(LoadBigEndian<U>(data + *pos));
+    *pos += sizeof(x);
+    char native[sizeof(x)];
+    memcpy(native, &x, sizeof(x));
+    return Value::DeserializeFrom(native, TYPE);
+  });
+}
+
+/** Encode a VARCHAR value. @return the number of bytes written */
+auto EncodeVarchar(const Value &value, char *out, size_t size) -> size_t {
+  if (value.IsNull()) {
+    CheckFits(0, 2, size);
+    out[0] = '\x00';
+    out[1] = '\x00';
+    return 2;
+  }
+  const char *str = value.GetData();
+  uint32_t len = value.GetLength();
+  // Strings built by Value carry their C string terminator, which is not part of the string.
+  if (len > 0 && str[len - 1] == '\0') {
+    len--;
+  }
+  size_t pos = 0;
+  for (uint32_t i = 0; i < len; i++) {
+    if (str[i] == '\0') {
+      CheckFits(pos, 2, size);
+      out[pos++] = '\x00';
+      out[pos++] = '\xff';
+    } else {
+      CheckFits(pos, 1, size);
+      out[pos++] = str[i];
+    }
+  }
+  CheckFits(pos, 2, size);
+  out[pos++] = '\x00';
+  out[pos++] = '\x01';
+  return pos;
+}
+
+/** Decode a VARCHAR value at data + *pos and advance *pos past it. */
+auto DecodeVarchar(const char *data, size_t size, size_t *pos) -> Value {
+  std::string str;
+  size_t i = *pos;
+  while (i + 1 < size && (data[i] != '\0' || data[i + 1] == '\xff')) {
+    str.push_back(data[i]);
+    i += data[i] == '\0' ? 2 : 1;
+  }
+  CheckFits(i, 2, size);
+  bool is_null = data[i + 1] == '\x00';
+  *pos = i + 2;
+  if (is_null) {
+    return ValueFactory::GetNullValueByType(TypeId::VARCHAR);
+  }
+  return ValueFactory::GetVarcharValue(str);
+}
+
+}  // namespace
+
+auto EncodeKey(const Tuple &key, const Schema *key_schema, char *out, size_t size) -> size_t {
+  size_t pos = 0;
+  for (uint32_t i = 0; i < key_schema->GetColumnCount(); i++) {
+    const auto &col = key_schema->GetColumn(i);
+    if (col.GetType() == TypeId::VARCHAR) {
+      pos += EncodeVarchar(key.GetValue(key_schema, i), out + pos, size - pos);
+    } else {
+      pos += EncodeFixed(col.GetType(), key.GetData() + col.GetOffset(), out + pos, size - pos);
+    }
+  }
+  return pos;
+}
+
+auto MaxEncodedKeySize(const Schema *key_schema) -> size_t {
+  size_t size = 0;
+  for (const auto &col : key_schema->GetColumns()) {
+    if (col.GetType() == TypeId::VARCHAR) {
+      size += col.GetVariableLength() + 2;
+    } else {
+      size += DispatchFixedType(col.GetType(), [](auto tag) -> size_t {
+        return sizeof(typename NativeType<decltype(tag)::value>::Type);
+      });
+    }
+  }
+  return size;
+}
+
+auto EncodeKeyValue(const Value &value, char *out, size_t size) -> size_t {
+  if (value.GetTypeId() == TypeId::VARCHAR) {
+    return EncodeVarchar(value, out, size);
+  }
+  char native[sizeof(uint64_t)];
+  value.SerializeTo(native);
+  return EncodeFixed(value.GetTypeId(), native, out, size);
+}
+
+auto DecodeKeyColumn(const char *data, size_t size, const Schema *key_schema, uint32_t column_idx) -> Value {
+  size_t pos = 0;
+  for (uint32_t i = 0;; i++) {
+    TypeId type = key_schema->GetColumn(i).GetType();
+    Value value = type == TypeId::VARCHAR ? DecodeVarchar(data, size, &pos) : DecodeFixed(type, data, size, &pos);
+    if (i == column_idx) {
+      return value;
+    }
+  }
+}
+
+auto DecodeKey(const char *data, size_t size, const Schema *key_schema) -> std::vector<Value> {
+  std::vector<Value> values;
+  size_t pos = 0;
+  for (const auto &col : key_schema->GetColumns()) {
+    TypeId type = col.GetType();
+    values.push_back(type == TypeId::VARCHAR ? DecodeVarchar(data, size, &pos) : DecodeFixed(type, data, size, &pos));
+  }
+  return values;
+}
+
+}  // namespace bustub
@@ -0,0 +1,134 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// key_search.cpp
+//
+// Identification: src/storage/index/key_search.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/index/key_search.h"
+
+#include "common/macros.h"
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+#define BUSTUB_AVX2_KERNELS
+#define BUSTUB_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+
+namespace bustub {
+
+namespace {
+
+/** @return the mask of the first size bytes of a big-endian word */
+auto WordMask(int size) -> uint64_t { return size == 0 ? 0 : UINT64_MAX << (64 - 8 * size); }
+
+/** @return the key of up to 8 bytes at data, padded with zeros, as a native integer */
+auto LoadWord(const char *data, int size) -> uint64_t {
+  uint64_t word = 0;
+  memcpy(&word, data, size);
+  return __builtin_bswap64(word);
+}
+
+/** @return the key of the entry at offset, which may be followed by other bytes, as a native integer */
+auto LoadEntryWord(const char *page, uint16_t offset) -> uint64_t {
+  int size;
+  const char *key = EntryKey(page, offset, &size);
+  uint64_t word;
+  memcpy(&word, key, sizeof(word));
+  return __builtin_bswap64(word) & WordMask(size);
+}
+
+#ifdef BUSTUB_AVX2_KERNELS
+
+auto CpuHasAvx2() -> bool {
+  static const bool HAS_AVX2 = __builtin_cpu_supports("avx2") != 0;
+  return HAS_AVX2;
+}
+
+/*
+ * AVX2 has only signed comparisons, so the keys and the key they are compared with get their sign bits flipped first.
+ * The kernel counts whole registers of keys and returns how many keys it compared.
+ */
+BUSTUB_TARGET_AVX2 auto CountBelowAvx2(const char *page, const uint16_t *offsets, int size, uint64_t key,
+                                       bool inclusive, int *count) -> int {
+  const __m256i swap_bytes =
+      _mm256_setr_epi8(7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11,
+                       10, 9, 8);
+  const __m256i sign = _mm256_set1_epi64x(INT64_MIN);
+  const __m256i ones = _mm256_set1_epi64x(-1);
+  const __m256i bits = _mm256_set1_epi64x(64);
+  const __m256i target = _mm256_xor_si256(_mm256_set1_epi64x(static_cast<int64_t>(key)), sign);
+  const auto *bytes = reinterpret_cast<const uint8_t *>(page);
+  int i = 0;
+  for (; i + 4 <= size; i += 4) {
+    const uint16_t *o = offsets + i;
+    // The keys start right after their size.
+    __m128i key_offsets = _mm_setr_epi32(o[0] + 1, o[1] + 1, o[2] + 1, o[3] + 1);
+    __m256i sizes = _mm256_setr_epi64x(bytes[o[0]], bytes[o[1]], bytes[o[2]], bytes[o[3]]);
+    __m256i keys = _mm256_i32gather_epi64(reinterpret_cast<const long long *>(page), key_offsets, 1);  // NOLINT
+    // Only the first size bytes belong to a key, and shifting all bits out leaves an empty key as zero.
+    __m256i mask = _mm256_sllv_epi64(ones, _mm256_sub_epi64(bits, _mm256_slli_epi64(sizes, 3)));
+    keys = _mm256_xor_si256(_mm256_and_si256(_mm256_shuffle_epi8(keys, swap_bytes), mask), sign);
+    // A key is below the target if the target is greater, or in the inclusive case, if the key is not greater.
+    __m256i below = inclusive ? _mm256_cmpgt_epi64(keys, target) : _mm256_cmpgt_epi64(target, keys);
+    int matches = __builtin_popcount(static_cast<uint32_t>(_mm256_movemask_pd(_mm256_castsi256_pd(below))));
+    *count += inclusive ? 4 - matches : matches;
+  }
+  return i;
+}
+
+#endif
+
+}  // namespace
+
+auto CountKeysBelow(const char *page, const uint16_t *offsets, int size, uint64_t key, bool inclusive) -> int {
+  int count = 0;
+  int i = 0;
+#ifdef BUSTUB_AVX2_KERNELS
+  if (CpuHasAvx2()) {
+    i = CountBelowAvx2(page, offsets, size, key, inclusive, &count);
+  }
+#endif
+  for (; i < size; i++) {
+    uint64_t word = LoadEntryWord(page, offsets[i]);
+    count += static_cast<int>(inclusive ? word <= key : word < key);
+  }
+  return count;
+}
+
+auto KeySearch(const char *page, const uint16_t *offsets, int size, const char *key, int key_size, int width,
+               bool upper) -> int {
+  int low = 0;
+  int high = size;
+  if (width <= static_cast<int>(sizeof(uint64_t))) {
+    BUSTUB_ASSERT(key_size <= width, "the key is longer than the keys of the page");
+    uint64_t word = LoadWord(key, key_size);
+    while (high - low > KEY_SEARCH_WINDOW) {
+      int middle = low + (high - low) / 2;
+      uint64_t middle_word = LoadEntryWord(page, offsets[middle]);
+      if (upper ? middle_word <= word : middle_word < word) {
+        low = middle + 1;
+      } else {
+        high = middle;
+      }
+    }
+    return low + CountKeysBelow(page, offsets + low, high - low, word, upper);
+  }
+  while (low < high) {
+    int middle = low + (high - low) / 2;
+    int middle_size;
+    const char *middle_key = EntryKey(page, offsets[middle], &middle_size);
+    int cmp = CompareStoredKeys(middle_key, middle_size, key, key_size);
+    if (upper ? cmp <= 0 : cmp < 0) {
+      low = middle + 1;
+    } else {
+      high = middle;
+    }
+  }
+  return low;
+}
+
+}  // namespace bustub
@@ -10,15 +10,14 @@
 //===----------------------------------------------------------------------===//
 
 #include <algorithm>
-#include <csignal>
 #include <cstddef>
 #include <cstring>
-#include <iostream>
 #include <sstream>
 
-#include "catalog/schema.h"
 #include "common/exception.h"
+#include "common/macros.h"
 #include "storage/index/generic_key.h"
+#include "storage/index/key_search.h"
 #include "storage/page/b_plus_tree_internal_page.h"
 #include "storage/page/b_plus_tree_page.h"
 
@@ -26,18 +25,52 @@ namespace bustub {
 /*****************************************************************************
  * HELPER METHODS AND UTILITIES
  *****************************************************************************/
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::GetDataCapacity(int prefix_size) -> int { return HEAP_END - HEADER_SIZE; }
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::GetStoredKeySize(const KeyType &key, int prefix_size) -> int {
+  int size = SignificantSize(reinterpret_cast<const char *>(&key), sizeof(KeyType));
+  return std::max(size, prefix_size) - prefix_size;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::GetEntrySize(const KeyType &key, int prefix_size) -> int {
+  return sizeof(uint16_t) + 1 + GetStoredKeySize(key, prefix_size) + sizeof(ValueType);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::GetDataSize(const MappingType *items, int size, int prefix_size) -> int {
+  // The first key of a page is not stored.
+  int data_size = size > 0 ? sizeof(uint16_t) + 1 + sizeof(ValueType) : 0;
+  for (int i = 1; i < size; i++) {
+    data_size += GetEntrySize(items[i].first, prefix_size);
+  }
+  return data_size;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::GetPrefixSize(const KeyType &low_key, const KeyType *high_key) -> int {
+  return FencePrefixSize(reinterpret_cast<const char *>(&low_key), reinterpret_cast<const char *>(high_key),
+                         sizeof(KeyType));
+}
+
 /*
  * Init method after creating a new internal page
- * Including set page type, set current size, set page id, set parent id and set
- * max page size
+ * Including set page type, set current size, set page id and set max page size
  */
 INDEX_TEMPLATE_ARGUMENTS
-void B_PLUS_TREE_INTERNAL_PAGE_TYPE::Init(page_id_t page_id, page_id_t parent_id, int max_size) {
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::Init(page_id_t page_id, int max_size) {
+  BUSTUB_ASSERT(reinterpret_cast<char *>(offsets_) - Data() == HEADER_SIZE, "the header size is off");
   SetPageId(page_id);
-  SetParentPageId(parent_id);
   SetMaxSize(max_size);
   SetPageType(IndexPageType::INTERNAL_PAGE);
   SetSize(0);
+  SetLSN();
+  SetNextPageId(INVALID_PAGE_ID);
+  memset(&low_key_, 0, sizeof(KeyType));
+  prefix_size_ = 0;
+  heap_offset_ = HEAP_END;
 }
 /*
  * Helper method to get/set the key associated with input "index"(a.k.a
@@ -45,50 +78,302 @@ void B_PLUS_TREE_INTERNAL_PAGE_TYPE::Init(page_id_t page_id, page_id_t parent_id
  */
 INDEX_TEMPLATE_ARGUMENTS
 auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::KeyAt(int index) const -> KeyType {
-  // replace with your own code
-  // KeyType key{};
-  
-  return array_[index].first;
+  if (index == 0) {
+    return low_key_;
+  }
+  KeyType key;
+  auto *bytes = reinterpret_cast<char *>(&key);
+  int size;
+  const char *stored = EntryKey(Data(), offsets_[index], &size);
+  memcpy(bytes, &low_key_, prefix_size_);
+  memcpy(bytes + prefix_size_, stored, size);
+  memset(bytes + prefix_size_ + size, 0, sizeof(KeyType) - prefix_size_ - size);
+  return key;
 }
 
 INDEX_TEMPLATE_ARGUMENTS
 void B_PLUS_TREE_INTERNAL_PAGE_TYPE::SetKeyAt(int index, const KeyType &key) {
-  array_[index].first = key;
+  BUSTUB_ASSERT(index > 0, "the first key is the low key, which cannot change");
+  ValueType value = ValueAt(index);
+  RemoveEntry(index);
+  InsertEntry(index, key, value);
 }
 
+/*
+ * Helper method to get the value associated with input "index"(a.k.a array
+ * offset)
+ */
 INDEX_TEMPLATE_ARGUMENTS
-void B_PLUS_TREE_INTERNAL_PAGE_TYPE::SetValueAt(int index, const ValueType &value) {
-  array_[index].second = value;
+auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::ValueAt(int index) const -> ValueType {
+  int size;
+  const char *stored = EntryKey(Data(), offsets_[index], &size);
+  ValueType value;
+  memcpy(&value, stored + size, sizeof(ValueType));
+  return value;
 }
-//Custom
 
 INDEX_TEMPLATE_ARGUMENTS
-auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::Lookup(const KeyType& key,  KeyComparator &comparator)->page_id_t{
-  auto iter = std::lower_bound(array_+1, array_ + 1 + GetSize(), 
-  [comparator](const MappingType p, const KeyType key){
-  return comparator(p.first, key) < 0;
-  });
-
-  if(iter == array_+1+GetSize()){
-    return ValueAt(GetSize());
+auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::GetItems() const -> std::vector<MappingType> {
+  std::vector<MappingType> items;
+  items.reserve(GetSize());
+  for (int i = 0; i < GetSize(); i++) {
+    items.emplace_back(KeyAt(i), ValueAt(i));
   }
+  return items;
+}
 
-  if(comparator(iter->first, key) == 0){
-    return iter->second;
-  }
+/*
+ * Helper methods to get/set the next page id and the fences, of which the high key is only meaningful when there is a
+ * next page
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::GetNextPageId() const -> page_id_t { return next_page_id_; }
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::SetNextPageId(page_id_t next_page_id) { next_page_id_ = next_page_id; }
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::GetLowKey() const -> const KeyType & { return low_key_; }
 
-  return std::prev(iter)->second;
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::GetHighKey() const -> const KeyType & { return high_key_; }
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::SetFences(const KeyType &low_key, const KeyType *high_key) {
+  BUSTUB_ASSERT(GetSize() == 0, "the fences of a page that holds keys compressed against them cannot change");
+  Reset(nullptr, 0, low_key, high_key);
+}
 
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::IsBeyondHighKey(const KeyType &key, const KeyComparator &comparator) const
+    -> bool {
+  return next_page_id_ != INVALID_PAGE_ID && comparator(key, high_key_) >= 0;
 }
 
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::ValueIndex(const ValueType &value) const -> int {
+  for (int i = 0; i < GetSize(); i++) {
+    if (ValueAt(i) == value) {
+      return i;
+    }
+  }
+  return -1;
+}
 
 /*
- * Helper method to get the value associated with input "index"(a.k.a array
- * offset)
+ * Helper methods to tell how full the page is
  */
 INDEX_TEMPLATE_ARGUMENTS
-auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::ValueAt(int index) const -> ValueType {
-   return array_[index].second; 
+auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::GetFreeSpace() const -> int {
+  return heap_offset_ - HEADER_SIZE - GetSize() * static_cast<int>(sizeof(uint16_t));
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::GetMaxEntrySize() const -> int {
+  return sizeof(uint16_t) + 1 + (sizeof(KeyType) - prefix_size_) + sizeof(ValueType);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::HasRoomFor(int count) const -> bool {
+  return GetSize() + count <= GetMaxSize() && GetFreeSpace() >= count * GetMaxEntrySize();
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::HasRoomForLongerKey() const -> bool {
+  return GetFreeSpace() >= static_cast<int>(sizeof(KeyType)) - prefix_size_;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::IsHalfFull(int removed) const -> bool {
+  int data_size = HEAP_END - HEADER_SIZE - GetFreeSpace();
+  return GetSize() - removed >= GetMinSize() ||
+         data_size - removed * GetMaxEntrySize() >= (HEAP_END - HEADER_SIZE) / 2;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::Fits(const MappingType *items, int size, const KeyType &low_key,
+                                          const KeyType *high_key) const -> bool {
+  int prefix_size = GetPrefixSize(low_key, high_key);
+  return size <= GetMaxSize() && GetDataSize(items, size, prefix_size) <= GetDataCapacity(prefix_size);
+}
+
+/*****************************************************************************
+ * LOOKUP
+ *****************************************************************************/
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::Lookup(const KeyType &key, const KeyComparator &comparator) const -> ValueType {
+  // Keys are memcomparable, so they are searched by their bytes. All keys of the page share the prefix.
+  const auto *bytes = reinterpret_cast<const char *>(&key);
+  int cmp = memcmp(bytes, &low_key_, prefix_size_);
+  if (cmp != 0) {
+    return ValueAt(cmp < 0 ? 0 : GetSize() - 1);
+  }
+  // The first key greater than key bounds the subtree of the child before it.
+  return ValueAt(KeySearch(Data(), offsets_ + 1, GetSize() - 1, bytes + prefix_size_,
+                           GetStoredKeySize(key, prefix_size_), sizeof(KeyType) - prefix_size_, true));
+}
+
+/*****************************************************************************
+ * INSERTION
+ *****************************************************************************/
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::PopulateNewRoot(const ValueType &old_value, const KeyType &key,
+                                                     const ValueType &new_value) {
+  InsertEntry(0, low_key_, old_value);
+  InsertEntry(1, key, new_value);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::InsertNodeAfter(const ValueType &old_value, const KeyType &key,
+                                                     const ValueType &new_value) {
+  BUSTUB_ASSERT(HasRoomFor(1), "internal page is full");
+  int index = ValueIndex(old_value) + 1;
+  BUSTUB_ASSERT(index > 0, "old_value is not a child of this page");
+  InsertEntry(index, key, new_value);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::InsertNodeAfterAndSplit(const ValueType &old_value, const KeyType &key,
+                                                             const ValueType &new_value,
+                                                             BPlusTreeInternalPage *recipient) {
+  // The page has no room for one more child, so lay the children out in a buffer first.
+  std::vector<MappingType> items = GetItems();
+  items.insert(items.begin() + ValueIndex(old_value) + 1, {key, new_value});
+  auto size = static_cast<int>(items.size());
+  int left_size = SplitIndex(items, prefix_size_);
+  // Separators bound the subtrees below them, so the one that moves up cannot be truncated any further.
+  KeyType separator = items[left_size].first;
+  const KeyType *high_key = next_page_id_ != INVALID_PAGE_ID ? &high_key_ : nullptr;
+  recipient->Reset(items.data() + left_size, size - left_size, separator, high_key);
+  recipient->SetNextPageId(GetNextPageId());
+  Reset(items.data(), left_size, low_key_, &separator);
+  SetNextPageId(recipient->GetPageId());
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::CopyNFrom(const MappingType *items, int size) {
+  BUSTUB_ASSERT(GetSize() + size <= GetMaxSize(), "too many children for an internal page");
+  for (int i = 0; i < size; i++) {
+    InsertEntry(GetSize(), items[i].first, items[i].second);
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::InsertEntry(int index, const KeyType &key, const ValueType &value) {
+  BUSTUB_ASSERT(index == 0 || memcmp(&key, &low_key_, prefix_size_) == 0,
+                "the key does not share the prefix of the page");
+  int key_size = index == 0 ? 0 : GetStoredKeySize(key, prefix_size_);
+  int entry_size = 1 + key_size + static_cast<int>(sizeof(ValueType));
+  BUSTUB_ASSERT(GetFreeSpace() >= entry_size + static_cast<int>(sizeof(uint16_t)), "the entry does not fit");
+  heap_offset_ -= entry_size;
+  char *entry = Data() + heap_offset_;
+  entry[0] = static_cast<char>(key_size);
+  memcpy(entry + 1, reinterpret_cast<const char *>(&key) + prefix_size_, key_size);
+  memcpy(entry + 1 + key_size, &value, sizeof(ValueType));
+  memmove(offsets_ + index + 1, offsets_ + index, (GetSize() - index) * sizeof(uint16_t));
+  offsets_[index] = static_cast<uint16_t>(heap_offset_);
+  IncreaseSize(1);
+}
+
+/*****************************************************************************
+ * REMOVE
+ *****************************************************************************/
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::Remove(int index) {
+  BUSTUB_ASSERT(index > 0, "the first child goes away only with its page");
+  RemoveEntry(index);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::RemoveEntry(int index) {
+  int offset = offsets_[index];
+  int entry_size = 1 + static_cast<uint8_t>(Data()[offset]) + static_cast<int>(sizeof(ValueType));
+  // Close the gap, so that the free space stays in one piece.
+  memmove(Data() + heap_offset_ + entry_size, Data() + heap_offset_, offset - heap_offset_);
+  heap_offset_ += entry_size;
+  for (int i = 0; i < GetSize(); i++) {
+    if (offsets_[i] < offset) {
+      offsets_[i] += entry_size;
+    }
+  }
+  memmove(offsets_ + index, offsets_ + index + 1, (GetSize() - index - 1) * sizeof(uint16_t));
+  IncreaseSize(-1);
+}
+
+/*****************************************************************************
+ * MERGE AND REDISTRIBUTE
+ *****************************************************************************/
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::Reset(const MappingType *items, int size, const KeyType &low_key,
+                                           const KeyType *high_key) {
+  int prefix_size = GetPrefixSize(low_key, high_key);
+  low_key_ = low_key;
+  if (high_key != nullptr) {
+    high_key_ = *high_key;
+  }
+  prefix_size_ = prefix_size;
+  heap_offset_ = HEAP_END;
+  SetSize(0);
+  for (int i = 0; i < size; i++) {
+    InsertEntry(i, items[i].first, items[i].second);
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::SplitIndex(const std::vector<MappingType> &items, int prefix_size) const -> int {
+  auto size = static_cast<int>(items.size());
+  // Children that are too many for one page are split in half, unless they take too many bytes that way.
+  if (size > GetMaxSize()) {
+    int left_size = (size + 1) / 2;
+    if (GetDataSize(items.data(), left_size, prefix_size) <= GetDataCapacity(prefix_size) &&
+        GetDataSize(items.data() + left_size, size - left_size, prefix_size) <= GetDataCapacity(prefix_size)) {
+      return left_size;
+    }
+  }
+  // Otherwise, they are split where they take half of the bytes.
+  int half = GetDataSize(items.data(), size, prefix_size) / 2;
+  int left_size = 0;
+  for (int data_size = 0; left_size < size && data_size < half; left_size++) {
+    data_size += GetEntrySize(items[left_size].first, prefix_size);
+  }
+  return std::clamp(left_size, 1, size - 1);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::MoveAllTo(BPlusTreeInternalPage *recipient) -> bool {
+  // The first key of this page reads as its low key, the separator of the two pages, so the children can be appended
+  // as they are. The merged page covers the keys of both, which may share fewer bytes.
+  std::vector<MappingType> items = recipient->GetItems();
+  std::vector<MappingType> own_items = GetItems();
+  items.insert(items.end(), own_items.begin(), own_items.end());
+  const KeyType *high_key = next_page_id_ != INVALID_PAGE_ID ? &high_key_ : nullptr;
+  auto size = static_cast<int>(items.size());
+  if (!recipient->Fits(items.data(), size, recipient->low_key_, high_key)) {
+    return false;
+  }
+  recipient->Reset(items.data(), size, recipient->low_key_, high_key);
+  recipient->SetNextPageId(GetNextPageId());
+  SetSize(0);
+  return true;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::Redistribute(BPlusTreeInternalPage *right, KeyType *separator) -> bool {
+  std::vector<MappingType> items = GetItems();
+  std::vector<MappingType> right_items = right->GetItems();
+  items.insert(items.end(), right_items.begin(), right_items.end());
+  auto size = static_cast<int>(items.size());
+  int left_size = SplitIndex(items, std::min(prefix_size_, right->prefix_size_));
+  KeyType middle_key = items[left_size].first;
+  const KeyType *high_key = right->next_page_id_ != INVALID_PAGE_ID ? &right->high_key_ : nullptr;
+  if (!Fits(items.data(), left_size, low_key_, &middle_key) ||
+      !right->Fits(items.data() + left_size, size - left_size, middle_key, high_key)) {
+    return false;
+  }
+  Reset(items.data(), left_size, low_key_, &middle_key);
+  right->Reset(items.data() + left_size, size - left_size, middle_key, high_key);
+  *separator = middle_key;
+  return true;
 }
 
 // valuetype for internalNode should be page id_t
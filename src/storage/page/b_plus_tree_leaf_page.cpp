@@ -10,10 +10,13 @@
 //===----------------------------------------------------------------------===//
 
 #include <algorithm>
+#include <cstring>
 #include <sstream>
 
 #include "common/exception.h"
+#include "common/macros.h"
 #include "common/rid.h"
+#include "storage/index/key_search.h"
 #include "storage/page/b_plus_tree_leaf_page.h"
 #include "storage/page/b_plus_tree_page.h"
 
@@ -23,32 +26,125 @@ namespace bustub {
  * HELPER METHODS AND UTILITIES
  *****************************************************************************/
 
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::GetDataCapacity(int prefix_size) -> int {
+  // A leaf at rest keeps room for one more entry with the longest key and a single value.
+  return HEAP_END - HEADER_SIZE - (static_cast<int>(sizeof(uint16_t) + 2 + sizeof(KeyType) + sizeof(ValueType)) -
+                                   prefix_size);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::GetStoredKeySize(const KeyType &key, int prefix_size) -> int {
+  int size = SignificantSize(reinterpret_cast<const char *>(&key), sizeof(KeyType));
+  return std::max(size, prefix_size) - prefix_size;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::GetEntrySize(const KeyType &key, int prefix_size) -> int {
+  return sizeof(uint16_t) + 2 + GetStoredKeySize(key, prefix_size) + sizeof(ValueType);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::GetEntrySize(const LeafEntryType &entry, int prefix_size) -> int {
+  return sizeof(uint16_t) + 1 + GetStoredKeySize(entry.first, prefix_size) + GetPostingSize(entry.second);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::GetPostingSize(const LeafPosting<ValueType> &posting) -> int {
+  if (posting.values_.empty()) {
+    return 1 + 2 * sizeof(page_id_t);
+  }
+  return 1 + posting.values_.size() * sizeof(ValueType);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_LEAF_PAGE_TYPE::EncodePosting(const LeafPosting<ValueType> &posting, char *buffer) {
+  auto count = static_cast<int>(posting.values_.size());
+  BUSTUB_ASSERT(count <= POSTING_LIST_MAX_SIZE, "too many values for an inline posting list");
+  buffer[0] = static_cast<char>(count);
+  if (count == 0) {
+    memcpy(buffer + 1, &posting.first_page_id_, sizeof(page_id_t));
+    memcpy(buffer + 1 + sizeof(page_id_t), &posting.last_page_id_, sizeof(page_id_t));
+  } else {
+    memcpy(buffer + 1, posting.values_.data(), count * sizeof(ValueType));
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::GetStoredPostingSize(const char *posting) -> int {
+  int count = static_cast<uint8_t>(posting[0]);
+  return 1 + (count == 0 ? 2 * sizeof(page_id_t) : count * sizeof(ValueType));
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::GetDataSize(const LeafEntryType *items, int size, int prefix_size) -> int {
+  int data_size = 0;
+  for (int i = 0; i < size; i++) {
+    data_size += GetEntrySize(items[i], prefix_size);
+  }
+  return data_size;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::GetPrefixSize(const KeyType &low_key, const KeyType *high_key) -> int {
+  return FencePrefixSize(reinterpret_cast<const char *>(&low_key), reinterpret_cast<const char *>(high_key),
+                         sizeof(KeyType));
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::GetSeparator(const KeyType &left, const KeyType &right) -> KeyType {
+  KeyType separator;
+  ShortestSeparator(reinterpret_cast<const char *>(&left), reinterpret_cast<const char *>(&right),
+                    reinterpret_cast<char *>(&separator), sizeof(KeyType));
+  return separator;
+}
+
 /**
  * Init method after creating a new leaf page
- * Including set page type, set current size to zero, set page id/parent id, set
+ * Including set page type, set current size to zero, set page id, set
  * next page id and set max size
  */
 INDEX_TEMPLATE_ARGUMENTS
-void B_PLUS_TREE_LEAF_PAGE_TYPE::Init(page_id_t page_id, page_id_t parent_id, int max_size) {
+void B_PLUS_TREE_LEAF_PAGE_TYPE::Init(page_id_t page_id, int max_size) {
+  BUSTUB_ASSERT(reinterpret_cast<char *>(offsets_) - Data() == HEADER_SIZE, "the header size is off");
   SetPageId(page_id);
-  SetParentPageId(parent_id);
   SetMaxSize(max_size);
   SetPageType(IndexPageType::LEAF_PAGE);
   SetSize(0);
-  SetNextPageId(next_page_id_);
+  SetLSN();
+  SetNextPageId(INVALID_PAGE_ID);
+  memset(&low_key_, 0, sizeof(KeyType));
+  prefix_size_ = 0;
+  heap_offset_ = HEAP_END;
 }
 
 /**
  * Helper methods to set/get next page id
  */
 INDEX_TEMPLATE_ARGUMENTS
-auto B_PLUS_TREE_LEAF_PAGE_TYPE::GetNextPageId() const -> page_id_t { 
-  return next_page_id_; 
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::GetNextPageId() const -> page_id_t { return next_page_id_; }
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_LEAF_PAGE_TYPE::SetNextPageId(page_id_t next_page_id) { next_page_id_ = next_page_id; }
+
+/**
+ * Helper methods to get/set the fences, of which the high key is only meaningful when there is a next page
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::GetLowKey() const -> const KeyType & { return low_key_; }
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::GetHighKey() const -> const KeyType & { return high_key_; }
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_LEAF_PAGE_TYPE::SetFences(const KeyType &low_key, const KeyType *high_key) {
+  BUSTUB_ASSERT(GetSize() == 0, "the fences of a page that holds keys compressed against them cannot change");
+  Reset(nullptr, 0, low_key, high_key);
 }
 
 INDEX_TEMPLATE_ARGUMENTS
-void B_PLUS_TREE_LEAF_PAGE_TYPE::SetNextPageId(page_id_t next_page_id) {
-  next_page_id_ = next_page_id;
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::IsBeyondHighKey(const KeyType &key, const KeyComparator &comparator) const -> bool {
+  return next_page_id_ != INVALID_PAGE_ID && comparator(key, high_key_) >= 0;
 }
 
 /*
@@ -57,60 +153,369 @@ void B_PLUS_TREE_LEAF_PAGE_TYPE::SetNextPageId(page_id_t next_page_id) {
  */
 INDEX_TEMPLATE_ARGUMENTS
 auto B_PLUS_TREE_LEAF_PAGE_TYPE::KeyAt(int index) const -> KeyType {
-  // replace with your own code
-  // KeyType key{};
-  return array_[index].first;
+  KeyType key;
+  auto *bytes = reinterpret_cast<char *>(&key);
+  int size;
+  const char *stored = EntryKey(Data(), offsets_[index], &size);
+  memcpy(bytes, &low_key_, prefix_size_);
+  memcpy(bytes + prefix_size_, stored, size);
+  memset(bytes + prefix_size_ + size, 0, sizeof(KeyType) - prefix_size_ - size);
+  return key;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::PostingAt(int index) const -> const char * {
+  int size;
+  const char *stored = EntryKey(Data(), offsets_[index], &size);
+  return stored + size;
 }
 
 INDEX_TEMPLATE_ARGUMENTS
-auto B_PLUS_TREE_LEAF_PAGE_TYPE::ValueAt(int index) const -> ValueType {
-  // replace with your own code
-  // KeyType key{};
-  return array_[index].second;
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::ValueAt(int index, int position) const -> ValueType {
+  const char *posting = PostingAt(index);
+  BUSTUB_ASSERT(position < static_cast<uint8_t>(posting[0]), "the key has no such inline value");
+  ValueType value;
+  memcpy(&value, posting + 1 + position * sizeof(ValueType), sizeof(ValueType));
+  return value;
 }
 
-//Custom Methods
 INDEX_TEMPLATE_ARGUMENTS
-void B_PLUS_TREE_LEAF_PAGE_TYPE::SetKeyAt(int index, const KeyType &key) {
-  // replace with your own code
-  // KeyType key{};
-  array_[index].first = key;
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::GetValueCount(int index) const -> int {
+  return static_cast<uint8_t>(PostingAt(index)[0]);
 }
 
 INDEX_TEMPLATE_ARGUMENTS
-void B_PLUS_TREE_LEAF_PAGE_TYPE::SetValueAt(int index, const ValueType &value) {
-  array_[index].second = value;
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::GetPosting(int index) const -> LeafPosting<ValueType> {
+  const char *posting = PostingAt(index);
+  int count = static_cast<uint8_t>(posting[0]);
+  LeafPosting<ValueType> result;
+  if (count == 0) {
+    memcpy(&result.first_page_id_, posting + 1, sizeof(page_id_t));
+    memcpy(&result.last_page_id_, posting + 1 + sizeof(page_id_t), sizeof(page_id_t));
+  } else {
+    result.values_.resize(count);
+    memcpy(result.values_.data(), posting + 1, count * sizeof(ValueType));
+  }
+  return result;
 }
 
 INDEX_TEMPLATE_ARGUMENTS
-auto B_PLUS_TREE_LEAF_PAGE_TYPE::Insert(const KeyType &key, const ValueType &value, 
-KeyComparator &comparator) -> bool{
-  int index = FindKeyIndex(key, comparator);
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::GetItem(int index) const -> LeafEntryType { return {KeyAt(index), GetPosting(index)}; }
 
-  if(index == GetSize()){
-    array_[index] = {key, value};
-    IncreaseSize(1);
-    return true;
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::GetItems() const -> std::vector<LeafEntryType> {
+  std::vector<LeafEntryType> items;
+  items.reserve(GetSize());
+  for (int i = 0; i < GetSize(); i++) {
+    items.push_back(GetItem(i));
+  }
+  return items;
+}
+
+/*
+ * Helper methods to tell how full the page is
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::GetFreeSpace() const -> int {
+  return heap_offset_ - HEADER_SIZE - GetSize() * static_cast<int>(sizeof(uint16_t));
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::GetMaxEntrySize() const -> int {
+  return sizeof(uint16_t) + 2 + (sizeof(KeyType) - prefix_size_) + sizeof(ValueType);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::HasRoomFor(int count) const -> bool {
+  return GetSize() + count <= GetMaxSize() && GetFreeSpace() >= count * GetMaxEntrySize();
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::HasRoomForValues(int index, int count) const -> bool {
+  int growth = 1 + count * static_cast<int>(sizeof(ValueType)) - GetStoredPostingSize(PostingAt(index));
+  return GetSize() < GetMaxSize() && GetFreeSpace() - growth >= GetMaxEntrySize();
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::IsHalfFull(int removed) const -> bool {
+  int data_size = HEAP_END - HEADER_SIZE - GetFreeSpace();
+  return GetSize() - removed >= GetMinSize() ||
+         data_size - removed * GetMaxEntrySize() >= (HEAP_END - HEADER_SIZE) / 2;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::Fits(const LeafEntryType *items, int size, const KeyType &low_key,
+                                      const KeyType *high_key) const -> bool {
+  int prefix_size = GetPrefixSize(low_key, high_key);
+  return size < GetMaxSize() && GetDataSize(items, size, prefix_size) <= GetDataCapacity(prefix_size);
+}
+
+/*****************************************************************************
+ * LOOKUP
+ *****************************************************************************/
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::KeyIndex(const KeyType &key, const KeyComparator &comparator) const -> int {
+  // Keys are memcomparable, so they are searched by their bytes. All keys of the page share the prefix.
+  const auto *bytes = reinterpret_cast<const char *>(&key);
+  int cmp = memcmp(bytes, &low_key_, prefix_size_);
+  if (cmp != 0) {
+    return cmp < 0 ? 0 : GetSize();
+  }
+  return KeySearch(Data(), offsets_, GetSize(), bytes + prefix_size_, GetStoredKeySize(key, prefix_size_),
+                   sizeof(KeyType) - prefix_size_, false);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::FindKey(const KeyType &key, const KeyComparator &comparator) const -> int {
+  int index = KeyIndex(key, comparator);
+  if (index == GetSize() || comparator(KeyAt(index), key) != 0) {
+    return -1;
   }
-  if(comparator(array_[index].first, key) == 0){
+  return index;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::Lookup(const KeyType &key, ValueType *value, const KeyComparator &comparator) const
+    -> bool {
+  int index = FindKey(key, comparator);
+  if (index < 0) {
+    return false;
+  }
+  *value = ValueAt(index);
+  return true;
+}
+
+/*****************************************************************************
+ * INSERTION
+ *****************************************************************************/
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::Insert(const KeyType &key, const ValueType &value, const KeyComparator &comparator)
+    -> bool {
+  BUSTUB_ASSERT(HasRoomFor(1), "leaf page is full");
+  int index = KeyIndex(key, comparator);
+  if (index < GetSize() && comparator(KeyAt(index), key) == 0) {
+    return false;
+  }
+  char posting[1 + sizeof(ValueType)];
+  posting[0] = 1;
+  memcpy(posting + 1, &value, sizeof(ValueType));
+  InsertEntry(index, key, posting, sizeof(posting));
+  return true;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::AddValue(int index, const ValueType &value) -> bool {
+  BUSTUB_ASSERT(HasRoomFor(1), "leaf page is full");
+  const char *posting = PostingAt(index);
+  int count = static_cast<uint8_t>(posting[0]);
+  BUSTUB_ASSERT(count > 0 && count < POSTING_LIST_MAX_SIZE, "the posting list must be inline and not full");
+  ValueType values[POSTING_LIST_MAX_SIZE];
+  memcpy(values, posting + 1, count * sizeof(ValueType));
+  ValueType *position = std::lower_bound(values, values + count, value);
+  if (position != values + count && *position == value) {
     return false;
   }
-  std::move_backward(array_ + index, array_ + GetSize(), array_ + GetSize()+1);
-  array_[index] = {key, value};
+  std::copy_backward(position, values + count, values + count + 1);
+  *position = value;
+  char buffer[1 + sizeof(values)];
+  buffer[0] = static_cast<char>(count + 1);
+  memcpy(buffer + 1, values, (count + 1) * sizeof(ValueType));
+  ReplacePosting(index, buffer, 1 + (count + 1) * sizeof(ValueType));
+  return true;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_LEAF_PAGE_TYPE::SetPosting(int index, const LeafPosting<ValueType> &posting) {
+  char buffer[1 + POSTING_LIST_MAX_SIZE * sizeof(ValueType)];
+  EncodePosting(posting, buffer);
+  ReplacePosting(index, buffer, GetPostingSize(posting));
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_LEAF_PAGE_TYPE::InsertEntry(int index, const KeyType &key, const char *posting, int posting_size) {
+  BUSTUB_ASSERT(memcmp(&key, &low_key_, prefix_size_) == 0, "the key does not share the prefix of the page");
+  int key_size = GetStoredKeySize(key, prefix_size_);
+  int entry_size = 1 + key_size + posting_size;
+  BUSTUB_ASSERT(GetFreeSpace() >= entry_size + static_cast<int>(sizeof(uint16_t)), "the entry does not fit");
+  heap_offset_ -= entry_size;
+  char *entry = Data() + heap_offset_;
+  entry[0] = static_cast<char>(key_size);
+  memcpy(entry + 1, reinterpret_cast<const char *>(&key) + prefix_size_, key_size);
+  memcpy(entry + 1 + key_size, posting, posting_size);
+  memmove(offsets_ + index + 1, offsets_ + index, (GetSize() - index) * sizeof(uint16_t));
+  offsets_[index] = static_cast<uint16_t>(heap_offset_);
   IncreaseSize(1);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_LEAF_PAGE_TYPE::InsertEntry(int index, const LeafEntryType &item) {
+  char buffer[1 + POSTING_LIST_MAX_SIZE * sizeof(ValueType)];
+  EncodePosting(item.second, buffer);
+  InsertEntry(index, item.first, buffer, GetPostingSize(item.second));
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_LEAF_PAGE_TYPE::ReplacePosting(int index, const char *posting, int posting_size) {
+  char *stored = Data() + offsets_[index] + 1 + static_cast<uint8_t>(Data()[offsets_[index]]);
+  if (GetStoredPostingSize(stored) == posting_size) {
+    memcpy(stored, posting, posting_size);
+    return;
+  }
+  // The entry changes its size, so it is stored anew, which keeps the free space in one piece.
+  KeyType key = KeyAt(index);
+  RemoveEntry(index);
+  InsertEntry(index, key, posting, posting_size);
+}
+
+/*****************************************************************************
+ * REMOVE
+ *****************************************************************************/
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::Remove(const KeyType &key, const KeyComparator &comparator) -> bool {
+  int index = KeyIndex(key, comparator);
+  if (index == GetSize() || comparator(KeyAt(index), key) != 0) {
+    return false;
+  }
+  RemoveEntry(index);
+  return true;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::RemoveValue(int index, const ValueType &value) -> bool {
+  const char *posting = PostingAt(index);
+  int count = static_cast<uint8_t>(posting[0]);
+  BUSTUB_ASSERT(count > 0, "the posting list must be inline");
+  ValueType values[POSTING_LIST_MAX_SIZE];
+  memcpy(values, posting + 1, count * sizeof(ValueType));
+  ValueType *position = std::lower_bound(values, values + count, value);
+  if (position == values + count || !(*position == value)) {
+    return false;
+  }
+  if (count == 1) {
+    RemoveEntry(index);
+    return true;
+  }
+  std::copy(position + 1, values + count, position);
+  char buffer[1 + sizeof(values)];
+  buffer[0] = static_cast<char>(count - 1);
+  memcpy(buffer + 1, values, (count - 1) * sizeof(ValueType));
+  ReplacePosting(index, buffer, 1 + (count - 1) * sizeof(ValueType));
   return true;
 }
 
 INDEX_TEMPLATE_ARGUMENTS
-auto B_PLUS_TREE_LEAF_PAGE_TYPE::FindKeyIndex(const KeyType &key, KeyComparator &comparator) -> int {
-auto iter = std::lower_bound(array_, array_ + GetSize(), key,
-[comparator](const MappingType p, const KeyType key){
-  return comparator(p.first, key) < 0;
-});
-  return iter-array_;
+void B_PLUS_TREE_LEAF_PAGE_TYPE::RemoveEntry(int index) {
+  int offset = offsets_[index];
+  int key_size = static_cast<uint8_t>(Data()[offset]);
+  int entry_size = 1 + key_size + GetStoredPostingSize(Data() + offset + 1 + key_size);
+  // Close the gap, so that the free space stays in one piece.
+  memmove(Data() + heap_offset_ + entry_size, Data() + heap_offset_, offset - heap_offset_);
+  heap_offset_ += entry_size;
+  for (int i = 0; i < GetSize(); i++) {
+    if (offsets_[i] < offset) {
+      offsets_[i] += entry_size;
+    }
+  }
+  memmove(offsets_ + index, offsets_ + index + 1, (GetSize() - index - 1) * sizeof(uint16_t));
+  IncreaseSize(-1);
+}
+
+/*****************************************************************************
+ * SPLIT, MERGE AND REDISTRIBUTE
+ *****************************************************************************/
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_LEAF_PAGE_TYPE::Reset(const LeafEntryType *items, int size, const KeyType &low_key,
+                                       const KeyType *high_key) {
+  int prefix_size = GetPrefixSize(low_key, high_key);
+  low_key_ = low_key;
+  if (high_key != nullptr) {
+    high_key_ = *high_key;
+  }
+  prefix_size_ = prefix_size;
+  heap_offset_ = HEAP_END;
+  SetSize(0);
+  for (int i = 0; i < size; i++) {
+    InsertEntry(i, items[i]);
+  }
 }
 
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::SplitIndex(const std::vector<LeafEntryType> &items, int prefix_size) const -> int {
+  auto size = static_cast<int>(items.size());
+  // Entries that are too many for one page are split in half, unless they take too many bytes that way.
+  if (size >= GetMaxSize()) {
+    int left_size = size / 2;
+    if (GetDataSize(items.data(), left_size, prefix_size) <= GetDataCapacity(prefix_size) &&
+        GetDataSize(items.data() + left_size, size - left_size, prefix_size) <= GetDataCapacity(prefix_size)) {
+      return left_size;
+    }
+  }
+  // Otherwise, they are split where they take half of the bytes.
+  int half = GetDataSize(items.data(), size, prefix_size) / 2;
+  int left_size = 0;
+  for (int data_size = 0; left_size < size && data_size < half; left_size++) {
+    data_size += GetEntrySize(items[left_size], prefix_size);
+  }
+  return std::clamp(left_size, 1, size - 1);
+}
 
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_LEAF_PAGE_TYPE::CopyNFrom(const LeafEntryType *items, int size) {
+  for (int i = 0; i < size; i++) {
+    InsertEntry(GetSize(), items[i]);
+  }
+  BUSTUB_ASSERT(HasRoomFor(1), "a leaf at rest must have room for another entry");
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_LEAF_PAGE_TYPE::MoveHalfTo(BPlusTreeLeafPage *recipient) {
+  std::vector<LeafEntryType> items = GetItems();
+  auto size = static_cast<int>(items.size());
+  int left_size = SplitIndex(items, prefix_size_);
+  // Suffix truncation: the separator only has to tell the last key on the left from the first one on the right.
+  KeyType separator = GetSeparator(items[left_size - 1].first, items[left_size].first);
+  const KeyType *high_key = next_page_id_ != INVALID_PAGE_ID ? &high_key_ : nullptr;
+  recipient->Reset(items.data() + left_size, size - left_size, separator, high_key);
+  recipient->SetNextPageId(GetNextPageId());
+  Reset(items.data(), left_size, low_key_, &separator);
+  SetNextPageId(recipient->GetPageId());
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::MoveAllTo(BPlusTreeLeafPage *recipient) -> bool {
+  // The merged page covers the keys of both, which may share fewer bytes.
+  std::vector<LeafEntryType> items = recipient->GetItems();
+  std::vector<LeafEntryType> own_items = GetItems();
+  items.insert(items.end(), own_items.begin(), own_items.end());
+  const KeyType *high_key = next_page_id_ != INVALID_PAGE_ID ? &high_key_ : nullptr;
+  auto size = static_cast<int>(items.size());
+  if (!recipient->Fits(items.data(), size, recipient->low_key_, high_key)) {
+    return false;
+  }
+  recipient->Reset(items.data(), size, recipient->low_key_, high_key);
+  recipient->SetNextPageId(GetNextPageId());
+  SetSize(0);
+  return true;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::Redistribute(BPlusTreeLeafPage *right, KeyType *separator) -> bool {
+  std::vector<LeafEntryType> items = GetItems();
+  std::vector<LeafEntryType> right_items = right->GetItems();
+  items.insert(items.end(), right_items.begin(), right_items.end());
+  auto size = static_cast<int>(items.size());
+  int left_size = SplitIndex(items, std::min(prefix_size_, right->prefix_size_));
+  KeyType middle_key = GetSeparator(items[left_size - 1].first, items[left_size].first);
+  const KeyType *high_key = right->next_page_id_ != INVALID_PAGE_ID ? &right->high_key_ : nullptr;
+  if (!Fits(items.data(), left_size, low_key_, &middle_key) ||
+      !right->Fits(items.data() + left_size, size - left_size, middle_key, high_key)) {
+    return false;
+  }
+  Reset(items.data(), left_size, low_key_, &middle_key);
+  right->Reset(items.data() + left_size, size - left_size, middle_key, high_key);
+  *separator = middle_key;
+  return true;
+}
 
 template class BPlusTreeLeafPage<GenericKey<4>, RID, GenericComparator<4>>;
 template class BPlusTreeLeafPage<GenericKey<8>, RID, GenericComparator<8>>;
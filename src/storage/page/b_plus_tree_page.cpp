@@ -11,6 +11,10 @@
 
 #include "storage/page/b_plus_tree_page.h"
 
+#include <cstring>
+
+#include "common/macros.h"
+
 namespace bustub {
 
 /*
@@ -18,46 +22,75 @@ namespace bustub {
  * Page type enum class is defined in b_plus_tree_page.h
  */
 auto BPlusTreePage::IsLeafPage() const -> bool { return page_type_ == IndexPageType::LEAF_PAGE; }
-auto BPlusTreePage::IsRootPage() const -> bool { return page_type_ == IndexPageType::INTERNAL_PAGE; }
-void BPlusTreePage::SetPageType(IndexPageType page_type) {
-    page_type_ = page_type;
-}
+void BPlusTreePage::SetPageType(IndexPageType page_type) { page_type_ = page_type; }
 
 /*
  * Helper methods to get/set size (number of key/value pairs stored in that
  * page)
  */
 auto BPlusTreePage::GetSize() const -> int { return size_; }
-void BPlusTreePage::SetSize(int size) {size_ = size;}
-void BPlusTreePage::IncreaseSize(int amount) {size_ += amount;}
+void BPlusTreePage::SetSize(int size) { size_ = size; }
+void BPlusTreePage::IncreaseSize(int amount) { size_ += amount; }
 
 /*
  * Helper methods to get/set max size (capacity) of the page
  */
 auto BPlusTreePage::GetMaxSize() const -> int { return max_size_; }
-void BPlusTreePage::SetMaxSize(int size) {max_size_ = size;}
+void BPlusTreePage::SetMaxSize(int size) { max_size_ = size; }
 
 /*
  * Helper method to get min page size
- * Generally, min page size == max page size / 2
- */
-auto BPlusTreePage::GetMinSize() const -> int { return max_size_/2; }
-
-/*
- * Helper methods to get/set parent page id
+ * A leaf splits once it holds max size entries, so it needs max size / 2 to stay half full, while an internal page
+ * holds up to max size children and needs half of them rounded up.
  */
-auto BPlusTreePage::GetParentPageId() const -> page_id_t { return parent_page_id_; }
-void BPlusTreePage::SetParentPageId(page_id_t parent_page_id) {parent_page_id_ = parent_page_id;}
+auto BPlusTreePage::GetMinSize() const -> int { return IsLeafPage() ? max_size_ / 2 : (max_size_ + 1) / 2; }
 
 /*
  * Helper methods to get/set self page id
  */
 auto BPlusTreePage::GetPageId() const -> page_id_t { return page_id_; }
-void BPlusTreePage::SetPageId(page_id_t page_id) {page_id_ = page_id;}
+void BPlusTreePage::SetPageId(page_id_t page_id) { page_id_ = page_id; }
 
 /*
  * Helper methods to set lsn
  */
 void BPlusTreePage::SetLSN(lsn_t lsn) { lsn_ = lsn; }
 
+/*
+ * Helper methods to compress keys
+ */
+auto BPlusTreePage::CommonPrefixSize(const char *a, const char *b, int size) -> int {
+  int i = 0;
+  while (i < size && a[i] == b[i]) {
+    i++;
+  }
+  return i;
+}
+
+auto BPlusTreePage::SignificantSize(const char *key, int size) -> int {
+  while (size > 0 && key[size - 1] == 0) {
+    size--;
+  }
+  return size;
+}
+
+auto BPlusTreePage::FencePrefixSize(const char *low, const char *high, int size) -> int {
+  if (high != nullptr) {
+    return CommonPrefixSize(low, high, size);
+  }
+  // Without a high key, only the bytes of the low key that are already as great as they get are shared.
+  int i = 0;
+  while (i < size && static_cast<uint8_t>(low[i]) == UINT8_MAX) {
+    i++;
+  }
+  return i;
+}
+
+void BPlusTreePage::ShortestSeparator(const char *left, const char *right, char *separator, int size) {
+  int prefix_size = CommonPrefixSize(left, right, size);
+  BUSTUB_ASSERT(prefix_size < size, "right must be greater than left");
+  memcpy(separator, right, prefix_size + 1);
+  memset(separator + prefix_size + 1, 0, size - prefix_size - 1);
+}
+
 }  // namespace bustub
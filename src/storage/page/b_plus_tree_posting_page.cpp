@@ -0,0 +1,102 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_plus_tree_posting_page.cpp
+//
+// Identification: src/storage/page/b_plus_tree_posting_page.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/page/b_plus_tree_posting_page.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "common/macros.h"
+#include "common/rid.h"
+
+namespace bustub {
+
+template <typename ValueType>
+void B_PLUS_TREE_POSTING_PAGE_TYPE::Init(page_id_t page_id, int max_size) {
+  BUSTUB_ASSERT(reinterpret_cast<char *>(array_) - reinterpret_cast<char *>(this) == POSTING_PAGE_HEADER_SIZE,
+                "the header size is off");
+  SetPageId(page_id);
+  SetMaxSize(max_size);
+  SetPageType(IndexPageType::POSTING_PAGE);
+  SetSize(0);
+  SetLSN();
+  SetNextPageId(INVALID_PAGE_ID);
+}
+
+template <typename ValueType>
+auto B_PLUS_TREE_POSTING_PAGE_TYPE::GetNextPageId() const -> page_id_t {
+  return next_page_id_;
+}
+
+template <typename ValueType>
+void B_PLUS_TREE_POSTING_PAGE_TYPE::SetNextPageId(page_id_t next_page_id) {
+  next_page_id_ = next_page_id;
+}
+
+template <typename ValueType>
+auto B_PLUS_TREE_POSTING_PAGE_TYPE::ValueAt(int index) const -> const ValueType & {
+  return array_[index];
+}
+
+template <typename ValueType>
+auto B_PLUS_TREE_POSTING_PAGE_TYPE::ValueIndex(const ValueType &value) const -> int {
+  return static_cast<int>(std::lower_bound(array_, array_ + GetSize(), value) - array_);
+}
+
+template <typename ValueType>
+auto B_PLUS_TREE_POSTING_PAGE_TYPE::Insert(const ValueType &value) -> bool {
+  BUSTUB_ASSERT(GetSize() < GetMaxSize(), "posting page is full");
+  int index = ValueIndex(value);
+  if (index < GetSize() && array_[index] == value) {
+    return false;
+  }
+  memmove(array_ + index + 1, array_ + index, (GetSize() - index) * sizeof(ValueType));
+  array_[index] = value;
+  IncreaseSize(1);
+  return true;
+}
+
+template <typename ValueType>
+auto B_PLUS_TREE_POSTING_PAGE_TYPE::Remove(const ValueType &value) -> bool {
+  int index = ValueIndex(value);
+  if (index == GetSize() || !(array_[index] == value)) {
+    return false;
+  }
+  memmove(array_ + index, array_ + index + 1, (GetSize() - index - 1) * sizeof(ValueType));
+  IncreaseSize(-1);
+  return true;
+}
+
+template <typename ValueType>
+void B_PLUS_TREE_POSTING_PAGE_TYPE::CopyNFrom(const ValueType *values, int size) {
+  BUSTUB_ASSERT(GetSize() + size <= GetMaxSize(), "the values do not fit");
+  std::copy(values, values + size, array_ + GetSize());
+  IncreaseSize(size);
+}
+
+template <typename ValueType>
+void B_PLUS_TREE_POSTING_PAGE_TYPE::MoveHalfTo(BPlusTreePostingPage *recipient) {
+  int left_size = GetSize() / 2;
+  recipient->CopyNFrom(array_ + left_size, GetSize() - left_size);
+  recipient->SetNextPageId(GetNextPageId());
+  SetSize(left_size);
+  SetNextPageId(recipient->GetPageId());
+}
+
+template <typename ValueType>
+void B_PLUS_TREE_POSTING_PAGE_TYPE::MoveAllTo(BPlusTreePostingPage *recipient) {
+  recipient->CopyNFrom(array_, GetSize());
+  recipient->SetNextPageId(GetNextPageId());
+  SetSize(0);
+}
+
+template class BPlusTreePostingPage<RID>;
+
+}  // namespace bustub
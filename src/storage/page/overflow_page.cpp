@@ -0,0 +1,68 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// overflow_page.cpp
+//
+// Identification: src/storage/page/overflow_page.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/page/overflow_page.h"
+
+#include <algorithm>
+
+#include "common/macros.h"
+
+namespace bustub {
+
+auto OverflowPage::WriteChain(BufferPoolManager *bpm, const char *data, uint32_t size) -> page_id_t {
+  // Write the chain back to front, so that every page knows its successor when it is written. Nobody else can see the
+  // chain before it is returned, so the pages are not latched.
+  page_id_t next_page_id = INVALID_PAGE_ID;
+  uint32_t num_pages = std::max<uint32_t>(1, (size + CAPACITY - 1) / CAPACITY);
+  for (uint32_t i = num_pages; i-- > 0;) {
+    page_id_t page_id;
+    auto page = reinterpret_cast<OverflowPage *>(bpm->NewPage(&page_id));
+    if (page == nullptr) {
+      DeleteChain(bpm, next_page_id);
+      return INVALID_PAGE_ID;
+    }
+    uint32_t offset = i * CAPACITY;
+    page->Init(next_page_id, data + offset, std::min(CAPACITY, size - offset));
+    bpm->UnpinPage(page_id, true);
+    next_page_id = page_id;
+  }
+  return next_page_id;
+}
+
+void OverflowPage::ReadChain(BufferPoolManager *bpm, page_id_t first_page_id, char *out, uint32_t size) {
+  uint32_t offset = 0;
+  for (auto page_id = first_page_id; page_id != INVALID_PAGE_ID;) {
+    auto page = reinterpret_cast<OverflowPage *>(bpm->FetchPage(page_id));
+    BUSTUB_ENSURE(page != nullptr, "BPM full");
+    page->RLatch();
+    uint32_t data_size = page->GetDataSize();
+    BUSTUB_ASSERT(offset + data_size <= size, "Overflow chain is longer than its value.");
+    memcpy(out + offset, page->GetPayload(), data_size);
+    offset += data_size;
+    auto next_page_id = page->GetNextPageId();
+    page->RUnlatch();
+    bpm->UnpinPage(page_id, false);
+    page_id = next_page_id;
+  }
+  BUSTUB_ASSERT(offset == size, "Overflow chain is shorter than its value.");
+}
+
+void OverflowPage::DeleteChain(BufferPoolManager *bpm, page_id_t first_page_id) {
+  for (auto page_id = first_page_id; page_id != INVALID_PAGE_ID;) {
+    auto page = reinterpret_cast<OverflowPage *>(bpm->FetchPage(page_id));
+    BUSTUB_ENSURE(page != nullptr, "BPM full");
+    auto next_page_id = page->GetNextPageId();
+    bpm->UnpinPage(page_id, false);
+    bpm->DeletePage(page_id);
+    page_id = next_page_id;
+  }
+}
+
+}  // namespace bustub
@@ -0,0 +1,160 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// pax_page.cpp
+//
+// Identification: src/storage/page/pax_page.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/page/pax_page.h"
+
+namespace bustub {
+
+void PaxPage::Init(page_id_t page_id, uint32_t page_size, page_id_t prev_page_id, const Schema &schema,
+                   LogManager *log_manager, Transaction *txn) {
+  BUSTUB_ASSERT(schema.IsInlined(), "PAX pages only hold fixed-length tuples.");
+  // Set the page ID.
+  memcpy(GetData(), &page_id, sizeof(page_id));
+  // Log that we are creating a new page.
+  if (enable_logging) {
+    LogRecord log_record =
+        LogRecord(txn->GetTransactionId(), txn->GetPrevLSN(), LogRecordType::NEWPAGE, prev_page_id, page_id);
+    lsn_t lsn = log_manager->AppendLogRecord(&log_record);
+    SetLSN(lsn);
+    txn->SetPrevLSN(lsn);
+  }
+  // Set the previous and next page IDs.
+  memcpy(GetData() + OFFSET_PREV_PAGE_ID, &prev_page_id, sizeof(page_id_t));
+  page_id_t next_page_id = INVALID_PAGE_ID;
+  memcpy(GetData() + OFFSET_NEXT_PAGE_ID, &next_page_id, sizeof(page_id_t));
+  SetTupleCount(0);
+  uint32_t capacity = ComputeCapacity(page_size, schema);
+  SetCapacity(capacity);
+  memset(GetData() + OFFSET_SLOT_STATE, SLOT_FREE, SIZE_SLOT_STATE * capacity);
+}
+
+auto PaxPage::InsertTuple(const Tuple &tuple, const Schema &schema, RID *rid) -> bool {
+  BUSTUB_ASSERT(tuple.size_ == schema.GetLength(), "PAX tuples must be fixed-length.");
+  // Reuse the first free slot, or claim a new one at the end.
+  uint32_t i;
+  for (i = 0; i < GetTupleCount(); i++) {
+    if (GetSlotState(i) == SLOT_FREE) {
+      break;
+    }
+  }
+  if (i == GetCapacity()) {
+    return false;
+  }
+
+  WriteSlot(i, tuple.data_, schema);
+  SetSlotState(i, SLOT_LIVE);
+  rid->Set(GetTablePageId(), i);
+  if (i == GetTupleCount()) {
+    SetTupleCount(GetTupleCount() + 1);
+  }
+  return true;
+}
+
+auto PaxPage::MarkDelete(const RID &rid) -> bool {
+  uint32_t slot_num = rid.GetSlotNum();
+  if (slot_num >= GetTupleCount() || GetSlotState(slot_num) != SLOT_LIVE) {
+    return false;
+  }
+  SetSlotState(slot_num, SLOT_DELETED);
+  return true;
+}
+
+auto PaxPage::UpdateTuple(const Tuple &new_tuple, Tuple *old_tuple, const RID &rid, const Schema &schema) -> bool {
+  BUSTUB_ASSERT(new_tuple.size_ == schema.GetLength(), "PAX tuples must be fixed-length.");
+  uint32_t slot_num = rid.GetSlotNum();
+  if (slot_num >= GetTupleCount() || GetSlotState(slot_num) != SLOT_LIVE) {
+    return false;
+  }
+  // Copy out the old value, then overwrite the slot in every minipage.
+  GetTuple(rid, old_tuple, schema);
+  WriteSlot(slot_num, new_tuple.data_, schema);
+  return true;
+}
+
+void PaxPage::ApplyDelete(const RID &rid) {
+  uint32_t slot_num = rid.GetSlotNum();
+  BUSTUB_ASSERT(slot_num < GetTupleCount(), "Cannot have more slots than tuples.");
+  SetSlotState(slot_num, SLOT_FREE);
+  // Give trailing free slots back so that the next insert appends densely.
+  uint32_t tuple_count = GetTupleCount();
+  while (tuple_count > 0 && GetSlotState(tuple_count - 1) == SLOT_FREE) {
+    tuple_count--;
+  }
+  SetTupleCount(tuple_count);
+}
+
+void PaxPage::RollbackDelete(const RID &rid) {
+  uint32_t slot_num = rid.GetSlotNum();
+  BUSTUB_ASSERT(slot_num < GetTupleCount(), "We can't have more slots than tuples.");
+  if (GetSlotState(slot_num) == SLOT_DELETED) {
+    SetSlotState(slot_num, SLOT_LIVE);
+  }
+}
+
+auto PaxPage::GetTuple(const RID &rid, Tuple *tuple, const Schema &schema) -> bool {
+  uint32_t slot_num = rid.GetSlotNum();
+  if (slot_num >= GetTupleCount() || GetSlotState(slot_num) != SLOT_LIVE) {
+    return false;
+  }
+  tuple->size_ = schema.GetLength();
+  if (tuple->allocated_) {
+    delete[] tuple->data_;
+  }
+  tuple->data_ = new char[tuple->size_];
+  ReadSlot(slot_num, tuple->data_, schema);
+  tuple->rid_ = rid;
+  tuple->allocated_ = true;
+  return true;
+}
+
+auto PaxPage::GetFirstTupleRid(RID *first_rid) -> bool {
+  for (uint32_t i = 0; i < GetTupleCount(); ++i) {
+    if (IsTupleVisible(i)) {
+      first_rid->Set(GetTablePageId(), i);
+      return true;
+    }
+  }
+  first_rid->Set(INVALID_PAGE_ID, 0);
+  return false;
+}
+
+auto PaxPage::GetNextTupleRid(const RID &cur_rid, RID *next_rid) -> bool {
+  BUSTUB_ASSERT(cur_rid.GetPageId() == GetTablePageId(), "Wrong table!");
+  for (auto i = cur_rid.GetSlotNum() + 1; i < GetTupleCount(); ++i) {
+    if (IsTupleVisible(i)) {
+      next_rid->Set(GetTablePageId(), i);
+      return true;
+    }
+  }
+  next_rid->Set(INVALID_PAGE_ID, 0);
+  return false;
+}
+
+void PaxPage::WriteSlot(uint32_t slot_num, const char *data, const Schema &schema) {
+  uint32_t bitmap_size = schema.GetNullBitmapSize();
+  memcpy(GetData() + GetNullBitmapOffset() + slot_num * bitmap_size, data, bitmap_size);
+  for (uint32_t col_idx = 0; col_idx < schema.GetColumnCount(); col_idx++) {
+    const auto &col = schema.GetColumn(col_idx);
+    uint32_t len = col.GetFixedLength();
+    memcpy(GetData() + GetColumnOffset(col_idx, schema) + slot_num * len, data + col.GetOffset(), len);
+  }
+}
+
+void PaxPage::ReadSlot(uint32_t slot_num, char *data, const Schema &schema) {
+  uint32_t bitmap_size = schema.GetNullBitmapSize();
+  memcpy(data, GetData() + GetNullBitmapOffset() + slot_num * bitmap_size, bitmap_size);
+  for (uint32_t col_idx = 0; col_idx < schema.GetColumnCount(); col_idx++) {
+    const auto &col = schema.GetColumn(col_idx);
+    uint32_t len = col.GetFixedLength();
+    memcpy(data + col.GetOffset(), GetData() + GetColumnOffset(col_idx, schema) + slot_num * len, len);
+  }
+}
+
+}  // namespace bustub
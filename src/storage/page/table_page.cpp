@@ -208,7 +208,7 @@ auto TablePage::UpdateTuple(const Tuple &new_tuple, Tuple *old_tuple, const RID
   return true;
 }
 
-void TablePage::ApplyDelete(const RID &rid, Transaction *txn, LogManager *log_manager) {
+void TablePage::ApplyDelete(const RID &rid, Transaction *txn, LogManager *log_manager, Tuple *deleted_tuple) {
   uint32_t slot_num = rid.GetSlotNum();
   BUSTUB_ASSERT(slot_num < GetTupleCount(), "Cannot have more slots than tuples.");
 
@@ -227,6 +227,9 @@ void TablePage::ApplyDelete(const RID &rid, Transaction *txn, LogManager *log_ma
   memcpy(delete_tuple.data_, GetData() + tuple_offset, delete_tuple.size_);
   delete_tuple.rid_ = rid;
   delete_tuple.allocated_ = true;
+  if (deleted_tuple != nullptr) {
+    *deleted_tuple = delete_tuple;
+  }
 
   /**
    * Removed to support new lock manager API for p4 (multilevel locking); Big hack energy
@@ -351,4 +354,17 @@ auto TablePage::GetNextTupleRid(const RID &cur_rid, RID *next_rid) -> bool {
   next_rid->Set(INVALID_PAGE_ID, 0);
   return false;
 }
+
+auto TablePage::Compact() -> bool {
+  uint32_t tuple_count = GetTupleCount();
+  while (tuple_count > 0 && GetTupleSize(tuple_count - 1) == 0) {
+    tuple_count--;
+  }
+  if (tuple_count == GetTupleCount()) {
+    return false;
+  }
+  SetTupleCount(tuple_count);
+  return true;
+}
+
 }  // namespace bustub
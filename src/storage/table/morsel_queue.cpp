@@ -0,0 +1,27 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// morsel_queue.cpp
+//
+// Identification: src/storage/table/morsel_queue.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/table/morsel_queue.h"
+
+#include <algorithm>
+
+namespace bustub {
+
+auto MorselQueue::Next(std::vector<page_id_t> *morsel) -> bool {
+  auto begin = next_.fetch_add(morsel_size_);
+  if (begin >= page_ids_.size()) {
+    return false;
+  }
+  auto end = std::min(begin + morsel_size_, page_ids_.size());
+  morsel->assign(page_ids_.begin() + begin, page_ids_.begin() + end);
+  return true;
+}
+
+}  // namespace bustub
@@ -10,40 +10,80 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
 #include <cassert>
 
 #include "common/logger.h"
 #include "fmt/format.h"
+#include "storage/page/overflow_page.h"
 #include "storage/table/table_heap.h"
+#include "storage/table/tuple_builder.h"
 
 namespace bustub {
 
 TableHeap::TableHeap(BufferPoolManager *buffer_pool_manager, LockManager *lock_manager, LogManager *log_manager,
-                     page_id_t first_page_id)
+                     page_id_t first_page_id, const Schema *schema, TableStorageFormat format)
     : buffer_pool_manager_(buffer_pool_manager),
       lock_manager_(lock_manager),
       log_manager_(log_manager),
-      first_page_id_(first_page_id) {}
+      first_page_id_(first_page_id),
+      schema_(schema),
+      format_(format) {
+  BUSTUB_ASSERT(format_ == TableStorageFormat::ROW || schema_ != nullptr, "PAX tables need a schema.");
+  // Rebuild the page directory from the page chain.
+  for (auto page_id = first_page_id_; page_id != INVALID_PAGE_ID;) {
+    auto page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(page_id));
+    BUSTUB_ENSURE(page != nullptr, "BPM full");
+    page_ids_.push_back(page_id);
+    page->RLatch();
+    auto next_page_id = page->GetNextPageId();
+    page->RUnlatch();
+    buffer_pool_manager_->UnpinPage(page_id, false);
+    page_id = next_page_id;
+  }
+}
 
 TableHeap::TableHeap(BufferPoolManager *buffer_pool_manager, LockManager *lock_manager, LogManager *log_manager,
-                     Transaction *txn)
-    : buffer_pool_manager_(buffer_pool_manager), lock_manager_(lock_manager), log_manager_(log_manager) {
+                     Transaction *txn, const Schema *schema, TableStorageFormat format)
+    : buffer_pool_manager_(buffer_pool_manager),
+      lock_manager_(lock_manager),
+      log_manager_(log_manager),
+      schema_(schema),
+      format_(format) {
+  BUSTUB_ASSERT(format_ == TableStorageFormat::ROW || schema_ != nullptr, "PAX tables need a schema.");
   // Initialize the first table page.
-  auto first_page = reinterpret_cast<TablePage *>(buffer_pool_manager_->NewPage(&first_page_id_));
+  auto first_page = buffer_pool_manager_->NewPage(&first_page_id_);
   BUSTUB_ASSERT(first_page != nullptr,
                 "Couldn't create a page for the table heap. Have you completed the buffer pool manager project?");
-  first_page->Init(first_page_id_, BUSTUB_PAGE_SIZE, INVALID_LSN, log_manager_, txn);
+  InitPage(first_page, first_page_id_, INVALID_LSN, txn);
   buffer_pool_manager_->UnpinPage(first_page_id_, true);
+  page_ids_.push_back(first_page_id_);
+  if (schema_ != nullptr) {
+    zone_map_ = std::make_unique<ZoneMap>(schema_);
+    zone_map_->AppendPage(INVALID_PAGE_ID, first_page_id_);
+  }
 }
 
 auto TableHeap::InsertTuple(const Tuple &tuple, RID *rid, Transaction *txn) -> bool {
-  if (tuple.size_ + 32 > BUSTUB_PAGE_SIZE) {  // larger than one page size
+  if (format_ == TableStorageFormat::PAX && tuple.size_ != schema_->GetLength()) {  // PAX slots are fixed-length
     txn->SetState(TransactionState::ABORTED);
     return false;
   }
+  // A tuple larger than one page is stored with its largest values in overflow pages. A tuple read from a table may
+  // reference overflow pages already, which belong to the tuple it was read from, so its values are copied.
+  Tuple spilled;
+  const Tuple *stored = &tuple;
+  if (!FitsIntoPage(tuple.size_) || HasOverflowedValues(tuple)) {
+    if (!SpillLargeValues(tuple, &spilled)) {
+      txn->SetState(TransactionState::ABORTED);
+      return false;
+    }
+    stored = &spilled;
+  }
 
   auto cur_page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(first_page_id_));
   if (cur_page == nullptr) {
+    FreeOverflowChains(*stored);
     txn->SetState(TransactionState::ABORTED);
     return false;
   }
@@ -52,7 +92,7 @@ auto TableHeap::InsertTuple(const Tuple &tuple, RID *rid, Transaction *txn) -> b
 
   // Insert into the first page with enough space. If no such page exists, create a new page and insert into that.
   // INVARIANT: cur_page is WLatched if you leave the loop normally.
-  while (!cur_page->InsertTuple(tuple, rid, txn, lock_manager_, log_manager_)) {
+  while (!InsertIntoPage(cur_page, *stored, rid, txn)) {
     auto next_page_id = cur_page->GetNextPageId();
     // If the next page is a valid page,
     if (next_page_id != INVALID_PAGE_ID) {
@@ -70,13 +110,22 @@ auto TableHeap::InsertTuple(const Tuple &tuple, RID *rid, Transaction *txn) -> b
         // Then life sucks and we abort the transaction.
         cur_page->WUnlatch();
         buffer_pool_manager_->UnpinPage(cur_page->GetTablePageId(), false);
+        FreeOverflowChains(*stored);
         txn->SetState(TransactionState::ABORTED);
         return false;
       }
       // Otherwise we were able to create a new page. We initialize it now.
       new_page->WLatch();
       cur_page->SetNextPageId(next_page_id);
-      new_page->Init(next_page_id, BUSTUB_PAGE_SIZE, cur_page->GetTablePageId(), log_manager_, txn);
+      InitPage(new_page, next_page_id, cur_page->GetTablePageId(), txn);
+      if (zone_map_ != nullptr) {
+        zone_map_->AppendPage(cur_page->GetTablePageId(), next_page_id);
+      }
+      {
+        // New pages are only appended while the last page is latched, so the directory stays in chain order.
+        std::scoped_lock lock(page_ids_latch_);
+        page_ids_.push_back(next_page_id);
+      }
       cur_page->WUnlatch();
       buffer_pool_manager_->UnpinPage(cur_page->GetTablePageId(), true);
       cur_page = new_page;
@@ -84,6 +133,11 @@ auto TableHeap::InsertTuple(const Tuple &tuple, RID *rid, Transaction *txn) -> b
   }
   // This line has caused most of us to double-take and "whoa double unlatch".
   // We are not, in fact, double unlatching. See the invariant above.
+  // Widen the summary before other scans can see the tuple. The summary is taken from the tuple as it was passed in,
+  // so that it does not have to read overflowed values back.
+  if (zone_map_ != nullptr) {
+    zone_map_->Update(cur_page->GetTablePageId(), tuple);
+  }
   cur_page->WUnlatch();
   buffer_pool_manager_->UnpinPage(cur_page->GetTablePageId(), true);
   // Update the transaction's write set.
@@ -92,7 +146,7 @@ auto TableHeap::InsertTuple(const Tuple &tuple, RID *rid, Transaction *txn) -> b
 }
 
 auto TableHeap::MarkDelete(const RID &rid, Transaction *txn) -> bool {
-  // TODO(Amadou): remove empty page
+  // Empty pages are removed by Vacuum.
   // Find the page which contains the tuple.
   auto page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(rid.GetPageId()));
   // If the page could not be found, then abort the transaction.
@@ -102,7 +156,11 @@ auto TableHeap::MarkDelete(const RID &rid, Transaction *txn) -> bool {
   }
   // Otherwise, mark the tuple as deleted.
   page->WLatch();
-  page->MarkDelete(rid, txn, lock_manager_, log_manager_);
+  if (format_ == TableStorageFormat::PAX) {
+    reinterpret_cast<PaxPage *>(page)->MarkDelete(rid);
+  } else {
+    page->MarkDelete(rid, txn, lock_manager_, log_manager_);
+  }
   page->WUnlatch();
   buffer_pool_manager_->UnpinPage(page->GetTablePageId(), true);
   // Update the transaction's write set.
@@ -121,28 +179,51 @@ auto TableHeap::UpdateTuple(const Tuple &tuple, const RID &rid, Transaction *txn
   // Update the tuple; but first save the old value for rollbacks.
   Tuple old_tuple;
   page->WLatch();
-  bool is_updated = page->UpdateTuple(tuple, &old_tuple, rid, txn, lock_manager_, log_manager_);
+  bool is_updated = format_ == TableStorageFormat::PAX
+                        ? reinterpret_cast<PaxPage *>(page)->UpdateTuple(tuple, &old_tuple, rid, *schema_)
+                        : page->UpdateTuple(tuple, &old_tuple, rid, txn, lock_manager_, log_manager_);
+  if (is_updated && zone_map_ != nullptr) {
+    zone_map_->Update(rid.GetPageId(), tuple);
+  }
+  // The old tuple may be written back by an abort, which reads its overflowed values.
+  if (format_ == TableStorageFormat::ROW) {
+    old_tuple.overflow_bpm_ = buffer_pool_manager_;
+  }
   page->WUnlatch();
   buffer_pool_manager_->UnpinPage(page->GetTablePageId(), is_updated);
   // Update the transaction's write set.
   if (is_updated && txn->GetState() != TransactionState::ABORTED) {
     txn->GetWriteSet()->emplace_back(rid, WType::UPDATE, old_tuple, this);
+    txn->GetWriteSet()->back().overflow_chains_ = ReplacedOverflowChains(old_tuple, tuple);
   }
   return is_updated;
 }
 
+void TableHeap::ApplyUpdate(const std::vector<page_id_t> &overflow_chains) {
+  for (auto first_page_id : overflow_chains) {
+    OverflowPage::DeleteChain(buffer_pool_manager_, first_page_id);
+  }
+}
+
 void TableHeap::ApplyDelete(const RID &rid, Transaction *txn) {
   // Find the page which contains the tuple.
   auto page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(rid.GetPageId()));
   BUSTUB_ASSERT(page != nullptr, "Couldn't find a page containing that RID.");
   // Delete the tuple from the page.
   page->WLatch();
-  page->ApplyDelete(rid, txn, log_manager_);
+  Tuple deleted_tuple;
+  ApplyDeleteOnPage(page, rid, txn, &deleted_tuple);
   /** Commented out to make compatible with p4; This is called only on commit or delete, which consequently unlocks the
    * tuple; so should be fine */
   // lock_manager_->Unlock(txn, rid);
   page->WUnlatch();
   buffer_pool_manager_->UnpinPage(page->GetTablePageId(), true);
+  {
+    std::scoped_lock lock(page_ids_latch_);
+    pages_to_vacuum_.insert(rid.GetPageId());
+  }
+  // The overflow chains of the tuple go with it.
+  FreeOverflowChains(deleted_tuple);
 }
 
 void TableHeap::RollbackDelete(const RID &rid, Transaction *txn) {
@@ -151,7 +232,11 @@ void TableHeap::RollbackDelete(const RID &rid, Transaction *txn) {
   BUSTUB_ASSERT(page != nullptr, "Couldn't find a page containing that RID.");
   // Rollback the delete.
   page->WLatch();
-  page->RollbackDelete(rid, txn, log_manager_);
+  if (format_ == TableStorageFormat::PAX) {
+    reinterpret_cast<PaxPage *>(page)->RollbackDelete(rid);
+  } else {
+    page->RollbackDelete(rid, txn, log_manager_);
+  }
   page->WUnlatch();
   buffer_pool_manager_->UnpinPage(page->GetTablePageId(), true);
 }
@@ -168,7 +253,7 @@ auto TableHeap::GetTuple(const RID &rid, Tuple *tuple, Transaction *txn, bool ac
   if (acquire_read_lock) {
     page->RLatch();
   }
-  bool res = page->GetTuple(rid, tuple, txn, lock_manager_);
+  bool res = GetTupleFromPage(page, rid, tuple, txn);
   if (acquire_read_lock) {
     page->RUnlatch();
   }
@@ -185,7 +270,7 @@ auto TableHeap::Begin(Transaction *txn) -> TableIterator {
     auto page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(page_id));
     page->RLatch();
     // If this fails because there is no tuple, then RID will be the default-constructed value, which means EOF.
-    auto found_tuple = page->GetFirstTupleRid(&rid);
+    auto found_tuple = GetFirstTupleRid(page, &rid);
     page->RUnlatch();
     buffer_pool_manager_->UnpinPage(page_id, false);
     if (found_tuple) {
@@ -198,4 +283,387 @@ auto TableHeap::Begin(Transaction *txn) -> TableIterator {
 
 auto TableHeap::End() -> TableIterator { return {this, RID(INVALID_PAGE_ID, 0), nullptr}; }
 
+auto TableHeap::Vacuum(const TupleMoveCallback &on_move) -> uint32_t {
+  // Take the page chain up front, so that it can be walked from both ends.
+  std::unordered_set<page_id_t> to_vacuum;
+  std::vector<page_id_t> pages;
+  {
+    std::scoped_lock lock(page_ids_latch_);
+    to_vacuum.swap(pages_to_vacuum_);
+    pages = page_ids_;
+  }
+  if (to_vacuum.empty()) {
+    return 0;
+  }
+
+  // Drain sparse pages from the tail into the earliest pages with free space. Only deletes make a page sparse.
+  uint32_t freed_pages = 0;
+  size_t dest_idx = 0;
+  for (size_t src_idx = pages.size() - 1; src_idx > dest_idx; src_idx--) {
+    if (to_vacuum.count(pages[src_idx]) == 0) {
+      continue;
+    }
+    std::vector<Tuple> tuples;
+    GetPageTuples(pages[src_idx], &tuples, nullptr);
+    size_t live_bytes = 0;
+    for (const auto &tuple : tuples) {
+      live_bytes += tuple.GetLength();
+    }
+    if (live_bytes * 2 >= BUSTUB_PAGE_SIZE) {
+      continue;
+    }
+
+    size_t moved = 0;
+    while (moved < tuples.size() && dest_idx < src_idx) {
+      // Latch in page chain order, like InsertTuple does.
+      auto dest_page = buffer_pool_manager_->FetchPage(pages[dest_idx]);
+      auto src_page = buffer_pool_manager_->FetchPage(pages[src_idx]);
+      BUSTUB_ENSURE(dest_page != nullptr && src_page != nullptr, "BPM full");
+      dest_page->WLatch();
+      src_page->WLatch();
+      size_t moved_before = moved;
+      for (; moved < tuples.size(); moved++) {
+        RID new_rid;
+        const auto &tuple = tuples[moved];
+        if (!InsertIntoPage(dest_page, tuple, &new_rid, nullptr)) {
+          break;
+        }
+        ApplyDeleteOnPage(src_page, tuple.GetRid(), nullptr);
+        if (zone_map_ != nullptr) {
+          zone_map_->Update(pages[dest_idx], tuple);
+        }
+        on_move(tuple, tuple.GetRid(), new_rid);
+      }
+      src_page->WUnlatch();
+      dest_page->WUnlatch();
+      buffer_pool_manager_->UnpinPage(pages[src_idx], moved > moved_before);
+      buffer_pool_manager_->UnpinPage(pages[dest_idx], moved > moved_before);
+      if (moved < tuples.size()) {
+        dest_idx++;
+      }
+    }
+    if (moved < tuples.size()) {
+      break;
+    }
+
+    auto src_page = buffer_pool_manager_->FetchPage(pages[src_idx]);
+    src_page->WLatch();
+    bool is_compacted = CompactPage(src_page);
+    bool is_empty = IsPageEmpty(src_page);
+    src_page->WUnlatch();
+    buffer_pool_manager_->UnpinPage(pages[src_idx], is_compacted);
+    if (is_empty) {
+      RemovePage(pages[src_idx]);
+      to_vacuum.erase(pages[src_idx]);
+      freed_pages++;
+    }
+  }
+
+  // Trim the remaining pages with deletes and tighten their summaries, which deletes never shrink.
+  for (auto page_id : to_vacuum) {
+    auto page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(page_id));
+    BUSTUB_ENSURE(page != nullptr, "BPM full");
+    page->WLatch();
+    bool is_compacted = CompactPage(page);
+    if (zone_map_ != nullptr) {
+      zone_map_->ResetPage(page_id);
+      RID rid;
+      Tuple tuple;
+      bool found = GetFirstTupleRid(page, &rid);
+      while (found) {
+        GetTupleFromPage(page, rid, &tuple, nullptr);
+        zone_map_->Update(page_id, tuple);
+        found = GetNextTupleRid(page, rid, &rid);
+      }
+    }
+    page->WUnlatch();
+    buffer_pool_manager_->UnpinPage(page_id, is_compacted);
+  }
+  return freed_pages;
+}
+
+auto TableHeap::HasPagesToVacuum() -> bool {
+  std::scoped_lock lock(page_ids_latch_);
+  return !pages_to_vacuum_.empty();
+}
+
+auto TableHeap::GetPageIds() -> std::vector<page_id_t> {
+  std::scoped_lock lock(page_ids_latch_);
+  return page_ids_;
+}
+
+auto TableHeap::GetPageTuples(page_id_t page_id, std::vector<Tuple> *tuples, Transaction *txn) -> page_id_t {
+  auto page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(page_id));
+  BUSTUB_ENSURE(page != nullptr, "BPM full");
+  page->RLatch();
+  RID rid;
+  bool found = GetFirstTupleRid(page, &rid);
+  while (found) {
+    tuples->emplace_back();
+    GetTupleFromPage(page, rid, &tuples->back(), txn);
+    found = GetNextTupleRid(page, rid, &rid);
+  }
+  auto next_page_id = page->GetNextPageId();
+  page->RUnlatch();
+  buffer_pool_manager_->UnpinPage(page_id, false);
+  return next_page_id;
+}
+
+void TableHeap::GetPageTuples(page_id_t page_id, const std::vector<RID> &rids, std::vector<Tuple> *tuples,
+                              Transaction *txn) {
+  auto page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(page_id));
+  BUSTUB_ENSURE(page != nullptr, "BPM full");
+  page->RLatch();
+  for (const auto &rid : rids) {
+    tuples->emplace_back();
+    if (!GetTupleFromPage(page, rid, &tuples->back(), txn)) {
+      tuples->pop_back();
+    }
+  }
+  page->RUnlatch();
+  buffer_pool_manager_->UnpinPage(page_id, false);
+}
+
+auto TableHeap::ReadColumnChunk(page_id_t page_id, uint32_t column_idx, std::vector<char> *values,
+                                std::vector<RID> *rids) -> page_id_t {
+  BUSTUB_ASSERT(schema_ != nullptr, "Reading a column needs the table schema.");
+  const auto &col = schema_->GetColumn(column_idx);
+  BUSTUB_ASSERT(col.IsInlined(), "Only inlined columns can be read as a chunk.");
+  uint32_t len = col.GetFixedLength();
+
+  auto page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(page_id));
+  BUSTUB_ENSURE(page != nullptr, "BPM full");
+  page->RLatch();
+  if (format_ == TableStorageFormat::PAX) {
+    auto pax_page = reinterpret_cast<PaxPage *>(page);
+    const char *minipage = pax_page->GetColumnData(column_idx, *schema_);
+    uint32_t tuple_count = pax_page->GetTupleCount();
+    values->reserve(values->size() + tuple_count * len);
+    // Copy maximal runs of visible slots in one go.
+    uint32_t i = 0;
+    while (i < tuple_count) {
+      if (!pax_page->IsTupleVisible(i)) {
+        i++;
+        continue;
+      }
+      uint32_t run_end = i;
+      while (run_end < tuple_count && pax_page->IsTupleVisible(run_end)) {
+        rids->emplace_back(page_id, run_end);
+        run_end++;
+      }
+      values->insert(values->end(), minipage + i * len, minipage + run_end * len);
+      i = run_end;
+    }
+  } else {
+    RID rid;
+    Tuple tuple;
+    bool found = page->GetFirstTupleRid(&rid);
+    while (found) {
+      page->GetTuple(rid, &tuple, nullptr, lock_manager_);
+      const char *src = tuple.GetData() + col.GetOffset();
+      values->insert(values->end(), src, src + len);
+      rids->push_back(rid);
+      found = page->GetNextTupleRid(rid, &rid);
+    }
+  }
+  auto next_page_id = page->GetNextPageId();
+  page->RUnlatch();
+  buffer_pool_manager_->UnpinPage(page_id, false);
+  return next_page_id;
+}
+
+void TableHeap::InitPage(Page *page, page_id_t page_id, page_id_t prev_page_id, Transaction *txn) {
+  if (format_ == TableStorageFormat::PAX) {
+    reinterpret_cast<PaxPage *>(page)->Init(page_id, BUSTUB_PAGE_SIZE, prev_page_id, *schema_, log_manager_, txn);
+  } else {
+    reinterpret_cast<TablePage *>(page)->Init(page_id, BUSTUB_PAGE_SIZE, prev_page_id, log_manager_, txn);
+  }
+}
+
+auto TableHeap::InsertIntoPage(Page *page, const Tuple &tuple, RID *rid, Transaction *txn) -> bool {
+  if (format_ == TableStorageFormat::PAX) {
+    return reinterpret_cast<PaxPage *>(page)->InsertTuple(tuple, *schema_, rid);
+  }
+  return reinterpret_cast<TablePage *>(page)->InsertTuple(tuple, rid, txn, lock_manager_, log_manager_);
+}
+
+void TableHeap::ApplyDeleteOnPage(Page *page, const RID &rid, Transaction *txn, Tuple *deleted_tuple) {
+  if (format_ == TableStorageFormat::PAX) {
+    // PAX tuples have no varlen values, let alone overflowed ones.
+    reinterpret_cast<PaxPage *>(page)->ApplyDelete(rid);
+  } else {
+    reinterpret_cast<TablePage *>(page)->ApplyDelete(rid, txn, log_manager_, deleted_tuple);
+  }
+}
+
+auto TableHeap::SpillLargeValues(const Tuple &tuple, Tuple *spilled) -> bool {
+  if (schema_ == nullptr || format_ == TableStorageFormat::PAX) {
+    return false;
+  }
+  std::vector<Value> values;
+  values.reserve(schema_->GetColumnCount());
+  for (uint32_t i = 0; i < schema_->GetColumnCount(); i++) {
+    values.push_back(tuple.GetValue(schema_, i));
+  }
+  auto length_of = [&](uint32_t col) { return values[col].IsNull() ? 0 : values[col].GetLength(); };
+  uint32_t size = schema_->GetLength();
+  for (auto col : schema_->GetUnlinedColumns()) {
+    size += sizeof(uint32_t) + length_of(col);
+  }
+  // Move the largest values first, which frees the most space with the fewest chains.
+  std::vector<uint32_t> columns = schema_->GetUnlinedColumns();
+  std::sort(columns.begin(), columns.end(), [&](uint32_t a, uint32_t b) { return length_of(a) > length_of(b); });
+
+  std::vector<page_id_t> chains(schema_->GetColumnCount(), INVALID_PAGE_ID);
+  auto free_chains = [&]() {
+    for (auto page_id : chains) {
+      OverflowPage::DeleteChain(buffer_pool_manager_, page_id);
+    }
+  };
+  for (auto col : columns) {
+    uint32_t len = length_of(col);
+    uint32_t reference_size = Tuple::GetOverflowReferenceSize(len);
+    if (FitsIntoPage(size) || len + sizeof(uint32_t) <= reference_size) {
+      break;
+    }
+    chains[col] = OverflowPage::WriteChain(buffer_pool_manager_, values[col].GetData(), len);
+    if (chains[col] == INVALID_PAGE_ID) {
+      free_chains();
+      return false;
+    }
+    size -= len + sizeof(uint32_t) - reference_size;
+  }
+  if (!FitsIntoPage(size)) {
+    free_chains();
+    return false;
+  }
+
+  TupleBuilder builder(schema_);
+  for (uint32_t i = 0; i < schema_->GetColumnCount(); i++) {
+    if (chains[i] != INVALID_PAGE_ID) {
+      builder.AppendOverflowed(values[i], chains[i]);
+    } else {
+      builder.Append(values[i]);
+    }
+  }
+  builder.Build(spilled);
+  spilled->overflow_bpm_ = buffer_pool_manager_;
+  return true;
+}
+
+auto TableHeap::HasOverflowedValues(const Tuple &tuple) -> bool {
+  if (schema_ == nullptr || tuple.overflow_bpm_ == nullptr) {
+    return false;
+  }
+  const auto &columns = schema_->GetUnlinedColumns();
+  return std::any_of(columns.begin(), columns.end(), [&](uint32_t col) { return tuple.IsOverflowed(schema_, col); });
+}
+
+auto TableHeap::ReplacedOverflowChains(const Tuple &old_tuple, const Tuple &new_tuple) -> std::vector<page_id_t> {
+  std::vector<page_id_t> replaced;
+  if (schema_ == nullptr || format_ == TableStorageFormat::PAX || old_tuple.GetData() == nullptr) {
+    return replaced;
+  }
+  // A new tuple built from the old one may still reference some of its chains.
+  const auto &columns = schema_->GetUnlinedColumns();
+  for (auto col : columns) {
+    if (!old_tuple.IsOverflowed(schema_, col)) {
+      continue;
+    }
+    auto first_page_id = old_tuple.GetOverflowPageId(schema_, col);
+    if (std::none_of(columns.begin(), columns.end(), [&](uint32_t new_col) {
+          return new_tuple.IsOverflowed(schema_, new_col) &&
+                 new_tuple.GetOverflowPageId(schema_, new_col) == first_page_id;
+        })) {
+      replaced.push_back(first_page_id);
+    }
+  }
+  return replaced;
+}
+
+void TableHeap::FreeOverflowChains(const Tuple &tuple) {
+  if (schema_ == nullptr || tuple.GetData() == nullptr) {
+    return;
+  }
+  for (auto col : schema_->GetUnlinedColumns()) {
+    if (tuple.IsOverflowed(schema_, col)) {
+      OverflowPage::DeleteChain(buffer_pool_manager_, tuple.GetOverflowPageId(schema_, col));
+    }
+  }
+}
+
+auto TableHeap::CompactPage(Page *page) -> bool {
+  if (format_ == TableStorageFormat::PAX) {
+    // PaxPage::ApplyDelete already gives trailing free slots back.
+    return false;
+  }
+  return reinterpret_cast<TablePage *>(page)->Compact();
+}
+
+auto TableHeap::IsPageEmpty(Page *page) -> bool {
+  if (format_ == TableStorageFormat::PAX) {
+    return reinterpret_cast<PaxPage *>(page)->GetTupleCount() == 0;
+  }
+  return reinterpret_cast<TablePage *>(page)->IsEmpty();
+}
+
+void TableHeap::RemovePage(page_id_t page_id) {
+  BUSTUB_ASSERT(page_id != first_page_id_, "The first page of a table is never removed.");
+  // PAX pages share the page chain part of the TablePage header.
+  auto page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(page_id));
+  BUSTUB_ENSURE(page != nullptr, "BPM full");
+  auto prev_page_id = page->GetPrevPageId();
+  auto next_page_id = page->GetNextPageId();
+  buffer_pool_manager_->UnpinPage(page_id, false);
+
+  auto prev_page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(prev_page_id));
+  BUSTUB_ENSURE(prev_page != nullptr, "BPM full");
+  prev_page->WLatch();
+  prev_page->SetNextPageId(next_page_id);
+  prev_page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(prev_page_id, true);
+  if (next_page_id != INVALID_PAGE_ID) {
+    auto next_page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(next_page_id));
+    BUSTUB_ENSURE(next_page != nullptr, "BPM full");
+    next_page->WLatch();
+    next_page->SetPrevPageId(prev_page_id);
+    next_page->WUnlatch();
+    buffer_pool_manager_->UnpinPage(next_page_id, true);
+  }
+  if (zone_map_ != nullptr) {
+    zone_map_->RemovePage(prev_page_id, page_id);
+  }
+  {
+    std::scoped_lock lock(page_ids_latch_);
+    page_ids_.erase(std::find(page_ids_.begin(), page_ids_.end(), page_id));
+  }
+  buffer_pool_manager_->DeletePage(page_id);
+}
+
+auto TableHeap::GetTupleFromPage(Page *page, const RID &rid, Tuple *tuple, Transaction *txn) -> bool {
+  if (format_ == TableStorageFormat::PAX) {
+    return reinterpret_cast<PaxPage *>(page)->GetTuple(rid, tuple, *schema_);
+  }
+  if (!reinterpret_cast<TablePage *>(page)->GetTuple(rid, tuple, txn, lock_manager_)) {
+    return false;
+  }
+  // Overflowed values are read from their chain only when their column is read.
+  tuple->overflow_bpm_ = buffer_pool_manager_;
+  return true;
+}
+
+auto TableHeap::GetFirstTupleRid(Page *page, RID *first_rid) -> bool {
+  if (format_ == TableStorageFormat::PAX) {
+    return reinterpret_cast<PaxPage *>(page)->GetFirstTupleRid(first_rid);
+  }
+  return reinterpret_cast<TablePage *>(page)->GetFirstTupleRid(first_rid);
+}
+
+auto TableHeap::GetNextTupleRid(Page *page, const RID &cur_rid, RID *next_rid) -> bool {
+  if (format_ == TableStorageFormat::PAX) {
+    return reinterpret_cast<PaxPage *>(page)->GetNextTupleRid(cur_rid, next_rid);
+  }
+  return reinterpret_cast<TablePage *>(page)->GetNextTupleRid(cur_rid, next_rid);
+}
+
 }  // namespace bustub
@@ -44,15 +44,15 @@ auto TableIterator::operator++() -> TableIterator & {
 
   cur_page->RLatch();
   RID next_tuple_rid;
-  if (!cur_page->GetNextTupleRid(tuple_->rid_,
-                                 &next_tuple_rid)) {  // end of this page
+  if (!table_heap_->GetNextTupleRid(cur_page, tuple_->rid_,
+                                    &next_tuple_rid)) {  // end of this page
     while (cur_page->GetNextPageId() != INVALID_PAGE_ID) {
       auto next_page = static_cast<TablePage *>(buffer_pool_manager->FetchPage(cur_page->GetNextPageId()));
       cur_page->RUnlatch();
       buffer_pool_manager->UnpinPage(cur_page->GetTablePageId(), false);
       cur_page = next_page;
       cur_page->RLatch();
-      if (cur_page->GetFirstTupleRid(&next_tuple_rid)) {
+      if (table_heap_->GetFirstTupleRid(cur_page, &next_tuple_rid)) {
         break;
       }
     }
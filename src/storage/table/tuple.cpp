@@ -16,13 +16,26 @@
 #include <string>
 #include <vector>
 
+#include "storage/page/overflow_page.h"
 #include "storage/table/tuple.h"
+#include "type/value_factory.h"
 
 namespace bustub {
 
-// TODO(Amadou): It does not look like nulls are supported. Add a null bitmap?
 Tuple::Tuple(std::vector<Value> values, const Schema *schema) : allocated_(true) {
   assert(values.size() == schema->GetColumnCount());
+  uint32_t column_count = schema->GetColumnCount();
+
+  if (schema->IsInlined()) {
+    // Every column is stored in place, so the tuple is of fixed size and there are no offsets to compute.
+    size_ = schema->GetLength();
+    data_ = new char[size_];
+    std::memset(data_, 0, schema->GetNullBitmapSize());
+    for (uint32_t i = 0; i < column_count; i++) {
+      SerializeInlined(schema, i, values[i], data_);
+    }
+    return;
+  }
 
   // 1. Calculate the size of the tuple.
   uint32_t tuple_size = schema->GetLength();
@@ -40,14 +53,14 @@ Tuple::Tuple(std::vector<Value> values, const Schema *schema) : allocated_(true)
   std::memset(data_, 0, size_);
 
   // 3. Serialize each attribute based on the input value.
-  uint32_t column_count = schema->GetColumnCount();
   uint32_t offset = schema->GetLength();
 
   for (uint32_t i = 0; i < column_count; i++) {
-    const auto &col = schema->GetColumn(i);
-    if (!col.IsInlined()) {
+    const auto &accessor = schema->GetAccessor(i);
+    if (!accessor.inlined_) {
+      SetNullBit(data_, accessor, values[i].IsNull());
       // Serialize relative offset, where the actual varchar data is stored.
-      *reinterpret_cast<uint32_t *>(data_ + col.GetOffset()) = offset;
+      *reinterpret_cast<uint32_t *>(data_ + accessor.offset_) = offset;
       // Serialize varchar value, in place (size+data).
       values[i].SerializeTo(data_ + offset);
       auto len = values[i].GetLength();
@@ -56,12 +69,25 @@ Tuple::Tuple(std::vector<Value> values, const Schema *schema) : allocated_(true)
       }
       offset += (len + sizeof(uint32_t));
     } else {
-      values[i].SerializeTo(data_ + col.GetOffset());
+      SerializeInlined(schema, i, values[i], data_);
     }
   }
 }
 
-Tuple::Tuple(const Tuple &other) : allocated_(other.allocated_), rid_(other.rid_), size_(other.size_) {
+void Tuple::SerializeInlined(const Schema *schema, uint32_t column_idx, const Value &value, char *data) {
+  const auto &accessor = schema->GetAccessor(column_idx);
+  SetNullBit(data, accessor, value.IsNull());
+  if (accessor.dictionary_encoded_) {
+    // Serialize the dictionary code in place of the string.
+    *reinterpret_cast<uint32_t *>(data + accessor.offset_) =
+        EncodeDictionaryValue(schema->GetColumn(column_idx), value);
+  } else {
+    value.SerializeTo(data + accessor.offset_);
+  }
+}
+
+Tuple::Tuple(const Tuple &other)
+    : allocated_(other.allocated_), rid_(other.rid_), size_(other.size_), overflow_bpm_(other.overflow_bpm_) {
   if (allocated_) {
     delete[] data_;
   }
@@ -82,6 +108,7 @@ auto Tuple::operator=(const Tuple &other) -> Tuple & {
   allocated_ = other.allocated_;
   rid_ = other.rid_;
   size_ = other.size_;
+  overflow_bpm_ = other.overflow_bpm_;
 
   if (allocated_) {
     // Deep copy.
@@ -95,17 +122,75 @@ auto Tuple::operator=(const Tuple &other) -> Tuple & {
   return *this;
 }
 
+Tuple::Tuple(const Tuple &other, AbstractPool *pool)
+    : allocated_(false), rid_(other.rid_), size_(other.size_), overflow_bpm_(other.overflow_bpm_) {
+  data_ = static_cast<char *>(pool->Allocate(size_));
+  memcpy(data_, other.data_, size_);
+}
+
+void Tuple::Release(AbstractPool *pool) {
+  BUSTUB_ASSERT(!allocated_, "only tuples copied into a pool can be released");
+  pool->Free(data_);
+  data_ = nullptr;
+  size_ = 0;
+}
+
 auto Tuple::GetValue(const Schema *schema, const uint32_t column_idx) const -> Value {
   assert(schema);
   assert(data_);
-  const TypeId column_type = schema->GetColumn(column_idx).GetType();
+  const auto &accessor = schema->GetAccessor(column_idx);
   const char *data_ptr = GetDataPtr(schema, column_idx);
+  if (accessor.dictionary_encoded_) {
+    return DecodeDictionaryValue(schema->GetColumn(column_idx), *reinterpret_cast<const uint32_t *>(data_ptr));
+  }
+  if (IsOverflowed(schema, column_idx)) {
+    uint32_t len = *reinterpret_cast<const uint32_t *>(data_ptr + sizeof(uint32_t));
+    BUSTUB_ASSERT(overflow_bpm_ != nullptr, "Tuple does not know where its overflow pages are.");
+    std::vector<char> data(len);
+    OverflowPage::ReadChain(overflow_bpm_, GetOverflowPageId(schema, column_idx), data.data(), len);
+    return {accessor.type_, data.data(), len, true};
+  }
   // the third parameter "is_inlined" is unused
-  return Value::DeserializeFrom(data_ptr, column_type);
+  return Value::DeserializeFrom(data_ptr, accessor.type_);
+}
+
+auto Tuple::IsOverflowed(const Schema *schema, const uint32_t column_idx) const -> bool {
+  if (schema->GetAccessor(column_idx).inlined_ || IsNull(schema, column_idx)) {
+    return false;
+  }
+  return (*reinterpret_cast<const uint32_t *>(GetDataPtr(schema, column_idx)) & OVERFLOW_FLAG) != 0;
+}
+
+auto Tuple::GetOverflowPageId(const Schema *schema, const uint32_t column_idx) const -> page_id_t {
+  assert(IsOverflowed(schema, column_idx));
+  return *reinterpret_cast<const page_id_t *>(GetDataPtr(schema, column_idx) + 2 * sizeof(uint32_t));
+}
+
+auto Tuple::GetDictionaryCode(const Schema *schema, const uint32_t column_idx) const -> uint32_t {
+  assert(schema->GetColumn(column_idx).IsDictionaryEncoded());
+  return *reinterpret_cast<const uint32_t *>(GetDataPtr(schema, column_idx));
+}
+
+auto Tuple::EncodeDictionaryValue(const Column &col, const Value &value) -> uint32_t {
+  if (value.IsNull()) {
+    return StringDictionary::NULL_CODE;
+  }
+  if (value.GetTypeId() != TypeId::VARCHAR) {
+    return EncodeDictionaryValue(col, value.CastAs(TypeId::VARCHAR));
+  }
+  // The length of a VARCHAR value includes the trailing '\0'.
+  return col.GetDictionary()->GetOrAddCode(std::string(value.GetData(), value.GetLength() - 1));
+}
+
+auto Tuple::DecodeDictionaryValue(const Column &col, uint32_t code) -> Value {
+  if (code == StringDictionary::NULL_CODE) {
+    return ValueFactory::GetNullValueByType(TypeId::VARCHAR);
+  }
+  return {TypeId::VARCHAR, col.GetDictionary()->GetString(code)};
 }
 
 auto Tuple::KeyFromTuple(const Schema &schema, const Schema &key_schema, const std::vector<uint32_t> &key_attrs)
-    -> Tuple {
+    const -> Tuple {
   std::vector<Value> values;
   values.reserve(key_attrs.size());
   for (auto idx : key_attrs) {
@@ -117,14 +202,13 @@ auto Tuple::KeyFromTuple(const Schema &schema, const Schema &key_schema, const s
 auto Tuple::GetDataPtr(const Schema *schema, const uint32_t column_idx) const -> const char * {
   assert(schema);
   assert(data_);
-  const auto &col = schema->GetColumn(column_idx);
-  bool is_inlined = col.IsInlined();
+  const auto &accessor = schema->GetAccessor(column_idx);
   // For inline type, data is stored where it is.
-  if (is_inlined) {
-    return (data_ + col.GetOffset());
+  if (accessor.inlined_) {
+    return (data_ + accessor.offset_);
   }
   // We read the relative offset from the tuple data.
-  int32_t offset = *reinterpret_cast<int32_t *>(data_ + col.GetOffset());
+  int32_t offset = *reinterpret_cast<int32_t *>(data_ + accessor.offset_);
   // And return the beginning address of the real data for the VARCHAR type.
   return (data_ + offset);
 }
@@ -0,0 +1,75 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// tuple_builder.cpp
+//
+// Identification: src/storage/table/tuple_builder.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/table/tuple_builder.h"
+
+namespace bustub {
+
+void TupleBuilder::Append(const Value &value) {
+  BUSTUB_ASSERT(next_column_ < schema_->GetColumnCount(), "all columns were appended already");
+  uint32_t column_idx = next_column_++;
+  const auto &accessor = schema_->GetAccessor(column_idx);
+  if (!accessor.inlined_) {
+    // Serialize the offset of the varchar data, and then the data itself (size+data) at the end of the row.
+    uint32_t len = value.GetLength();
+    if (len == BUSTUB_VALUE_NULL) {
+      len = 0;
+    }
+    Reserve(size_ + sizeof(uint32_t) + len);
+    Tuple::SetNullBit(buffer_.data(), accessor, value.IsNull());
+    *reinterpret_cast<uint32_t *>(buffer_.data() + accessor.offset_) = size_;
+    value.SerializeTo(buffer_.data() + size_);
+    size_ += sizeof(uint32_t) + len;
+  } else {
+    Tuple::SerializeInlined(schema_, column_idx, value, buffer_.data());
+  }
+}
+
+void TupleBuilder::AppendOverflowed(const Value &value, page_id_t first_page_id) {
+  BUSTUB_ASSERT(next_column_ < schema_->GetColumnCount(), "all columns were appended already");
+  const auto &accessor = schema_->GetAccessor(next_column_++);
+  BUSTUB_ASSERT(!accessor.inlined_ && !value.IsNull(), "only varied-sized values can be overflowed");
+  uint32_t len = value.GetLength();
+  uint32_t reference_size = Tuple::GetOverflowReferenceSize(len);
+  Reserve(size_ + reference_size);
+  *reinterpret_cast<uint32_t *>(buffer_.data() + accessor.offset_) = size_;
+  // The length field carries the flag and the size of the rest of the reference.
+  char *out = buffer_.data() + size_;
+  uint32_t flagged_size = Tuple::OVERFLOW_FLAG | (reference_size - static_cast<uint32_t>(sizeof(uint32_t)));
+  memcpy(out, &flagged_size, sizeof(uint32_t));
+  memcpy(out + sizeof(uint32_t), &len, sizeof(uint32_t));
+  memcpy(out + 2 * sizeof(uint32_t), &first_page_id, sizeof(page_id_t));
+  memcpy(out + 3 * sizeof(uint32_t), value.GetData(), std::min(len, Tuple::OVERFLOW_PREFIX_SIZE));
+  size_ += reference_size;
+}
+
+void TupleBuilder::Build(Tuple *tuple) const {
+  if (!tuple->allocated_ || tuple->size_ != size_) {
+    if (tuple->allocated_) {
+      delete[] tuple->data_;
+    }
+    tuple->data_ = new char[size_];
+    tuple->allocated_ = true;
+  }
+  tuple->size_ = size_;
+  tuple->rid_ = RID{};
+  tuple->overflow_bpm_ = nullptr;
+  CopyTo(tuple->data_);
+}
+
+auto TupleBuilder::Build(AbstractPool *pool) const -> Tuple {
+  Tuple tuple;
+  tuple.size_ = size_;
+  tuple.data_ = static_cast<char *>(pool->Allocate(size_));
+  CopyTo(tuple.data_);
+  return tuple;
+}
+
+}  // namespace bustub
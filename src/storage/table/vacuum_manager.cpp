@@ -0,0 +1,82 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// vacuum_manager.cpp
+//
+// Identification: src/storage/table/vacuum_manager.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/table/vacuum_manager.h"
+
+#include "common/logger.h"
+
+namespace bustub {
+
+void VacuumManager::StartVacuum() {
+  if (enable_vacuum_) {
+    return;
+  }
+  enable_vacuum_ = true;
+  vacuum_thread_ = new std::thread(&VacuumManager::RunVacuum, this);
+}
+
+void VacuumManager::StopVacuum() {
+  if (!enable_vacuum_) {
+    return;
+  }
+  {
+    std::scoped_lock lock(latch_);
+    enable_vacuum_ = false;
+  }
+  cv_.notify_all();
+  vacuum_thread_->join();
+  delete vacuum_thread_;
+  vacuum_thread_ = nullptr;
+}
+
+auto VacuumManager::RunVacuumRound() -> uint32_t {
+  // CREATE TABLE and CREATE INDEX change the catalog within a transaction, so the catalog is only read while
+  // transactions are blocked.
+  txn_manager_->BlockAllTransactions();
+  uint32_t freed_pages = 0;
+  // Index maintenance needs a transaction to hand to the indexes; nothing else runs while transactions are blocked.
+  Transaction txn(INVALID_TXN_ID);
+  for (const auto &table_name : catalog_->GetTableNames()) {
+    auto *table_info = catalog_->GetTable(table_name);
+    // Only tables with deletes since their last vacuum have anything to reclaim.
+    if (table_info->table_ == nullptr || !table_info->table_->HasPagesToVacuum()) {
+      continue;
+    }
+    auto indexes = catalog_->GetTableIndexes(table_name);
+    freed_pages += table_info->table_->Vacuum([&](const Tuple &tuple, const RID &old_rid, const RID &new_rid) {
+      for (auto *index_info : indexes) {
+        auto key =
+            tuple.KeyFromTuple(table_info->schema_, index_info->key_schema_, index_info->index_->GetKeyAttrs());
+        index_info->index_->DeleteEntry(key, old_rid, &txn);
+        index_info->index_->InsertEntry(key, new_rid, &txn);
+      }
+    });
+  }
+  txn_manager_->ResumeTransactions();
+  if (freed_pages > 0) {
+    LOG_DEBUG("vacuum freed %u pages", freed_pages);
+  }
+  return freed_pages;
+}
+
+void VacuumManager::RunVacuum() {
+  std::unique_lock lock(latch_);
+  while (enable_vacuum_) {
+    cv_.wait_for(lock, vacuum_interval, [&] { return !enable_vacuum_; });
+    if (!enable_vacuum_) {
+      break;
+    }
+    lock.unlock();
+    RunVacuumRound();
+    lock.lock();
+  }
+}
+
+}  // namespace bustub
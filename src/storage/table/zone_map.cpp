@@ -0,0 +1,100 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// zone_map.cpp
+//
+// Identification: src/storage/table/zone_map.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/table/zone_map.h"
+
+#include <algorithm>
+
+#include "common/macros.h"
+
+namespace bustub {
+
+void ZoneMap::AppendPage(page_id_t prev_page_id, page_id_t page_id) {
+  latch_.WLock();
+  auto &zone = zones_[page_id];
+  zone.min_.resize(schema_->GetColumnCount());
+  zone.max_.resize(schema_->GetColumnCount());
+  if (prev_page_id != INVALID_PAGE_ID) {
+    zones_[prev_page_id].next_page_id_ = page_id;
+  }
+  latch_.WUnlock();
+}
+
+void ZoneMap::RemovePage(page_id_t prev_page_id, page_id_t page_id) {
+  latch_.WLock();
+  auto it = zones_.find(page_id);
+  if (it != zones_.end()) {
+    zones_[prev_page_id].next_page_id_ = it->second.next_page_id_;
+    zones_.erase(it);
+  }
+  latch_.WUnlock();
+}
+
+void ZoneMap::ResetPage(page_id_t page_id) {
+  latch_.WLock();
+  auto it = zones_.find(page_id);
+  if (it != zones_.end()) {
+    std::fill(it->second.min_.begin(), it->second.min_.end(), std::nullopt);
+    std::fill(it->second.max_.begin(), it->second.max_.end(), std::nullopt);
+  }
+  latch_.WUnlock();
+}
+
+void ZoneMap::Update(page_id_t page_id, const Tuple &tuple) {
+  latch_.WLock();
+  auto it = zones_.find(page_id);
+  if (it == zones_.end()) {
+    latch_.WUnlock();
+    return;
+  }
+  auto &zone = it->second;
+  for (uint32_t i = 0; i < schema_->GetColumnCount(); i++) {
+    auto value = tuple.GetValue(schema_, i);
+    if (value.IsNull()) {
+      continue;
+    }
+    if (!zone.min_[i].has_value() || value.CompareLessThan(*zone.min_[i]) == CmpBool::CmpTrue) {
+      zone.min_[i] = value;
+    }
+    if (!zone.max_[i].has_value() || value.CompareGreaterThan(*zone.max_[i]) == CmpBool::CmpTrue) {
+      zone.max_[i] = value;
+    }
+  }
+  latch_.WUnlock();
+}
+
+auto ZoneMap::GetRange(page_id_t page_id, uint32_t column_idx) -> std::optional<std::pair<Value, Value>> {
+  latch_.RLock();
+  std::optional<std::pair<Value, Value>> range = std::nullopt;
+  auto it = zones_.find(page_id);
+  if (it != zones_.end() && it->second.min_[column_idx].has_value()) {
+    range = std::make_pair(*it->second.min_[column_idx], *it->second.max_[column_idx]);
+  }
+  latch_.RUnlock();
+  return range;
+}
+
+auto ZoneMap::Contains(page_id_t page_id) -> bool {
+  latch_.RLock();
+  bool found = zones_.count(page_id) != 0;
+  latch_.RUnlock();
+  return found;
+}
+
+auto ZoneMap::GetNextPageId(page_id_t page_id) -> page_id_t {
+  latch_.RLock();
+  auto it = zones_.find(page_id);
+  BUSTUB_ASSERT(it != zones_.end(), "Page is not tracked by the zone map.");
+  auto next_page_id = it->second.next_page_id_;
+  latch_.RUnlock();
+  return next_page_id;
+}
+
+}  // namespace bustub
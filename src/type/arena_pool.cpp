@@ -0,0 +1,68 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// arena_pool.cpp
+//
+// Identification: src/type/arena_pool.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include "type/arena_pool.h"
+
+namespace bustub {
+
+auto ArenaPool::SizeClassOf(size_t size) -> size_t {
+  if (size <= (size_t{1} << MIN_SIZE_CLASS)) {
+    return MIN_SIZE_CLASS;
+  }
+  // The smallest power of two that is not below size.
+  return 64 - __builtin_clzll(size - 1);
+}
+
+auto ArenaPool::Allocate(size_t size) -> void * {
+  size_t size_class = SizeClassOf(size);
+  std::scoped_lock lock(latch_);
+  if (void *block = free_lists_[size_class]; block != nullptr) {
+    free_lists_[size_class] = *static_cast<void **>(block);
+    return block;
+  }
+
+  size_t block_size = HEADER_SIZE + (size_t{1} << size_class);
+  char *start;
+  if (block_size > chunk_size_ / 4) {
+    // A large block gets a chunk of its own, rather than wasting the rest of the current chunk.
+    chunks_.emplace_back(new char[block_size]);
+    capacity_ += block_size;
+    start = chunks_.back().get();
+  } else {
+    if (block_size > remaining_) {
+      chunks_.emplace_back(new char[chunk_size_]);
+      capacity_ += chunk_size_;
+      cursor_ = chunks_.back().get();
+      remaining_ = chunk_size_;
+    }
+    start = cursor_;
+    cursor_ += block_size;
+    remaining_ -= block_size;
+  }
+  *reinterpret_cast<size_t *>(start) = size_class;
+  return start + HEADER_SIZE;
+}
+
+void ArenaPool::Free(void *ptr) {
+  if (ptr == nullptr) {
+    return;
+  }
+  size_t size_class = *reinterpret_cast<size_t *>(static_cast<char *>(ptr) - HEADER_SIZE);
+  std::scoped_lock lock(latch_);
+  *static_cast<void **>(ptr) = free_lists_[size_class];
+  free_lists_[size_class] = ptr;
+}
+
+auto ArenaPool::GetCapacity() const -> size_t {
+  std::scoped_lock lock(latch_);
+  return capacity_;
+}
+
+}  // namespace bustub
@@ -0,0 +1,672 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// batch_kernels.cpp
+//
+// Identification: src/type/batch_kernels.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include "type/batch_kernels.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+#include <utility>
+
+#include "common/exception.h"
+#include "common/macros.h"
+#include "type/limits.h"
+#include "type/type.h"
+#include "type/value_factory.h"
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+#define BUSTUB_AVX2_KERNELS
+#define BUSTUB_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+
+namespace bustub {
+
+namespace {
+
+template <TypeId T>
+using TypeTag = std::integral_constant<TypeId, T>;
+
+template <CompareKernelOp Op>
+using CompareOpTag = std::integral_constant<CompareKernelOp, Op>;
+
+template <ArithmeticKernelOp Op>
+using ArithmeticOpTag = std::integral_constant<ArithmeticKernelOp, Op>;
+
+/** Call f with the TypeTag of a fixed-width type. */
+template <class F>
+void DispatchFixedType(TypeId type, F &&f) {
+  switch (type) {
+    case TypeId::BOOLEAN:
+      return f(TypeTag<TypeId::BOOLEAN>{});
+    case TypeId::TINYINT:
+      return f(TypeTag<TypeId::TINYINT>{});
+    case TypeId::SMALLINT:
+      return f(TypeTag<TypeId::SMALLINT>{});
+    case TypeId::INTEGER:
+      return f(TypeTag<TypeId::INTEGER>{});
+    case TypeId::BIGINT:
+      return f(TypeTag<TypeId::BIGINT>{});
+    case TypeId::DECIMAL:
+      return f(TypeTag<TypeId::DECIMAL>{});
+    case TypeId::TIMESTAMP:
+      return f(TypeTag<TypeId::TIMESTAMP>{});
+    default:
+      throw Exception(ExceptionType::MISMATCH_TYPE, "Column vectors only hold fixed-width types.");
+  }
+}
+
+/** Call f with the TypeTag of a type that has batch kernels. */
+template <class F>
+void DispatchKernelType(TypeId type, F &&f) {
+  switch (type) {
+    case TypeId::BOOLEAN:
+      return f(TypeTag<TypeId::BOOLEAN>{});
+    case TypeId::INTEGER:
+      return f(TypeTag<TypeId::INTEGER>{});
+    case TypeId::BIGINT:
+      return f(TypeTag<TypeId::BIGINT>{});
+    case TypeId::DECIMAL:
+      return f(TypeTag<TypeId::DECIMAL>{});
+    default:
+      throw Exception(ExceptionType::MISMATCH_TYPE, "No batch kernels for this type.");
+  }
+}
+
+template <class F>
+void DispatchCompareOp(CompareKernelOp op, F &&f) {
+  switch (op) {
+    case CompareKernelOp::Equal:
+      return f(CompareOpTag<CompareKernelOp::Equal>{});
+    case CompareKernelOp::NotEqual:
+      return f(CompareOpTag<CompareKernelOp::NotEqual>{});
+    case CompareKernelOp::LessThan:
+      return f(CompareOpTag<CompareKernelOp::LessThan>{});
+    case CompareKernelOp::LessThanOrEqual:
+      return f(CompareOpTag<CompareKernelOp::LessThanOrEqual>{});
+    case CompareKernelOp::GreaterThan:
+      return f(CompareOpTag<CompareKernelOp::GreaterThan>{});
+    case CompareKernelOp::GreaterThanOrEqual:
+      return f(CompareOpTag<CompareKernelOp::GreaterThanOrEqual>{});
+  }
+}
+
+template <class F>
+void DispatchArithmeticOp(ArithmeticKernelOp op, F &&f) {
+  switch (op) {
+    case ArithmeticKernelOp::Add:
+      return f(ArithmeticOpTag<ArithmeticKernelOp::Add>{});
+    case ArithmeticKernelOp::Subtract:
+      return f(ArithmeticOpTag<ArithmeticKernelOp::Subtract>{});
+    case ArithmeticKernelOp::Multiply:
+      return f(ArithmeticOpTag<ArithmeticKernelOp::Multiply>{});
+  }
+}
+
+void CheckSameShape(const ColumnVector &lhs, const ColumnVector &rhs) {
+  if (lhs.GetType() != rhs.GetType() || lhs.GetSize() != rhs.GetSize()) {
+    throw Exception(ExceptionType::MISMATCH_TYPE, "Batch kernels need vectors of the same type and size.");
+  }
+}
+
+/*
+ * Scalar kernels. They are written without branches on the data, so that compilers can vectorize them, and they also
+ * process the tails that the AVX2 kernels leave over.
+ */
+
+template <CompareKernelOp Op, class T>
+inline auto CompareScalar(T x, T y) -> bool {
+  if constexpr (Op == CompareKernelOp::Equal) {
+    return x == y;
+  } else if constexpr (Op == CompareKernelOp::NotEqual) {
+    return x != y;
+  } else if constexpr (Op == CompareKernelOp::LessThan) {
+    return x < y;
+  } else if constexpr (Op == CompareKernelOp::LessThanOrEqual) {
+    return x <= y;
+  } else if constexpr (Op == CompareKernelOp::GreaterThan) {
+    return x > y;
+  } else {
+    return x >= y;
+  }
+}
+
+/** Select the rows in [begin, end), writing their indices to out. @return the number of selected rows */
+template <CompareKernelOp Op, class T, bool RhsIsConstant>
+auto SelectScalar(const T *lhs, const T *rhs, const uint8_t *lhs_nulls, const uint8_t *rhs_nulls, size_t begin,
+                  size_t end, uint32_t *out) -> size_t {
+  size_t count = 0;
+  for (size_t i = begin; i < end; i++) {
+    bool keep;
+    if constexpr (RhsIsConstant) {
+      keep = CompareScalar<Op>(lhs[i], rhs[0]) & (lhs_nulls[i] == 0);
+    } else {
+      keep = CompareScalar<Op>(lhs[i], rhs[i]) & ((lhs_nulls[i] | rhs_nulls[i]) == 0);
+    }
+    out[count] = static_cast<uint32_t>(i);
+    count += static_cast<size_t>(keep);
+  }
+  return count;
+}
+
+/** Compute the rows in [begin, end). @return true if a non-NULL row overflowed */
+template <ArithmeticKernelOp Op, class T>
+auto ComputeScalar(const T *lhs, const T *rhs, const uint8_t *nulls, size_t begin, size_t end, T *out) -> bool {
+  bool overflow = false;
+  for (size_t i = begin; i < end; i++) {
+    if constexpr (std::is_floating_point_v<T>) {
+      if constexpr (Op == ArithmeticKernelOp::Add) {
+        out[i] = lhs[i] + rhs[i];
+      } else if constexpr (Op == ArithmeticKernelOp::Subtract) {
+        out[i] = lhs[i] - rhs[i];
+      } else {
+        out[i] = lhs[i] * rhs[i];
+      }
+    } else {
+      bool row_overflow;
+      if constexpr (Op == ArithmeticKernelOp::Add) {
+        row_overflow = __builtin_add_overflow(lhs[i], rhs[i], &out[i]);
+      } else if constexpr (Op == ArithmeticKernelOp::Subtract) {
+        row_overflow = __builtin_sub_overflow(lhs[i], rhs[i], &out[i]);
+      } else {
+        row_overflow = __builtin_mul_overflow(lhs[i], rhs[i], &out[i]);
+      }
+      overflow |= row_overflow & (nulls[i] == 0);
+    }
+  }
+  return overflow;
+}
+
+template <bool IsMin, class T>
+auto MinMaxScalar(const T *data, const uint8_t *nulls, size_t begin, size_t end, T result) -> T {
+  for (size_t i = begin; i < end; i++) {
+    T candidate = IsMin ? std::min(result, data[i]) : std::max(result, data[i]);
+    result = nulls[i] == 0 ? candidate : result;
+  }
+  return result;
+}
+
+#ifdef BUSTUB_AVX2_KERNELS
+
+/*
+ * AVX2 kernels. They process whole registers and return the index of the first row they left over. They may only be
+ * called if CpuHasAvx2() is true.
+ */
+
+auto CpuHasAvx2() -> bool {
+  static const bool HAS_AVX2 = __builtin_cpu_supports("avx2") != 0;
+  return HAS_AVX2;
+}
+
+/** The AVX2 registers and instructions for lanes of type T. */
+template <class T>
+struct Avx2Lanes {
+  static constexpr bool SUPPORTED = false;
+};
+
+template <>
+struct Avx2Lanes<int32_t> {
+  using Register = __m256i;
+  static constexpr bool SUPPORTED = true;
+  static constexpr size_t WIDTH = 8;
+
+  BUSTUB_TARGET_AVX2 static auto Load(const int32_t *p) -> Register {
+    return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+  }
+  BUSTUB_TARGET_AVX2 static void Store(int32_t *p, Register x) {
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(p), x);
+  }
+  BUSTUB_TARGET_AVX2 static auto Broadcast(int32_t x) -> Register { return _mm256_set1_epi32(x); }
+  /** @return a mask of the lanes whose null mask byte is 0 */
+  BUSTUB_TARGET_AVX2 static auto NotNull(const uint8_t *nulls) -> Register {
+    auto bytes = _mm_loadl_epi64(reinterpret_cast<const __m128i *>(nulls));
+    return _mm256_cmpeq_epi32(_mm256_cvtepu8_epi32(bytes), _mm256_setzero_si256());
+  }
+  /** @return the sign bit of every lane, one bit per lane */
+  BUSTUB_TARGET_AVX2 static auto Bits(Register mask) -> uint32_t {
+    return static_cast<uint32_t>(_mm256_movemask_ps(_mm256_castsi256_ps(mask)));
+  }
+  BUSTUB_TARGET_AVX2 static auto Equal(Register x, Register y) -> Register { return _mm256_cmpeq_epi32(x, y); }
+  BUSTUB_TARGET_AVX2 static auto Greater(Register x, Register y) -> Register { return _mm256_cmpgt_epi32(x, y); }
+  /** @return x in the lanes set in mask, y in the others */
+  BUSTUB_TARGET_AVX2 static auto Select(Register mask, Register x, Register y) -> Register {
+    return _mm256_blendv_epi8(y, x, mask);
+  }
+  BUSTUB_TARGET_AVX2 static auto Min(Register x, Register y) -> Register { return _mm256_min_epi32(x, y); }
+  BUSTUB_TARGET_AVX2 static auto Max(Register x, Register y) -> Register { return _mm256_max_epi32(x, y); }
+  BUSTUB_TARGET_AVX2 static auto Add(Register x, Register y) -> Register { return _mm256_add_epi32(x, y); }
+  BUSTUB_TARGET_AVX2 static auto Subtract(Register x, Register y) -> Register { return _mm256_sub_epi32(x, y); }
+};
+
+template <>
+struct Avx2Lanes<int64_t> {
+  using Register = __m256i;
+  static constexpr bool SUPPORTED = true;
+  static constexpr size_t WIDTH = 4;
+
+  BUSTUB_TARGET_AVX2 static auto Load(const int64_t *p) -> Register {
+    return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+  }
+  BUSTUB_TARGET_AVX2 static void Store(int64_t *p, Register x) {
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(p), x);
+  }
+  BUSTUB_TARGET_AVX2 static auto Broadcast(int64_t x) -> Register { return _mm256_set1_epi64x(x); }
+  BUSTUB_TARGET_AVX2 static auto NotNull(const uint8_t *nulls) -> Register {
+    int32_t word;
+    memcpy(&word, nulls, sizeof(word));
+    return _mm256_cmpeq_epi64(_mm256_cvtepu8_epi64(_mm_cvtsi32_si128(word)), _mm256_setzero_si256());
+  }
+  BUSTUB_TARGET_AVX2 static auto Bits(Register mask) -> uint32_t {
+    return static_cast<uint32_t>(_mm256_movemask_pd(_mm256_castsi256_pd(mask)));
+  }
+  BUSTUB_TARGET_AVX2 static auto Equal(Register x, Register y) -> Register { return _mm256_cmpeq_epi64(x, y); }
+  BUSTUB_TARGET_AVX2 static auto Greater(Register x, Register y) -> Register { return _mm256_cmpgt_epi64(x, y); }
+  BUSTUB_TARGET_AVX2 static auto Select(Register mask, Register x, Register y) -> Register {
+    return _mm256_blendv_epi8(y, x, mask);
+  }
+  // AVX2 has no 64-bit min and max.
+  BUSTUB_TARGET_AVX2 static auto Min(Register x, Register y) -> Register { return Select(Greater(x, y), y, x); }
+  BUSTUB_TARGET_AVX2 static auto Max(Register x, Register y) -> Register { return Select(Greater(x, y), x, y); }
+  BUSTUB_TARGET_AVX2 static auto Add(Register x, Register y) -> Register { return _mm256_add_epi64(x, y); }
+  BUSTUB_TARGET_AVX2 static auto Subtract(Register x, Register y) -> Register { return _mm256_sub_epi64(x, y); }
+};
+
+template <>
+struct Avx2Lanes<double> {
+  using Register = __m256d;
+  static constexpr bool SUPPORTED = true;
+  static constexpr size_t WIDTH = 4;
+
+  BUSTUB_TARGET_AVX2 static auto Load(const double *p) -> Register { return _mm256_loadu_pd(p); }
+  BUSTUB_TARGET_AVX2 static void Store(double *p, Register x) { _mm256_storeu_pd(p, x); }
+  BUSTUB_TARGET_AVX2 static auto Broadcast(double x) -> Register { return _mm256_set1_pd(x); }
+  BUSTUB_TARGET_AVX2 static auto NotNull(const uint8_t *nulls) -> Register {
+    return _mm256_castsi256_pd(Avx2Lanes<int64_t>::NotNull(nulls));
+  }
+  BUSTUB_TARGET_AVX2 static auto Bits(Register mask) -> uint32_t {
+    return static_cast<uint32_t>(_mm256_movemask_pd(mask));
+  }
+  BUSTUB_TARGET_AVX2 static auto Equal(Register x, Register y) -> Register { return _mm256_cmp_pd(x, y, _CMP_EQ_OQ); }
+  BUSTUB_TARGET_AVX2 static auto Greater(Register x, Register y) -> Register {
+    return _mm256_cmp_pd(x, y, _CMP_GT_OQ);
+  }
+  BUSTUB_TARGET_AVX2 static auto Select(Register mask, Register x, Register y) -> Register {
+    return _mm256_blendv_pd(y, x, mask);
+  }
+  BUSTUB_TARGET_AVX2 static auto Min(Register x, Register y) -> Register { return _mm256_min_pd(x, y); }
+  BUSTUB_TARGET_AVX2 static auto Max(Register x, Register y) -> Register { return _mm256_max_pd(x, y); }
+  BUSTUB_TARGET_AVX2 static auto Add(Register x, Register y) -> Register { return _mm256_add_pd(x, y); }
+  BUSTUB_TARGET_AVX2 static auto Subtract(Register x, Register y) -> Register { return _mm256_sub_pd(x, y); }
+  BUSTUB_TARGET_AVX2 static auto Multiply(Register x, Register y) -> Register { return _mm256_mul_pd(x, y); }
+};
+
+/** @return one bit per lane, set where `x op y` holds */
+template <CompareKernelOp Op, class T>
+BUSTUB_TARGET_AVX2 inline auto CompareBitsAvx2(typename Avx2Lanes<T>::Register x, typename Avx2Lanes<T>::Register y)
+    -> uint32_t {
+  using L = Avx2Lanes<T>;
+  constexpr uint32_t ALL_LANES = (1U << L::WIDTH) - 1;
+  if constexpr (Op == CompareKernelOp::Equal) {
+    return L::Bits(L::Equal(x, y));
+  } else if constexpr (Op == CompareKernelOp::NotEqual) {
+    return ~L::Bits(L::Equal(x, y)) & ALL_LANES;
+  } else if constexpr (Op == CompareKernelOp::LessThan) {
+    return L::Bits(L::Greater(y, x));
+  } else if constexpr (Op == CompareKernelOp::LessThanOrEqual) {
+    return ~L::Bits(L::Greater(x, y)) & ALL_LANES;
+  } else if constexpr (Op == CompareKernelOp::GreaterThan) {
+    return L::Bits(L::Greater(x, y));
+  } else {
+    return ~L::Bits(L::Greater(y, x)) & ALL_LANES;
+  }
+}
+
+template <CompareKernelOp Op, class T, bool RhsIsConstant>
+BUSTUB_TARGET_AVX2 auto SelectAvx2(const T *lhs, const T *rhs, const uint8_t *lhs_nulls, const uint8_t *rhs_nulls,
+                                   size_t size, uint32_t *out, size_t *count) -> size_t {
+  using L = Avx2Lanes<T>;
+  auto constant = L::Broadcast(rhs[0]);
+  size_t i = 0;
+  for (; i + L::WIDTH <= size; i += L::WIDTH) {
+    uint32_t bits;
+    if constexpr (RhsIsConstant) {
+      bits = CompareBitsAvx2<Op, T>(L::Load(lhs + i), constant) & L::Bits(L::NotNull(lhs_nulls + i));
+    } else {
+      bits = CompareBitsAvx2<Op, T>(L::Load(lhs + i), L::Load(rhs + i)) & L::Bits(L::NotNull(lhs_nulls + i)) &
+             L::Bits(L::NotNull(rhs_nulls + i));
+    }
+    while (bits != 0) {
+      out[(*count)++] = static_cast<uint32_t>(i + __builtin_ctz(bits));
+      bits &= bits - 1;
+    }
+  }
+  return i;
+}
+
+template <ArithmeticKernelOp Op, class T>
+BUSTUB_TARGET_AVX2 auto ComputeAvx2(const T *lhs, const T *rhs, const uint8_t *nulls, size_t size, T *out,
+                                    bool *overflow) -> size_t {
+  using L = Avx2Lanes<T>;
+  uint32_t overflow_bits = 0;
+  size_t i = 0;
+  for (; i + L::WIDTH <= size; i += L::WIDTH) {
+    auto x = L::Load(lhs + i);
+    auto y = L::Load(rhs + i);
+    typename L::Register result;
+    if constexpr (Op == ArithmeticKernelOp::Add) {
+      result = L::Add(x, y);
+    } else if constexpr (Op == ArithmeticKernelOp::Subtract) {
+      result = L::Subtract(x, y);
+    } else {
+      result = L::Multiply(x, y);
+    }
+    if constexpr (std::is_integral_v<T>) {
+      // A two's complement sum overflowed iff its sign differs from the signs of both operands, and a difference
+      // overflowed iff the operands have different signs and the result does not have the sign of x.
+      auto signs = Op == ArithmeticKernelOp::Add
+                       ? _mm256_and_si256(_mm256_xor_si256(x, result), _mm256_xor_si256(y, result))
+                       : _mm256_and_si256(_mm256_xor_si256(x, y), _mm256_xor_si256(x, result));
+      overflow_bits |= L::Bits(signs) & L::Bits(L::NotNull(nulls + i));
+    }
+    L::Store(out + i, result);
+  }
+  *overflow = overflow_bits != 0;
+  return i;
+}
+
+BUSTUB_TARGET_AVX2 auto SumInt32Avx2(const int32_t *data, const uint8_t *nulls, size_t size, int64_t *sum) -> size_t {
+  using L = Avx2Lanes<int32_t>;
+  auto acc = _mm256_setzero_si256();
+  size_t i = 0;
+  for (; i + L::WIDTH <= size; i += L::WIDTH) {
+    auto x = _mm256_and_si256(L::Load(data + i), L::NotNull(nulls + i));
+    acc = _mm256_add_epi64(acc, _mm256_cvtepi32_epi64(_mm256_castsi256_si128(x)));
+    acc = _mm256_add_epi64(acc, _mm256_cvtepi32_epi64(_mm256_extracti128_si256(x, 1)));
+  }
+  int64_t lanes[4];
+  Avx2Lanes<int64_t>::Store(lanes, acc);
+  *sum += lanes[0] + lanes[1] + lanes[2] + lanes[3];
+  return i;
+}
+
+BUSTUB_TARGET_AVX2 auto SumDoubleAvx2(const double *data, const uint8_t *nulls, size_t size, double *sum) -> size_t {
+  using L = Avx2Lanes<double>;
+  auto acc = _mm256_setzero_pd();
+  size_t i = 0;
+  for (; i + L::WIDTH <= size; i += L::WIDTH) {
+    acc = _mm256_add_pd(acc, _mm256_and_pd(L::Load(data + i), L::NotNull(nulls + i)));
+  }
+  double lanes[4];
+  L::Store(lanes, acc);
+  *sum += lanes[0] + lanes[1] + lanes[2] + lanes[3];
+  return i;
+}
+
+template <bool IsMin, class T>
+BUSTUB_TARGET_AVX2 auto MinMaxAvx2(const T *data, const uint8_t *nulls, size_t size, T *result) -> size_t {
+  using L = Avx2Lanes<T>;
+  auto identity = L::Broadcast(*result);
+  auto acc = identity;
+  size_t i = 0;
+  for (; i + L::WIDTH <= size; i += L::WIDTH) {
+    auto x = L::Select(L::NotNull(nulls + i), L::Load(data + i), identity);
+    acc = IsMin ? L::Min(acc, x) : L::Max(acc, x);
+  }
+  T lanes[L::WIDTH];
+  L::Store(lanes, acc);
+  for (auto lane : lanes) {
+    *result = IsMin ? std::min(*result, lane) : std::max(*result, lane);
+  }
+  return i;
+}
+
+#endif
+
+template <CompareKernelOp Op, class T, bool RhsIsConstant>
+void SelectTyped(const T *lhs, const T *rhs, const uint8_t *lhs_nulls, const uint8_t *rhs_nulls, size_t size,
+                 std::vector<uint32_t> *selection) {
+  auto old_size = selection->size();
+  selection->resize(old_size + size);
+  auto *out = selection->data() + old_size;
+  size_t count = 0;
+  size_t i = 0;
+#ifdef BUSTUB_AVX2_KERNELS
+  if constexpr (Avx2Lanes<T>::SUPPORTED) {
+    if (CpuHasAvx2()) {
+      i = SelectAvx2<Op, T, RhsIsConstant>(lhs, rhs, lhs_nulls, rhs_nulls, size, out, &count);
+    }
+  }
+#endif
+  count += SelectScalar<Op, T, RhsIsConstant>(lhs, rhs, lhs_nulls, rhs_nulls, i, size, out + count);
+  selection->resize(old_size + count);
+}
+
+template <bool IsMin>
+auto MinMaxColumn(const ColumnVector &column) -> Value {
+  if (CountColumn(column) == 0) {
+    return ValueFactory::GetNullValueByType(column.GetType());
+  }
+  Value result;
+  DispatchKernelType(column.GetType(), [&](auto tag) {
+    constexpr TypeId TYPE = decltype(tag)::value;
+    using T = typename NativeType<TYPE>::Type;
+    const auto *data = column.GetData<T>();
+    const auto *nulls = column.GetNullMask();
+    T extreme = IsMin ? std::numeric_limits<T>::max() : std::numeric_limits<T>::lowest();
+    size_t i = 0;
+#ifdef BUSTUB_AVX2_KERNELS
+    if constexpr (Avx2Lanes<T>::SUPPORTED) {
+      if (CpuHasAvx2()) {
+        i = MinMaxAvx2<IsMin>(data, nulls, column.GetSize(), &extreme);
+      }
+    }
+#endif
+    result = Value(TYPE, MinMaxScalar<IsMin>(data, nulls, i, column.GetSize(), extreme));
+  });
+  return result;
+}
+
+}  // namespace
+
+ColumnVector::ColumnVector(TypeId type, size_t size)
+    : type_(type), size_(size), data_(size * Type::GetTypeSize(type)), nulls_(size) {}
+
+ColumnVector::ColumnVector(TypeId type, std::vector<char> data)
+    : type_(type), size_(data.size() / Type::GetTypeSize(type)), data_(std::move(data)), nulls_(size_) {
+  DispatchFixedType(type_, [&](auto tag) {
+    constexpr TypeId TYPE = decltype(tag)::value;
+    const auto *values = GetData<typename NativeType<TYPE>::Type>();
+    for (size_t i = 0; i < size_; i++) {
+      nulls_[i] = static_cast<uint8_t>(values[i] == NativeType<TYPE>::NULL_VALUE);
+    }
+  });
+}
+
+ColumnVector::ColumnVector(TypeId type, std::vector<char> data, std::vector<uint8_t> nulls)
+    : type_(type), size_(nulls.size()), data_(std::move(data)), nulls_(std::move(nulls)) {
+  BUSTUB_ASSERT(data_.size() == size_ * Type::GetTypeSize(type), "the null mask must have one byte per value");
+}
+
+auto ColumnVector::FromValues(TypeId type, const std::vector<Value> &values) -> ColumnVector {
+  ColumnVector column(type, values.size());
+  for (size_t i = 0; i < values.size(); i++) {
+    column.SetValue(i, values[i]);
+  }
+  return column;
+}
+
+auto ColumnVector::GetValue(size_t i) const -> Value {
+  if (IsNull(i)) {
+    return ValueFactory::GetNullValueByType(type_);
+  }
+  Value value;
+  DispatchFixedType(type_, [&](auto tag) {
+    constexpr TypeId TYPE = decltype(tag)::value;
+    value = Value(TYPE, GetData<typename NativeType<TYPE>::Type>()[i]);
+  });
+  return value;
+}
+
+void ColumnVector::SetValue(size_t i, const Value &value) {
+  nulls_[i] = static_cast<uint8_t>(value.IsNull());
+  if (value.IsNull()) {
+    return;
+  }
+  const auto &typed = value.GetTypeId() == type_ ? value : value.CastAs(type_);
+  DispatchFixedType(type_, [&](auto tag) {
+    using T = typename NativeType<decltype(tag)::value>::Type;
+    GetMutableData<T>()[i] = typed.GetAs<T>();
+  });
+}
+
+auto HasBatchKernels(TypeId type) -> bool {
+  switch (type) {
+    case TypeId::BOOLEAN:
+    case TypeId::INTEGER:
+    case TypeId::BIGINT:
+    case TypeId::DECIMAL:
+      return true;
+    default:
+      return false;
+  }
+}
+
+void SelectCompare(CompareKernelOp op, const ColumnVector &column, const Value &constant,
+                   std::vector<uint32_t> *selection) {
+  if (constant.GetTypeId() != column.GetType() || constant.IsNull()) {
+    throw Exception(ExceptionType::MISMATCH_TYPE, "Batch comparisons need a non-NULL constant of the column type.");
+  }
+  DispatchKernelType(column.GetType(), [&](auto type_tag) {
+    using T = typename NativeType<decltype(type_tag)::value>::Type;
+    T rhs = constant.GetAs<T>();
+    DispatchCompareOp(op, [&](auto op_tag) {
+      SelectTyped<decltype(op_tag)::value, T, true>(column.GetData<T>(), &rhs, column.GetNullMask(), nullptr,
+                                                    column.GetSize(), selection);
+    });
+  });
+}
+
+void SelectCompare(CompareKernelOp op, const ColumnVector &lhs, const ColumnVector &rhs,
+                   std::vector<uint32_t> *selection) {
+  CheckSameShape(lhs, rhs);
+  DispatchKernelType(lhs.GetType(), [&](auto type_tag) {
+    using T = typename NativeType<decltype(type_tag)::value>::Type;
+    DispatchCompareOp(op, [&](auto op_tag) {
+      SelectTyped<decltype(op_tag)::value, T, false>(lhs.GetData<T>(), rhs.GetData<T>(), lhs.GetNullMask(),
+                                                     rhs.GetNullMask(), lhs.GetSize(), selection);
+    });
+  });
+}
+
+auto Compute(ArithmeticKernelOp op, const ColumnVector &lhs, const ColumnVector &rhs) -> ColumnVector {
+  CheckSameShape(lhs, rhs);
+  if (lhs.GetType() == TypeId::BOOLEAN) {
+    throw Exception(ExceptionType::MISMATCH_TYPE, "Boolean values cannot be used in arithmetic.");
+  }
+  auto size = lhs.GetSize();
+  ColumnVector result(lhs.GetType(), size);
+  auto *nulls = result.GetMutableNullMask();
+  for (size_t i = 0; i < size; i++) {
+    nulls[i] = lhs.GetNullMask()[i] | rhs.GetNullMask()[i];
+  }
+  bool overflow = false;
+  DispatchKernelType(lhs.GetType(), [&](auto type_tag) {
+    using T = typename NativeType<decltype(type_tag)::value>::Type;
+    DispatchArithmeticOp(op, [&](auto op_tag) {
+      constexpr ArithmeticKernelOp OP = decltype(op_tag)::value;
+      size_t i = 0;
+#ifdef BUSTUB_AVX2_KERNELS
+      // AVX2 has no 64-bit multiplication, and no cheap overflow check for 32-bit multiplication.
+      if constexpr (Avx2Lanes<T>::SUPPORTED && (std::is_floating_point_v<T> || OP != ArithmeticKernelOp::Multiply)) {
+        if (CpuHasAvx2()) {
+          i = ComputeAvx2<OP>(lhs.GetData<T>(), rhs.GetData<T>(), nulls, size, result.GetMutableData<T>(), &overflow);
+        }
+      }
+#endif
+      overflow |= ComputeScalar<OP>(lhs.GetData<T>(), rhs.GetData<T>(), nulls, i, size, result.GetMutableData<T>());
+    });
+  });
+  if (overflow) {
+    throw Exception(ExceptionType::OUT_OF_RANGE, "Numeric value out of range.");
+  }
+  return result;
+}
+
+auto CountColumn(const ColumnVector &column) -> size_t {
+  const auto *nulls = column.GetNullMask();
+  size_t count = 0;
+  for (size_t i = 0; i < column.GetSize(); i++) {
+    count += static_cast<size_t>(nulls[i] == 0);
+  }
+  return count;
+}
+
+auto SumColumn(const ColumnVector &column) -> Value {
+  if (CountColumn(column) == 0) {
+    return ValueFactory::GetNullValueByType(column.GetType());
+  }
+  const auto *nulls = column.GetNullMask();
+  auto size = column.GetSize();
+  switch (column.GetType()) {
+    case TypeId::INTEGER: {
+      const auto *data = column.GetData<int32_t>();
+      int64_t sum = 0;
+      size_t i = 0;
+#ifdef BUSTUB_AVX2_KERNELS
+      if (CpuHasAvx2()) {
+        i = SumInt32Avx2(data, nulls, size, &sum);
+      }
+#endif
+      for (; i < size; i++) {
+        sum += nulls[i] == 0 ? data[i] : 0;
+      }
+      if (sum < BUSTUB_INT32_MIN || sum > BUSTUB_INT32_MAX) {
+        throw Exception(ExceptionType::OUT_OF_RANGE, "Numeric value out of range.");
+      }
+      return {TypeId::INTEGER, static_cast<int32_t>(sum)};
+    }
+    case TypeId::BIGINT: {
+      // A 64-bit sum can overflow, which AVX2 cannot detect cheaply.
+      const auto *data = column.GetData<int64_t>();
+      int64_t sum = 0;
+      bool overflow = false;
+      for (size_t i = 0; i < size; i++) {
+        overflow |= __builtin_add_overflow(sum, nulls[i] == 0 ? data[i] : 0, &sum);
+      }
+      if (overflow || sum < BUSTUB_INT64_MIN) {
+        throw Exception(ExceptionType::OUT_OF_RANGE, "Numeric value out of range.");
+      }
+      return {TypeId::BIGINT, sum};
+    }
+    case TypeId::DECIMAL: {
+      const auto *data = column.GetData<double>();
+      double sum = 0;
+      size_t i = 0;
+#ifdef BUSTUB_AVX2_KERNELS
+      if (CpuHasAvx2()) {
+        i = SumDoubleAvx2(data, nulls, size, &sum);
+      }
+#endif
+      for (; i < size; i++) {
+        sum += nulls[i] == 0 ? data[i] : 0;
+      }
+      return {TypeId::DECIMAL, sum};
+    }
+    default:
+      throw Exception(ExceptionType::MISMATCH_TYPE, "SUM needs a numeric column.");
+  }
+}
+
+auto MinColumn(const ColumnVector &column) -> Value { return MinMaxColumn<true>(column); }
+
+auto MaxColumn(const ColumnVector &column) -> Value { return MinMaxColumn<false>(column); }
+
+}  // namespace bustub
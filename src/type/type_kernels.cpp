@@ -0,0 +1,129 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// type_kernels.cpp
+//
+// Identification: src/type/type_kernels.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include "type/type_kernels.h"
+
+namespace bustub {
+
+namespace {
+
+/** @return the compare kernel for L and a numeric rhs */
+template <TypeId L>
+auto GetNumericCompareKernel(TypeId rhs) -> CompareKernel {
+  switch (rhs) {
+    case TypeId::TINYINT:
+      return &TypedCompare<L, TypeId::TINYINT>;
+    case TypeId::SMALLINT:
+      return &TypedCompare<L, TypeId::SMALLINT>;
+    case TypeId::INTEGER:
+      return &TypedCompare<L, TypeId::INTEGER>;
+    case TypeId::BIGINT:
+      return &TypedCompare<L, TypeId::BIGINT>;
+    case TypeId::DECIMAL:
+      return &TypedCompare<L, TypeId::DECIMAL>;
+    default:
+      return nullptr;
+  }
+}
+
+/** @return the arithmetic kernel for L and a numeric rhs */
+template <ArithmeticKernelOp Op, TypeId L>
+auto GetNumericArithmeticKernel(TypeId rhs) -> ArithmeticKernel {
+  switch (rhs) {
+    case TypeId::TINYINT:
+      return &TypedCompute<Op, L, TypeId::TINYINT>;
+    case TypeId::SMALLINT:
+      return &TypedCompute<Op, L, TypeId::SMALLINT>;
+    case TypeId::INTEGER:
+      return &TypedCompute<Op, L, TypeId::INTEGER>;
+    case TypeId::BIGINT:
+      return &TypedCompute<Op, L, TypeId::BIGINT>;
+    case TypeId::DECIMAL:
+      return &TypedCompute<Op, L, TypeId::DECIMAL>;
+    default:
+      return nullptr;
+  }
+}
+
+template <ArithmeticKernelOp Op>
+auto GetArithmeticKernelForOp(TypeId lhs, TypeId rhs) -> ArithmeticKernel {
+  switch (lhs) {
+    case TypeId::TINYINT:
+      return GetNumericArithmeticKernel<Op, TypeId::TINYINT>(rhs);
+    case TypeId::SMALLINT:
+      return GetNumericArithmeticKernel<Op, TypeId::SMALLINT>(rhs);
+    case TypeId::INTEGER:
+      return GetNumericArithmeticKernel<Op, TypeId::INTEGER>(rhs);
+    case TypeId::BIGINT:
+      return GetNumericArithmeticKernel<Op, TypeId::BIGINT>(rhs);
+    case TypeId::DECIMAL:
+      return GetNumericArithmeticKernel<Op, TypeId::DECIMAL>(rhs);
+    default:
+      return nullptr;
+  }
+}
+
+}  // namespace
+
+auto GetCompareKernel(TypeId lhs, TypeId rhs) -> CompareKernel {
+  switch (lhs) {
+    case TypeId::BOOLEAN:
+      return rhs == TypeId::BOOLEAN ? &TypedCompare<TypeId::BOOLEAN, TypeId::BOOLEAN> : nullptr;
+    case TypeId::TINYINT:
+      return GetNumericCompareKernel<TypeId::TINYINT>(rhs);
+    case TypeId::SMALLINT:
+      return GetNumericCompareKernel<TypeId::SMALLINT>(rhs);
+    case TypeId::INTEGER:
+      return GetNumericCompareKernel<TypeId::INTEGER>(rhs);
+    case TypeId::BIGINT:
+      return GetNumericCompareKernel<TypeId::BIGINT>(rhs);
+    case TypeId::DECIMAL:
+      return GetNumericCompareKernel<TypeId::DECIMAL>(rhs);
+    case TypeId::TIMESTAMP:
+      return rhs == TypeId::TIMESTAMP ? &TypedCompare<TypeId::TIMESTAMP, TypeId::TIMESTAMP> : nullptr;
+    default:
+      return nullptr;
+  }
+}
+
+auto GetRawCompareKernel(TypeId type) -> RawCompareKernel {
+  switch (type) {
+    case TypeId::BOOLEAN:
+      return &TypedCompareRaw<TypeId::BOOLEAN>;
+    case TypeId::TINYINT:
+      return &TypedCompareRaw<TypeId::TINYINT>;
+    case TypeId::SMALLINT:
+      return &TypedCompareRaw<TypeId::SMALLINT>;
+    case TypeId::INTEGER:
+      return &TypedCompareRaw<TypeId::INTEGER>;
+    case TypeId::BIGINT:
+      return &TypedCompareRaw<TypeId::BIGINT>;
+    case TypeId::DECIMAL:
+      return &TypedCompareRaw<TypeId::DECIMAL>;
+    case TypeId::TIMESTAMP:
+      return &TypedCompareRaw<TypeId::TIMESTAMP>;
+    default:
+      return nullptr;
+  }
+}
+
+auto GetArithmeticKernel(ArithmeticKernelOp op, TypeId lhs, TypeId rhs) -> ArithmeticKernel {
+  switch (op) {
+    case ArithmeticKernelOp::Add:
+      return GetArithmeticKernelForOp<ArithmeticKernelOp::Add>(lhs, rhs);
+    case ArithmeticKernelOp::Subtract:
+      return GetArithmeticKernelForOp<ArithmeticKernelOp::Subtract>(lhs, rhs);
+    case ArithmeticKernelOp::Multiply:
+      return GetArithmeticKernelForOp<ArithmeticKernelOp::Multiply>(lhs, rhs);
+  }
+  return nullptr;
+}
+
+}  // namespace bustub
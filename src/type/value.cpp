@@ -28,10 +28,11 @@ Value::Value(const Value &other) {
       if (size_.len_ == BUSTUB_VALUE_NULL) {
         value_.varlen_ = nullptr;
       } else {
-        if (manage_data_) {
+        if (manage_data_ && !IsVarlenInlined()) {
           value_.varlen_ = new char[size_.len_];
           memcpy(value_.varlen_, other.value_.varlen_, size_.len_);
         } else {
+          // Inlined strings were copied along with value_, and unmanaged ones are shared.
           value_ = other.value_;
         }
       }
@@ -41,6 +42,14 @@ Value::Value(const Value &other) {
   }
 }
 
+Value::Value(Value &&other) noexcept
+    : value_(other.value_), size_(other.size_), manage_data_(other.manage_data_), type_id_(other.type_id_) {
+  // A string on the heap now belongs to this value. An inlined one was copied, and stays valid in other.
+  if (!other.IsVarlenInlined()) {
+    other.manage_data_ = false;
+  }
+}
+
 auto Value::operator=(Value other) -> Value & {
   Swap(*this, other);
   return *this;
@@ -221,10 +230,8 @@ Value::Value(TypeId type, const char *data, uint32_t len, bool manage_data) : Va
         manage_data_ = manage_data;
         if (manage_data_) {
           assert(len < BUSTUB_VARCHAR_MAX_LEN);
-          value_.varlen_ = new char[len];
-          assert(value_.varlen_ != nullptr);
           size_.len_ = len;
-          memcpy(value_.varlen_, data, len);
+          memcpy(AllocateVarlen(len), data, len);
         } else {
           // FUCK YOU GCC I do what I want.
           value_.const_varlen_ = data;
@@ -243,10 +250,8 @@ Value::Value(TypeId type, const std::string &data) : Value(type) {
       manage_data_ = true;
       // TODO(TAs): How to represent a null string here?
       uint32_t len = static_cast<uint32_t>(data.length()) + 1;
-      value_.varlen_ = new char[len];
-      assert(value_.varlen_ != nullptr);
       size_.len_ = len;
-      memcpy(value_.varlen_, data.c_str(), len);
+      memcpy(AllocateVarlen(len), data.c_str(), len);
       break;
     }
     default:
@@ -258,7 +263,7 @@ Value::Value(TypeId type, const std::string &data) : Value(type) {
 Value::~Value() {
   switch (type_id_) {
     case TypeId::VARCHAR:
-      if (manage_data_) {
+      if (manage_data_ && !IsVarlenInlined()) {
         delete[] value_.varlen_;
       }
       break;
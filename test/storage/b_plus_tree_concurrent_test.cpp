@@ -100,7 +100,7 @@ void DeleteHelperSplit(BPlusTree<GenericKey<8>, RID, GenericComparator<8>> *tree
   delete transaction;
 }
 
-TEST(BPlusTreeConcurrentTest, DISABLED_InsertTest1) {
+TEST(BPlusTreeConcurrentTest, InsertTest1) {
   // create KeyComparator and index schema
   auto key_schema = ParseCreateStatement("a bigint");
   GenericComparator<8> comparator(key_schema.get());
@@ -152,7 +152,7 @@ TEST(BPlusTreeConcurrentTest, DISABLED_InsertTest1) {
   remove("test.log");
 }
 
-TEST(BPlusTreeConcurrentTest, DISABLED_InsertTest2) {
+TEST(BPlusTreeConcurrentTest, InsertTest2) {
   // create KeyComparator and index schema
   auto key_schema = ParseCreateStatement("a bigint");
   GenericComparator<8> comparator(key_schema.get());
@@ -203,7 +203,7 @@ TEST(BPlusTreeConcurrentTest, DISABLED_InsertTest2) {
   remove("test.log");
 }
 
-TEST(BPlusTreeConcurrentTest, DISABLED_DeleteTest1) {
+TEST(BPlusTreeConcurrentTest, DeleteTest1) {
   // create KeyComparator and index schema
   auto key_schema = ParseCreateStatement("a bigint");
   GenericComparator<8> comparator(key_schema.get());
@@ -245,7 +245,7 @@ TEST(BPlusTreeConcurrentTest, DISABLED_DeleteTest1) {
   remove("test.log");
 }
 
-TEST(BPlusTreeConcurrentTest, DISABLED_DeleteTest2) {
+TEST(BPlusTreeConcurrentTest, DeleteTest2) {
   // create KeyComparator and index schema
   auto key_schema = ParseCreateStatement("a bigint");
   GenericComparator<8> comparator(key_schema.get());
@@ -288,7 +288,7 @@ TEST(BPlusTreeConcurrentTest, DISABLED_DeleteTest2) {
   remove("test.log");
 }
 
-TEST(BPlusTreeConcurrentTest, DISABLED_MixTest) {
+TEST(BPlusTreeConcurrentTest, MixTest) {
   // create KeyComparator and index schema
   auto key_schema = ParseCreateStatement("a bigint");
   GenericComparator<8> comparator(key_schema.get());
@@ -333,4 +333,178 @@ TEST(BPlusTreeConcurrentTest, DISABLED_MixTest) {
   remove("test.log");
 }
 
+void MixHelper(BPlusTreeMode mode) {
+  // create KeyComparator and index schema
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+
+  auto *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManagerInstance(100, disk_manager);
+  // create b+ tree with small pages, so that splits and merges run all the way up to the root
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", bpm, comparator, 4, 5, mode);
+
+  // create and fetch header_page
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  (void)header_page;
+
+  // populate the index with the even keys
+  const int64_t num_keys = 2000;
+  std::vector<int64_t> even_keys;
+  std::vector<int64_t> odd_keys;
+  std::vector<int64_t> remove_keys;
+  for (int64_t key = 0; key < num_keys; key++) {
+    (key % 2 == 0 ? even_keys : odd_keys).push_back(key);
+    if (key % 4 == 0) {
+      remove_keys.push_back(key);
+    }
+  }
+  InsertHelper(&tree, even_keys);
+
+  // insert the odd keys and remove every other even key, while scanners check that the keys they see are in order and
+  // include all keys that stay in the tree
+  auto scan = [&tree]() {
+    for (int round = 0; round < 5; round++) {
+      int64_t last_key = -1;
+      int64_t kept_keys = 0;
+      for (auto iterator = tree.Begin(); iterator != tree.End(); ++iterator) {
+        int64_t key = (*iterator).second.GetSlotNum();
+        EXPECT_GT(key, last_key);
+        last_key = key;
+        kept_keys += static_cast<int64_t>(key % 4 == 2);
+      }
+      EXPECT_EQ(kept_keys, num_keys / 4);
+    }
+  };
+  std::vector<std::thread> threads;
+  for (uint64_t i = 0; i < 2; i++) {
+    threads.emplace_back(InsertHelperSplit, &tree, odd_keys, 2, i);
+    threads.emplace_back(DeleteHelperSplit, &tree, remove_keys, 2, i);
+    threads.emplace_back(scan);
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  std::vector<int64_t> expected;
+  for (int64_t key = 0; key < num_keys; key++) {
+    if (key % 4 != 0) {
+      expected.push_back(key);
+    }
+  }
+  std::vector<int64_t> actual;
+  for (auto iterator = tree.Begin(); iterator != tree.End(); ++iterator) {
+    actual.push_back((*iterator).second.GetSlotNum());
+  }
+  EXPECT_EQ(actual, expected);
+
+  std::vector<RID> rids;
+  GenericKey<8> index_key;
+  for (int64_t key = 0; key < num_keys; key++) {
+    rids.clear();
+    index_key.SetFromInteger(key);
+    EXPECT_EQ(tree.GetValue(index_key, &rids), key % 4 != 0);
+  }
+
+  // removing everything leaves an empty tree, which keeps its pages in B-link mode
+  DeleteHelper(&tree, expected);
+  EXPECT_EQ(tree.IsEmpty(), mode == BPlusTreeMode::LATCH_CRABBING);
+  EXPECT_TRUE(tree.Begin() == tree.End());
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete disk_manager;
+  delete bpm;
+  remove("test.db");
+  remove("test.log");
+}
+
+TEST(BPlusTreeConcurrentTest, MixTest2) { MixHelper(BPlusTreeMode::LATCH_CRABBING); }
+
+TEST(BPlusTreeConcurrentTest, BLinkMixTest) { MixHelper(BPlusTreeMode::B_LINK); }
+
+TEST(BPlusTreeConcurrentTest, RangeScanTest) {
+  // create KeyComparator and index schema
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+
+  auto *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManagerInstance(100, disk_manager);
+  // create b+ tree with small pages, so that leaves merge and even out under the scans
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", bpm, comparator, 4, 5);
+
+  // create and fetch header_page
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  (void)header_page;
+
+  const int64_t num_keys = 2000;
+  std::vector<int64_t> keys;
+  std::vector<int64_t> remove_keys;
+  for (int64_t key = 0; key < num_keys; key++) {
+    keys.push_back(key);
+    if (key % 2 == 1) {
+      remove_keys.push_back(key);
+    }
+  }
+  InsertHelper(&tree, keys);
+
+  // remove the odd keys, while forward and reverse scanners check that they see each even key of their range once, in
+  // order, and nothing outside of it
+  auto scan = [&tree]() {
+    IndexBound<GenericKey<8>> lower;
+    lower.key_.SetFromInteger(num_keys / 4);
+    lower.inclusive_ = false;
+    IndexBound<GenericKey<8>> upper;
+    upper.key_.SetFromInteger(3 * num_keys / 4);
+    upper.inclusive_ = true;
+    for (int round = 0; round < 5; round++) {
+      int64_t last_key = num_keys / 4;
+      int64_t kept_keys = 0;
+      for (auto iterator = tree.Begin(lower, upper); !iterator.IsEnd(); ++iterator) {
+        int64_t key = (*iterator).second.GetSlotNum();
+        EXPECT_GT(key, last_key);
+        EXPECT_LE(key, 3 * num_keys / 4);
+        last_key = key;
+        kept_keys += static_cast<int64_t>(key % 2 == 0);
+      }
+      EXPECT_EQ(kept_keys, num_keys / 4);
+    }
+  };
+  auto scan_reverse = [&tree]() {
+    IndexBound<GenericKey<8>> lower;
+    lower.key_.SetFromInteger(num_keys / 4);
+    lower.inclusive_ = false;
+    IndexBound<GenericKey<8>> upper;
+    upper.key_.SetFromInteger(3 * num_keys / 4);
+    upper.inclusive_ = true;
+    for (int round = 0; round < 5; round++) {
+      int64_t last_key = 3 * num_keys / 4 + 1;
+      int64_t kept_keys = 0;
+      for (auto iterator = tree.BeginReverse(lower, upper); !iterator.IsEnd(); ++iterator) {
+        int64_t key = (*iterator).second.GetSlotNum();
+        EXPECT_LT(key, last_key);
+        EXPECT_GT(key, num_keys / 4);
+        last_key = key;
+        kept_keys += static_cast<int64_t>(key % 2 == 0);
+      }
+      EXPECT_EQ(kept_keys, num_keys / 4);
+    }
+  };
+  std::vector<std::thread> threads;
+  for (uint64_t i = 0; i < 2; i++) {
+    threads.emplace_back(DeleteHelperSplit, &tree, remove_keys, 2, i);
+    threads.emplace_back(scan);
+    threads.emplace_back(scan_reverse);
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete disk_manager;
+  delete bpm;
+  remove("test.db");
+  remove("test.log");
+}
+
 }  // namespace bustub
@@ -74,6 +74,59 @@ bool BPlusTreeLockBenchmarkCall(size_t num_threads, int leaf_node_size, bool wit
   return success;
 }
 
+/** @return the time in ms that num_threads threads take to insert fresh keys and look up a few hot ones in turn */
+size_t BPlusTreeModeBenchmarkCall(BPlusTreeMode mode, size_t num_threads) {
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+  auto *disk_manager = new DiskManagerMemory(256 << 10);
+  BufferPoolManager *bpm = new BufferPoolManagerInstance(256, disk_manager);
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", bpm, comparator, 16, 16, mode);
+  page_id_t page_id;
+  auto *header_page = bpm->NewPage(&page_id);
+  (void)header_page;
+
+  const int64_t hot_keys = 64;
+  GenericKey<8> index_key;
+  RID rid;
+  for (int64_t key = 0; key < hot_keys; key++) {
+    rid.Set(0, key);
+    index_key.SetFromInteger(key);
+    tree.Insert(index_key, rid);
+  }
+
+  // the inserted keys interleave between the threads, so that they all split the same few leaves on the right
+  const auto keys_per_thread = static_cast<int64_t>(20000 / num_threads);
+  auto clock_start = std::chrono::system_clock::now();
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < num_threads; i++) {
+    threads.emplace_back([&tree, i, num_threads, keys_per_thread]() {
+      GenericKey<8> index_key;
+      RID rid;
+      std::vector<RID> rids;
+      for (int64_t n = 0; n < keys_per_thread; n++) {
+        int64_t key = hot_keys + n * static_cast<int64_t>(num_threads) + static_cast<int64_t>(i);
+        rid.Set(0, key);
+        index_key.SetFromInteger(key);
+        tree.Insert(index_key, rid);
+        for (int64_t lookup = 0; lookup < 4; lookup++) {
+          rids.clear();
+          index_key.SetFromInteger((key + lookup) % hot_keys);
+          tree.GetValue(index_key, &rids);
+        }
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  auto clock_end = std::chrono::system_clock::now();
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete disk_manager;
+  delete bpm;
+  return std::chrono::duration_cast<std::chrono::milliseconds>(clock_end - clock_start).count();
+}
+
 TEST(BPlusTreeTest, DISABLED_BPlusTreeContentionBenchmark) {  // NOLINT
   std::vector<size_t> time_ms_with_mutex;
   std::vector<size_t> time_ms_wo_mutex;
@@ -154,4 +207,18 @@ TEST(BPlusTreeTest, DISABLED_BPlusTreeContentionBenchmark2) {  // NOLINT
             << std::endl;
 }
 
+TEST(BPlusTreeTest, DISABLED_BPlusTreeModeBenchmark) {  // NOLINT
+  size_t time_ms_crabbing = 0;
+  size_t time_ms_b_link = 0;
+  for (size_t iter = 0; iter < 10; iter++) {
+    time_ms_crabbing += BPlusTreeModeBenchmarkCall(BPlusTreeMode::LATCH_CRABBING, 16);
+    time_ms_b_link += BPlusTreeModeBenchmarkCall(BPlusTreeMode::B_LINK, 16);
+  }
+  std::cout << "<<< BEGIN3" << std::endl;
+  std::cout << "Latch Crabbing Time: " << time_ms_crabbing << std::endl;
+  std::cout << "B-Link Time: " << time_ms_b_link << std::endl;
+  std::cout << "Ratio: " << static_cast<double>(time_ms_b_link) / static_cast<double>(time_ms_crabbing) << std::endl;
+  std::cout << ">>> END3" << std::endl;
+}
+
 }  // namespace bustub
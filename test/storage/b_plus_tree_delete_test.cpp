@@ -20,7 +20,7 @@
 
 namespace bustub {
 
-TEST(BPlusTreeTests, DISABLED_DeleteTest1) {
+TEST(BPlusTreeTests, DeleteTest1) {
   // create KeyComparator and index schema
   auto key_schema = ParseCreateStatement("a bigint");
   GenericComparator<8> comparator(key_schema.get());
@@ -92,7 +92,7 @@ TEST(BPlusTreeTests, DISABLED_DeleteTest1) {
   remove("test.log");
 }
 
-TEST(BPlusTreeTests, DISABLED_DeleteTest2) {
+TEST(BPlusTreeTests, DeleteTest2) {
   // create KeyComparator and index schema
   auto key_schema = ParseCreateStatement("a bigint");
   GenericComparator<8> comparator(key_schema.get());
@@ -163,4 +163,71 @@ TEST(BPlusTreeTests, DISABLED_DeleteTest2) {
   remove("test.db");
   remove("test.log");
 }
+
+TEST(BPlusTreeTests, DeletePinnedPageTest) {
+  // create KeyComparator and index schema
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManagerInstance(50, disk_manager);
+  // create b+ tree with small pages, so that a few removes merge leaves
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", bpm, comparator, 4, 5);
+  GenericKey<8> index_key;
+  RID rid;
+
+  // create and fetch header_page
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  (void)header_page;
+
+  std::vector<int64_t> keys = {1, 2, 3, 4, 5, 6, 7, 8};
+  for (auto key : keys) {
+    rid.Set(0, key);
+    index_key.SetFromInteger(key);
+    tree.Insert(index_key, rid);
+  }
+  auto find_frame = [bpm](page_id_t page_id) -> Page * {
+    Page *pages = bpm->GetPages();
+    Page *frame = std::find_if(pages, pages + bpm->GetPoolSize(),
+                               [page_id](Page &page) { return page.GetPageId() == page_id; });
+    return frame == pages + bpm->GetPoolSize() ? nullptr : frame;
+  };
+
+  {
+    // the iterator copies the first leaf and keeps the second one pinned
+    auto iterator = tree.Begin();
+    auto *root = reinterpret_cast<BPlusTreeInternalPage<GenericKey<8>, page_id_t, GenericComparator<8>> *>(
+        bpm->FetchPage(tree.GetRootPageId())->GetData());
+    ASSERT_FALSE(root->IsLeafPage());
+    page_id_t second_leaf_id = root->ValueAt(1);
+    bpm->UnpinPage(root->GetPageId(), false);
+    Page *second_leaf = find_frame(second_leaf_id);
+    ASSERT_NE(second_leaf, nullptr);
+    ASSERT_EQ(second_leaf->GetPinCount(), 1);
+
+    // removing from the first leaf merges the second one into it, but the page can not go while it is pinned
+    for (auto key : keys) {
+      if (!reinterpret_cast<BPlusTreePage *>(second_leaf->GetData())->IsLeafPage()) {
+        break;
+      }
+      index_key.SetFromInteger(key);
+      tree.Remove(index_key);
+    }
+    ASSERT_FALSE(reinterpret_cast<BPlusTreePage *>(second_leaf->GetData())->IsLeafPage());
+    EXPECT_EQ(find_frame(second_leaf_id), second_leaf);
+
+    // once the iterator moves past it, the page is deleted
+    while (!iterator.IsEnd()) {
+      ++iterator;
+    }
+    EXPECT_EQ(find_frame(second_leaf_id), nullptr);
+  }
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete disk_manager;
+  delete bpm;
+  remove("test.db");
+  remove("test.log");
+}
 }  // namespace bustub
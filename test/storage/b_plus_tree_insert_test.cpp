@@ -12,10 +12,15 @@
 
 #include <algorithm>
 #include <cstdio>
+#include <cstring>
+#include <optional>
+#include <random>
 
 #include "buffer/buffer_pool_manager_instance.h"
 #include "gtest/gtest.h"
 #include "storage/index/b_plus_tree.h"
+#include "storage/index/index_build_sorter.h"
+#include "storage/index/key_search.h"
 #include "test_util.h"  // NOLINT
 
 namespace bustub {
@@ -64,7 +69,7 @@ TEST(BPlusTreeTests, InsertTest1) {
   remove("test.log");
 }
 
-TEST(BPlusTreeTests, DISABLED_InsertTest2) {
+TEST(BPlusTreeTests, InsertTest2) {
   // create KeyComparator and index schema
   auto key_schema = ParseCreateStatement("a bigint");
   GenericComparator<8> comparator(key_schema.get());
@@ -127,7 +132,7 @@ TEST(BPlusTreeTests, DISABLED_InsertTest2) {
   remove("test.log");
 }
 
-TEST(BPlusTreeTests, DISABLED_InsertTest3) {
+TEST(BPlusTreeTests, InsertTest3) {
   // create KeyComparator and index schema
   auto key_schema = ParseCreateStatement("a bigint");
   GenericComparator<8> comparator(key_schema.get());
@@ -195,4 +200,583 @@ TEST(BPlusTreeTests, DISABLED_InsertTest3) {
   remove("test.db");
   remove("test.log");
 }
+
+TEST(BPlusTreeTests, BulkLoadTest) {
+  // create KeyComparator and index schema
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+
+  auto *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManagerInstance(50, disk_manager);
+  // create b+ tree
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", bpm, comparator, 10, 5);
+  using LeafPage = BPlusTreeLeafPage<GenericKey<8>, RID, GenericComparator<8>>;
+  using InternalPage = BPlusTreeInternalPage<GenericKey<8>, page_id_t, GenericComparator<8>>;
+  GenericKey<8> index_key;
+  RID rid;
+
+  // create and fetch header_page
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  ASSERT_EQ(page_id, HEADER_PAGE_ID);
+  (void)header_page;
+
+  // sort the keys in a shuffled order, each one twice, with room for only 100 entries in memory, so that the runs
+  // take more than one merge pass with 50 frames
+  const int64_t num_keys = 5000;
+  std::vector<int64_t> keys;
+  for (int64_t key = 0; key < num_keys; key++) {
+    keys.push_back(key);
+  }
+  std::shuffle(keys.begin(), keys.end(), std::mt19937(15445));
+  IndexBuildSorter<GenericKey<8>, RID, GenericComparator<8>> sorter(bpm, comparator,
+                                                                     100 * sizeof(std::pair<GenericKey<8>, RID>));
+  for (int copy = 0; copy < 2; copy++) {
+    for (auto key : keys) {
+      rid.Set(copy, key);
+      index_key.SetFromInteger(key);
+      sorter.Add(index_key, rid);
+    }
+  }
+  sorter.Finish();
+  EXPECT_GT(sorter.GetNumSpilledRuns(), 2 * num_keys / 100);
+  tree.BulkLoad([&sorter](std::pair<GenericKey<8>, RID> *entry) { return sorter.Next(entry); }, 0.7);
+
+  // of the two entries of each key, the first one added is kept
+  int64_t current_key = 0;
+  for (auto iterator = tree.Begin(); iterator != tree.End(); ++iterator) {
+    EXPECT_EQ((*iterator).second.GetPageId(), 0);
+    EXPECT_EQ((*iterator).second.GetSlotNum(), current_key);
+    current_key++;
+  }
+  EXPECT_EQ(current_key, num_keys);
+
+  // every leaf but the last two holds 70% of the 9 entries it can hold, and the last two at least the min size
+  page_id_t leaf_page_id = tree.GetRootPageId();
+  auto *node = reinterpret_cast<BPlusTreePage *>(bpm->FetchPage(leaf_page_id)->GetData());
+  while (!node->IsLeafPage()) {
+    page_id_t child_page_id = reinterpret_cast<InternalPage *>(node)->ValueAt(0);
+    bpm->UnpinPage(leaf_page_id, false);
+    leaf_page_id = child_page_id;
+    node = reinterpret_cast<BPlusTreePage *>(bpm->FetchPage(leaf_page_id)->GetData());
+  }
+  bpm->UnpinPage(leaf_page_id, false);
+  std::vector<int> leaf_sizes;
+  while (leaf_page_id != INVALID_PAGE_ID) {
+    auto *leaf = reinterpret_cast<LeafPage *>(bpm->FetchPage(leaf_page_id)->GetData());
+    leaf_sizes.push_back(leaf->GetSize());
+    page_id_t next_page_id = leaf->GetNextPageId();
+    bpm->UnpinPage(leaf_page_id, false);
+    leaf_page_id = next_page_id;
+  }
+  ASSERT_GT(leaf_sizes.size(), 2);
+  for (size_t i = 0; i + 2 < leaf_sizes.size(); i++) {
+    EXPECT_EQ(leaf_sizes[i], 6);
+  }
+  for (size_t i = leaf_sizes.size() - 2; i < leaf_sizes.size(); i++) {
+    EXPECT_GE(leaf_sizes[i], 5);
+    EXPECT_LE(leaf_sizes[i], 9);
+  }
+
+  // the loaded tree takes inserts and removes like any other
+  for (int64_t key = 0; key < num_keys; key += 2) {
+    index_key.SetFromInteger(key);
+    tree.Remove(index_key);
+  }
+  for (int64_t key = num_keys; key < 2 * num_keys; key++) {
+    rid.Set(0, key);
+    index_key.SetFromInteger(key);
+    EXPECT_TRUE(tree.Insert(index_key, rid));
+  }
+  std::vector<RID> rids;
+  for (int64_t key = 0; key < 2 * num_keys; key++) {
+    rids.clear();
+    index_key.SetFromInteger(key);
+    EXPECT_EQ(tree.GetValue(index_key, &rids), key >= num_keys || key % 2 == 1);
+  }
+
+  // an empty input leaves the tree empty, and a loaded tree cannot be loaded again
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> empty_tree("bar_pk", bpm, comparator, 10, 5);
+  empty_tree.BulkLoad([](std::pair<GenericKey<8>, RID> *entry) { return false; });
+  EXPECT_TRUE(empty_tree.IsEmpty());
+  EXPECT_THROW(tree.BulkLoad([](std::pair<GenericKey<8>, RID> *entry) { return false; }), Exception);
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete disk_manager;
+  delete bpm;
+  remove("test.db");
+  remove("test.log");
+}
+
+TEST(BPlusTreeTests, RangeScanTest) {
+  // create KeyComparator and index schema
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+
+  auto *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManagerInstance(50, disk_manager);
+  // create b+ tree with small leaves, so that ranges span many of them
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", bpm, comparator, 10, 5);
+  GenericKey<8> index_key;
+  RID rid;
+
+  // create and fetch header_page
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  ASSERT_EQ(page_id, HEADER_PAGE_ID);
+  (void)header_page;
+
+  // insert the even keys, so that bounds fall both on and between keys
+  const int64_t num_keys = 1000;
+  for (int64_t key = 0; key < 2 * num_keys; key += 2) {
+    rid.Set(0, key);
+    index_key.SetFromInteger(key);
+    tree.Insert(index_key, rid);
+  }
+
+  using Bound = std::optional<IndexBound<GenericKey<8>>>;
+  auto bound = [](int64_t key, bool inclusive) {
+    IndexBound<GenericKey<8>> bound;
+    bound.key_.SetFromInteger(key);
+    bound.inclusive_ = inclusive;
+    return Bound(bound);
+  };
+  auto scan = [&tree](const Bound &lower, const Bound &upper) {
+    std::vector<int64_t> keys;
+    for (auto iterator = tree.Begin(lower, upper); !iterator.IsEnd(); ++iterator) {
+      keys.push_back((*iterator).second.GetSlotNum());
+    }
+    return keys;
+  };
+  auto expected = [](int64_t first, int64_t last) {
+    std::vector<int64_t> keys;
+    for (int64_t key = first; key <= last; key += 2) {
+      keys.push_back(key);
+    }
+    return keys;
+  };
+  EXPECT_EQ(scan(bound(100, true), bound(200, true)), expected(100, 200));
+  EXPECT_EQ(scan(bound(100, false), bound(200, false)), expected(102, 198));
+  EXPECT_EQ(scan(bound(101, true), bound(199, true)), expected(102, 198));
+  EXPECT_EQ(scan(std::nullopt, bound(10, false)), expected(0, 8));
+  EXPECT_EQ(scan(bound(1991, true), std::nullopt), expected(1992, 1998));
+  EXPECT_EQ(scan(std::nullopt, std::nullopt), expected(0, 1998));
+  EXPECT_EQ(scan(bound(6, true), bound(6, true)), expected(6, 6));
+  EXPECT_TRUE(scan(bound(6, false), bound(6, true)).empty());
+  EXPECT_TRUE(scan(bound(5, true), bound(5, true)).empty());
+  EXPECT_TRUE(scan(bound(200, true), bound(100, true)).empty());
+  EXPECT_TRUE(scan(bound(2000, true), std::nullopt).empty());
+
+  // reverse iterators produce the same ranges in descending order
+  auto scan_reverse = [&tree](const Bound &lower, const Bound &upper) {
+    std::vector<int64_t> keys;
+    for (auto iterator = tree.BeginReverse(lower, upper); !iterator.IsEnd(); ++iterator) {
+      keys.push_back((*iterator).second.GetSlotNum());
+    }
+    std::reverse(keys.begin(), keys.end());
+    return keys;
+  };
+  EXPECT_EQ(scan_reverse(bound(100, true), bound(200, true)), expected(100, 200));
+  EXPECT_EQ(scan_reverse(bound(100, false), bound(200, false)), expected(102, 198));
+  EXPECT_EQ(scan_reverse(bound(101, true), bound(199, true)), expected(102, 198));
+  EXPECT_EQ(scan_reverse(std::nullopt, bound(10, false)), expected(0, 8));
+  EXPECT_EQ(scan_reverse(bound(1991, true), std::nullopt), expected(1992, 1998));
+  EXPECT_EQ(scan_reverse(std::nullopt, std::nullopt), expected(0, 1998));
+  EXPECT_EQ(scan_reverse(bound(6, true), bound(6, true)), expected(6, 6));
+  EXPECT_TRUE(scan_reverse(bound(6, false), bound(6, true)).empty());
+  EXPECT_TRUE(scan_reverse(bound(200, true), bound(100, true)).empty());
+  EXPECT_TRUE(scan_reverse(std::nullopt, bound(0, false)).empty());
+
+  // batches hand out the values of one leaf at a time
+  auto iterator = tree.Begin(bound(500, true), bound(1500, false));
+  std::vector<RID> values;
+  size_t num_batches = 0;
+  while (iterator.NextBatch(&values)) {
+    num_batches++;
+    EXPECT_LE(values.size(), 10 * num_batches);
+  }
+  ASSERT_EQ(values.size(), 500);
+  for (size_t i = 0; i < values.size(); i++) {
+    EXPECT_EQ(values[i].GetSlotNum(), 500 + 2 * static_cast<int64_t>(i));
+  }
+  EXPECT_GE(num_batches, 500 / 10);
+
+  // iterators that stop early give back the leaf they hold pinned, so the buffer pool does not run out of frames
+  for (int round = 0; round < 100; round++) {
+    auto early = tree.Begin(bound(round, true), std::nullopt);
+    ASSERT_FALSE(early.IsEnd());
+  }
+  EXPECT_EQ(scan(std::nullopt, std::nullopt), expected(0, 1998));
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete disk_manager;
+  delete bpm;
+  remove("test.db");
+  remove("test.log");
+}
+
+TEST(BPlusTreeTests, DuplicateKeyTest) {
+  // create KeyComparator and index schema
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+
+  auto *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManagerInstance(50, disk_manager);
+  // create b+ tree for duplicate keys
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_idx", bpm, comparator, 10, 5,
+                                                           BPlusTreeMode::LATCH_CRABBING, false);
+  using LeafPage = BPlusTreeLeafPage<GenericKey<8>, RID, GenericComparator<8>>;
+  using InternalPage = BPlusTreeInternalPage<GenericKey<8>, page_id_t, GenericComparator<8>>;
+  using PostingPage = BPlusTreePostingPage<RID>;
+  GenericKey<8> index_key;
+  RID rid;
+
+  // create and fetch header_page
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  ASSERT_EQ(page_id, HEADER_PAGE_ID);
+  (void)header_page;
+
+  // the sizes of the posting pages of key 0, the first key of the first leaf, or none while its values are inline
+  auto hot_posting_page_sizes = [&]() {
+    page_id_t node_page_id = tree.GetRootPageId();
+    auto *node = reinterpret_cast<BPlusTreePage *>(bpm->FetchPage(node_page_id)->GetData());
+    while (!node->IsLeafPage()) {
+      page_id_t child_page_id = reinterpret_cast<InternalPage *>(node)->ValueAt(0);
+      bpm->UnpinPage(node_page_id, false);
+      node_page_id = child_page_id;
+      node = reinterpret_cast<BPlusTreePage *>(bpm->FetchPage(node_page_id)->GetData());
+    }
+    auto *leaf = reinterpret_cast<LeafPage *>(node);
+    std::vector<int> sizes;
+    page_id_t posting_page_id = leaf->GetValueCount(0) == 0 ? leaf->GetPosting(0).first_page_id_ : INVALID_PAGE_ID;
+    while (posting_page_id != INVALID_PAGE_ID) {
+      auto *posting_page = reinterpret_cast<PostingPage *>(bpm->FetchPage(posting_page_id)->GetData());
+      sizes.push_back(posting_page->GetSize());
+      page_id_t next_page_id = posting_page->GetNextPageId();
+      bpm->UnpinPage(posting_page_id, false);
+      posting_page_id = next_page_id;
+    }
+    bpm->UnpinPage(node_page_id, false);
+    return sizes;
+  };
+
+  // key 0 is hot, with more values than a posting page holds, and the other keys have a few values each
+  const int64_t num_keys = 200;
+  const int64_t num_hot_values = 3000;
+  const int64_t num_values = 3;
+  std::vector<RID> hot_rids;
+  for (int64_t i = 0; i < num_hot_values; i++) {
+    hot_rids.emplace_back(i / 100, i % 100);
+  }
+  std::shuffle(hot_rids.begin(), hot_rids.end(), std::mt19937(15445));
+  index_key.SetFromInteger(0);
+  for (const auto &hot_rid : hot_rids) {
+    EXPECT_TRUE(tree.Insert(index_key, hot_rid));
+  }
+  for (int64_t copy = num_values - 1; copy >= 0; copy--) {
+    for (int64_t key = 1; key <= num_keys; key++) {
+      rid.Set(copy, key);
+      index_key.SetFromInteger(key);
+      EXPECT_TRUE(tree.Insert(index_key, rid));
+    }
+  }
+  // a key-value pair is only present once
+  EXPECT_FALSE(tree.Insert(index_key, rid));
+  index_key.SetFromInteger(0);
+  EXPECT_FALSE(tree.Insert(index_key, hot_rids[0]));
+
+  // the values of a key come out in ascending order
+  std::vector<RID> sorted_hot_rids = hot_rids;
+  std::sort(sorted_hot_rids.begin(), sorted_hot_rids.end());
+  std::vector<RID> values;
+  EXPECT_TRUE(tree.GetValue(index_key, &values));
+  EXPECT_EQ(values, sorted_hot_rids);
+  values.clear();
+  index_key.SetFromInteger(num_keys);
+  EXPECT_TRUE(tree.GetValue(index_key, &values));
+  EXPECT_EQ(values, std::vector<RID>({RID(0, num_keys), RID(1, num_keys), RID(2, num_keys)}));
+
+  // iterators see each key once for each of its values, which reverse iterators see in descending order
+  std::vector<std::pair<int64_t, RID>> entries;
+  for (auto iterator = tree.Begin(); iterator != tree.End(); ++iterator) {
+    entries.emplace_back((*iterator).first.ToString(), (*iterator).second);
+  }
+  ASSERT_EQ(entries.size(), num_hot_values + num_keys * num_values);
+  EXPECT_TRUE(std::is_sorted(entries.begin(), entries.end()));
+  std::vector<std::pair<int64_t, RID>> reverse_entries;
+  for (auto iterator = tree.BeginReverse(std::nullopt, std::nullopt); !iterator.IsEnd(); ++iterator) {
+    reverse_entries.emplace_back((*iterator).first.ToString(), (*iterator).second);
+  }
+  std::reverse(reverse_entries.begin(), reverse_entries.end());
+  EXPECT_EQ(reverse_entries, entries);
+
+  // a key goes away along with its last value, or with all of them at once
+  index_key.SetFromInteger(1);
+  tree.Remove(index_key, RID(1, 1));
+  tree.Remove(index_key, RID(1, 1));
+  values.clear();
+  EXPECT_TRUE(tree.GetValue(index_key, &values));
+  EXPECT_EQ(values, std::vector<RID>({RID(0, 1), RID(2, 1)}));
+  tree.Remove(index_key, RID(0, 1));
+  tree.Remove(index_key, RID(2, 1));
+  EXPECT_FALSE(tree.GetValue(index_key, &values));
+  index_key.SetFromInteger(2);
+  tree.Remove(index_key);
+  EXPECT_FALSE(tree.GetValue(index_key, &values));
+
+  // the hot key keeps its other values while half of them go
+  index_key.SetFromInteger(0);
+  for (int64_t i = 0; i < num_hot_values / 2; i++) {
+    tree.Remove(index_key, hot_rids[i]);
+  }
+  sorted_hot_rids.assign(hot_rids.begin() + num_hot_values / 2, hot_rids.end());
+  std::sort(sorted_hot_rids.begin(), sorted_hot_rids.end());
+  values.clear();
+  EXPECT_TRUE(tree.GetValue(index_key, &values));
+  EXPECT_EQ(values, sorted_hot_rids);
+
+  // posting pages whose values fit onto one page are merged, so no two neighbours are less than full together
+  const int64_t posting_page_size = (BUSTUB_PAGE_SIZE - POSTING_PAGE_HEADER_SIZE) / sizeof(RID);
+  auto sizes = hot_posting_page_sizes();
+  ASSERT_GE(sizes.size(), 2);
+  for (size_t i = 1; i < sizes.size(); i++) {
+    EXPECT_GT(sizes[i - 1] + sizes[i], posting_page_size);
+  }
+  EXPECT_LE(sizes.size(), 2 * (num_hot_values / 2) / posting_page_size + 1);
+
+  // once no more values are left than a posting list holds inline, they move back into the leaf
+  const int64_t num_inline_values = LeafPage::POSTING_LIST_MAX_SIZE;
+  for (int64_t i = num_hot_values / 2; i < num_hot_values - num_inline_values; i++) {
+    tree.Remove(index_key, hot_rids[i]);
+  }
+  EXPECT_TRUE(hot_posting_page_sizes().empty());
+  sorted_hot_rids.assign(hot_rids.end() - num_inline_values, hot_rids.end());
+  std::sort(sorted_hot_rids.begin(), sorted_hot_rids.end());
+  values.clear();
+  EXPECT_TRUE(tree.GetValue(index_key, &values));
+  EXPECT_EQ(values, sorted_hot_rids);
+
+  for (int64_t key = 0; key <= num_keys; key++) {
+    index_key.SetFromInteger(key);
+    tree.Remove(index_key);
+  }
+  EXPECT_TRUE(tree.IsEmpty());
+
+  // bulk loading keeps all the values of a key too
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> loaded_tree("bar_idx", bpm, comparator, 10, 5,
+                                                                  BPlusTreeMode::LATCH_CRABBING, false);
+  std::vector<std::pair<GenericKey<8>, RID>> load_entries;
+  for (int64_t key = 0; key < num_keys; key++) {
+    int64_t key_values = key == num_keys / 2 ? num_hot_values : num_values;
+    index_key.SetFromInteger(key);
+    for (int64_t i = key_values - 1; i >= 0; i--) {
+      load_entries.emplace_back(index_key, RID(i, key));
+    }
+  }
+  size_t next_entry = 0;
+  loaded_tree.BulkLoad(
+      [&](std::pair<GenericKey<8>, RID> *entry) {
+        if (next_entry == load_entries.size()) {
+          return false;
+        }
+        *entry = load_entries[next_entry++];
+        return true;
+      },
+      0.7);
+  int64_t num_entries = 0;
+  for (auto iterator = loaded_tree.Begin(); iterator != loaded_tree.End(); ++iterator) {
+    num_entries++;
+  }
+  EXPECT_EQ(num_entries, num_hot_values + (num_keys - 1) * num_values);
+  index_key.SetFromInteger(num_keys / 2);
+  values.clear();
+  EXPECT_TRUE(loaded_tree.GetValue(index_key, &values));
+  ASSERT_EQ(values.size(), num_hot_values);
+  EXPECT_TRUE(std::is_sorted(values.begin(), values.end()));
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete disk_manager;
+  delete bpm;
+  remove("test.db");
+  remove("test.log");
+}
+
+TEST(BPlusTreeTests, KeyCompressionTest) {
+  // create KeyComparator and index schema
+  auto key_schema = ParseCreateStatement("a varchar(32)");
+  GenericComparator<32> comparator(key_schema.get());
+
+  auto *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManagerInstance(50, disk_manager);
+  // create b+ tree with the default page sizes
+  BPlusTree<GenericKey<32>, RID, GenericComparator<32>> tree("foo_pk", bpm, comparator);
+  using LeafPage = BPlusTreeLeafPage<GenericKey<32>, RID, GenericComparator<32>>;
+  using InternalPage = BPlusTreeInternalPage<GenericKey<32>, page_id_t, GenericComparator<32>>;
+  RID rid;
+
+  // create and fetch header_page
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  ASSERT_EQ(page_id, HEADER_PAGE_ID);
+  (void)header_page;
+
+  // keys like those of a composite index, which share a long tenant prefix and differ in a counter after it
+  auto make_key = [](int64_t key) {
+    GenericKey<32> index_key;
+    memset(index_key.data_, 0, sizeof(index_key.data_));
+    memcpy(index_key.data_, "tenant-0000000001:", 18);
+    for (int i = 0; i < 4; i++) {
+      index_key.data_[18 + i] = static_cast<char>((key >> (8 * (3 - i))) & 0xff);
+    }
+    return index_key;
+  };
+  const int64_t num_keys = 20000;
+  std::vector<int64_t> keys;
+  for (int64_t key = 0; key < num_keys; key++) {
+    keys.push_back(key);
+  }
+  std::shuffle(keys.begin(), keys.end(), std::mt19937(15445));
+  for (auto key : keys) {
+    rid.Set(0, key);
+    EXPECT_TRUE(tree.Insert(make_key(key), rid));
+  }
+
+  // a leaf would hold 101 entries of 32-byte keys, but the shared bytes are only stored once per leaf
+  page_id_t leaf_page_id = tree.GetRootPageId();
+  auto *node = reinterpret_cast<BPlusTreePage *>(bpm->FetchPage(leaf_page_id)->GetData());
+  int height = 1;
+  while (!node->IsLeafPage()) {
+    page_id_t child_page_id = reinterpret_cast<InternalPage *>(node)->ValueAt(0);
+    bpm->UnpinPage(leaf_page_id, false);
+    leaf_page_id = child_page_id;
+    node = reinterpret_cast<BPlusTreePage *>(bpm->FetchPage(leaf_page_id)->GetData());
+    height++;
+  }
+  bpm->UnpinPage(leaf_page_id, false);
+  int num_leaves = 0;
+  while (leaf_page_id != INVALID_PAGE_ID) {
+    auto *leaf = reinterpret_cast<LeafPage *>(bpm->FetchPage(leaf_page_id)->GetData());
+    page_id_t next_page_id = leaf->GetNextPageId();
+    bpm->UnpinPage(leaf_page_id, false);
+    leaf_page_id = next_page_id;
+    num_leaves++;
+  }
+  EXPECT_LT(num_leaves, num_keys / 101);
+  EXPECT_EQ(height, 2);
+
+  // the keys come back whole and in order
+  int64_t current_key = 0;
+  for (auto iterator = tree.Begin(); iterator != tree.End(); ++iterator) {
+    EXPECT_EQ(comparator((*iterator).first, make_key(current_key)), 0);
+    EXPECT_EQ((*iterator).second.GetSlotNum(), current_key);
+    current_key++;
+  }
+  EXPECT_EQ(current_key, num_keys);
+
+  // removes merge the compressed pages, and a key that differs only in its trailing bytes is a different key
+  for (int64_t key = 0; key < num_keys; key++) {
+    if (key % 3 != 0) {
+      tree.Remove(make_key(key));
+    }
+  }
+  std::vector<RID> rids;
+  for (int64_t key = 0; key < num_keys; key++) {
+    rids.clear();
+    EXPECT_EQ(tree.GetValue(make_key(key), &rids), key % 3 == 0);
+  }
+  GenericKey<32> longer_key = make_key(3);
+  longer_key.data_[31] = 1;
+  rids.clear();
+  EXPECT_FALSE(tree.GetValue(longer_key, &rids));
+  EXPECT_TRUE(tree.Insert(longer_key, rid));
+  EXPECT_TRUE(tree.GetValue(longer_key, &rids));
+  for (int64_t key = 0; key < num_keys; key += 3) {
+    tree.Remove(make_key(key));
+  }
+  tree.Remove(longer_key);
+  EXPECT_TRUE(tree.IsEmpty());
+
+  // bulk loading fills the pages by the bytes of their compressed keys
+  BPlusTree<GenericKey<32>, RID, GenericComparator<32>> loaded_tree("bar_pk", bpm, comparator);
+  int64_t next_key = 0;
+  loaded_tree.BulkLoad([&](std::pair<GenericKey<32>, RID> *entry) {
+    if (next_key == num_keys) {
+      return false;
+    }
+    *entry = {make_key(next_key), RID(0, next_key)};
+    next_key++;
+    return true;
+  });
+  for (int64_t key = 0; key < num_keys; key++) {
+    rids.clear();
+    EXPECT_TRUE(loaded_tree.GetValue(make_key(key), &rids));
+  }
+  current_key = 0;
+  for (auto iterator = loaded_tree.Begin(); iterator != loaded_tree.End(); ++iterator) {
+    EXPECT_EQ((*iterator).second.GetSlotNum(), current_key);
+    current_key++;
+  }
+  EXPECT_EQ(current_key, num_keys);
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete disk_manager;
+  delete bpm;
+  remove("test.db");
+  remove("test.log");
+}
+
+template <size_t KeySize>
+void KeySearchHelper() {
+  GenericComparator<KeySize> comparator(nullptr);
+  auto less = [&comparator](const auto &a, const auto &b) { return comparator(a, b) < 0; };
+  std::mt19937 gen(15445);
+  // draw the key bytes from a small alphabet, so that keys share prefixes and probes hit existing keys
+  std::uniform_int_distribution<int> byte(0, 3);
+  auto random_key = [&]() {
+    GenericKey<KeySize> key;
+    for (auto &c : key.data_) {
+      c = static_cast<char>(byte(gen) * 85);
+    }
+    return key;
+  };
+  // store the keys without their trailing zeros, like pages do, in a page with a word to spare at the end
+  auto stored_size = [](const GenericKey<KeySize> &key) {
+    return BPlusTreePage::SignificantSize(key.data_, static_cast<int>(KeySize));
+  };
+  for (int size : {0, 1, 7, 16, 17, 100, 255}) {
+    std::vector<GenericKey<KeySize>> keys;
+    for (int i = 0; i < size; i++) {
+      keys.push_back(random_key());
+    }
+    std::sort(keys.begin(), keys.end(), less);
+    keys.erase(std::unique(keys.begin(), keys.end(), [&](const auto &a, const auto &b) { return !less(a, b); }),
+               keys.end());
+    std::vector<char> page(BUSTUB_PAGE_SIZE * 4);
+    std::vector<uint16_t> offsets;
+    size_t offset = 0;
+    for (const auto &key : keys) {
+      offsets.push_back(static_cast<uint16_t>(offset));
+      page[offset] = static_cast<char>(stored_size(key));
+      memcpy(&page[offset + 1], key.data_, stored_size(key));
+      offset += 1 + stored_size(key);
+    }
+    for (int probe = 0; probe < 200; probe++) {
+      GenericKey<KeySize> key = random_key();
+      auto lower = std::lower_bound(keys.begin(), keys.end(), key, less) - keys.begin();
+      auto upper = std::upper_bound(keys.begin(), keys.end(), key, less) - keys.begin();
+      int count = static_cast<int>(keys.size());
+      int width = static_cast<int>(KeySize);
+      EXPECT_EQ(KeySearch(page.data(), offsets.data(), count, key.data_, stored_size(key), width, false), lower);
+      EXPECT_EQ(KeySearch(page.data(), offsets.data(), count, key.data_, stored_size(key), width, true), upper);
+    }
+  }
+}
+
+TEST(BPlusTreeTests, KeySearchTest) {
+  // keys of up to a word are searched as integers, and the others bytewise
+  KeySearchHelper<4>();
+  KeySearchHelper<8>();
+  KeySearchHelper<16>();
+}
 }  // namespace bustub
@@ -0,0 +1,104 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// key_encoding_test.cpp
+//
+// Identification: test/storage/key_encoding_test.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include <string>
+#include <vector>
+
+#include "catalog/schema.h"
+#include "common/exception.h"
+#include "gtest/gtest.h"
+#include "storage/index/generic_key.h"
+#include "storage/index/key_encoding.h"
+#include "storage/table/tuple.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(KeyEncodingTest, GenericKeyTest) {
+  Column col1{"a", TypeId::INTEGER};
+  Column col2{"b", TypeId::VARCHAR, 16};
+  Column col3{"c", TypeId::DECIMAL};
+  Schema schema({col1, col2, col3});
+  GenericComparator<32> comparator(&schema);
+
+  // Rows in ascending order, which the keys have to sort in as well. NULL sorts first.
+  std::vector<std::vector<Value>> rows = {
+      {ValueFactory::GetNullValueByType(TypeId::INTEGER), ValueFactory::GetVarcharValue("a"),
+       ValueFactory::GetDecimalValue(0)},
+      {ValueFactory::GetIntegerValue(-300), ValueFactory::GetVarcharValue("b"), ValueFactory::GetDecimalValue(0)},
+      {ValueFactory::GetIntegerValue(-1), ValueFactory::GetNullValueByType(TypeId::VARCHAR),
+       ValueFactory::GetDecimalValue(0)},
+      {ValueFactory::GetIntegerValue(-1), ValueFactory::GetVarcharValue(""), ValueFactory::GetDecimalValue(0)},
+      {ValueFactory::GetIntegerValue(-1), ValueFactory::GetVarcharValue("a"), ValueFactory::GetDecimalValue(-2.5)},
+      {ValueFactory::GetIntegerValue(-1), ValueFactory::GetVarcharValue("a"), ValueFactory::GetDecimalValue(-0.0)},
+      {ValueFactory::GetIntegerValue(-1), ValueFactory::GetVarcharValue("a"), ValueFactory::GetDecimalValue(1e-300)},
+      {ValueFactory::GetIntegerValue(-1), ValueFactory::GetVarcharValue(std::string("a\0b", 3)),
+       ValueFactory::GetDecimalValue(0)},
+      {ValueFactory::GetIntegerValue(-1), ValueFactory::GetVarcharValue("ab"), ValueFactory::GetDecimalValue(-7)},
+      {ValueFactory::GetIntegerValue(0), ValueFactory::GetVarcharValue("a"), ValueFactory::GetDecimalValue(0)},
+      {ValueFactory::GetIntegerValue(256), ValueFactory::GetVarcharValue("a"), ValueFactory::GetDecimalValue(0)},
+  };
+  std::vector<GenericKey<32>> keys(rows.size());
+  for (size_t i = 0; i < rows.size(); i++) {
+    keys[i].SetFromKey(Tuple(rows[i], &schema), &schema);
+    for (uint32_t col = 0; col < schema.GetColumnCount(); col++) {
+      Value value = keys[i].ToValue(&schema, col);
+      ASSERT_EQ(rows[i][col].IsNull(), value.IsNull());
+      if (!rows[i][col].IsNull()) {
+        ASSERT_EQ(CmpBool::CmpTrue, value.CompareEquals(rows[i][col]));
+      }
+    }
+  }
+  for (size_t i = 0; i < keys.size(); i++) {
+    for (size_t j = 0; j < keys.size(); j++) {
+      int expected = static_cast<int>(i > j) - static_cast<int>(i < j);
+      ASSERT_EQ(expected, comparator(keys[i], keys[j])) << i << " vs " << j;
+    }
+  }
+
+  // 0.0 and -0.0 are the same key.
+  GenericKey<32> zero;
+  zero.SetFromKey(Tuple({rows[5][0], rows[5][1], ValueFactory::GetDecimalValue(0)}, &schema), &schema);
+  ASSERT_EQ(0, comparator(zero, keys[5]));
+
+  GenericKey<8> small;
+  GenericKey<8> large;
+  small.SetFromInteger(-5);
+  large.SetFromInteger(3);
+  ASSERT_EQ(-5, small.ToString());
+  ASSERT_EQ(3, large.ToString());
+  ASSERT_EQ(-1, GenericComparator<8>(&schema)(small, large));
+
+  // Keys that do not fit into the key size are rejected.
+  GenericKey<8> too_long;
+  ASSERT_THROW(too_long.SetFromKey(Tuple(rows[1], &schema), &schema), Exception);
+
+  // The widest key takes the integer, the 16 byte string with its terminator, and the decimal.
+  ASSERT_EQ(4 + 16 + 2 + 8, MaxEncodedKeySize(&schema));
+
+  // Padding the values of the leading columns makes the smallest and the greatest keys that start with them.
+  GenericKey<32> first;
+  GenericKey<32> last;
+  first.SetFromPrefix({ValueFactory::GetIntegerValue(-1)}, '\x00');
+  last.SetFromPrefix({ValueFactory::GetIntegerValue(-1)}, '\xff');
+  ASSERT_EQ(1, comparator(first, keys[1]));
+  ASSERT_EQ(-1, comparator(first, keys[2]));
+  ASSERT_EQ(1, comparator(last, keys[8]));
+  ASSERT_EQ(-1, comparator(last, keys[9]));
+  first.SetFromPrefix({ValueFactory::GetIntegerValue(-1), ValueFactory::GetVarcharValue("a")}, '\x00');
+  last.SetFromPrefix({ValueFactory::GetIntegerValue(-1), ValueFactory::GetVarcharValue("a")}, '\xff');
+  ASSERT_EQ(1, comparator(first, keys[3]));
+  ASSERT_EQ(-1, comparator(first, keys[4]));
+  ASSERT_EQ(1, comparator(last, keys[6]));
+  ASSERT_EQ(-1, comparator(last, keys[7]));
+}
+
+}  // namespace bustub
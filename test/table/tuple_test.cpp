@@ -13,14 +13,28 @@
 #include <algorithm>
 #include <cstdio>
 #include <iostream>
+#include <numeric>
 #include <string>
+#include <thread>  // NOLINT
+#include <unordered_map>
 #include <vector>
 
 #include "buffer/buffer_pool_manager_instance.h"
+#include "catalog/catalog.h"
+#include "execution/executors/aggregation_executor.h"
+#include "execution/executors/seq_scan_executor.h"
 #include "gtest/gtest.h"
 #include "logging/common.h"
+#include "execution/expressions/arithmetic_expression.h"
+#include "execution/expressions/column_value_expression.h"
+#include "execution/expressions/comparison_expression.h"
+#include "execution/expressions/constant_value_expression.h"
+#include "execution/expressions/logic_expression.h"
+#include "storage/page/overflow_page.h"
 #include "storage/table/table_heap.h"
 #include "storage/table/tuple.h"
+#include "storage/table/tuple_builder.h"
+#include "type/arena_pool.h"
 
 namespace bustub {
 // NOLINTNEXTLINE
@@ -71,4 +85,729 @@ TEST(TupleTest, DISABLED_TableHeapTest) {
   delete disk_manager;
 }
 
+// NOLINTNEXTLINE
+TEST(TupleTest, PaxTableHeapTest) {
+  Column col1{"a", TypeId::INTEGER};
+  Column col2{"b", TypeId::BIGINT};
+  Column col3{"c", TypeId::INTEGER};
+  Schema schema{{col1, col2, col3}};
+
+  auto *transaction = new Transaction(0);
+  auto *disk_manager = new DiskManager("test.db");
+  auto *buffer_pool_manager = new BufferPoolManagerInstance(50, disk_manager);
+  auto *lock_manager = new LockManager();
+  auto *log_manager = new LogManager(disk_manager);
+  auto *table =
+      new TableHeap(buffer_pool_manager, lock_manager, log_manager, transaction, &schema, TableStorageFormat::PAX);
+
+  std::vector<RID> rid_v;
+  for (int i = 0; i < 2000; ++i) {
+    RID rid;
+    Value b = i % 7 == 0 ? ValueFactory::GetNullValueByType(TypeId::BIGINT)
+                         : Value(TypeId::BIGINT, static_cast<int64_t>(i) * 2);
+    Tuple tuple{{Value(TypeId::INTEGER, i), b, Value(TypeId::INTEGER, -i)}, &schema};
+    ASSERT_TRUE(table->InsertTuple(tuple, &rid, transaction));
+    rid_v.push_back(rid);
+  }
+  ASSERT_NE(rid_v.front().GetPageId(), rid_v.back().GetPageId());
+
+  int i = 0;
+  for (auto itr = table->Begin(transaction); itr != table->End(); ++itr, ++i) {
+    ASSERT_EQ(itr->GetValue(&schema, 0).GetAs<int32_t>(), i);
+    // The null bitmap survives being split across the minipages.
+    ASSERT_EQ(i % 7 == 0, itr->IsNull(&schema, 1));
+    if (i % 7 != 0) {
+      ASSERT_EQ(itr->GetValue(&schema, 1).GetAs<int64_t>(), static_cast<int64_t>(i) * 2);
+    }
+    ASSERT_EQ(itr->GetValue(&schema, 2).GetAs<int32_t>(), -i);
+  }
+  ASSERT_EQ(i, 2000);
+
+  // Delete every other tuple, then read the remaining values of one column page by page.
+  for (size_t j = 0; j < rid_v.size(); j += 2) {
+    ASSERT_TRUE(table->MarkDelete(rid_v[j], transaction));
+    table->ApplyDelete(rid_v[j], transaction);
+  }
+  std::vector<char> values;
+  std::vector<RID> rids;
+  for (auto page_id = table->GetFirstPageId(); page_id != INVALID_PAGE_ID;) {
+    page_id = table->ReadColumnChunk(page_id, 2, &values, &rids);
+  }
+  ASSERT_EQ(rids.size(), 1000);
+  ASSERT_EQ(values.size(), 1000 * sizeof(int32_t));
+  for (size_t j = 0; j < rids.size(); j++) {
+    ASSERT_EQ(rids[j], rid_v[2 * j + 1]);
+    ASSERT_EQ(reinterpret_cast<const int32_t *>(values.data())[j], -static_cast<int32_t>(2 * j + 1));
+  }
+
+  // A filtered scan of a PAX table selects on column chunks and reads only the matching tuples in full.
+  auto *catalog = new Catalog(buffer_pool_manager, nullptr, nullptr);
+  auto *table_info = catalog->CreateTable(transaction, "t", schema, true, TableStorageFormat::PAX);
+  for (int j = 0; j < 2000; ++j) {
+    RID rid;
+    Value b = j % 7 == 0 ? ValueFactory::GetNullValueByType(TypeId::BIGINT)
+                         : Value(TypeId::BIGINT, static_cast<int64_t>(j) * 2);
+    Tuple tuple{{Value(TypeId::INTEGER, j), b, Value(TypeId::INTEGER, -j)}, &schema};
+    ASSERT_TRUE(table_info->table_->InsertTuple(tuple, &rid, transaction));
+  }
+  auto scan_ids = [&](const AbstractExpressionRef &filter) {
+    SeqScanPlanNode plan{std::make_shared<Schema>(schema), table_info->oid_, "t", filter};
+    ExecutorContext exec_ctx{transaction, catalog, buffer_pool_manager, nullptr, nullptr};
+    SeqScanExecutor executor{&exec_ctx, &plan};
+    executor.Init();
+    std::vector<int32_t> ids;
+    Tuple tuple;
+    RID rid;
+    while (executor.Next(&tuple, &rid)) {
+      ids.push_back(tuple.GetValue(&schema, 0).GetAs<int32_t>());
+    }
+    return ids;
+  };
+  auto col_a = std::make_shared<ColumnValueExpression>(0, 0, TypeId::INTEGER);
+  auto col_b = std::make_shared<ColumnValueExpression>(0, 1, TypeId::BIGINT);
+  auto col_c = std::make_shared<ColumnValueExpression>(0, 2, TypeId::INTEGER);
+  auto hundred = std::make_shared<ConstantValueExpression>(ValueFactory::GetIntegerValue(100));
+  auto below_hundred = std::make_shared<ComparisonExpression>(hundred, col_a, ComparisonType::GreaterThan);
+  std::vector<int32_t> expected(100);
+  std::iota(expected.begin(), expected.end(), 0);
+  ASSERT_EQ(scan_ids(below_hundred), expected);
+  // Only the first conjunct runs over the chunks; the rest of the predicate is checked on the tuples it selects. NULLs
+  // in the chunk are never selected.
+  auto large_b = std::make_shared<ComparisonExpression>(
+      col_b, std::make_shared<ConstantValueExpression>(ValueFactory::GetIntegerValue(3000)), ComparisonType::GreaterThan);
+  auto not_1600 = std::make_shared<ComparisonExpression>(
+      col_c, std::make_shared<ConstantValueExpression>(ValueFactory::GetIntegerValue(-1600)), ComparisonType::NotEqual);
+  expected.clear();
+  for (int32_t j = 1501; j < 2000; j++) {
+    if (j % 7 != 0 && j != 1600) {
+      expected.push_back(j);
+    }
+  }
+  ASSERT_EQ(scan_ids(std::make_shared<LogicExpression>(large_b, not_1600, LogicType::And)), expected);
+  delete catalog;
+
+  disk_manager->ShutDown();
+  remove("test.db");  // remove db file
+  remove("test.log");
+  delete table;
+  delete log_manager;
+  delete lock_manager;
+  delete buffer_pool_manager;
+  delete disk_manager;
+  delete transaction;
+}
+
+// NOLINTNEXTLINE
+TEST(TupleTest, ZoneMapTest) {
+  Column col1{"id", TypeId::INTEGER};
+  Column col2{"v", TypeId::INTEGER};
+  Schema schema{{col1, col2}};
+
+  auto *transaction = new Transaction(0);
+  auto *disk_manager = new DiskManager("test.db");
+  auto *buffer_pool_manager = new BufferPoolManagerInstance(50, disk_manager);
+  auto *lock_manager = new LockManager();
+  auto *log_manager = new LogManager(disk_manager);
+  auto *table = new TableHeap(buffer_pool_manager, lock_manager, log_manager, transaction, &schema);
+  auto *zone_map = table->GetZoneMap();
+  ASSERT_NE(zone_map, nullptr);
+
+  std::vector<RID> rid_v;
+  for (int i = 0; i < 1000; ++i) {
+    RID rid;
+    Tuple tuple{{Value(TypeId::INTEGER, i), Value(TypeId::INTEGER, i % 7)}, &schema};
+    ASSERT_TRUE(table->InsertTuple(tuple, &rid, transaction));
+    rid_v.push_back(rid);
+  }
+
+  // Ids are inserted in order, so every page covers a disjoint id range; the chain follows the pages.
+  int pages = 0;
+  int expected_min = 0;
+  for (auto page_id = table->GetFirstPageId(); page_id != INVALID_PAGE_ID; page_id = zone_map->GetNextPageId(page_id)) {
+    auto range = zone_map->GetRange(page_id, 0);
+    ASSERT_TRUE(range.has_value());
+    ASSERT_EQ(range->first.GetAs<int32_t>(), expected_min);
+    expected_min = range->second.GetAs<int32_t>() + 1;
+    auto v_range = zone_map->GetRange(page_id, 1);
+    ASSERT_EQ(v_range->first.GetAs<int32_t>(), 0);
+    ASSERT_EQ(v_range->second.GetAs<int32_t>(), 6);
+    pages++;
+  }
+  ASSERT_GT(pages, 1);
+  ASSERT_EQ(expected_min, 1000);
+
+  // Updates widen the summary of their page.
+  Tuple updated{{Value(TypeId::INTEGER, 5000), Value(TypeId::INTEGER, 0)}, &schema};
+  ASSERT_TRUE(table->UpdateTuple(updated, rid_v[0], transaction));
+  ASSERT_EQ(zone_map->GetRange(rid_v[0].GetPageId(), 0)->second.GetAs<int32_t>(), 5000);
+
+  disk_manager->ShutDown();
+  remove("test.db");  // remove db file
+  remove("test.log");
+  delete table;
+  delete log_manager;
+  delete lock_manager;
+  delete buffer_pool_manager;
+  delete disk_manager;
+  delete transaction;
+}
+
+// NOLINTNEXTLINE
+TEST(TupleTest, VacuumTest) {
+  Column col1{"id", TypeId::INTEGER};
+  Column col2{"name", TypeId::VARCHAR, 32};
+  Schema schema{{col1, col2}};
+
+  auto *transaction = new Transaction(0);
+  auto *disk_manager = new DiskManager("test.db");
+  auto *buffer_pool_manager = new BufferPoolManagerInstance(50, disk_manager);
+  auto *lock_manager = new LockManager();
+  auto *log_manager = new LogManager(disk_manager);
+  auto *table = new TableHeap(buffer_pool_manager, lock_manager, log_manager, transaction, &schema);
+
+  auto count_pages = [&]() {
+    int pages = 0;
+    for (auto page_id = table->GetFirstPageId(); page_id != INVALID_PAGE_ID;
+         page_id = table->GetZoneMap()->GetNextPageId(page_id)) {
+      pages++;
+    }
+    return pages;
+  };
+
+  std::vector<RID> rid_v;
+  for (int i = 0; i < 2000; ++i) {
+    RID rid;
+    Tuple tuple{{Value(TypeId::INTEGER, i), Value(TypeId::VARCHAR, std::to_string(i))}, &schema};
+    ASSERT_TRUE(table->InsertTuple(tuple, &rid, transaction));
+    rid_v.push_back(rid);
+  }
+  int pages_before = count_pages();
+
+  // Without deletes there is nothing to reclaim, so no page is touched.
+  ASSERT_FALSE(table->HasPagesToVacuum());
+  ASSERT_EQ(table->Vacuum([](const Tuple &, const RID &, const RID &) { FAIL(); }), 0);
+
+  // Keep every tenth tuple.
+  std::unordered_map<int, RID> expected;
+  for (int i = 0; i < 2000; ++i) {
+    if (i % 10 == 0) {
+      expected[i] = rid_v[i];
+      continue;
+    }
+    ASSERT_TRUE(table->MarkDelete(rid_v[i], transaction));
+    table->ApplyDelete(rid_v[i], transaction);
+  }
+  ASSERT_TRUE(table->HasPagesToVacuum());
+
+  int moved = 0;
+  auto freed = table->Vacuum([&](const Tuple &tuple, const RID &old_rid, const RID &new_rid) {
+    int id = tuple.GetValue(&schema, 0).GetAs<int32_t>();
+    ASSERT_EQ(expected[id], old_rid);
+    expected[id] = new_rid;
+    moved++;
+  });
+  ASSERT_GT(moved, 0);
+  ASSERT_GT(freed, 0);
+  ASSERT_EQ(count_pages(), pages_before - static_cast<int>(freed));
+  ASSERT_FALSE(table->HasPagesToVacuum());
+
+  // Every surviving tuple is reachable at its new RID, and a scan sees exactly the survivors.
+  for (const auto &[id, rid] : expected) {
+    Tuple tuple;
+    ASSERT_TRUE(table->GetTuple(rid, &tuple, transaction));
+    ASSERT_EQ(tuple.GetValue(&schema, 0).GetAs<int32_t>(), id);
+    ASSERT_EQ(tuple.GetValue(&schema, 1).ToString(), std::to_string(id));
+  }
+  size_t scanned = 0;
+  for (auto itr = table->Begin(transaction); itr != table->End(); ++itr) {
+    scanned++;
+  }
+  ASSERT_EQ(scanned, expected.size());
+
+  disk_manager->ShutDown();
+  remove("test.db");  // remove db file
+  remove("test.log");
+  delete table;
+  delete log_manager;
+  delete lock_manager;
+  delete buffer_pool_manager;
+  delete disk_manager;
+  delete transaction;
+}
+
+// NOLINTNEXTLINE
+TEST(TupleTest, DictionaryEncodingTest) {
+  auto dictionary = std::make_shared<StringDictionary>();
+  Column col1{"id", TypeId::INTEGER};
+  Column col2{"status", TypeId::VARCHAR, 16, dictionary};
+  Schema schema{{col1, col2}};
+  ASSERT_TRUE(schema.IsInlined());
+  // One byte of null bitmap, the integer and the dictionary code.
+  ASSERT_EQ(schema.GetLength(), 9);
+
+  const std::vector<std::string> statuses{"open", "closed", "pending"};
+  std::vector<Tuple> tuples;
+  for (int i = 0; i < 30; i++) {
+    tuples.emplace_back(std::vector<Value>{Value(TypeId::INTEGER, i), Value(TypeId::VARCHAR, statuses[i % 3])},
+                        &schema);
+  }
+  tuples.emplace_back(std::vector<Value>{Value(TypeId::INTEGER, 30), ValueFactory::GetNullValueByType(TypeId::VARCHAR)},
+                      &schema);
+  ASSERT_EQ(dictionary->Size(), 3);
+  for (int i = 0; i < 30; i++) {
+    ASSERT_EQ(tuples[i].GetLength(), schema.GetLength());
+    ASSERT_EQ(tuples[i].GetValue(&schema, 1).ToString(), statuses[i % 3]);
+    ASSERT_EQ(tuples[i].GetDictionaryCode(&schema, 1), i % 3);
+  }
+  ASSERT_TRUE(tuples[30].IsNull(&schema, 1));
+
+  // Equality against a constant is decided on the codes, including constants no tuple holds.
+  auto column = std::make_shared<ColumnValueExpression>(0, 1, TypeId::VARCHAR);
+  auto closed = std::make_shared<ConstantValueExpression>(Value(TypeId::VARCHAR, "closed"));
+  auto eq_closed = ComparisonExpression(column, closed, ComparisonType::Equal);
+  auto ne_missing = ComparisonExpression(
+      std::make_shared<ConstantValueExpression>(Value(TypeId::VARCHAR, "archived")), column, ComparisonType::NotEqual);
+  for (int i = 0; i < 30; i++) {
+    ASSERT_EQ(eq_closed.Evaluate(&tuples[i], schema).GetAs<bool>(), i % 3 == 1);
+    ASSERT_TRUE(ne_missing.Evaluate(&tuples[i], schema).GetAs<bool>());
+  }
+  ASSERT_TRUE(eq_closed.Evaluate(&tuples[30], schema).IsNull());
+  ASSERT_EQ(dictionary->Size(), 3);
+
+  // A constant that was missing from the dictionary is found once a tuple adds it.
+  auto eq_archived = ComparisonExpression(
+      column, std::make_shared<ConstantValueExpression>(Value(TypeId::VARCHAR, "archived")), ComparisonType::Equal);
+  ASSERT_FALSE(eq_archived.Evaluate(&tuples[0], schema).GetAs<bool>());
+  tuples.emplace_back(std::vector<Value>{Value(TypeId::INTEGER, 31), Value(TypeId::VARCHAR, "archived")}, &schema);
+  ASSERT_TRUE(eq_archived.Evaluate(&tuples[31], schema).GetAs<bool>());
+  ASSERT_FALSE(eq_archived.Evaluate(&tuples[0], schema).GetAs<bool>());
+
+  // GROUP BY on the column groups on the codes and decodes the strings of the groups.
+  auto *transaction = new Transaction(0);
+  auto *disk_manager = new DiskManager("test.db");
+  auto *buffer_pool_manager = new BufferPoolManagerInstance(50, disk_manager);
+  auto *catalog = new Catalog(buffer_pool_manager, nullptr, nullptr);
+  auto *table_info = catalog->CreateTable(transaction, "t", schema);
+  for (const auto &tuple : tuples) {
+    RID rid;
+    ASSERT_TRUE(table_info->table_->InsertTuple(tuple, &rid, transaction));
+  }
+  auto table_schema = std::make_shared<Schema>(schema);
+  auto scan = std::make_shared<SeqScanPlanNode>(table_schema, table_info->oid_, "t");
+  auto output = std::make_shared<Schema>(
+      std::vector<Column>{Column{"status", TypeId::VARCHAR, 16}, Column{"count", TypeId::INTEGER}});
+  AggregationPlanNode plan{output, scan, {column}, {column}, {AggregationType::CountStarAggregate}};
+  ExecutorContext exec_ctx{transaction, catalog, buffer_pool_manager, nullptr, nullptr};
+  AggregationExecutor executor{&exec_ctx, &plan, std::make_unique<SeqScanExecutor>(&exec_ctx, scan.get())};
+  executor.Init();
+  std::unordered_map<std::string, int> counts;
+  Tuple tuple;
+  RID rid;
+  while (executor.Next(&tuple, &rid)) {
+    auto status = tuple.GetValue(output.get(), 0);
+    counts[status.IsNull() ? "NULL" : status.ToString()] += tuple.GetValue(output.get(), 1).GetAs<int32_t>();
+  }
+  std::unordered_map<std::string, int> expected{
+      {"open", 10}, {"closed", 10}, {"pending", 10}, {"archived", 1}, {"NULL", 1}};
+  ASSERT_EQ(counts, expected);
+
+  disk_manager->ShutDown();
+  remove("test.db");  // remove db file
+  remove("test.log");
+  delete catalog;
+  delete buffer_pool_manager;
+  delete disk_manager;
+  delete transaction;
+}
+
+// NOLINTNEXTLINE
+TEST(TupleTest, ParallelScanTest) {
+  Column col1{"id", TypeId::INTEGER};
+  Column col2{"v", TypeId::INTEGER};
+  Column col3{"payload", TypeId::VARCHAR, 128};
+  auto schema = std::make_shared<Schema>(std::vector<Column>{col1, col2, col3});
+
+  auto *transaction = new Transaction(0);
+  auto *disk_manager = new DiskManager("test.db");
+  auto *buffer_pool_manager = new BufferPoolManagerInstance(50, disk_manager);
+  auto *catalog = new Catalog(buffer_pool_manager, nullptr, nullptr);
+  auto *table_info = catalog->CreateTable(transaction, "t", *schema);
+  // Wide enough for the table to outgrow the buffer pool.
+  const int num_tuples = 3000;
+  const std::string payload(100, 'x');
+  for (int i = 0; i < num_tuples; i++) {
+    RID rid;
+    Tuple tuple{{Value(TypeId::INTEGER, i), Value(TypeId::INTEGER, i % 10), Value(TypeId::VARCHAR, payload)},
+                schema.get()};
+    ASSERT_TRUE(table_info->table_->InsertTuple(tuple, &rid, transaction));
+  }
+  auto page_ids = table_info->table_->GetPageIds();
+  ASSERT_GT(page_ids.size(), 4 * SCAN_MORSEL_SIZE);
+
+  // Threads sharing a queue take every page exactly once.
+  MorselQueue queue{page_ids, SCAN_MORSEL_SIZE};
+  std::vector<std::vector<page_id_t>> taken(4);
+  std::vector<std::thread> threads;
+  for (auto &pages : taken) {
+    threads.emplace_back([&queue, &pages] {
+      std::vector<page_id_t> morsel;
+      while (queue.Next(&morsel)) {
+        pages.insert(pages.end(), morsel.begin(), morsel.end());
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  std::vector<page_id_t> all_taken;
+  for (const auto &pages : taken) {
+    all_taken.insert(all_taken.end(), pages.begin(), pages.end());
+  }
+  std::sort(all_taken.begin(), all_taken.end());
+  auto sorted_page_ids = page_ids;
+  std::sort(sorted_page_ids.begin(), sorted_page_ids.end());
+  ASSERT_EQ(all_taken, sorted_page_ids);
+
+  // A filtered scan spread over several threads returns every match once.
+  auto saved_threads = parallel_scan_threads;
+  parallel_scan_threads = 4;
+  auto column = std::make_shared<ColumnValueExpression>(0, 1, TypeId::INTEGER);
+  auto three = std::make_shared<ConstantValueExpression>(ValueFactory::GetIntegerValue(3));
+  auto filter = std::make_shared<ComparisonExpression>(column, three, ComparisonType::Equal);
+  SeqScanPlanNode plan{schema, table_info->oid_, "t", filter};
+  ExecutorContext exec_ctx{transaction, catalog, buffer_pool_manager, nullptr, nullptr};
+  SeqScanExecutor executor{&exec_ctx, &plan};
+  for (int round = 0; round < 2; round++) {
+    executor.Init();
+    std::vector<int32_t> ids;
+    Tuple tuple;
+    RID rid;
+    while (executor.Next(&tuple, &rid)) {
+      ASSERT_EQ(tuple.GetValue(schema.get(), 1).GetAs<int32_t>(), 3);
+      ids.push_back(tuple.GetValue(schema.get(), 0).GetAs<int32_t>());
+    }
+    std::sort(ids.begin(), ids.end());
+    ASSERT_EQ(ids.size(), num_tuples / 10);
+    for (size_t i = 0; i < ids.size(); i++) {
+      ASSERT_EQ(ids[i], static_cast<int32_t>(i * 10 + 3));
+    }
+  }
+
+  // A scan that is abandoned early stops its workers.
+  {
+    SeqScanPlanNode full_plan{schema, table_info->oid_, "t"};
+    SeqScanExecutor abandoned{&exec_ctx, &full_plan};
+    abandoned.Init();
+    Tuple tuple;
+    RID rid;
+    ASSERT_TRUE(abandoned.Next(&tuple, &rid));
+  }
+
+  // An exception thrown by a worker stops the scan and is rethrown to the consumer.
+  {
+    auto id = std::make_shared<ColumnValueExpression>(0, 0, TypeId::INTEGER);
+    auto large = std::make_shared<ConstantValueExpression>(ValueFactory::GetIntegerValue(BUSTUB_INT32_MAX - 1000));
+    auto sum = std::make_shared<ArithmeticExpression>(id, large, ArithmeticType::Plus);
+    auto overflow = std::make_shared<ComparisonExpression>(sum, three, ComparisonType::GreaterThan);
+    SeqScanPlanNode failing_plan{schema, table_info->oid_, "t", overflow};
+    SeqScanExecutor failing{&exec_ctx, &failing_plan};
+    failing.Init();
+    Tuple tuple;
+    RID rid;
+    ASSERT_THROW(
+        {
+          while (failing.Next(&tuple, &rid)) {
+          }
+        },
+        Exception);
+  }
+  parallel_scan_threads = saved_threads;
+
+  disk_manager->ShutDown();
+  remove("test.db");  // remove db file
+  remove("test.log");
+  delete catalog;
+  delete buffer_pool_manager;
+  delete disk_manager;
+  delete transaction;
+}
+
+// NOLINTNEXTLINE
+TEST(TupleTest, ColumnAccessorTest) {
+  Schema schema({Column{"a", TypeId::INTEGER}, Column{"b", TypeId::VARCHAR, 16}, Column{"c", TypeId::BIGINT},
+                 Column{"a", TypeId::DECIMAL}, Column{"d", TypeId::BOOLEAN}});
+
+  // Lookups by name find the first column with the name.
+  EXPECT_EQ(0, schema.GetColIdx("a"));
+  EXPECT_EQ(2, schema.GetColIdx("c"));
+  EXPECT_EQ(std::nullopt, schema.TryGetColIdx("e"));
+
+  EXPECT_TRUE(schema.GetAccessor(0).inlined_);
+  EXPECT_FALSE(schema.GetAccessor(1).inlined_);
+  EXPECT_EQ(TypeId::BIGINT, schema.GetAccessor(2).type_);
+  EXPECT_EQ(schema.GetColumn(3).GetOffset(), schema.GetAccessor(3).offset_);
+
+  Tuple tuple({ValueFactory::GetIntegerValue(-7), ValueFactory::GetVarcharValue("bustub"),
+               ValueFactory::GetBigIntValue(int64_t{1} << 40), ValueFactory::GetDecimalValue(2.5),
+               ValueFactory::GetBooleanValue(true)},
+              &schema);
+  EXPECT_EQ(-7, tuple.GetInt32(&schema, 0));
+  EXPECT_EQ(int64_t{1} << 40, tuple.GetInt64(&schema, 2));
+  EXPECT_EQ(2.5, tuple.GetDecimal(&schema, 3));
+  EXPECT_EQ(1, tuple.GetBoolean(&schema, 4));
+  EXPECT_EQ("bustub", tuple.GetValue(&schema, 1).ToString());
+  for (uint32_t i = 0; i < schema.GetColumnCount(); i++) {
+    EXPECT_FALSE(tuple.IsNull(&schema, i));
+  }
+
+  std::vector<Value> nulls;
+  for (const auto &col : schema.GetColumns()) {
+    nulls.push_back(ValueFactory::GetNullValueByType(col.GetType()));
+  }
+  Tuple null_tuple(nulls, &schema);
+  for (uint32_t i = 0; i < schema.GetColumnCount(); i++) {
+    EXPECT_TRUE(null_tuple.IsNull(&schema, i));
+    EXPECT_TRUE(null_tuple.GetValue(&schema, i).IsNull());
+  }
+  EXPECT_EQ(BUSTUB_INT32_NULL, null_tuple.GetInt32(&schema, 0));
+}
+
+// NOLINTNEXTLINE
+TEST(TupleTest, TupleBuilderTest) {
+  Schema schema({Column{"a", TypeId::INTEGER}, Column{"b", TypeId::VARCHAR, 64}, Column{"c", TypeId::BIGINT},
+                 Column{"d", TypeId::VARCHAR, 64}, Column{"e", TypeId::DECIMAL}});
+  std::vector<std::vector<Value>> rows = {
+      {ValueFactory::GetIntegerValue(1), ValueFactory::GetVarcharValue("a string that is longer than inline"),
+       ValueFactory::GetBigIntValue(-2), ValueFactory::GetVarcharValue("short"), ValueFactory::GetDecimalValue(0.5)},
+      {ValueFactory::GetIntegerValue(3), ValueFactory::GetNullValueByType(TypeId::VARCHAR),
+       ValueFactory::GetBigIntValue(4), ValueFactory::GetVarcharValue(""), ValueFactory::GetDecimalValue(-1.5)},
+      {ValueFactory::GetIntegerValue(5), ValueFactory::GetVarcharValue("x"), ValueFactory::GetBigIntValue(6),
+       ValueFactory::GetVarcharValue("y"), ValueFactory::GetDecimalValue(2)},
+  };
+
+  TupleBuilder builder(&schema);
+  ArenaPool pool;
+  Tuple output;
+  for (const auto &row : rows) {
+    Tuple expected(row, &schema);
+    builder.Reset();
+    for (const auto &value : row) {
+      builder.Append(value);
+    }
+    ASSERT_EQ(expected.GetLength(), builder.GetSize());
+
+    // A tuple that already owns a buffer of the size of the row keeps it.
+    Tuple same_size(row, &schema);
+    const char *buffer = same_size.GetData();
+    builder.Build(&same_size);
+    ASSERT_EQ(buffer, same_size.GetData());
+    ASSERT_EQ(0, memcmp(expected.GetData(), same_size.GetData(), expected.GetLength()));
+
+    builder.Build(&output);
+    ASSERT_EQ(expected.GetLength(), output.GetLength());
+    ASSERT_EQ(0, memcmp(expected.GetData(), output.GetData(), expected.GetLength()));
+    for (uint32_t i = 0; i < schema.GetColumnCount(); i++) {
+      Value value = output.GetValue(&schema, i);
+      ASSERT_EQ(row[i].IsNull(), value.IsNull());
+      ASSERT_TRUE(value.IsNull() || value.CompareEquals(row[i]) == CmpBool::CmpTrue);
+    }
+
+    Tuple pooled = builder.Build(&pool);
+    ASSERT_EQ(0, memcmp(expected.GetData(), pooled.GetData(), expected.GetLength()));
+    pooled.Release(&pool);
+
+    std::vector<char> dest(builder.GetSize());
+    builder.CopyTo(dest.data());
+    ASSERT_EQ(0, memcmp(expected.GetData(), dest.data(), expected.GetLength()));
+  }
+
+  // Fixed-width columns can be appended without going through Value.
+  Schema fixed({Column{"a", TypeId::INTEGER}, Column{"b", TypeId::BIGINT}});
+  TupleBuilder fixed_builder(&fixed);
+  fixed_builder.AppendNative<int32_t>(7);
+  fixed_builder.AppendNative<int64_t>(-8);
+  fixed_builder.Build(&output);
+  ASSERT_EQ(7, output.GetInt32(&fixed, 0));
+  ASSERT_EQ(-8, output.GetInt64(&fixed, 1));
+}
+
+// NOLINTNEXTLINE
+TEST(TupleTest, NullBitmapTest) {
+  std::vector<Column> columns;
+  for (int i = 0; i < 10; i++) {
+    std::string name = "c" + std::to_string(i);
+    columns.push_back(i % 3 == 2 ? Column{name, TypeId::VARCHAR, 16} : Column{name, TypeId::INTEGER});
+  }
+  Schema schema(columns);
+  ASSERT_EQ(2, schema.GetNullBitmapSize());
+  ASSERT_EQ(2, schema.GetColumn(0).GetOffset());
+
+  std::vector<Value> values;
+  for (int i = 0; i < 10; i++) {
+    TypeId type = schema.GetColumn(i).GetType();
+    if (i % 4 == 1) {
+      values.push_back(ValueFactory::GetNullValueByType(type));
+    } else if (type == TypeId::VARCHAR) {
+      values.push_back(ValueFactory::GetVarcharValue(std::to_string(i)));
+    } else {
+      values.push_back(ValueFactory::GetIntegerValue(i));
+    }
+  }
+  Tuple tuple(values, &schema);
+  TupleBuilder builder(&schema);
+  for (const auto &value : values) {
+    builder.Append(value);
+  }
+  Tuple built;
+  builder.Build(&built);
+  ASSERT_EQ(0, memcmp(tuple.GetData(), built.GetData(), tuple.GetLength()));
+  for (uint32_t i = 0; i < 10; i++) {
+    ASSERT_EQ(i % 4 == 1, tuple.IsNull(&schema, i)) << i;
+    ASSERT_EQ(i % 4 == 1, tuple.GetValue(&schema, i).IsNull()) << i;
+  }
+  // Columns 1, 5 and 9 are NULL.
+  ASSERT_EQ(0x22, tuple.GetNullBitmap()[0]);
+  ASSERT_EQ(0x02, tuple.GetNullBitmap()[1]);
+
+  // The builder clears the null bitmap between rows, and treats the NULL sentinel of a native value as NULL.
+  Schema fixed({Column{"a", TypeId::INTEGER}, Column{"b", TypeId::BIGINT}, Column{"c", TypeId::DECIMAL}});
+  TupleBuilder fixed_builder(&fixed);
+  fixed_builder.AppendNative<int32_t>(BUSTUB_INT32_NULL);
+  fixed_builder.AppendNative<int64_t>(1);
+  fixed_builder.AppendNative<double>(BUSTUB_DECIMAL_NULL);
+  fixed_builder.Build(&built);
+  ASSERT_TRUE(built.IsNull(&fixed, 0));
+  ASSERT_FALSE(built.IsNull(&fixed, 1));
+  ASSERT_TRUE(built.IsNull(&fixed, 2));
+  fixed_builder.Reset();
+  fixed_builder.AppendNative<int32_t>(2);
+  fixed_builder.AppendNative<int64_t>(BUSTUB_INT64_NULL);
+  fixed_builder.AppendNative<double>(0.5);
+  fixed_builder.Build(&built);
+  ASSERT_FALSE(built.IsNull(&fixed, 0));
+  ASSERT_TRUE(built.IsNull(&fixed, 1));
+  ASSERT_FALSE(built.IsNull(&fixed, 2));
+  ASSERT_EQ(fixed.GetLength(), built.GetLength());
+
+  // Batches take their null mask from the null bitmaps.
+  std::vector<Tuple> batch;
+  for (int i = 0; i < 20; i++) {
+    Value a = i % 3 == 0 ? ValueFactory::GetNullValueByType(TypeId::INTEGER) : ValueFactory::GetIntegerValue(i);
+    batch.emplace_back(std::vector<Value>{a, ValueFactory::GetBigIntValue(i), ValueFactory::GetDecimalValue(i)},
+                       &fixed);
+  }
+  ColumnValueExpression column(0, 0, TypeId::INTEGER);
+  auto vector = column.EvaluateBatch(batch, fixed);
+  ASSERT_EQ(20, vector.GetSize());
+  for (size_t i = 0; i < 20; i++) {
+    ASSERT_EQ(i % 3 == 0, vector.IsNull(i)) << i;
+  }
+  ASSERT_EQ(13, CountColumn(vector));
+}
+
+// NOLINTNEXTLINE
+TEST(TupleTest, OverflowTest) {
+  Schema schema({Column{"a", TypeId::INTEGER}, Column{"b", TypeId::VARCHAR, 32}, Column{"c", TypeId::VARCHAR, 32}});
+  auto *transaction = new Transaction(0);
+  auto *disk_manager = new DiskManager("test.db");
+  auto *buffer_pool_manager = new BufferPoolManagerInstance(50, disk_manager);
+  auto *lock_manager = new LockManager();
+  auto *log_manager = new LogManager(disk_manager);
+  auto *table = new TableHeap(buffer_pool_manager, lock_manager, log_manager, transaction, &schema);
+
+  // Values of several pages, of exactly one page of overflow data, and values that fit into the tuple.
+  std::vector<std::string> payloads{std::string(3 * BUSTUB_PAGE_SIZE + 17, 'x'),
+                                    std::string(OverflowPage::CAPACITY - 1, 'y'), "small"};
+  std::vector<RID> rids;
+  for (size_t i = 0; i < payloads.size(); i++) {
+    Tuple tuple({ValueFactory::GetIntegerValue(static_cast<int32_t>(i)), ValueFactory::GetVarcharValue(payloads[i]),
+                 ValueFactory::GetVarcharValue("tail")},
+                &schema);
+    RID rid;
+    ASSERT_TRUE(table->InsertTuple(tuple, &rid, transaction));
+    rids.push_back(rid);
+  }
+
+  size_t i = 0;
+  for (auto itr = table->Begin(transaction); itr != table->End(); ++itr, ++i) {
+    ASSERT_EQ(i < 2, itr->IsOverflowed(&schema, 1));
+    ASSERT_FALSE(itr->IsOverflowed(&schema, 2));
+    ASSERT_LE(itr->GetLength(), BUSTUB_PAGE_SIZE);
+    // The other columns are read without the overflow chain.
+    ASSERT_EQ(static_cast<int32_t>(i), itr->GetInt32(&schema, 0));
+    ASSERT_EQ("tail", itr->GetValue(&schema, 2).ToString());
+    ASSERT_EQ(payloads[i], itr->GetValue(&schema, 1).ToString());
+  }
+  ASSERT_EQ(payloads.size(), i);
+
+  // Inserting a tuple read from the table gives the copy chains of its own.
+  Tuple original;
+  ASSERT_TRUE(table->GetTuple(rids[0], &original, transaction));
+  RID copy_rid;
+  ASSERT_TRUE(table->InsertTuple(original, &copy_rid, transaction));
+  Tuple copy;
+  ASSERT_TRUE(table->GetTuple(copy_rid, &copy, transaction));
+  ASSERT_NE(original.GetOverflowPageId(&schema, 1), copy.GetOverflowPageId(&schema, 1));
+  ASSERT_TRUE(table->MarkDelete(rids[0], transaction));
+  table->ApplyDelete(rids[0], transaction);
+  ASSERT_EQ(payloads[0], copy.GetValue(&schema, 1).ToString());
+
+  // An in-place update keeps the chains it replaced until commit, so that the old tuple can be written back.
+  auto is_resident = [&](page_id_t page_id) {
+    auto *pages = buffer_pool_manager->GetPages();
+    return std::any_of(pages, pages + buffer_pool_manager->GetPoolSize(),
+                       [&](Page &page) { return page.GetPageId() == page_id; });
+  };
+  auto write_set = transaction->GetWriteSet();
+  Tuple replaced;
+  ASSERT_TRUE(table->GetTuple(rids[1], &replaced, transaction));
+  auto chain = replaced.GetOverflowPageId(&schema, 1);
+  Tuple small({ValueFactory::GetIntegerValue(1), ValueFactory::GetVarcharValue("small"),
+               ValueFactory::GetVarcharValue("tail")},
+              &schema);
+  ASSERT_TRUE(table->UpdateTuple(small, rids[1], transaction));
+  ASSERT_EQ(std::vector<page_id_t>{chain}, write_set->back().overflow_chains_);
+  Tuple old_image = write_set->back().tuple_;
+  write_set->pop_back();
+  ASSERT_TRUE(table->UpdateTuple(old_image, rids[1], transaction));
+  ASSERT_TRUE(write_set->back().overflow_chains_.empty());
+  write_set->pop_back();
+  Tuple restored;
+  ASSERT_TRUE(table->GetTuple(rids[1], &restored, transaction));
+  ASSERT_EQ(payloads[1], restored.GetValue(&schema, 1).ToString());
+  // Writing the tuple back unchanged replaces none of its chains; committing a real change frees them.
+  ASSERT_TRUE(table->UpdateTuple(restored, rids[1], transaction));
+  ASSERT_TRUE(write_set->back().overflow_chains_.empty());
+  write_set->pop_back();
+  ASSERT_TRUE(table->UpdateTuple(small, rids[1], transaction));
+  ASSERT_TRUE(is_resident(chain));
+  table->ApplyUpdate(write_set->back().overflow_chains_);
+  write_set->pop_back();
+  ASSERT_FALSE(is_resident(chain));
+
+  // A tuple whose values are all too short to be moved out still cannot be stored.
+  std::vector<Column> columns;
+  std::vector<Value> values;
+  for (int j = 0; j < 200; j++) {
+    columns.emplace_back("c" + std::to_string(j), TypeId::VARCHAR, 32);
+    values.push_back(ValueFactory::GetVarcharValue(std::string(30, 'z')));
+  }
+  Schema wide_schema(columns);
+  auto *wide_table = new TableHeap(buffer_pool_manager, lock_manager, log_manager, transaction, &wide_schema);
+  RID rid;
+  ASSERT_FALSE(wide_table->InsertTuple(Tuple(values, &wide_schema), &rid, transaction));
+  ASSERT_EQ(TransactionState::ABORTED, transaction->GetState());
+
+  disk_manager->ShutDown();
+  remove("test.db");  // remove db file
+  remove("test.log");
+  delete wide_table;
+  delete table;
+  delete log_manager;
+  delete lock_manager;
+  delete buffer_pool_manager;
+  delete disk_manager;
+  delete transaction;
+}
+
 }  // namespace bustub
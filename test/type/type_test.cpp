@@ -10,13 +10,26 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <memory>
+#include <numeric>
+#include <random>
+#include <set>
 #include <string>
 #include <utility>
 #include <vector>
 
+#include "catalog/schema.h"
 #include "common/exception.h"
+#include "common/util/hash_util.h"
+#include "execution/expressions/arithmetic_expression.h"
+#include "execution/expressions/column_value_expression.h"
 #include "gtest/gtest.h"
+#include "storage/table/tuple.h"
+#include "type/arena_pool.h"
+#include "type/batch_kernels.h"
+#include "type/type_kernels.h"
 #include "type/value.h"
+#include "type/value_factory.h"
 
 namespace bustub {
 //===--------------------------------------------------------------------===//
@@ -95,4 +108,355 @@ TEST(TypeTests, TemplateTest) {
   BPlusTreePage<Value, Value> node;
   node.GetInfo(val1, val2);
 }
+
+// NOLINTNEXTLINE
+TEST(TypeTests, KernelTest) {
+  const std::vector<TypeId> numeric_types = {TypeId::TINYINT, TypeId::SMALLINT, TypeId::INTEGER, TypeId::BIGINT,
+                                             TypeId::DECIMAL};
+  std::vector<Value> values;
+  for (auto type : numeric_types) {
+    for (int i : {-3, 0, 7}) {
+      values.push_back(ValueFactory::GetIntegerValue(i).CastAs(type));
+    }
+  }
+
+  // The kernels agree with the Type hierarchy on every pair of numeric types.
+  for (const auto &lhs : values) {
+    for (const auto &rhs : values) {
+      auto kernel = GetCompareKernel(lhs.GetTypeId(), rhs.GetTypeId());
+      ASSERT_NE(kernel, nullptr);
+      int cmp = kernel(lhs, rhs);
+      EXPECT_EQ(cmp < 0, lhs.CompareLessThan(rhs) == CmpBool::CmpTrue);
+      EXPECT_EQ(cmp > 0, lhs.CompareGreaterThan(rhs) == CmpBool::CmpTrue);
+      EXPECT_EQ(TypedComparator(lhs.GetTypeId(), rhs.GetTypeId()).Compare(lhs, rhs), cmp);
+
+      for (auto op : {ArithmeticKernelOp::Add, ArithmeticKernelOp::Subtract, ArithmeticKernelOp::Multiply}) {
+        auto result = TypedArithmetic(op, lhs.GetTypeId(), rhs.GetTypeId()).Compute(lhs, rhs);
+        auto expected = op == ArithmeticKernelOp::Add        ? lhs.Add(rhs)
+                        : op == ArithmeticKernelOp::Subtract ? lhs.Subtract(rhs)
+                                                             : lhs.Multiply(rhs);
+        EXPECT_EQ(result.GetTypeId(), expected.GetTypeId());
+        EXPECT_EQ(result.CompareEquals(expected), CmpBool::CmpTrue);
+      }
+    }
+  }
+  EXPECT_EQ(GetCompareKernel(TypeId::VARCHAR, TypeId::INTEGER), nullptr);
+  EXPECT_EQ(GetArithmeticKernel(ArithmeticKernelOp::Add, TypeId::BOOLEAN, TypeId::BOOLEAN), nullptr);
+
+  // Integer overflow throws like it does through the Type hierarchy.
+  auto max = ValueFactory::GetIntegerValue(BUSTUB_INT32_MAX);
+  auto one = ValueFactory::GetIntegerValue(1);
+  EXPECT_THROW(TypedArithmetic(ArithmeticKernelOp::Add, TypeId::INTEGER, TypeId::INTEGER).Compute(max, one), Exception);
+  EXPECT_EQ(TypedArithmetic(ArithmeticKernelOp::Add, TypeId::INTEGER, TypeId::BIGINT)
+                .Compute(max, ValueFactory::GetBigIntValue(1))
+                .GetAs<int64_t>(),
+            static_cast<int64_t>(BUSTUB_INT32_MAX) + 1);
+
+  // Serialized values compare in place, and NULL compares equal to anything.
+  char lhs[sizeof(int32_t)];
+  char rhs[sizeof(int32_t)];
+  auto raw_kernel = GetRawCompareKernel(TypeId::INTEGER);
+  ValueFactory::GetIntegerValue(-5).SerializeTo(lhs);
+  ValueFactory::GetIntegerValue(3).SerializeTo(rhs);
+  EXPECT_LT(raw_kernel(lhs, rhs), 0);
+  EXPECT_GT(raw_kernel(rhs, lhs), 0);
+  ValueFactory::GetNullValueByType(TypeId::INTEGER).SerializeTo(lhs);
+  EXPECT_EQ(raw_kernel(lhs, rhs), 0);
+}
+
+// NOLINTNEXTLINE
+TEST(TypeTests, BatchKernelTest) {
+  // 77 rows leave a tail behind the SIMD registers.
+  const size_t size = 77;
+  std::mt19937 rng(42);
+  std::uniform_int_distribution<int32_t> dist(-20, 20);
+  auto random_value = [&](TypeId type) {
+    if (dist(rng) < -15) {
+      return ValueFactory::GetNullValueByType(type);
+    }
+    switch (type) {
+      case TypeId::BOOLEAN:
+        return ValueFactory::GetBooleanValue(dist(rng) < 0);
+      case TypeId::INTEGER:
+        return ValueFactory::GetIntegerValue(dist(rng));
+      case TypeId::BIGINT:
+        return ValueFactory::GetBigIntValue(dist(rng) * 100000000L);
+      default:
+        return ValueFactory::GetDecimalValue(dist(rng) / 4.0);
+    }
+  };
+
+  const std::vector<std::pair<CompareKernelOp, CmpBool (Value::*)(const Value &) const>> compare_ops = {
+      {CompareKernelOp::Equal, &Value::CompareEquals},
+      {CompareKernelOp::NotEqual, &Value::CompareNotEquals},
+      {CompareKernelOp::LessThan, &Value::CompareLessThan},
+      {CompareKernelOp::LessThanOrEqual, &Value::CompareLessThanEquals},
+      {CompareKernelOp::GreaterThan, &Value::CompareGreaterThan},
+      {CompareKernelOp::GreaterThanOrEqual, &Value::CompareGreaterThanEquals}};
+
+  for (auto type : {TypeId::BOOLEAN, TypeId::INTEGER, TypeId::BIGINT, TypeId::DECIMAL}) {
+    ASSERT_TRUE(HasBatchKernels(type));
+    std::vector<Value> lhs_values;
+    std::vector<Value> rhs_values;
+    for (size_t i = 0; i < size; i++) {
+      lhs_values.push_back(random_value(type));
+      rhs_values.push_back(random_value(type));
+    }
+    auto lhs = ColumnVector::FromValues(type, lhs_values);
+    auto rhs = ColumnVector::FromValues(type, rhs_values);
+    auto constant = rhs_values[0].IsNull() ? rhs_values[1] : rhs_values[0];
+
+    // Selections match comparing the values one by one, and NULL rows are never selected.
+    for (const auto &[op, compare] : compare_ops) {
+      std::vector<uint32_t> expected_columns;
+      std::vector<uint32_t> expected_constant;
+      for (uint32_t i = 0; i < size; i++) {
+        if ((lhs_values[i].*compare)(rhs_values[i]) == CmpBool::CmpTrue) {
+          expected_columns.push_back(i);
+        }
+        if ((lhs_values[i].*compare)(constant) == CmpBool::CmpTrue) {
+          expected_constant.push_back(i);
+        }
+      }
+      std::vector<uint32_t> selection;
+      SelectCompare(op, lhs, rhs, &selection);
+      EXPECT_EQ(selection, expected_columns);
+      selection.clear();
+      SelectCompare(op, lhs, constant, &selection);
+      EXPECT_EQ(selection, expected_constant);
+    }
+
+    // Reductions skip NULLs.
+    size_t count = 0;
+    Value min = ValueFactory::GetNullValueByType(type);
+    Value max = ValueFactory::GetNullValueByType(type);
+    for (const auto &value : lhs_values) {
+      if (value.IsNull()) {
+        continue;
+      }
+      count++;
+      if (min.IsNull() || value.CompareLessThan(min) == CmpBool::CmpTrue) {
+        min = value;
+      }
+      if (max.IsNull() || value.CompareGreaterThan(max) == CmpBool::CmpTrue) {
+        max = value;
+      }
+    }
+    EXPECT_EQ(CountColumn(lhs), count);
+    EXPECT_EQ(MinColumn(lhs).CompareEquals(min), CmpBool::CmpTrue);
+    EXPECT_EQ(MaxColumn(lhs).CompareEquals(max), CmpBool::CmpTrue);
+    EXPECT_TRUE(MinColumn(ColumnVector::FromValues(type, {ValueFactory::GetNullValueByType(type)})).IsNull());
+    if (type == TypeId::BOOLEAN) {
+      EXPECT_THROW(SumColumn(lhs), Exception);
+      EXPECT_THROW(Compute(ArithmeticKernelOp::Add, lhs, rhs), Exception);
+      continue;
+    }
+
+    Value sum = ValueFactory::GetNullValueByType(type);
+    for (const auto &value : lhs_values) {
+      if (!value.IsNull()) {
+        sum = sum.IsNull() ? value : sum.Add(value);
+      }
+    }
+    EXPECT_EQ(SumColumn(lhs).CompareEquals(sum), CmpBool::CmpTrue);
+
+    // Arithmetic matches Value, and is NULL where either side is.
+    for (auto op : {ArithmeticKernelOp::Add, ArithmeticKernelOp::Subtract, ArithmeticKernelOp::Multiply}) {
+      auto result = Compute(op, lhs, rhs);
+      ASSERT_EQ(result.GetSize(), size);
+      for (size_t i = 0; i < size; i++) {
+        if (lhs_values[i].IsNull() || rhs_values[i].IsNull()) {
+          EXPECT_TRUE(result.IsNull(i));
+          continue;
+        }
+        auto expected = op == ArithmeticKernelOp::Add        ? lhs_values[i].Add(rhs_values[i])
+                        : op == ArithmeticKernelOp::Subtract ? lhs_values[i].Subtract(rhs_values[i])
+                                                             : lhs_values[i].Multiply(rhs_values[i]);
+        EXPECT_EQ(result.GetValue(i).CompareEquals(expected), CmpBool::CmpTrue);
+      }
+    }
+  }
+
+  // Serialized values are wrapped as they are, with NULLs found by their sentinel.
+  std::vector<char> data(3 * sizeof(int32_t));
+  ValueFactory::GetIntegerValue(7).SerializeTo(data.data());
+  ValueFactory::GetNullValueByType(TypeId::INTEGER).SerializeTo(data.data() + sizeof(int32_t));
+  ValueFactory::GetIntegerValue(-2).SerializeTo(data.data() + 2 * sizeof(int32_t));
+  ColumnVector serialized(TypeId::INTEGER, std::move(data));
+  ASSERT_EQ(serialized.GetSize(), 3U);
+  EXPECT_TRUE(serialized.IsNull(1));
+  EXPECT_EQ(SumColumn(serialized).GetAs<int32_t>(), 5);
+  EXPECT_EQ(MinColumn(serialized).GetAs<int32_t>(), -2);
+
+  // Integer overflow throws, but not for NULL rows, whose stored value is the sentinel.
+  std::vector<Value> large(size, ValueFactory::GetIntegerValue(BUSTUB_INT32_MAX));
+  std::vector<Value> ones(size, ValueFactory::GetIntegerValue(1));
+  EXPECT_THROW(Compute(ArithmeticKernelOp::Add, ColumnVector::FromValues(TypeId::INTEGER, large),
+                       ColumnVector::FromValues(TypeId::INTEGER, ones)),
+               Exception);
+  EXPECT_THROW(SumColumn(ColumnVector::FromValues(TypeId::INTEGER, large)), Exception);
+  std::vector<Value> nulls(size, ValueFactory::GetNullValueByType(TypeId::INTEGER));
+  auto minus_one = std::vector<Value>(size, ValueFactory::GetIntegerValue(-1));
+  auto result = Compute(ArithmeticKernelOp::Add, ColumnVector(TypeId::INTEGER, std::vector<char>(size * 4, '\0')),
+                        ColumnVector::FromValues(TypeId::INTEGER, minus_one));
+  EXPECT_EQ(result.GetValue(size - 1).GetAs<int32_t>(), -1);
+  auto null_vector = ColumnVector::FromValues(TypeId::INTEGER, nulls);
+  null_vector.GetMutableData<int32_t>()[0] = BUSTUB_INT32_MIN - 1;
+  EXPECT_NO_THROW(Compute(ArithmeticKernelOp::Subtract, null_vector, ColumnVector::FromValues(TypeId::INTEGER, ones)));
+
+  // Arithmetic expressions follow the same overflow rule row by row as in batches.
+  Schema schema{{Column{"a", TypeId::INTEGER}, Column{"b", TypeId::INTEGER}}};
+  auto col_a = std::make_shared<ColumnValueExpression>(0, 0, TypeId::INTEGER);
+  auto col_b = std::make_shared<ColumnValueExpression>(0, 1, TypeId::INTEGER);
+  for (auto type : {ArithmeticType::Plus, ArithmeticType::Minus}) {
+    ArithmeticExpression expr{col_a, col_b, type};
+    int32_t rhs = type == ArithmeticType::Plus ? 1 : -1;
+    std::vector<Tuple> tuples;
+    tuples.emplace_back(std::vector<Value>{ValueFactory::GetIntegerValue(5), ValueFactory::GetIntegerValue(rhs)},
+                        &schema);
+    tuples.emplace_back(
+        std::vector<Value>{ValueFactory::GetIntegerValue(BUSTUB_INT32_MAX), ValueFactory::GetIntegerValue(rhs)},
+        &schema);
+    EXPECT_EQ(expr.Evaluate(&tuples[0], schema).GetAs<int32_t>(), 6);
+    EXPECT_THROW(expr.Evaluate(&tuples[1], schema), Exception);
+    EXPECT_THROW(expr.EvaluateJoin(&tuples[1], schema, &tuples[0], schema), Exception);
+    EXPECT_THROW(expr.EvaluateBatch(tuples, schema), Exception);
+    tuples.pop_back();
+    EXPECT_EQ(expr.EvaluateBatch(tuples, schema).GetValue(0).GetAs<int32_t>(), 6);
+  }
+}
+
+// NOLINTNEXTLINE
+TEST(TypeTests, HashTest) {
+  // Equal values hash equally, whatever their type.
+  auto hash_of = [](const Value &value) { return HashUtil::HashValue(&value); };
+  auto five = hash_of(ValueFactory::GetIntegerValue(5));
+  EXPECT_EQ(hash_of(ValueFactory::GetTinyIntValue(5)), five);
+  EXPECT_EQ(hash_of(ValueFactory::GetBigIntValue(5)), five);
+  EXPECT_NE(hash_of(ValueFactory::GetIntegerValue(6)), five);
+  EXPECT_EQ(hash_of(ValueFactory::GetDecimalValue(0.0)), hash_of(ValueFactory::GetDecimalValue(-0.0)));
+
+  // Every byte counts, including those behind the last full word.
+  std::string text = "the quick brown fox";
+  auto hash = HashUtil::HashBytes(text.data(), text.size());
+  EXPECT_EQ(HashUtil::HashBytes(text.data(), text.size()), hash);
+  EXPECT_NE(HashUtil::HashBytes(text.data(), text.size() - 1), hash);
+  text.back() = 'y';
+  EXPECT_NE(HashUtil::HashBytes(text.data(), text.size()), hash);
+  EXPECT_NE(HashUtil::CombineHashes(1, 2), HashUtil::CombineHashes(2, 1));
+
+  // Consecutive integers spread over the low bits, which hash tables index by.
+  std::set<hash_t> buckets;
+  for (int64_t i = 0; i < 4096; i++) {
+    buckets.insert(HashUtil::Hash(&i) & 0xFF);
+  }
+  EXPECT_EQ(buckets.size(), 256U);
+
+  // Hashing a column gives the same hashes as hashing its values one by one.
+  std::vector<Value> values;
+  for (int32_t i = 0; i < 100; i++) {
+    values.push_back(i % 7 == 0 ? ValueFactory::GetNullValueByType(TypeId::INTEGER) : ValueFactory::GetIntegerValue(i));
+  }
+  auto column = ColumnVector::FromValues(TypeId::INTEGER, values);
+  std::vector<hash_t> hashes(values.size());
+  HashUtil::HashColumn(column, hashes.data());
+  std::vector<hash_t> combined(values.size(), 42);
+  HashUtil::CombineHashColumn(column, combined.data());
+  for (size_t i = 0; i < values.size(); i++) {
+    EXPECT_EQ(hashes[i], hash_of(values[i]));
+    EXPECT_EQ(combined[i], values[i].IsNull() ? 42 : HashUtil::CombineHashes(42, hash_of(values[i])));
+  }
+}
+
+// NOLINTNEXTLINE
+TEST(TypeTests, ArenaPoolTest) {
+  ArenaPool pool(1024);
+
+  // Blocks are aligned and do not overlap.
+  std::vector<char *> blocks;
+  for (size_t size = 0; size < 100; size++) {
+    auto *block = static_cast<char *>(pool.Allocate(size));
+    ASSERT_EQ(0, reinterpret_cast<uintptr_t>(block) % alignof(std::max_align_t));
+    memset(block, static_cast<int>(size), size);
+    blocks.push_back(block);
+  }
+  for (size_t size = 0; size < 100; size++) {
+    for (size_t i = 0; i < size; i++) {
+      ASSERT_EQ(static_cast<char>(size), blocks[size][i]);
+    }
+  }
+
+  // A freed block is reused for a block of the same size class.
+  pool.Free(blocks[20]);
+  EXPECT_EQ(blocks[20], pool.Allocate(30));
+  // Allocating and freeing over and over does not grow the pool.
+  size_t capacity = pool.GetCapacity();
+  for (int i = 0; i < 100; i++) {
+    pool.Free(pool.Allocate(500));
+  }
+  EXPECT_LT(pool.GetCapacity() - capacity, 2 * 512);
+
+  // Containers can allocate from the pool.
+  std::vector<int64_t, PoolAllocator<int64_t>> values{PoolAllocator<int64_t>(&pool)};
+  for (int64_t i = 0; i < 10000; i++) {
+    values.push_back(i);
+  }
+  EXPECT_EQ(49995000, std::accumulate(values.begin(), values.end(), int64_t{0}));
+
+  // A VARCHAR cloned into the pool does not own its payload, and neither do its copies.
+  Value heap = ValueFactory::GetVarcharValue("a string that is too long to be inlined");
+  Value cloned = ValueFactory::Clone(heap, &pool);
+  Value copy = cloned;  // NOLINT
+  EXPECT_NE(heap.GetData(), cloned.GetData());
+  EXPECT_EQ(cloned.GetData(), copy.GetData());
+  EXPECT_EQ(CmpBool::CmpTrue, heap.CompareEquals(copy));
+  ValueFactory::Release(cloned, &pool);
+  EXPECT_EQ(cloned.GetData(), pool.Allocate(heap.GetLength()));
+
+  // Short strings are inlined instead.
+  Value code = ValueFactory::Clone(ValueFactory::GetVarcharValue("code"), &pool);
+  EXPECT_TRUE(code.IsVarlenInlined());
+  ValueFactory::Release(code, &pool);
+  EXPECT_EQ("code", code.ToString());
+}
+
+// NOLINTNEXTLINE
+TEST(TypeTests, InlineVarcharTest) {
+  std::vector<std::string> strings = {"", "a", "short code", std::string(15, 'x'), std::string(16, 'y'),
+                                      "a string that is too long to be inlined"};
+  for (const auto &str : strings) {
+    Value value = ValueFactory::GetVarcharValue(str);
+    EXPECT_EQ(str.length() + 1 <= Value::INLINE_VARLEN_LENGTH, value.IsVarlenInlined());
+    EXPECT_EQ(str, value.ToString());
+
+    // Copies and moves keep the string, and an inlined string lives inside the copy.
+    Value copy = value;  // NOLINT
+    EXPECT_EQ(str, copy.ToString());
+    const auto *copy_begin = reinterpret_cast<const char *>(&copy);
+    EXPECT_EQ(value.IsVarlenInlined(), copy.GetData() >= copy_begin && copy.GetData() < copy_begin + sizeof(Value));
+    Value moved = std::move(copy);
+    EXPECT_EQ(str, moved.ToString());
+    Value assigned;
+    assigned = moved;
+    EXPECT_EQ(str, assigned.ToString());
+    EXPECT_EQ(CmpBool::CmpTrue, assigned.CompareEquals(value));
+
+    // Serialization round-trips.
+    std::vector<char> storage(sizeof(uint32_t) + str.length() + 1);
+    value.SerializeTo(storage.data());
+    Value deserialized = Value::DeserializeFrom(storage.data(), TypeId::VARCHAR);
+    EXPECT_EQ(str, deserialized.ToString());
+    EXPECT_EQ(value.IsVarlenInlined(), deserialized.IsVarlenInlined());
+  }
+
+  // Values in containers survive reallocation.
+  std::vector<Value> values;
+  for (int i = 0; i < 100; i++) {
+    values.push_back(ValueFactory::GetVarcharValue(std::to_string(i) + (i % 2 == 0 ? "" : std::string(20, 'z'))));
+  }
+  for (int i = 0; i < 100; i++) {
+    EXPECT_EQ(std::to_string(i) + (i % 2 == 0 ? "" : std::string(20, 'z')), values[i].ToString());
+  }
+}
+
 }  // namespace bustub